@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Physics.hpp"
+#include "PitchConfig.hpp"
+#include "PitchSampler.hpp"
+#include "ResultStore.hpp"
+#include "TaskScheduler.hpp"
+#include "TrajectoryCodec.hpp"
+#include "TrajectoryPipeline.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options
+	{
+		std::string PitchPath;
+		std::string EnvPath;
+		std::string StorePath;
+		std::string CsvPath;
+		std::size_t Samples{ 1 };
+		std::uint64_t Seed{ 1 };
+		bool Trajectories{ false };
+	};
+
+	struct BatchPoint
+	{
+		std::size_t Entry{ 0 };
+		SimParams Params{};
+		PlateResult Result{};
+		bool FromStore{ false };
+	};
+
+	SimParams DefaultEnvironment()
+	{
+		SimParams p{};
+		p.ReleaseHeight_cm = 180.0;
+		p.SpinAxis = DVec3{ 1.0, 0.0, 0.0 };
+		p.Radius_mm = 37.0;
+		p.Mass_kg = 0.145;
+		p.AirTemp_C = 25.0;
+		p.RelHumidity_pct = 60.0;
+		p.Pressure_hPa = 1013.25;
+		p.Dt_s = 0.0001;
+		p.StopOnGroundHit = true;
+		return p;
+	}
+
+	void ApplyEnvironment(const std::string& path, SimParams& p)
+	{
+		Config::EnvironmentSettings es{};
+		std::vector<Config::ParseError> errors;
+		const bool loaded = Config::LoadEnvConfigFile(path, es, &errors);
+
+		for (const auto& e : errors)
+		{
+			std::fprintf(stderr, "%s\n", Config::FormatParseError(path, e).c_str());
+		}
+
+		if (!loaded)
+		{
+			std::fprintf(stderr, "failed to read %s, using defaults\n", path.c_str());
+			return;
+		}
+
+		p.Pressure_hPa = es.Pressure_hPa.value_or(p.Pressure_hPa);
+		p.UseAltitudePressure = es.UseHeightPressure.value_or(p.UseAltitudePressure);
+		p.Altitude_m = es.Height_m.value_or(p.Altitude_m);
+		p.AirTemp_C = es.AirTemp_C.value_or(p.AirTemp_C);
+		p.RelHumidity_pct = es.RelHumid_pct.value_or(p.RelHumidity_pct);
+		p.Radius_mm = es.Radius_mm.value_or(p.Radius_mm);
+		p.Mass_kg = es.Mass_kg.value_or(p.Mass_kg);
+		p.PlateDistance_m = es.PlateDistance_m.value_or(p.PlateDistance_m);
+		p.Dt_s = es.Dt_s.value_or(p.Dt_s);
+		p.Method = es.Method.value_or(p.Method);
+		p.Tolerance_m = es.Tolerance_m.value_or(p.Tolerance_m);
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: pitch_batch --pitch <path> [options]\n"
+			"  --env <path>       environment config\n"
+			"  --samples <n>      draws per RAND pitch (default 1)\n"
+			"  --seed <n>         sampler seed (default 1)\n"
+			"  --store <dir>      result store; stored results are reused and new ones appended\n"
+			"  --trajectories     also store quantized trajectories for new results\n"
+			"  --csv <path>       write the plate results as CSV\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string a = argv[i];
+			const bool hasValue = (i + 1 < argc);
+
+			if (a == "--pitch" && hasValue)
+			{
+				opt.PitchPath = argv[++i];
+			}
+			else if (a == "--env" && hasValue)
+			{
+				opt.EnvPath = argv[++i];
+			}
+			else if (a == "--samples" && hasValue)
+			{
+				opt.Samples = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+			}
+			else if (a == "--seed" && hasValue)
+			{
+				opt.Seed = std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if (a == "--store" && hasValue)
+			{
+				opt.StorePath = argv[++i];
+			}
+			else if (a == "--trajectories")
+			{
+				opt.Trajectories = true;
+			}
+			else if (a == "--csv" && hasValue)
+			{
+				opt.CsvPath = argv[++i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return !opt.PitchPath.empty();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options opt{};
+	if (!ParseOptions(argc, argv, opt))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	SimParams env = DefaultEnvironment();
+	if (!opt.EnvPath.empty())
+	{
+		ApplyEnvironment(opt.EnvPath, env);
+	}
+
+	std::vector<Config::PitchEntry> entries;
+	std::vector<Config::ParseError> errors;
+	const bool loaded = Config::LoadPitchConfigFileEx(opt.PitchPath, entries, &errors);
+
+	for (const auto& e : errors)
+	{
+		std::fprintf(stderr, "%s\n", Config::FormatParseError(opt.PitchPath, e).c_str());
+	}
+
+	if (!loaded)
+	{
+		std::fprintf(stderr, "failed to read %s\n", opt.PitchPath.c_str());
+		return 2;
+	}
+
+	std::vector<BatchPoint> points;
+	SamplerRng rng{ opt.Seed };
+
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		const PitchSampler sampler = PitchSampler::Compile(entries[i]);
+		const std::size_t draws = sampler.IsRandom() ? opt.Samples : 1;
+
+		for (std::size_t k = 0; k < draws; ++k)
+		{
+			Config::PitchEntry drawn = entries[i];
+			points.emplace_back(BatchPoint{ i, TrajectoryPipeline::Resolve(drawn, sampler, rng, env) });
+		}
+	}
+
+	ResultStore store;
+	if (!opt.StorePath.empty())
+	{
+		std::string error;
+		if (!store.Open(opt.StorePath, true, &error))
+		{
+			std::fprintf(stderr, "%s: %s\n", opt.StorePath.c_str(), error.c_str());
+			return 1;
+		}
+	}
+
+	const auto t0 = Clock::now();
+
+	std::vector<std::size_t> misses;
+	for (std::size_t i = 0; i < points.size(); ++i)
+	{
+		BatchPoint& bp = points[i];
+		bp.FromStore = store.IsOpen() && store.Find(bp.Params, bp.Result);
+
+		if (!bp.FromStore)
+		{
+			misses.emplace_back(i);
+		}
+	}
+
+	const auto t1 = Clock::now();
+
+	std::vector<QuantizedTrajectory> trajectories(opt.Trajectories && store.IsOpen() ? misses.size() : 0);
+
+	TaskScheduler scheduler;
+	scheduler.ParallelFor(0, misses.size(), [&](std::size_t begin, std::size_t end)
+	{
+		thread_local TrajectoryPipeline pipeline;
+
+		for (std::size_t k = begin; k < end; ++k)
+		{
+			BatchPoint& bp = points[misses[k]];
+			pipeline.Build(bp.Params, trajectories.empty() ? nullptr : &trajectories[k], nullptr, bp.Result);
+		}
+	});
+
+	const auto t2 = Clock::now();
+
+	if (store.IsOpen())
+	{
+		std::string error;
+		for (std::size_t k = 0; k < misses.size(); ++k)
+		{
+			const BatchPoint& bp = points[misses[k]];
+			if (!store.Put(bp.Params, bp.Result, trajectories.empty() ? nullptr : &trajectories[k], &error))
+			{
+				std::fprintf(stderr, "%s: %s\n", opt.StorePath.c_str(), error.c_str());
+				return 1;
+			}
+		}
+
+		if (!store.WriteIndex(&error))
+		{
+			std::fprintf(stderr, "%s: %s\n", opt.StorePath.c_str(), error.c_str());
+		}
+	}
+
+	const auto t3 = Clock::now();
+
+	const auto ms = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+	std::size_t crossed = 0;
+	for (const BatchPoint& bp : points)
+	{
+		crossed += bp.Result.Crossed ? 1 : 0;
+	}
+
+	std::printf("%zu pitches from %zu entries, %zu reach the plate\n", points.size(), entries.size(), crossed);
+	std::printf("  from store  %8zu  %10.3f ms\n", points.size() - misses.size(), ms(t0, t1));
+	std::printf("  simulated   %8zu  %10.3f ms (%u workers)\n", misses.size(), ms(t1, t2), scheduler.WorkerCount());
+
+	if (store.IsOpen())
+	{
+		std::printf("  stored      %8zu  %10.3f ms, %zu records in %s\n", misses.size(), ms(t2, t3), store.Size(), opt.StorePath.c_str());
+	}
+
+	if (!opt.CsvPath.empty())
+	{
+		std::ofstream ofs{ opt.CsvPath, std::ios::binary | std::ios::trunc };
+		ofs << "entry,label,speed_kmh,rpm,axis_x,axis_y,axis_z,release_cm,elevation_deg,azimuth_deg,crossed,y_m,z_m,time_s,termination,steps,source\n";
+
+		char buf[512];
+		for (const BatchPoint& bp : points)
+		{
+			const SimParams& p = bp.Params;
+			const PlateResult& r = bp.Result;
+			std::snprintf(buf, sizeof(buf), "%zu,\"%s\",%.6f,%.3f,%.6f,%.6f,%.6f,%.3f,%.4f,%.4f,%d,%.6e,%.6e,%.6e,%s,%llu,%s\n",
+				bp.Entry, entries[bp.Entry].Label.c_str(), p.InitialSpeed_mps * 3.6, p.SpinRPM, p.SpinAxis.X, p.SpinAxis.Y, p.SpinAxis.Z,
+				p.ReleaseHeight_cm, p.Elevation_deg, p.Azimuth_deg, r.Crossed ? 1 : 0, r.Y_m, r.Z_m, r.Time_s, ToString(r.Termination),
+				static_cast<unsigned long long>(r.Steps), bp.FromStore ? "store" : "sim");
+			ofs << buf;
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
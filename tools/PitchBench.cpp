@@ -0,0 +1,703 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Physics.hpp"
+#include "PitchConfig.hpp"
+#include "PitchSampler.hpp"
+#include "PolylineLod.hpp"
+#include "StateRecord.hpp"
+#include "TaskScheduler.hpp"
+#include "TrajectoryCache.hpp"
+#include "TrajectoryCodec.hpp"
+#include "TrajectoryPipeline.hpp"
+#include "TrajectorySimulator.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+#if defined(__GNUC__) || defined(__clang__)
+	template <typename T>
+	inline void KeepAlive(const T& value) noexcept
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+#else
+	volatile const void* g_Escape = nullptr;
+
+	template <typename T>
+	inline void KeepAlive(const T& value) noexcept
+	{
+		g_Escape = &value;
+	}
+#endif
+
+	struct Options
+	{
+		int Reps{ 10 };
+		double MinRepMs{ 20.0 };
+		double ThresholdPct{ 10.0 };
+		std::string Filter;
+		std::string JsonPath;
+		std::string BaselinePath;
+		bool List{ false };
+	};
+
+	struct BenchCase
+	{
+		std::string Name;
+		std::string ItemUnit;
+		std::function<std::uint64_t(std::uint64_t iterations)> Run;
+	};
+
+	struct BenchResult
+	{
+		std::string Name;
+		std::string ItemUnit;
+		std::uint64_t Iterations{ 0 };
+		double MedianNs{ 0.0 };
+		double MinNs{ 0.0 };
+		double MeanNs{ 0.0 };
+		double StddevNs{ 0.0 };
+		double ItemsPerOp{ 0.0 };
+	};
+
+	SimParams MakePitch(std::uint32_t k, double dt_s)
+	{
+		std::uint32_t h = k * 2654435761u;
+		auto unit = [&h]()
+		{
+			h ^= h << 13;
+			h ^= h >> 17;
+			h ^= h << 5;
+			return static_cast<double>(h & 0xFFFFFF) / static_cast<double>(0x1000000);
+		};
+
+		SimParams p{};
+		p.ReleaseHeight_cm = 150.0 + 20.0 * unit();
+		p.InitialSpeed_mps = (120.0 + 45.0 * unit()) / 3.6;
+		p.Elevation_deg = -2.0 + 4.0 * unit();
+		p.Azimuth_deg = -1.5 + 3.0 * unit();
+		p.SpinRPM = 500.0 + 2500.0 * unit();
+		p.SpinAxis = DVec3{ unit() - 0.5, unit() - 0.5, unit() - 0.5 };
+		p.Radius_mm = 37.0;
+		p.Mass_kg = 0.145;
+		p.Dt_s = dt_s;
+		p.StopOnGroundHit = true;
+		return p;
+	}
+
+	std::string WriteSyntheticConfig(std::size_t entries)
+	{
+		const auto path = std::filesystem::temp_directory_path() / ("pitchbench_" + std::to_string(entries) + ".txt");
+
+		std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+		ofs << "/synthetic pitch list for benchmarking\n\n";
+
+		char buf[256];
+		for (std::size_t i = 0; i < entries; ++i)
+		{
+			ofs << "#Pitch " << i << "\n";
+
+			if (i % 4 == 3)
+			{
+				ofs << "Speed=RAND[120:160],Axis=(RAND[-1:1],RAND[-1:1],RAND[-1:1]),RPM=RAND[500:3000],Elevation=RAND[-2:2],Azimuth=RAND[-1:1]\n\n";
+			}
+			else
+			{
+				std::snprintf(buf, sizeof(buf), "Speed=%.1f,Axis=(%.3f,%.3f,%.3f),RPM=%d,Release=%d,Elevation=%.2f,Azimuth=%.2f\n\n",
+					130.0 + static_cast<double>(i % 35), -0.5 + static_cast<double>(i % 11) * 0.1, 0.2, 0.9, 1500 + static_cast<int>(i % 1500), 150 + static_cast<int>(i % 20), -1.5 + static_cast<double>(i % 7) * 0.5, static_cast<double>(i % 5) * 0.2);
+				ofs << buf;
+			}
+		}
+
+		return path.string();
+	}
+
+	std::vector<BenchCase> BuildCases(std::vector<std::string>& tempFiles)
+	{
+		std::vector<BenchCase> cases;
+
+		cases.emplace_back(BenchCase{ "physics/air_density", "ops", [](std::uint64_t n)
+		{
+			double acc = 0.0;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				const double t = -5.0 + static_cast<double>(i & 63);
+				acc += ComputeAirDensity_kg_per_m3(t, 55.0, 1013.25);
+			}
+			KeepAlive(acc);
+			return n;
+		} });
+
+		cases.emplace_back(BenchCase{ "physics/compute_acceleration", "ops", [](std::uint64_t n)
+		{
+			const auto f = TrajectorySimulator::MakeForceParams(MakePitch(1, 1e-4));
+			DVec3 acc{ 0.0, 0.0, 0.0 };
+			DVec3 pos{ 1.0, 1.5, 0.0 };
+			DVec3 vel{ 40.0, -1.0, 0.5 };
+
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				vel.Y = -1.0 + static_cast<double>(i & 255) * 1e-3;
+				acc = Add(acc, TrajectorySimulator::ComputeAcceleration(pos, vel, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G));
+			}
+			KeepAlive(acc);
+			return n;
+		} });
+
+		cases.emplace_back(BenchCase{ "integrator/rk4_step", "steps", [](std::uint64_t n)
+		{
+			const auto f = TrajectorySimulator::MakeForceParams(MakePitch(2, 1e-4));
+			const TrajectorySimulator::RK4State start{ DVec3{ 0.0, 1.8, 0.0 }, DVec3{ 40.0, -0.5, 0.2 } };
+			TrajectorySimulator::RK4State s = start;
+
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				if ((i & 4095) == 0)
+				{
+					s = start;
+				}
+				TrajectorySimulator::StepRK4(s, f, 1e-4);
+			}
+			KeepAlive(s);
+			return n;
+		} });
+
+		for (const double dt : { 1e-3, 5e-4, 1e-4, 1e-5 })
+		{
+			char name[64];
+			std::snprintf(name, sizeof(name), "simulate/dt=%g", dt);
+
+			cases.emplace_back(BenchCase{ name, "pitches", [dt](std::uint64_t n)
+			{
+				TrajectorySimulator sim;
+				std::vector<Float3> points;
+				for (std::uint64_t i = 0; i < n; ++i)
+				{
+					sim.Simulate(MakePitch(static_cast<std::uint32_t>(i & 15), dt), points);
+					KeepAlive(points.back());
+				}
+				return n;
+			} });
+		}
+
+		constexpr std::size_t BATCH = 256;
+
+		cases.emplace_back(BenchCase{ "batch/serial_256", "pitches", [](std::uint64_t n)
+		{
+			TrajectorySimulator sim;
+			std::vector<Float3> points;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				for (std::size_t k = 0; k < BATCH; ++k)
+				{
+					sim.Simulate(MakePitch(static_cast<std::uint32_t>(k), 5e-4), points);
+					KeepAlive(points.back());
+				}
+			}
+			return n * BATCH;
+		} });
+
+		auto scheduler = std::make_shared<TaskScheduler>();
+		cases.emplace_back(BenchCase{ "batch/parallel_256", "pitches", [scheduler](std::uint64_t n)
+		{
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				scheduler->ParallelFor(0, BATCH, [](std::size_t begin, std::size_t end)
+				{
+					thread_local std::vector<Float3> points;
+					TrajectorySimulator sim;
+					for (std::size_t k = begin; k < end; ++k)
+					{
+						sim.Simulate(MakePitch(static_cast<std::uint32_t>(k), 5e-4), points);
+						KeepAlive(points.back());
+					}
+				});
+			}
+			return n * BATCH;
+		} });
+
+		auto cache = std::make_shared<TrajectoryCache>(std::uint64_t{ 256 } * 1024 * 1024);
+		{
+			TrajectorySimulator sim;
+			std::vector<Float3> points;
+			for (std::size_t k = 0; k < BATCH; ++k)
+			{
+				const SimParams p = MakePitch(static_cast<std::uint32_t>(k), 5e-4);
+				sim.Simulate(p, points);
+
+				QuantizedTrajectory traj;
+				traj.Box = TrajectoryCodec::ComputeBox(points.data(), points.size());
+				traj.Samples.resize(points.size());
+				TrajectoryCodec::Encode(points.data(), points.size(), traj.Box, traj.Samples.data());
+
+				PolylineLod lod;
+				PolylineSimplifier::Build(points.data(), points.size(), lod);
+				cache->Insert(p, PLATE_DISTANCE_M, traj, lod, SimStats{}, PlateResult{});
+			}
+		}
+
+		cases.emplace_back(BenchCase{ "cache/hit_256", "pitches", [cache](std::uint64_t n)
+		{
+			QuantizedTrajectory traj;
+			PolylineLod lod;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				for (std::size_t k = 0; k < BATCH; ++k)
+				{
+					const TrajectoryCache::Entry* e = cache->Find(MakePitch(static_cast<std::uint32_t>(k), 5e-4), PLATE_DISTANCE_M);
+					traj.Samples.assign(e->Samples.begin(), e->Samples.end());
+					lod = e->Lod;
+					KeepAlive(traj.Samples.back());
+				}
+			}
+			return n * BATCH;
+		} });
+
+		cases.emplace_back(BenchCase{ "build/staged", "pitches", [](std::uint64_t n)
+		{
+			TrajectorySimulator sim;
+			std::vector<Float3> points;
+			QuantizedTrajectory traj;
+			PolylineLod lod;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				sim.Simulate(MakePitch(static_cast<std::uint32_t>(i & 15), 1e-4), points);
+				PolylineSimplifier::Build(points.data(), points.size(), lod);
+				traj.Box = TrajectoryCodec::ComputeBox(points.data(), points.size());
+				traj.Samples.resize(points.size());
+				TrajectoryCodec::Encode(points.data(), points.size(), traj.Box, traj.Samples.data());
+
+				float hitY = 0.0f;
+				Float3 a = TrajectoryCodec::Decode(traj.Samples[0], traj.Box);
+				for (std::size_t k = 1; k < traj.Samples.size(); ++k)
+				{
+					const Float3 b = TrajectoryCodec::Decode(traj.Samples[k], traj.Box);
+					if (a.X <= PLATE_DISTANCE_M && b.X >= PLATE_DISTANCE_M)
+					{
+						hitY = a.Y + (b.Y - a.Y) * std::clamp((static_cast<float>(PLATE_DISTANCE_M) - a.X) / (b.X - a.X), 0.0f, 1.0f);
+						break;
+					}
+					a = b;
+				}
+				KeepAlive(hitY);
+			}
+			return n;
+		} });
+
+		cases.emplace_back(BenchCase{ "build/fused", "pitches", [](std::uint64_t n)
+		{
+			TrajectoryPipeline pipeline;
+			QuantizedTrajectory traj;
+			PolylineLod lod;
+			PlateResult hit;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				pipeline.Build(MakePitch(static_cast<std::uint32_t>(i & 15), 1e-4), &traj, &lod, hit);
+				KeepAlive(hit.Y_m);
+			}
+			return n;
+		} });
+
+		cases.emplace_back(BenchCase{ "build/fused_plate_only", "pitches", [](std::uint64_t n)
+		{
+			TrajectoryPipeline pipeline;
+			PlateResult hit;
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				pipeline.Build(MakePitch(static_cast<std::uint32_t>(i & 15), 1e-4), nullptr, nullptr, hit);
+				KeepAlive(hit.Y_m);
+			}
+			return n;
+		} });
+
+		for (const std::uint32_t stride : { 1u, 16u })
+		{
+			cases.emplace_back(BenchCase{ "record/stride_" + std::to_string(stride), "pitches", [stride](std::uint64_t n)
+			{
+				TrajectoryPipeline pipeline;
+				StateRecord record;
+				record.Stride = stride;
+				PlateResult hit;
+				for (std::uint64_t i = 0; i < n; ++i)
+				{
+					pipeline.Build(MakePitch(static_cast<std::uint32_t>(i & 15), 1e-4), nullptr, nullptr, hit, nullptr, nullptr, &record);
+					KeepAlive(record.T.back());
+				}
+				return n;
+			} });
+		}
+
+		auto recorded = std::make_shared<StateRecord>();
+		{
+			TrajectoryPipeline pipeline;
+			PlateResult hit;
+			pipeline.Build(MakePitch(3, 1e-5), nullptr, nullptr, hit, nullptr, nullptr, recorded.get());
+		}
+
+		cases.emplace_back(BenchCase{ "analysis/kernels", "states", [recorded](std::uint64_t n)
+		{
+			const std::size_t count = recorded->Size();
+			std::vector<double> a(count);
+			std::vector<double> b(count);
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				StateAnalysis::SpeedRatio(*recorded, a.data());
+				StateAnalysis::ApproachAngles(*recorded, a.data(), b.data());
+				StateAnalysis::BreakProfile(*recorded, a.data(), b.data());
+				KeepAlive(b.back());
+			}
+			return n * count;
+		} });
+
+		const auto compileSampler = [](const char* line)
+		{
+			std::vector<Config::PitchEntry> list;
+			Config::ParsePitchConfig(std::string{ "#bench\n" } + line, list, true);
+			return std::make_pair(list.front(), PitchSampler::Compile(list.front()));
+		};
+
+		const auto uniform = compileSampler("Speed=RAND[140:150],Axis=(RAND[-1:1],RAND[-1:1],1),RPM=RAND[1800:2400],Release=RAND[170:185]");
+		const auto shaped = compileSampler("Speed=NORMAL(145,3),Axis=SPHERE,RPM=TRUNCNORMAL(2200,150,1800,2500),Elevation=RAND[-3:0],Correlate=(Speed,RPM,0.6)");
+
+		for (const auto& [name, sampler] : { std::make_pair(std::string{ "uniform" }, uniform), std::make_pair(std::string{ "shaped" }, shaped) })
+		{
+			cases.emplace_back(BenchCase{ "sampler/" + name + "_one", "draws", [sampler](std::uint64_t n)
+			{
+				Config::PitchEntry entry = sampler.first;
+				SamplerRng rng{ 1 };
+				for (std::uint64_t i = 0; i < n; ++i)
+				{
+					sampler.second.SampleOne(entry, rng);
+					KeepAlive(entry.Speed_kmh);
+				}
+				return n;
+			} });
+
+			cases.emplace_back(BenchCase{ "sampler/" + name + "_batch_4096", "draws", [sampler](std::uint64_t n)
+			{
+				constexpr std::size_t COUNT = 4096;
+				std::vector<double> columns[PitchSampler::FIELD_COUNT];
+				SamplerRng rng{ 1 };
+				for (std::uint64_t i = 0; i < n; ++i)
+				{
+					SampleBatch(sampler.second, COUNT, columns, rng);
+					KeepAlive(columns[0].back());
+				}
+				return n * COUNT;
+			} });
+		}
+
+		for (const std::size_t entries : { std::size_t{ 1000 }, std::size_t{ 10000 }, std::size_t{ 100000 } })
+		{
+			const std::string path = WriteSyntheticConfig(entries);
+			tempFiles.emplace_back(path);
+
+			cases.emplace_back(BenchCase{ "config/parse_" + std::to_string(entries), "pitches", [path](std::uint64_t n)
+			{
+				std::vector<Config::PitchEntry> list;
+				std::uint64_t items = 0;
+				for (std::uint64_t i = 0; i < n; ++i)
+				{
+					Config::LoadPitchConfigFileEx(path, list);
+					items += list.size();
+				}
+				return items;
+			} });
+		}
+
+		return cases;
+	}
+
+	BenchResult RunCase(const BenchCase& c, const Options& opt)
+	{
+		c.Run(1);
+
+		std::uint64_t iterations = 1;
+		for (;;)
+		{
+			const auto t0 = Clock::now();
+			c.Run(iterations);
+			const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+			if (ms >= opt.MinRepMs || iterations >= (1ull << 40))
+			{
+				break;
+			}
+
+			const double scale = (ms > 0.0) ? std::min(10.0, std::max(1.5, 1.2 * opt.MinRepMs / ms)) : 10.0;
+			iterations = static_cast<std::uint64_t>(std::ceil(static_cast<double>(iterations) * scale));
+		}
+
+		std::vector<double> samples;
+		samples.reserve(static_cast<std::size_t>(opt.Reps));
+		std::uint64_t items = 0;
+
+		for (int r = 0; r < opt.Reps; ++r)
+		{
+			const auto t0 = Clock::now();
+			items += c.Run(iterations);
+			const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+			samples.emplace_back(ns / static_cast<double>(iterations));
+		}
+
+		BenchResult res{};
+		res.Name = c.Name;
+		res.ItemUnit = c.ItemUnit;
+		res.Iterations = iterations;
+		res.ItemsPerOp = static_cast<double>(items) / (static_cast<double>(iterations) * static_cast<double>(opt.Reps));
+
+		std::sort(samples.begin(), samples.end());
+		const std::size_t m = samples.size();
+		res.MedianNs = (m % 2 == 1) ? samples[m / 2] : 0.5 * (samples[m / 2 - 1] + samples[m / 2]);
+		res.MinNs = samples.front();
+
+		double sum = 0.0;
+		for (double s : samples)
+		{
+			sum += s;
+		}
+		res.MeanNs = sum / static_cast<double>(m);
+
+		double var = 0.0;
+		for (double s : samples)
+		{
+			var += (s - res.MeanNs) * (s - res.MeanNs);
+		}
+		res.StddevNs = (m > 1) ? std::sqrt(var / static_cast<double>(m - 1)) : 0.0;
+
+		return res;
+	}
+
+	double ItemsPerSecond(const BenchResult& r) noexcept
+	{
+		return (r.MedianNs > 0.0) ? (r.ItemsPerOp * 1e9 / r.MedianNs) : 0.0;
+	}
+
+	bool WriteJson(const std::string& path, const std::vector<BenchResult>& results, const Options& opt)
+	{
+		std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+		if (!ofs)
+		{
+			return false;
+		}
+
+		ofs << "{\n  \"version\": 1,\n  \"reps\": " << opt.Reps << ",\n  \"cases\": [\n";
+
+		char buf[512];
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::snprintf(buf, sizeof(buf), "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns\": %.3f, \"stddev_ns\": %.3f, \"iterations\": %llu, \"items_per_s\": %.3f, \"item_unit\": \"%s\" }%s\n",
+				r.Name.c_str(), r.MedianNs, r.MinNs, r.StddevNs, static_cast<unsigned long long>(r.Iterations), ItemsPerSecond(r), r.ItemUnit.c_str(), (i + 1 < results.size()) ? "," : "");
+			ofs << buf;
+		}
+
+		ofs << "  ]\n}\n";
+		return static_cast<bool>(ofs);
+	}
+
+	bool LoadBaseline(const std::string& path, std::map<std::string, double>& out)
+	{
+		std::ifstream ifs{ path, std::ios::binary };
+		if (!ifs)
+		{
+			return false;
+		}
+
+		std::stringstream ss;
+		ss << ifs.rdbuf();
+		const std::string text = ss.str();
+
+		const std::string nameKey = "\"name\"";
+		const std::string valueKey = "\"ns_per_op\"";
+
+		std::size_t pos = 0;
+		while ((pos = text.find(nameKey, pos)) != std::string::npos)
+		{
+			const std::size_t q0 = text.find('"', text.find(':', pos + nameKey.size()) + 1);
+			const std::size_t q1 = (q0 == std::string::npos) ? q0 : text.find('"', q0 + 1);
+			if (q1 == std::string::npos)
+			{
+				return false;
+			}
+
+			const std::string name = text.substr(q0 + 1, q1 - q0 - 1);
+			const std::size_t next = text.find(nameKey, q1);
+			const std::size_t v = text.find(valueKey, q1);
+
+			if (v != std::string::npos && v < next)
+			{
+				const std::size_t colon = text.find(':', v + valueKey.size());
+				out[name] = std::strtod(text.c_str() + colon + 1, nullptr);
+			}
+
+			pos = q1;
+		}
+
+		return !out.empty();
+	}
+
+	int CompareBaseline(const std::vector<BenchResult>& results, const std::map<std::string, double>& baseline, double thresholdPct)
+	{
+		int regressions = 0;
+
+		std::printf("\n%-32s %14s %14s %9s\n", "case", "baseline ns", "current ns", "delta");
+
+		for (const auto& r : results)
+		{
+			const auto it = baseline.find(r.Name);
+			if (it == baseline.end() || it->second <= 0.0)
+			{
+				std::printf("%-32s %14s %14.1f %9s\n", r.Name.c_str(), "-", r.MedianNs, "new");
+				continue;
+			}
+
+			const double deltaPct = (r.MedianNs / it->second - 1.0) * 100.0;
+			const bool regressed = deltaPct > thresholdPct;
+			regressions += regressed ? 1 : 0;
+
+			std::printf("%-32s %14.1f %14.1f %+8.1f%%%s\n", r.Name.c_str(), it->second, r.MedianNs, deltaPct, regressed ? "  REGRESSED" : "");
+		}
+
+		std::printf("%d case(s) regressed beyond %.1f%%\n", regressions, thresholdPct);
+		return regressions;
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: pitch_bench [options]\n"
+			"  --filter <text>      run cases whose name contains <text>\n"
+			"  --reps <n>           timed repetitions per case (default 10)\n"
+			"  --min-rep-ms <ms>    minimum duration of one repetition (default 20)\n"
+			"  --json <path>        write results as JSON\n"
+			"  --baseline <path>    compare against a JSON baseline, exit 1 on regression\n"
+			"  --threshold <pct>    allowed slowdown against the baseline (default 10)\n"
+			"  --list               list case names and exit\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string a = argv[i];
+			const bool hasValue = (i + 1 < argc);
+
+			if (a == "--filter" && hasValue)
+			{
+				opt.Filter = argv[++i];
+			}
+			else if (a == "--reps" && hasValue)
+			{
+				opt.Reps = std::max(1, std::atoi(argv[++i]));
+			}
+			else if (a == "--min-rep-ms" && hasValue)
+			{
+				opt.MinRepMs = std::max(0.1, std::atof(argv[++i]));
+			}
+			else if (a == "--json" && hasValue)
+			{
+				opt.JsonPath = argv[++i];
+			}
+			else if (a == "--baseline" && hasValue)
+			{
+				opt.BaselinePath = argv[++i];
+			}
+			else if (a == "--threshold" && hasValue)
+			{
+				opt.ThresholdPct = std::atof(argv[++i]);
+			}
+			else if (a == "--list")
+			{
+				opt.List = true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options opt{};
+	if (!ParseOptions(argc, argv, opt))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::map<std::string, double> baseline;
+	if (!opt.BaselinePath.empty() && !LoadBaseline(opt.BaselinePath, baseline))
+	{
+		std::fprintf(stderr, "failed to read baseline %s\n", opt.BaselinePath.c_str());
+		return 2;
+	}
+
+	std::vector<std::string> tempFiles;
+	const auto cases = BuildCases(tempFiles);
+
+	std::vector<BenchResult> results;
+
+	if (!opt.List)
+	{
+		std::printf("%-32s %14s %14s %9s %16s\n", "case", "ns/op (median)", "min ns/op", "stddev", "throughput");
+	}
+
+	for (const auto& c : cases)
+	{
+		if (!opt.Filter.empty() && c.Name.find(opt.Filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		if (opt.List)
+		{
+			std::printf("%s\n", c.Name.c_str());
+			continue;
+		}
+
+		const BenchResult r = RunCase(c, opt);
+		std::printf("%-32s %14.1f %14.1f %8.1f%% %12.4g %s/s\n", r.Name.c_str(), r.MedianNs, r.MinNs, (r.MeanNs > 0.0) ? (100.0 * r.StddevNs / r.MeanNs) : 0.0, ItemsPerSecond(r), r.ItemUnit.c_str());
+		std::fflush(stdout);
+		results.emplace_back(r);
+	}
+
+	for (const auto& path : tempFiles)
+	{
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+
+	if (!opt.JsonPath.empty() && !WriteJson(opt.JsonPath, results, opt))
+	{
+		std::fprintf(stderr, "failed to write %s\n", opt.JsonPath.c_str());
+		return 2;
+	}
+
+	if (!baseline.empty() && CompareBaseline(results, baseline, opt.ThresholdPct) > 0)
+	{
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,532 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Physics.hpp"
+#include "PitchConfig.hpp"
+#include "TrajectorySimulator.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr double REFERENCE_TOLERANCE_M = 1e-11;
+	constexpr double REFERENCE_OUTPUT_DT_S = 1e-6;
+	constexpr double CHECK_RK4_DT_S = 2e-6;
+
+	struct Options
+	{
+		std::string PitchPath;
+		std::string EnvPath;
+		std::string CsvPath;
+		int Reps{ 3 };
+	};
+
+	struct Setting
+	{
+		Integrator Method{ Integrator::RK4 };
+		double Dt_s{ 1e-4 };
+		double Tolerance_m{ 0.0 };
+		bool IsCurrent{ false };
+	};
+
+	struct Measurement
+	{
+		Setting Config;
+		double MsPerPitch{ 0.0 };
+		double MaxErr_m{ 0.0 };
+		double MeanErr_m{ 0.0 };
+		double MeanSteps{ 0.0 };
+		double MeanEvals{ 0.0 };
+		double MeanRejected{ 0.0 };
+		std::uint64_t PeakBytes{ 0 };
+		bool Pareto{ false };
+	};
+
+	struct PlateHit
+	{
+		double Y;
+		double Z;
+	};
+
+	const char* MethodName(Integrator m) noexcept
+	{
+		switch (m)
+		{
+			case Integrator::Euler: return "Euler";
+			case Integrator::Heun: return "Heun";
+			case Integrator::RK45: return "RK45";
+			default: return "RK4";
+		}
+	}
+
+	std::string Describe(const Setting& s)
+	{
+		char buf[96];
+		if (s.Method == Integrator::RK45)
+		{
+			std::snprintf(buf, sizeof(buf), "%s tol=%g out=%g", MethodName(s.Method), s.Tolerance_m, s.Dt_s);
+		}
+		else
+		{
+			std::snprintf(buf, sizeof(buf), "%s dt=%g%s", MethodName(s.Method), s.Dt_s, s.IsCurrent ? " (current)" : "");
+		}
+		return buf;
+	}
+
+	std::optional<PlateHit> PlateCrossing(const std::vector<Float3>& pts, double plateX)
+	{
+		for (std::size_t k = 1; k < pts.size(); ++k)
+		{
+			const Float3& a = pts[k - 1];
+			const Float3& b = pts[k];
+
+			if (a.X <= plateX && b.X >= plateX)
+			{
+				const double dx = static_cast<double>(b.X) - static_cast<double>(a.X);
+				const double t = (std::abs(dx) > 1e-12) ? std::clamp((plateX - a.X) / dx, 0.0, 1.0) : 0.0;
+				return PlateHit{ a.Y + (b.Y - a.Y) * t, a.Z + (b.Z - a.Z) * t };
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	double Mid(const std::optional<double>& lo, const std::optional<double>& hi, double fallback)
+	{
+		return (lo.has_value() && hi.has_value()) ? 0.5 * (lo.value() + hi.value()) : fallback;
+	}
+
+	SimParams ResolveEntry(const Config::PitchEntry& pe, const SimParams& env)
+	{
+		SimParams p = env;
+		p.InitialSpeed_mps = (pe.IsRandomSpeed ? Mid(pe.SpeedMin, pe.SpeedMax, pe.Speed_kmh) : pe.Speed_kmh) / 3.6;
+		p.SpinRPM = pe.IsRandomRpm ? Mid(pe.RpmMin, pe.RpmMax, pe.Rpm) : pe.Rpm;
+		p.SpinAxis = DVec3
+		{
+			pe.IsRandomAxisX ? Mid(pe.XMin, pe.XMax, pe.Axis.X) : pe.Axis.X,
+			pe.IsRandomAxisY ? Mid(pe.YMin, pe.YMax, pe.Axis.Y) : pe.Axis.Y,
+			pe.IsRandomAxisZ ? Mid(pe.ZMin, pe.ZMax, pe.Axis.Z) : pe.Axis.Z
+		};
+		p.ReleaseHeight_cm = pe.IsRandomRelease ? Mid(pe.ReleaseMin, pe.ReleaseMax, p.ReleaseHeight_cm) : pe.Release_cm.value_or(p.ReleaseHeight_cm);
+		p.Elevation_deg = pe.IsRandomElevation ? Mid(pe.ElevationMin, pe.ElevationMax, 0.0) : pe.Elevation_deg.value_or(0.0);
+		p.Azimuth_deg = pe.IsRandomAzimuth ? Mid(pe.AzimuthMin, pe.AzimuthMax, 0.0) : pe.Azimuth_deg.value_or(0.0);
+		return p;
+	}
+
+	std::vector<SimParams> SyntheticPitches(const SimParams& env)
+	{
+		struct Spec
+		{
+			double Speed_kmh;
+			DVec3 Axis;
+			double Rpm;
+			double Elevation_deg;
+			double Azimuth_deg;
+		};
+
+		const Spec specs[] =
+		{
+			{ 155.0, { 0.0, 0.0, 1.0 }, 2400.0, -1.5, 0.0 },
+			{ 150.0, { 0.0, -0.11, 0.955 }, 2100.0, -1.5, 0.2 },
+			{ 145.0, { 0.0, 0.11, 0.787 }, 2500.0, -1.0, 0.0 },
+			{ 130.0, { 0.0, 1.0, 0.0 }, 2700.0, 1.0, 1.5 },
+			{ 125.0, { 0.0, 0.2, -0.9 }, 2900.0, 2.0, 0.0 },
+			{ 140.0, { 0.0, 0.0, 1.0 }, 600.0, -1.2, 0.2 },
+			{ 138.0, { 0.88, 0.0, -0.2 }, 1000.0, -0.5, 0.6 },
+			{ 110.0, { 0.3, -0.5, 0.8 }, 1800.0, 3.0, -0.8 },
+		};
+
+		std::vector<SimParams> out;
+		for (const Spec& s : specs)
+		{
+			SimParams p = env;
+			p.InitialSpeed_mps = s.Speed_kmh / 3.6;
+			p.SpinAxis = s.Axis;
+			p.SpinRPM = s.Rpm;
+			p.Elevation_deg = s.Elevation_deg;
+			p.Azimuth_deg = s.Azimuth_deg;
+			out.emplace_back(p);
+		}
+
+		return out;
+	}
+
+	SimParams DefaultEnvironment()
+	{
+		SimParams p{};
+		p.ReleaseHeight_cm = 155.0;
+		p.Radius_mm = 37.0;
+		p.Mass_kg = 0.145;
+		p.AirTemp_C = 25.0;
+		p.RelHumidity_pct = 60.0;
+		p.Pressure_hPa = 1013.25;
+		p.StopOnGroundHit = true;
+		return p;
+	}
+
+	std::optional<double> ApplyEnvironment(const std::string& path, SimParams& p)
+	{
+		Config::EnvironmentSettings es{};
+		std::vector<Config::ParseError> errors;
+		const bool loaded = Config::LoadEnvConfigFile(path, es, &errors);
+
+		for (const auto& e : errors)
+		{
+			std::fprintf(stderr, "%s\n", Config::FormatParseError(path, e).c_str());
+		}
+
+		if (!loaded)
+		{
+			std::fprintf(stderr, "failed to read %s, using defaults\n", path.c_str());
+			return std::nullopt;
+		}
+
+		p.Pressure_hPa = es.Pressure_hPa.value_or(p.Pressure_hPa);
+		p.UseAltitudePressure = es.UseHeightPressure.value_or(p.UseAltitudePressure);
+		p.Altitude_m = es.Height_m.value_or(p.Altitude_m);
+		p.AirTemp_C = es.AirTemp_C.value_or(p.AirTemp_C);
+		p.RelHumidity_pct = es.RelHumid_pct.value_or(p.RelHumidity_pct);
+		p.Radius_mm = es.Radius_mm.value_or(p.Radius_mm);
+		p.Mass_kg = es.Mass_kg.value_or(p.Mass_kg);
+		p.PlateDistance_m = es.PlateDistance_m.value_or(p.PlateDistance_m);
+		return es.Dt_s;
+	}
+
+	std::vector<Setting> BuildSettings(const std::optional<double>& currentDt)
+	{
+		std::vector<Setting> out;
+
+		for (double dt : { 1e-3, 5e-4, 2e-4, 1e-4, 5e-5, 2e-5, 1e-5, 5e-6 })
+		{
+			out.emplace_back(Setting{ Integrator::Euler, dt });
+		}
+
+		for (double dt : { 5e-3, 2e-3, 1e-3, 5e-4, 2e-4, 1e-4, 5e-5, 2e-5 })
+		{
+			out.emplace_back(Setting{ Integrator::Heun, dt });
+		}
+
+		for (double dt : { 1e-2, 5e-3, 2e-3, 1e-3, 5e-4, 2e-4, 1e-4, 5e-5, 1e-5 })
+		{
+			out.emplace_back(Setting{ Integrator::RK4, dt });
+		}
+
+		if (currentDt.has_value())
+		{
+			out.emplace_back(Setting{ Integrator::RK4, currentDt.value(), 0.0, true });
+		}
+
+		for (double outDt : { 1e-3, 1e-4 })
+		{
+			for (double tol : { 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8 })
+			{
+				out.emplace_back(Setting{ Integrator::RK45, outDt, tol });
+			}
+		}
+
+		return out;
+	}
+
+	Measurement Measure(const Setting& s, const std::vector<SimParams>& pitches, const std::vector<PlateHit>& reference, int reps)
+	{
+		Measurement m{};
+		m.Config = s;
+
+		TrajectorySimulator sim;
+		std::vector<Float3> points;
+		double bestMs = std::numeric_limits<double>::max();
+
+		for (int r = 0; r < reps; ++r)
+		{
+			double errSum = 0.0;
+			double errMax = 0.0;
+			std::uint64_t steps = 0;
+			std::uint64_t evals = 0;
+			std::uint64_t rejected = 0;
+			std::uint64_t peak = 0;
+			double elapsedMs = 0.0;
+
+			for (std::size_t i = 0; i < pitches.size(); ++i)
+			{
+				SimParams p = pitches[i];
+				p.Method = s.Method;
+				p.Dt_s = s.Dt_s;
+				p.Tolerance_m = s.Tolerance_m;
+
+				SimStats st{};
+				const auto t0 = Clock::now();
+				sim.Simulate(p, points, &st);
+				elapsedMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+				const auto hit = PlateCrossing(points, p.PlateDistance_m);
+				const double err = hit.has_value() ? std::hypot(hit->Y - reference[i].Y, hit->Z - reference[i].Z) : std::numeric_limits<double>::infinity();
+
+				errSum += err;
+				errMax = std::max(errMax, err);
+				steps += st.Steps;
+				evals += st.ForceEvals;
+				rejected += st.RejectedSteps;
+				peak = std::max(peak, st.PeakOutput);
+			}
+
+			const double n = static_cast<double>(pitches.size());
+			bestMs = std::min(bestMs, elapsedMs / n);
+			m.MaxErr_m = errMax;
+			m.MeanErr_m = errSum / n;
+			m.MeanSteps = static_cast<double>(steps) / n;
+			m.MeanEvals = static_cast<double>(evals) / n;
+			m.MeanRejected = static_cast<double>(rejected) / n;
+			m.PeakBytes = peak * sizeof(Float3);
+		}
+
+		m.MsPerPitch = bestMs;
+		return m;
+	}
+
+	void MarkPareto(std::vector<Measurement>& ms)
+	{
+		for (auto& a : ms)
+		{
+			a.Pareto = std::isfinite(a.MaxErr_m);
+			for (const auto& b : ms)
+			{
+				const bool noWorse = (b.MsPerPitch <= a.MsPerPitch) && (b.MaxErr_m <= a.MaxErr_m);
+				const bool better = (b.MsPerPitch < a.MsPerPitch) || (b.MaxErr_m < a.MaxErr_m);
+				if (&a != &b && noWorse && better)
+				{
+					a.Pareto = false;
+					break;
+				}
+			}
+		}
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: pitch_pareto [options]\n"
+			"  --pitch <path>   pitch list (RAND ranges use their midpoint); built-in set otherwise\n"
+			"  --env <path>     environment config; its DT is measured as the current setting\n"
+			"  --reps <n>       timing repetitions per setting (default 3)\n"
+			"  --csv <path>     write the full table as CSV\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string a = argv[i];
+			const bool hasValue = (i + 1 < argc);
+
+			if (a == "--pitch" && hasValue)
+			{
+				opt.PitchPath = argv[++i];
+			}
+			else if (a == "--env" && hasValue)
+			{
+				opt.EnvPath = argv[++i];
+			}
+			else if (a == "--reps" && hasValue)
+			{
+				opt.Reps = std::max(1, std::atoi(argv[++i]));
+			}
+			else if (a == "--csv" && hasValue)
+			{
+				opt.CsvPath = argv[++i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options opt{};
+	if (!ParseOptions(argc, argv, opt))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	SimParams env = DefaultEnvironment();
+	std::optional<double> currentDt;
+	if (!opt.EnvPath.empty())
+	{
+		currentDt = ApplyEnvironment(opt.EnvPath, env);
+	}
+
+	std::vector<SimParams> candidates;
+	if (!opt.PitchPath.empty())
+	{
+		std::vector<Config::PitchEntry> entries;
+		std::vector<Config::ParseError> errors;
+		const bool loaded = Config::LoadPitchConfigFileEx(opt.PitchPath, entries, &errors);
+
+		for (const auto& e : errors)
+		{
+			std::fprintf(stderr, "%s\n", Config::FormatParseError(opt.PitchPath, e).c_str());
+		}
+
+		if (!loaded)
+		{
+			std::fprintf(stderr, "failed to read %s\n", opt.PitchPath.c_str());
+			return 2;
+		}
+
+		for (const auto& pe : entries)
+		{
+			candidates.emplace_back(ResolveEntry(pe, env));
+		}
+	}
+	else
+	{
+		candidates = SyntheticPitches(env);
+	}
+
+	std::vector<SimParams> pitches;
+	std::vector<PlateHit> reference;
+	double referenceSpread = 0.0;
+
+	TrajectorySimulator sim;
+	std::vector<Float3> points;
+
+	for (const SimParams& base : candidates)
+	{
+		SimParams ref = base;
+		ref.Method = Integrator::RK45;
+		ref.Tolerance_m = REFERENCE_TOLERANCE_M;
+		ref.Dt_s = REFERENCE_OUTPUT_DT_S;
+		sim.Simulate(ref, points);
+		const auto hitA = PlateCrossing(points, ref.PlateDistance_m);
+
+		SimParams check = base;
+		check.Method = Integrator::RK4;
+		check.Dt_s = CHECK_RK4_DT_S;
+		sim.Simulate(check, points);
+		const auto hitB = PlateCrossing(points, check.PlateDistance_m);
+
+		if (!hitA.has_value() || !hitB.has_value())
+		{
+			std::fprintf(stderr, "skipping a pitch that does not reach the plate\n");
+			continue;
+		}
+
+		referenceSpread = std::max(referenceSpread, std::hypot(hitA->Y - hitB->Y, hitA->Z - hitB->Z));
+		pitches.emplace_back(base);
+		reference.emplace_back(hitA.value());
+	}
+
+	if (pitches.empty())
+	{
+		std::fprintf(stderr, "no pitch reaches the plate\n");
+		return 1;
+	}
+
+	std::printf("%zu pitches, reference RK45 tol=%g; RK4 dt=%g cross-check differs by at most %.2e m\n\n", pitches.size(), REFERENCE_TOLERANCE_M, CHECK_RK4_DT_S, referenceSpread);
+
+	std::vector<Measurement> ms;
+	for (const Setting& s : BuildSettings(currentDt))
+	{
+		ms.emplace_back(Measure(s, pitches, reference, opt.Reps));
+	}
+
+	MarkPareto(ms);
+	std::sort(ms.begin(), ms.end(), [](const Measurement& a, const Measurement& b) { return a.MsPerPitch < b.MsPerPitch; });
+
+	std::printf("  %-30s %10s %11s %11s %10s %10s %9s %10s\n", "setting", "ms/pitch", "max err m", "mean err m", "steps", "evals", "rejected", "peak KiB");
+	for (const auto& m : ms)
+	{
+		std::printf("%c %-30s %10.3f %11.3e %11.3e %10.0f %10.0f %9.0f %10.1f\n", m.Pareto ? '*' : ' ', Describe(m.Config).c_str(), m.MsPerPitch, m.MaxErr_m, m.MeanErr_m, m.MeanSteps, m.MeanEvals, m.MeanRejected, static_cast<double>(m.PeakBytes) / 1024.0);
+	}
+	std::printf("(* = Pareto-optimal in time and max plate error)\n\n");
+
+	const Measurement* current = nullptr;
+	for (const auto& m : ms)
+	{
+		if (m.Config.IsCurrent)
+		{
+			current = &m;
+		}
+	}
+
+	auto cheapest = [&](double target, bool rk4Only)
+	{
+		const Measurement* best = nullptr;
+		for (const auto& m : ms)
+		{
+			if (rk4Only && (m.Config.Method != Integrator::RK4 || m.Config.IsCurrent))
+			{
+				continue;
+			}
+
+			if (m.MaxErr_m <= target && (!best || m.MsPerPitch < best->MsPerPitch))
+			{
+				best = &m;
+			}
+		}
+		return best;
+	};
+
+	auto printChoice = [&](const char* label, const Measurement* m)
+	{
+		std::printf("  %-10s %-30s %8.3f ms/pitch, %8.0f steps, %8.1f KiB", label, Describe(m->Config).c_str(), m->MsPerPitch, m->MeanSteps, static_cast<double>(m->PeakBytes) / 1024.0);
+		if (current && current->MsPerPitch > 0.0 && m->MsPerPitch > 0.0)
+		{
+			std::printf(", %.0fx faster than current", current->MsPerPitch / m->MsPerPitch);
+		}
+		std::printf("\n");
+	};
+
+	std::printf("recommended settings (max plate error target)\n");
+	for (const double target : { 1e-2, 1e-3, 1e-4, 1e-5 })
+	{
+		char label[32];
+		std::snprintf(label, sizeof(label), "%.0e m", target);
+
+		const Measurement* best = cheapest(target, false);
+		if (!best)
+		{
+			std::printf("  %-10s no setting reaches this accuracy\n", label);
+			continue;
+		}
+
+		printChoice(label, best);
+
+		const Measurement* rk4 = cheapest(target, true);
+		if (rk4 && rk4 != best)
+		{
+			printChoice("  fixed", rk4);
+		}
+	}
+
+	if (!opt.CsvPath.empty())
+	{
+		std::ofstream ofs{ opt.CsvPath, std::ios::binary | std::ios::trunc };
+		ofs << "method,dt_s,tolerance_m,ms_per_pitch,max_err_m,mean_err_m,steps,force_evals,rejected,peak_bytes,pareto\n";
+
+		char buf[256];
+		for (const auto& m : ms)
+		{
+			std::snprintf(buf, sizeof(buf), "%s,%g,%g,%.6f,%.6e,%.6e,%.1f,%.1f,%.1f,%llu,%d\n", MethodName(m.Config.Method), m.Config.Dt_s, m.Config.Tolerance_m, m.MsPerPitch, m.MaxErr_m, m.MeanErr_m, m.MeanSteps, m.MeanEvals, m.MeanRejected, static_cast<unsigned long long>(m.PeakBytes), m.Pareto ? 1 : 0);
+			ofs << buf;
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "PitchConfig.hpp"
+#include "PitchLibrary.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options
+	{
+		std::string SourcePath;
+		std::string SnapshotPath;
+		std::string Label;
+		std::string Pitcher;
+		bool Compile{ false };
+		bool Check{ false };
+	};
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	bool ParseSource(const std::string& path, std::vector<Config::PitchEntry>& entries, std::uint64_t& hash)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			std::fprintf(stderr, "failed to open %s\n", path.c_str());
+			return false;
+		}
+
+		std::vector<Config::ParseError> errors;
+		const bool loaded = Config::ParsePitchConfig(file.View(), entries, true, &errors);
+
+		for (const auto& e : errors)
+		{
+			std::fprintf(stderr, "%s\n", Config::FormatParseError(path, e).c_str());
+		}
+
+		if (!loaded)
+		{
+			std::fprintf(stderr, "failed to read %s\n", path.c_str());
+			return false;
+		}
+
+		hash = PitchLibrary::HashSource(file.View());
+		return true;
+	}
+
+	bool SameEntry(const Config::PitchEntry& a, const Config::PitchEntry& b)
+	{
+		return a.Label == b.Label && a.Pitcher == b.Pitcher
+			&& a.IsRandomSpeed == b.IsRandomSpeed && a.Speed_kmh == b.Speed_kmh && a.SpeedMin == b.SpeedMin && a.SpeedMax == b.SpeedMax
+			&& a.IsRandomAxisX == b.IsRandomAxisX && a.IsRandomAxisY == b.IsRandomAxisY && a.IsRandomAxisZ == b.IsRandomAxisZ
+			&& a.Axis.X == b.Axis.X && a.Axis.Y == b.Axis.Y && a.Axis.Z == b.Axis.Z
+			&& a.XMin == b.XMin && a.XMax == b.XMax && a.YMin == b.YMin && a.YMax == b.YMax && a.ZMin == b.ZMin && a.ZMax == b.ZMax
+			&& a.IsRandomRpm == b.IsRandomRpm && a.Rpm == b.Rpm && a.RpmMin == b.RpmMin && a.RpmMax == b.RpmMax
+			&& a.IsRandomRelease == b.IsRandomRelease && a.Release_cm == b.Release_cm && a.ReleaseMin == b.ReleaseMin && a.ReleaseMax == b.ReleaseMax
+			&& a.IsRandomElevation == b.IsRandomElevation && a.Elevation_deg == b.Elevation_deg && a.ElevationMin == b.ElevationMin && a.ElevationMax == b.ElevationMax
+			&& a.IsRandomAzimuth == b.IsRandomAzimuth && a.Azimuth_deg == b.Azimuth_deg && a.AzimuthMin == b.AzimuthMin && a.AzimuthMax == b.AzimuthMax
+			&& std::equal(std::begin(a.Sampling), std::end(a.Sampling), std::begin(b.Sampling))
+			&& a.IsRandomAxisSphere == b.IsRandomAxisSphere && a.Correlations == b.Correlations;
+	}
+
+	void PrintEntries(const PitchLibrary& library, std::span<const std::uint32_t> hits)
+	{
+		for (const std::uint32_t i : hits)
+		{
+			const std::string_view label = library.Label(i);
+			const std::string_view pitcher = library.Pitcher(i);
+
+			std::printf("%6u  %.*s  [%.*s]  speed=%.1f rpm=%.0f%s\n", i,
+				static_cast<int>(label.size()), label.data(), static_cast<int>(pitcher.size()), pitcher.data(),
+				library.Value(PitchField::Speed, i), library.Value(PitchField::Rpm, i), library.Distribution(i) ? " RAND" : "");
+		}
+
+		std::printf("%zu match(es)\n", hits.size());
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: pitch_snapshot [options] <snapshot.pslib>\n"
+			"  --compile <path>   compile a pitch list into the snapshot\n"
+			"  --check <path>     verify the snapshot against a pitch list\n"
+			"  --label <name>     list pitches with this label\n"
+			"  --pitcher <name>   list pitches thrown by this pitcher\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string a = argv[i];
+			const bool hasValue = (i + 1 < argc);
+
+			if (a == "--compile" && hasValue)
+			{
+				opt.SourcePath = argv[++i];
+				opt.Compile = true;
+			}
+			else if (a == "--check" && hasValue)
+			{
+				opt.SourcePath = argv[++i];
+				opt.Check = true;
+			}
+			else if (a == "--label" && hasValue)
+			{
+				opt.Label = argv[++i];
+			}
+			else if (a == "--pitcher" && hasValue)
+			{
+				opt.Pitcher = argv[++i];
+			}
+			else if (!a.starts_with("--") && opt.SnapshotPath.empty())
+			{
+				opt.SnapshotPath = a;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return !opt.SnapshotPath.empty() && !(opt.Compile && opt.Check);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options opt{};
+	if (!ParseOptions(argc, argv, opt))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<Config::PitchEntry> source;
+	std::uint64_t sourceHash = 0;
+	double parseMs = 0.0;
+
+	if (opt.Compile || opt.Check)
+	{
+		const auto start = Clock::now();
+		if (!ParseSource(opt.SourcePath, source, sourceHash))
+		{
+			return 2;
+		}
+
+		parseMs = ElapsedMs(start);
+	}
+
+	if (opt.Compile)
+	{
+		std::string error;
+		if (!PitchLibrary::Compile(source, sourceHash, opt.SnapshotPath, &error))
+		{
+			std::fprintf(stderr, "%s: %s\n", opt.SnapshotPath.c_str(), error.c_str());
+			return 1;
+		}
+	}
+
+	const auto openStart = Clock::now();
+	PitchLibrary library;
+	std::string error;
+	if (!library.Open(opt.SnapshotPath, &error))
+	{
+		std::fprintf(stderr, "%s: %s\n", opt.SnapshotPath.c_str(), error.c_str());
+		return 1;
+	}
+
+	const double openMs = ElapsedMs(openStart);
+
+	std::printf("%s: %zu pitches, %zu strings, %zu distributions, source %016llx, open %.3f ms\n",
+		opt.SnapshotPath.c_str(), library.Size(), library.StringCount(), library.DistributionCount(),
+		static_cast<unsigned long long>(library.SourceHash()), openMs);
+
+	if (opt.Check)
+	{
+		const auto start = Clock::now();
+		std::vector<Config::PitchEntry> loaded;
+		library.MaterializeAll(loaded);
+		const double materializeMs = ElapsedMs(start);
+
+		std::size_t mismatches = (loaded.size() == source.size()) ? 0 : 1;
+		for (std::size_t i = 0; i < std::min(loaded.size(), source.size()); ++i)
+		{
+			if (!SameEntry(loaded[i], source[i]))
+			{
+				if (mismatches++ == 0)
+				{
+					std::fprintf(stderr, "first mismatch at pitch %zu (%s)\n", i, source[i].Label.c_str());
+				}
+			}
+		}
+
+		std::printf("check: %zu mismatch(es)%s; parse %.3f ms, open+materialize %.3f ms\n", mismatches,
+			library.SourceHash() == sourceHash ? "" : ", source has changed since compile", parseMs, openMs + materializeMs);
+
+		if (mismatches != 0 || library.SourceHash() != sourceHash)
+		{
+			return 1;
+		}
+	}
+
+	if (!opt.Label.empty())
+	{
+		PrintEntries(library, library.FindByLabel(opt.Label));
+	}
+
+	if (!opt.Pitcher.empty())
+	{
+		PrintEntries(library, library.FindByPitcher(opt.Pitcher));
+	}
+
+	return 0;
+}
\ No newline at end of file
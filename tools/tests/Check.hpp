@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdio>
+
+namespace PitchSimTest
+{
+	inline int g_Failures = 0;
+
+	inline void Fail(const char* file, int line, const char* expr)
+	{
+		std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expr);
+		++g_Failures;
+	}
+
+	inline int Finish(const char* name)
+	{
+		if (g_Failures != 0)
+		{
+			std::fprintf(stderr, "%s: %d check(s) failed\n", name, g_Failures);
+			return 1;
+		}
+
+		std::printf("%s: ok\n", name);
+		return 0;
+	}
+}
+
+#define PITCHSIM_CHECK(expr) ((expr) ? (void)0 : ::PitchSimTest::Fail(__FILE__, __LINE__, #expr))
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <cstdint>
+
+#include "Check.hpp"
+#include "FrameScheduler.hpp"
+
+using namespace PitchSim;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using Clock = FrameScheduler::Clock;
+
+	bool Idle(const FrameScheduler::Decision& d) noexcept
+	{
+		return !d.RenderNow && d.WaitForever;
+	}
+
+	void RendersOnlyOnEvents()
+	{
+		FrameScheduler fs{};
+		const Clock::time_point t0{};
+
+		PITCHSIM_CHECK(fs.Poll(t0).RenderNow);
+		fs.OnFrameRendered(t0);
+
+		PITCHSIM_CHECK(fs.PendingReasons() == 0);
+		PITCHSIM_CHECK(Idle(fs.Poll(t0 + 1s)));
+
+		fs.Invalidate(RedrawReason::Input);
+		PITCHSIM_CHECK(fs.Poll(t0 + 1ms).RenderNow);
+
+		fs.Invalidate(RedrawReason::Data);
+		PITCHSIM_CHECK(fs.PendingReasons() == (static_cast<std::uint32_t>(RedrawReason::Input) | static_cast<std::uint32_t>(RedrawReason::Data)));
+
+		fs.OnFrameRendered(t0 + 1ms);
+		PITCHSIM_CHECK(Idle(fs.Poll(t0 + 2ms)));
+		PITCHSIM_CHECK(fs.FramesRendered() == 2);
+	}
+
+	void UnfocusedFramesAreCapped()
+	{
+		FrameScheduler::Policy policy{};
+		policy.FocusedMaxFps = 0.0;
+		policy.UnfocusedMaxFps = 10.0;
+
+		FrameScheduler fs{ policy };
+		const Clock::time_point t0{};
+		fs.OnFrameRendered(t0);
+
+		fs.SetFocused(false);
+		PITCHSIM_CHECK(!fs.IsFocused());
+		PITCHSIM_CHECK((fs.PendingReasons() & static_cast<std::uint32_t>(RedrawReason::Focus)) != 0);
+
+		const FrameScheduler::Decision early = fs.Poll(t0 + 10ms);
+		PITCHSIM_CHECK(!early.RenderNow && !early.WaitForever);
+		PITCHSIM_CHECK(early.Wait > 89ms && early.Wait <= 90ms);
+
+		PITCHSIM_CHECK(fs.Poll(t0 + 100ms).RenderNow);
+		fs.OnFrameRendered(t0 + 100ms);
+
+		fs.Invalidate(RedrawReason::Input);
+		PITCHSIM_CHECK(!fs.Poll(t0 + 150ms).RenderNow);
+		PITCHSIM_CHECK(fs.Poll(t0 + 200ms).RenderNow);
+
+		fs.SetFocused(true);
+		PITCHSIM_CHECK(fs.Poll(t0 + 150ms).RenderNow);
+
+		const std::uint64_t before = fs.FramesRendered();
+		fs.SetFocused(true);
+		fs.OnFrameRendered(t0 + 151ms);
+		PITCHSIM_CHECK(Idle(fs.Poll(t0 + 152ms)));
+		PITCHSIM_CHECK(fs.FramesRendered() == before + 1);
+	}
+
+	void ContinuousPacesToFocusedCap()
+	{
+		FrameScheduler::Policy policy{};
+		policy.FocusedMaxFps = 50.0;
+		policy.UnfocusedMaxFps = 5.0;
+
+		FrameScheduler fs{ policy };
+		Clock::time_point t{};
+		fs.OnFrameRendered(t);
+		PITCHSIM_CHECK(Idle(fs.Poll(t)));
+
+		fs.SetContinuous(true);
+		PITCHSIM_CHECK(fs.PendingReasons() == static_cast<std::uint32_t>(RedrawReason::Animation));
+
+		int frames = 0;
+		for (int step = 0; step < 1000; ++step)
+		{
+			t += 1ms;
+			const FrameScheduler::Decision d = fs.Poll(t);
+			PITCHSIM_CHECK(!d.WaitForever);
+
+			if (d.RenderNow)
+			{
+				fs.OnFrameRendered(t);
+				++frames;
+			}
+		}
+
+		PITCHSIM_CHECK(frames == 50);
+
+		fs.SetFocused(false);
+		fs.OnFrameRendered(t);
+		frames = 0;
+		for (int step = 0; step < 1000; ++step)
+		{
+			t += 1ms;
+			if (fs.Poll(t).RenderNow)
+			{
+				fs.OnFrameRendered(t);
+				++frames;
+			}
+		}
+
+		PITCHSIM_CHECK(frames == 5);
+
+		fs.SetContinuous(false);
+		fs.OnFrameRendered(t);
+		PITCHSIM_CHECK(Idle(fs.Poll(t + 1s)));
+	}
+
+	void TimingPercentiles()
+	{
+		FrameTimings timings;
+		PITCHSIM_CHECK(timings.Query(FramePhase::Total).Max == 0.0);
+
+		for (int i = 1; i <= 100; ++i)
+		{
+			timings.Add(FramePhase::Draw, 0.5 * i);
+			timings.Add(FramePhase::Draw, 0.5 * i);
+			timings.Add(FramePhase::Total, 2.0);
+			timings.CommitFrame();
+		}
+
+		const FrameTimings::Percentiles draw = timings.Query(FramePhase::Draw);
+		PITCHSIM_CHECK(timings.SampleCount() == 100);
+		PITCHSIM_CHECK(draw.P50 >= 50.0 && draw.P50 <= 51.0);
+		PITCHSIM_CHECK(draw.P95 >= 95.0 && draw.P95 <= 96.0);
+		PITCHSIM_CHECK(draw.P99 == 99.0);
+		PITCHSIM_CHECK(draw.Max == 100.0);
+		PITCHSIM_CHECK(timings.Query(FramePhase::Total).P50 == 2.0);
+		PITCHSIM_CHECK(timings.Query(FramePhase::Text).Max == 0.0);
+
+		for (std::size_t i = 0; i < FrameTimings::WINDOW; ++i)
+		{
+			timings.Add(FramePhase::Draw, 1.0);
+			timings.CommitFrame();
+		}
+
+		PITCHSIM_CHECK(timings.SampleCount() == FrameTimings::WINDOW);
+		PITCHSIM_CHECK(timings.Query(FramePhase::Draw).Max == 1.0);
+	}
+}
+
+int main()
+{
+	RendersOnlyOnEvents();
+	UnfocusedFramesAreCapped();
+	ContinuousPacesToFocusedCap();
+	TimingPercentiles();
+
+	return PitchSimTest::Finish("FrameSchedulerTest");
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "LabelLayout.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	constexpr std::uint32_t VIEW_W = 1280;
+	constexpr std::uint32_t VIEW_H = 720;
+
+	std::vector<LabelRequest> ClusteredRequests(std::uint32_t count, std::uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> x(500.0f, 780.0f);
+		std::uniform_real_distribution<float> y(260.0f, 460.0f);
+		std::uniform_real_distribution<float> w(40.0f, 120.0f);
+
+		std::vector<LabelRequest> requests;
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			requests.emplace_back(LabelRequest{ i, x(rng), y(rng), w(rng), 18.0f });
+		}
+
+		return requests;
+	}
+
+	LabelLayoutKey KeyFor(std::uint64_t generation, const std::vector<LabelRequest>& requests)
+	{
+		LabelLayoutKey key{};
+		key.Generation = generation;
+		key.ViewWidth = VIEW_W;
+		key.ViewHeight = VIEW_H;
+		key.ViewProj[0] = 1.0f;
+		key.ViewProj[5] = 1.0f;
+		key.ViewProj[10] = 1.0f;
+		key.ViewProj[15] = 1.0f;
+
+		for (const LabelRequest& q : requests)
+		{
+			key.Ids.emplace_back(q.Id);
+		}
+
+		return key;
+	}
+
+	void PlacedLabelsDoNotOverlap()
+	{
+		for (std::uint32_t seed = 1; seed <= 8; ++seed)
+		{
+			const auto requests = ClusteredRequests(60, seed);
+
+			LabelPlacer placer;
+			std::vector<LabelPlacement> out;
+			placer.Place(KeyFor(0, requests), requests, out);
+
+			PITCHSIM_CHECK(!out.empty());
+			PITCHSIM_CHECK(out.size() < requests.size());
+
+			for (std::size_t a = 0; a < out.size(); ++a)
+			{
+				const LabelRequest& qa = requests[out[a].Id];
+				PITCHSIM_CHECK(out[a].X >= 0.0f && out[a].Y >= 0.0f);
+				PITCHSIM_CHECK(out[a].X + qa.Width <= static_cast<float>(VIEW_W) && out[a].Y + qa.Height <= static_cast<float>(VIEW_H));
+
+				for (std::size_t b = a + 1; b < out.size(); ++b)
+				{
+					const LabelRequest& qb = requests[out[b].Id];
+					const bool overlap = out[a].X < out[b].X + qb.Width && out[b].X < out[a].X + qa.Width && out[a].Y < out[b].Y + qb.Height && out[b].Y < out[a].Y + qa.Height;
+					PITCHSIM_CHECK(!overlap);
+				}
+			}
+		}
+	}
+
+	void LayoutIsRebuiltOnlyWhenKeyChanges()
+	{
+		const auto requests = ClusteredRequests(20, 42);
+
+		LabelPlacer placer;
+		std::vector<LabelPlacement> out;
+
+		LabelLayoutKey key = KeyFor(1, requests);
+		PITCHSIM_CHECK(!placer.IsLayoutCurrent(key));
+
+		placer.Place(key, requests, out);
+		PITCHSIM_CHECK(placer.IsLayoutCurrent(key));
+		PITCHSIM_CHECK(placer.IsLayoutCurrent(KeyFor(1, requests)));
+
+		key.Generation = 2;
+		PITCHSIM_CHECK(!placer.IsLayoutCurrent(key));
+
+		placer.Place(key, requests, out);
+		PITCHSIM_CHECK(placer.IsLayoutCurrent(key));
+
+		LabelLayoutKey moved = key;
+		moved.ViewProj[12] = 0.5f;
+		PITCHSIM_CHECK(!placer.IsLayoutCurrent(moved));
+
+		LabelLayoutKey resized = key;
+		resized.ViewWidth = VIEW_W / 2;
+		PITCHSIM_CHECK(!placer.IsLayoutCurrent(resized));
+
+		LabelLayoutKey fewer = key;
+		fewer.Ids.pop_back();
+		PITCHSIM_CHECK(!placer.IsLayoutCurrent(fewer));
+	}
+}
+
+int main()
+{
+	PlacedLabelsDoNotOverlap();
+	LayoutIsRebuiltOnlyWhenKeyChanges();
+
+	return PitchSimTest::Finish("LabelLayoutTest");
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "PitchConfig.hpp"
+
+using namespace PitchSim;
+using namespace PitchSim::Config;
+
+namespace
+{
+	constexpr std::string_view PITCHES =
+		"/comment\n"
+		"#Fork\n"
+		"Speed=140,Axis=(0.880,0,-0.2.00),RPM=1000,Release=155,Elevation=-0.5,Azimuth=0.6\n"
+		"\n"
+		"#Units\n"
+		"Speed=140km,Axis=(0,0,1),RPM=500rpm\n"
+		"\n"
+		"#Broken\n"
+		"Speed=fast,Axis=(0,0,1),RPM=500\n"
+		"\n"
+		"#Random\n"
+		"Speed=RAND[120:150],Axis=(RAND[-1:1],0.5,NORMAL(0.2,0.1)),RPM=RAND[1000:2000]\n"
+		"\n"
+		"#Clean\n"
+		"Speed=130.5,Axis=(1,0,0),RPM=+2400,Azimuth=-1e-1\n";
+
+	void PrefixNumbersWarn()
+	{
+		std::vector<PitchEntry> entries;
+		std::vector<ParseError> errors;
+
+		PITCHSIM_CHECK(ParsePitchConfig(PITCHES, entries, true, &errors));
+		PITCHSIM_CHECK(entries.size() == 4);
+		PITCHSIM_CHECK(errors.size() == 3);
+
+		if (entries.size() != 4 || errors.size() != 3)
+		{
+			return;
+		}
+
+		PITCHSIM_CHECK(entries[0].Label == "Fork");
+		PITCHSIM_CHECK(entries[0].Axis.Z == -0.2);
+		PITCHSIM_CHECK(entries[0].Release_cm == 155.0);
+
+		PITCHSIM_CHECK(entries[1].Label == "Units");
+		PITCHSIM_CHECK(entries[1].Speed_kmh == 140.0 && entries[1].Rpm == 500.0);
+
+		PITCHSIM_CHECK(entries[2].Label == "Random");
+		PITCHSIM_CHECK(entries[2].IsRandomSpeed && entries[2].IsRandomAxisX && entries[2].IsRandomAxisZ);
+
+		PITCHSIM_CHECK(entries[3].Label == "Clean");
+		PITCHSIM_CHECK(entries[3].Rpm == 2400.0 && entries[3].Azimuth_deg == -0.1);
+
+		PITCHSIM_CHECK(errors[0].Warning && errors[0].Line == 3 && errors[0].Column == 29);
+		PITCHSIM_CHECK(errors[0].Message == "ignored \".00\" after the number");
+		PITCHSIM_CHECK(errors[1].Warning && errors[1].Line == 6 && errors[1].Column == 10);
+		PITCHSIM_CHECK(!errors[2].Warning && errors[2].Line == 9);
+
+		PITCHSIM_CHECK(FormatParseError("p.txt", errors[0]) == "p.txt(3,29): warning: ignored \".00\" after the number");
+		PITCHSIM_CHECK(FormatParseError("p.txt", errors[2]).rfind("p.txt(9,", 0) == 0);
+		PITCHSIM_CHECK(FormatParseError("p.txt", errors[2]).find("warning") == std::string::npos);
+	}
+
+	void EnvWarningsDoNotFail()
+	{
+		EnvironmentSettings es{};
+		std::vector<ParseError> errors;
+
+		PITCHSIM_CHECK(ParseEnvConfig("DT=0.0002s\nTEMP=21.5\nMSAA=4x\n", es, &errors));
+		PITCHSIM_CHECK(es.Dt_s == 0.0002 && es.AirTemp_C == 21.5 && es.MsaaCount == 4);
+		PITCHSIM_CHECK(errors.size() == 2 && errors[0].Warning && errors[1].Warning);
+
+		errors.clear();
+		PITCHSIM_CHECK(!ParseEnvConfig("DT=abc\nTEMP=20\n", es, &errors));
+		PITCHSIM_CHECK(errors.size() == 1 && !errors[0].Warning && errors[0].Line == 1);
+		PITCHSIM_CHECK(es.AirTemp_C == 20.0);
+	}
+}
+
+int main()
+{
+	PrefixNumbersWarn();
+	EnvWarningsDoNotFail();
+
+	return PitchSimTest::Finish("PitchConfigTest");
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "Physics.hpp"
+#include "PolylineLod.hpp"
+#include "TrajectoryPipeline.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	float DistanceToSegment(const Float3& p, const Float3& a, const Float3& b) noexcept
+	{
+		const double abx = b.X - a.X;
+		const double aby = b.Y - a.Y;
+		const double abz = b.Z - a.Z;
+		const double apx = p.X - a.X;
+		const double apy = p.Y - a.Y;
+		const double apz = p.Z - a.Z;
+
+		const double len2 = abx * abx + aby * aby + abz * abz;
+		const double t = (len2 > 0.0) ? std::clamp((apx * abx + apy * aby + apz * abz) / len2, 0.0, 1.0) : 0.0;
+
+		const double dx = apx - abx * t;
+		const double dy = apy - aby * t;
+		const double dz = apz - abz * t;
+		return static_cast<float>(std::sqrt(dx * dx + dy * dy + dz * dz));
+	}
+
+	std::vector<Float3> SimulatedPitch(std::uint32_t k)
+	{
+		SimParams p{};
+		p.ReleaseHeight_cm = 160.0 + k;
+		p.InitialSpeed_mps = (115.0 + 4.0 * k) / 3.6;
+		p.Elevation_deg = -1.5 + 0.3 * k;
+		p.SpinRPM = 600.0 + 250.0 * k;
+		p.SpinAxis = DVec3{ std::cos(0.7 * k), 0.4, std::sin(0.7 * k) };
+		p.StopOnGroundHit = true;
+
+		TrajectoryPipeline pipeline;
+		PlateResult hit{};
+		PolylineLod lod;
+		pipeline.Build(p, nullptr, &lod, hit);
+
+		return std::vector<Float3>(pipeline.Points().begin(), pipeline.Points().end());
+	}
+
+	std::vector<Float3> NoisyPolyline(std::uint32_t seed)
+	{
+		std::mt19937 rng{ seed };
+		std::normal_distribution<float> noise{ 0.0f, 0.004f };
+
+		std::vector<Float3> points;
+		for (int i = 0; i < 3000; ++i)
+		{
+			const float t = 0.001f * static_cast<float>(i);
+			points.emplace_back(Float3{ 6.0f * t + noise(rng), 1.0f + std::sin(4.0f * t) + noise(rng), 0.5f * t * t + noise(rng) });
+		}
+
+		return points;
+	}
+
+	void LevelsAreNestedAndWithinTolerance(const std::vector<Float3>& points)
+	{
+		PolylineLod lod;
+		PolylineSimplifier::Build(points.data(), points.size(), lod);
+
+		PITCHSIM_CHECK(lod.SampleCount == points.size());
+		PITCHSIM_CHECK(lod.LevelCount() >= 2);
+
+		for (std::size_t level = 1; level < lod.LevelCount(); ++level)
+		{
+			const std::uint32_t* idx = lod.LevelIndices(level);
+			const std::size_t size = lod.LevelSize(level);
+
+			PITCHSIM_CHECK(lod.LevelError[level] > lod.LevelError[level - 1]);
+			PITCHSIM_CHECK(size >= 2 && size < lod.LevelSize(level - 1));
+			PITCHSIM_CHECK(idx[0] == 0 && idx[size - 1] == points.size() - 1);
+
+			float worst = 0.0f;
+			for (std::size_t s = 0; s + 1 < size; ++s)
+			{
+				PITCHSIM_CHECK(idx[s] < idx[s + 1]);
+
+				for (std::uint32_t k = idx[s] + 1; k < idx[s + 1]; ++k)
+				{
+					worst = std::max(worst, DistanceToSegment(points[k], points[idx[s]], points[idx[s + 1]]));
+				}
+			}
+
+			PITCHSIM_CHECK(worst <= lod.LevelError[level] * 1.0001f);
+
+			if (level > 1)
+			{
+				const std::uint32_t* finer = lod.LevelIndices(level - 1);
+				const std::uint32_t* finerEnd = finer + lod.LevelSize(level - 1);
+				bool nested = true;
+
+				for (std::size_t s = 0; s < size; ++s)
+				{
+					nested = nested && std::binary_search(finer, finerEnd, idx[s]);
+				}
+				PITCHSIM_CHECK(nested);
+			}
+		}
+	}
+
+	void SelectionIsMonotonic(const std::vector<Float3>& points)
+	{
+		PolylineLod lod;
+		PolylineSimplifier::Build(points.data(), points.size(), lod);
+
+		LodView view{};
+		view.PixelScale = PolylineSimplifier::PixelScaleFor(45.0f, 1080);
+		view.MaxPixelError = 1.0f;
+
+		std::size_t prev = 0;
+		for (float back = 0.0f; back < 100000.0f; back = back * 1.25f + 0.05f)
+		{
+			view.Eye = Float3{ -back, 1.0f, 0.0f };
+			const std::size_t level = PolylineSimplifier::SelectLevel(lod, view);
+
+			PITCHSIM_CHECK(level >= prev);
+			PITCHSIM_CHECK(PolylineSimplifier::ProjectedError(lod, level, view) <= view.MaxPixelError);
+
+			if (level + 1 < lod.LevelCount())
+			{
+				PITCHSIM_CHECK(PolylineSimplifier::ProjectedError(lod, level + 1, view) > view.MaxPixelError);
+			}
+
+			prev = level;
+		}
+
+		PITCHSIM_CHECK(prev == lod.LevelCount() - 1);
+
+		view.Eye = Float3{ -5.0f, 1.0f, 0.0f };
+		prev = 0;
+		for (float maxPx = 0.01f; maxPx < 1000.0f; maxPx *= 1.5f)
+		{
+			view.MaxPixelError = maxPx;
+			const std::size_t level = PolylineSimplifier::SelectLevel(lod, view);
+
+			PITCHSIM_CHECK(level >= prev);
+			prev = level;
+		}
+
+		for (std::size_t level = 2; level < lod.LevelCount(); ++level)
+		{
+			PITCHSIM_CHECK(PolylineSimplifier::ProjectedError(lod, level, view) > PolylineSimplifier::ProjectedError(lod, level - 1, view));
+		}
+	}
+
+	void RangeCoversVisiblePrefix(const std::vector<Float3>& points)
+	{
+		PolylineLod lod;
+		PolylineSimplifier::Build(points.data(), points.size(), lod);
+
+		LodView view{};
+		view.PixelScale = PolylineSimplifier::PixelScaleFor(45.0f, 1080);
+		view.Eye = Float3{ -50.0f, 1.0f, 0.0f };
+
+		for (std::size_t visible = 1; visible <= points.size(); visible += 97)
+		{
+			const LodRange r = PolylineSimplifier::SelectRange(lod, view, visible);
+
+			if (r.Level == 0)
+			{
+				PITCHSIM_CHECK(r.TailFirst == 0 && r.TailCount == visible);
+				continue;
+			}
+
+			const std::uint32_t* idx = lod.Indices.data() + r.IndexOffset;
+			const std::uint32_t head = static_cast<std::uint32_t>(visible - 1);
+
+			PITCHSIM_CHECK(r.IndexCount > 0 && idx[r.IndexCount - 1] <= head);
+			PITCHSIM_CHECK(r.TailCount == 0 ? idx[r.IndexCount - 1] == head : r.TailFirst + r.TailCount - 1 == head);
+		}
+	}
+}
+
+int main()
+{
+	for (std::uint32_t k = 0; k < 6; ++k)
+	{
+		const std::vector<Float3> pitch = SimulatedPitch(k);
+		LevelsAreNestedAndWithinTolerance(pitch);
+		SelectionIsMonotonic(pitch);
+		RangeCoversVisiblePrefix(pitch);
+	}
+
+	const std::vector<Float3> noisy = NoisyPolyline(30);
+	LevelsAreNestedAndWithinTolerance(noisy);
+	SelectionIsMonotonic(noisy);
+
+	return PitchSimTest::Finish("PolylineLodTest");
+}
\ No newline at end of file
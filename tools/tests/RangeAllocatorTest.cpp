@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "RangeAllocator.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	struct Block
+	{
+		std::size_t Offset;
+		std::size_t Count;
+	};
+
+	class Model
+	{
+	public:
+		explicit Model(std::size_t capacity) : m_Used(capacity, false) {}
+
+		void Grow(std::size_t capacity) { m_Used.resize(capacity, false); }
+
+		bool Mark(std::size_t offset, std::size_t count, bool used)
+		{
+			if (offset + count > m_Used.size())
+			{
+				return false;
+			}
+
+			bool ok = true;
+			for (std::size_t i = offset; i < offset + count; ++i)
+			{
+				ok = ok && (m_Used[i] != used);
+				m_Used[i] = used;
+			}
+
+			return ok;
+		}
+
+		void Verify(const RangeAllocator& a) const
+		{
+			std::size_t freeCount = 0;
+			std::size_t runs = 0;
+			std::size_t largest = 0;
+			std::size_t run = 0;
+
+			for (std::size_t i = 0; i <= m_Used.size(); ++i)
+			{
+				if (i < m_Used.size() && !m_Used[i])
+				{
+					++freeCount;
+					++run;
+					continue;
+				}
+
+				if (run > 0)
+				{
+					++runs;
+					largest = std::max(largest, run);
+					run = 0;
+				}
+			}
+
+			PITCHSIM_CHECK(a.Capacity() == m_Used.size());
+			PITCHSIM_CHECK(a.FreeCount() == freeCount);
+			PITCHSIM_CHECK(a.UsedCount() == m_Used.size() - freeCount);
+			PITCHSIM_CHECK(a.FreeRangeCount() == runs);
+			PITCHSIM_CHECK(a.LargestFreeRange() == largest);
+		}
+
+	private:
+		std::vector<bool> m_Used;
+	};
+
+	void RandomAllocFree(std::uint32_t seed)
+	{
+		std::mt19937 rng{ seed };
+		std::uniform_int_distribution<std::size_t> size{ 1, 300 };
+		std::uniform_int_distribution<int> action{ 0, 99 };
+
+		std::size_t capacity = 4096;
+		RangeAllocator alloc{ capacity };
+		Model model{ capacity };
+		std::vector<Block> live;
+
+		for (int step = 0; step < 20000; ++step)
+		{
+			const int a = action(rng);
+
+			if (a < 55)
+			{
+				const std::size_t count = size(rng);
+				const std::size_t offset = alloc.Allocate(count);
+
+				if (offset == RangeAllocator::INVALID_OFFSET)
+				{
+					PITCHSIM_CHECK(alloc.LargestFreeRange() < count);
+				}
+				else
+				{
+					PITCHSIM_CHECK(model.Mark(offset, count, true));
+					live.emplace_back(Block{ offset, count });
+				}
+			}
+			else if (a < 98)
+			{
+				if (live.empty())
+				{
+					continue;
+				}
+
+				const std::size_t k = std::uniform_int_distribution<std::size_t>{ 0, live.size() - 1 }(rng);
+				const Block b = live[k];
+				live[k] = live.back();
+				live.pop_back();
+
+				alloc.Free(b.Offset, b.Count);
+				PITCHSIM_CHECK(model.Mark(b.Offset, b.Count, false));
+			}
+			else
+			{
+				capacity += size(rng);
+				alloc.Grow(capacity);
+				model.Grow(capacity);
+			}
+
+			model.Verify(alloc);
+		}
+
+		for (const Block& b : live)
+		{
+			alloc.Free(b.Offset, b.Count);
+			model.Mark(b.Offset, b.Count, false);
+		}
+
+		model.Verify(alloc);
+		PITCHSIM_CHECK(alloc.FreeRangeCount() == 1);
+		PITCHSIM_CHECK(alloc.LargestFreeRange() == capacity);
+	}
+
+	void BestFitAndCoalesce()
+	{
+		RangeAllocator alloc{ 100 };
+
+		const std::size_t a = alloc.Allocate(10);
+		const std::size_t b = alloc.Allocate(20);
+		const std::size_t c = alloc.Allocate(10);
+		const std::size_t d = alloc.Allocate(5);
+
+		PITCHSIM_CHECK(a == 0 && b == 10 && c == 30 && d == 40);
+
+		alloc.Free(b, 20);
+		alloc.Free(d, 5);
+		PITCHSIM_CHECK(alloc.FreeRangeCount() == 2);
+
+		PITCHSIM_CHECK(alloc.Allocate(15) == b);
+		PITCHSIM_CHECK(alloc.Allocate(5) == b + 15);
+		PITCHSIM_CHECK(alloc.FreeRangeCount() == 1);
+
+		alloc.Free(a, 10);
+		alloc.Free(c, 10);
+		alloc.Free(b, 15);
+		alloc.Free(b + 15, 5);
+		PITCHSIM_CHECK(alloc.FreeRangeCount() == 1);
+		PITCHSIM_CHECK(alloc.LargestFreeRange() == 100);
+
+		PITCHSIM_CHECK(alloc.Allocate(0) == RangeAllocator::INVALID_OFFSET);
+		PITCHSIM_CHECK(alloc.Allocate(101) == RangeAllocator::INVALID_OFFSET);
+
+		alloc.Grow(150);
+		PITCHSIM_CHECK(alloc.FreeRangeCount() == 1);
+		PITCHSIM_CHECK(alloc.Allocate(150) == 0);
+		PITCHSIM_CHECK(alloc.FreeCount() == 0 && alloc.FreeRangeCount() == 0);
+	}
+}
+
+int main()
+{
+	BestFitAndCoalesce();
+
+	for (std::uint32_t seed = 1; seed <= 4; ++seed)
+	{
+		RandomAllocFree(seed);
+	}
+
+	return PitchSimTest::Finish("RangeAllocatorTest");
+}
\ No newline at end of file
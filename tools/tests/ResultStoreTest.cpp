@@ -0,0 +1,256 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "ResultStore.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	SimParams Pitch(std::uint32_t k)
+	{
+		SimParams p{};
+		p.InitialSpeed_mps = 30.0 + 0.125 * static_cast<double>(k);
+		p.SpinRPM = 1500.0 + static_cast<double>(k);
+		return p;
+	}
+
+	PlateResult Result(std::uint32_t k)
+	{
+		PlateResult r{};
+		r.Crossed = true;
+		r.Y_m = 0.5 + 0.001 * static_cast<double>(k);
+		r.Z_m = -0.001 * static_cast<double>(k);
+		r.Time_s = 0.4;
+		r.Termination = SimTermination::Plate;
+		r.Steps = 800 + k;
+		return r;
+	}
+
+	QuantizedTrajectory Trajectory(std::uint32_t k)
+	{
+		QuantizedTrajectory t;
+		t.Box = QuantizationBox{ Float3{ 0.0f, 0.0f, -1.0f }, Float3{ 18.44f, 2.5f, 2.0f } };
+		t.Samples.resize(16 + k % 7);
+
+		for (std::size_t i = 0; i < t.Samples.size(); ++i)
+		{
+			t.Samples[i] = QuantizedSample{ static_cast<std::uint16_t>(k), static_cast<std::uint16_t>(i), 7 };
+		}
+
+		return t;
+	}
+
+	bool Holds(const ResultStore& store, std::uint32_t k)
+	{
+		PlateResult r{};
+		StoredTrajectory t;
+		if (!store.Find(Pitch(k), r, &t))
+		{
+			return false;
+		}
+
+		const QuantizedTrajectory expected = Trajectory(k);
+		bool same = r.Y_m == Result(k).Y_m && r.Steps == Result(k).Steps && t.Samples.size() == expected.Samples.size();
+
+		for (std::size_t i = 0; same && i < t.Samples.size(); ++i)
+		{
+			same = t.Samples[i].X == expected.Samples[i].X && t.Samples[i].Y == expected.Samples[i].Y;
+		}
+
+		return same;
+	}
+
+	bool Put(ResultStore& store, std::uint32_t k)
+	{
+		const QuantizedTrajectory t = Trajectory(k);
+		return store.Put(Pitch(k), Result(k), &t);
+	}
+
+	fs::path FreshDirectory(const char* name)
+	{
+		const fs::path dir = fs::temp_directory_path() / name;
+		std::error_code ec;
+		fs::remove_all(dir, ec);
+		return dir;
+	}
+
+	void ReopenFindsRecordsThroughIndex()
+	{
+		const fs::path dir = FreshDirectory("pitchsim_store_reopen");
+
+		{
+			ResultStore store;
+			PITCHSIM_CHECK(store.Open(dir.string(), true));
+			for (std::uint32_t k = 0; k < 20; ++k)
+			{
+				PITCHSIM_CHECK(Put(store, k));
+			}
+
+			PITCHSIM_CHECK(Put(store, 3));
+			PITCHSIM_CHECK(store.Size() == 20);
+		}
+
+		ResultStore store;
+		PITCHSIM_CHECK(store.Open(dir.string(), false));
+		PITCHSIM_CHECK(store.Size() == 20);
+		PITCHSIM_CHECK(store.TailRecords() == 0);
+
+		for (std::uint32_t k = 0; k < 20; ++k)
+		{
+			PITCHSIM_CHECK(Holds(store, k));
+		}
+
+		PITCHSIM_CHECK(!store.Contains(Pitch(20)));
+	}
+
+	void TornTailIsScannedAndRepaired()
+	{
+		const fs::path dir = FreshDirectory("pitchsim_store_live");
+		const fs::path crashed = FreshDirectory("pitchsim_store_crashed");
+		const fs::path log = crashed / "results.log";
+
+		{
+			ResultStore store;
+			PITCHSIM_CHECK(store.Open(dir.string(), true));
+			PITCHSIM_CHECK(Put(store, 0));
+		}
+
+		{
+			ResultStore writer;
+			PITCHSIM_CHECK(writer.Open(dir.string(), true));
+			PITCHSIM_CHECK(Put(writer, 1));
+			PITCHSIM_CHECK(Put(writer, 2));
+			PITCHSIM_CHECK(writer.TailRecords() == 2);
+
+			fs::create_directories(crashed);
+			fs::copy_file(dir / "results.log", crashed / "results.log");
+			fs::copy_file(dir / "results.idx", crashed / "results.idx");
+		}
+
+		const std::uintmax_t validSize = fs::file_size(log);
+		{
+			std::ifstream ifs{ log, std::ios::binary };
+			std::string head(100, '\0');
+			ifs.seekg(16);
+			ifs.read(head.data(), static_cast<std::streamsize>(head.size()));
+
+			std::ofstream ofs{ log, std::ios::binary | std::ios::app };
+			ofs.write(head.data(), static_cast<std::streamsize>(head.size()));
+		}
+
+		{
+			ResultStore reader;
+			PITCHSIM_CHECK(reader.Open(crashed.string(), false));
+			PITCHSIM_CHECK(reader.Size() == 3);
+			PITCHSIM_CHECK(reader.TailRecords() == 2);
+			PITCHSIM_CHECK(Holds(reader, 0) && Holds(reader, 1) && Holds(reader, 2));
+		}
+
+		PITCHSIM_CHECK(fs::file_size(log) == validSize + 100);
+
+		{
+			ResultStore writer;
+			PITCHSIM_CHECK(writer.Open(crashed.string(), true));
+			PITCHSIM_CHECK(fs::file_size(log) == validSize);
+			PITCHSIM_CHECK(Put(writer, 3));
+		}
+
+		ResultStore store;
+		PITCHSIM_CHECK(store.Open(crashed.string(), false));
+		PITCHSIM_CHECK(store.Size() == 4);
+		PITCHSIM_CHECK(store.TailRecords() == 0);
+		PITCHSIM_CHECK(Holds(store, 0) && Holds(store, 1) && Holds(store, 2) && Holds(store, 3));
+	}
+
+	void MissingIndexIsRebuilt()
+	{
+		const fs::path dir = FreshDirectory("pitchsim_store_rebuild");
+
+		{
+			ResultStore store;
+			PITCHSIM_CHECK(store.Open(dir.string(), true));
+			for (std::uint32_t k = 0; k < 12; ++k)
+			{
+				PITCHSIM_CHECK(Put(store, k));
+			}
+		}
+
+		std::error_code ec;
+		PITCHSIM_CHECK(fs::remove(dir / "results.idx", ec));
+
+		{
+			ResultStore store;
+			PITCHSIM_CHECK(store.Open(dir.string(), true));
+			PITCHSIM_CHECK(store.TailRecords() == 12);
+			PITCHSIM_CHECK(store.WriteIndex());
+			PITCHSIM_CHECK(store.TailRecords() == 0);
+		}
+
+		{
+			std::ofstream ofs{ dir / "results.idx", std::ios::binary | std::ios::trunc };
+			ofs.write("garbage", 7);
+		}
+
+		ResultStore store;
+		PITCHSIM_CHECK(store.Open(dir.string(), false));
+		PITCHSIM_CHECK(store.Size() == 12);
+
+		for (std::uint32_t k = 0; k < 12; ++k)
+		{
+			PITCHSIM_CHECK(Holds(store, k));
+		}
+	}
+
+	void ConcurrentWritersKeepEveryRecord()
+	{
+		const fs::path dir = FreshDirectory("pitchsim_store_writers");
+		constexpr std::uint32_t PER_WRITER = 150;
+
+		{
+			ResultStore a;
+			ResultStore b;
+			PITCHSIM_CHECK(a.Open(dir.string(), true));
+			PITCHSIM_CHECK(b.Open(dir.string(), true));
+
+			PITCHSIM_CHECK(Put(a, 0));
+			PITCHSIM_CHECK(Put(b, 1));
+			PITCHSIM_CHECK(Put(a, 2));
+			PITCHSIM_CHECK(Holds(a, 1));
+
+			std::thread ta{ [&] { for (std::uint32_t k = 0; k < PER_WRITER; ++k) { Put(a, 100 + 2 * k); } } };
+			std::thread tb{ [&] { for (std::uint32_t k = 0; k < PER_WRITER; ++k) { Put(b, 101 + 2 * k); } } };
+			ta.join();
+			tb.join();
+
+			PITCHSIM_CHECK(a.WriteIndex());
+		}
+
+		ResultStore store;
+		PITCHSIM_CHECK(store.Open(dir.string(), false));
+		PITCHSIM_CHECK(store.Size() == 3 + 2 * PER_WRITER);
+		PITCHSIM_CHECK(Holds(store, 0) && Holds(store, 1) && Holds(store, 2));
+
+		for (std::uint32_t k = 100; k < 100 + 2 * PER_WRITER; ++k)
+		{
+			PITCHSIM_CHECK(Holds(store, k));
+		}
+	}
+}
+
+int main()
+{
+	ReopenFindsRecordsThroughIndex();
+	TornTailIsScannedAndRepaired();
+	MissingIndexIsRebuilt();
+	ConcurrentWritersKeepEveryRecord();
+
+	return PitchSimTest::Finish("ResultStoreTest");
+}
\ No newline at end of file
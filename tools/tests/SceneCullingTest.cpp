@@ -0,0 +1,298 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "PolylineLod.hpp"
+#include "SceneCulling.hpp"
+#include "TrajectoryCodec.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	using Matrix = float[16];
+
+	void Multiply(const float* a, const float* b, float* out) noexcept
+	{
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				out[r * 4 + c] = a[r * 4 + 0] * b[0 * 4 + c] + a[r * 4 + 1] * b[1 * 4 + c] + a[r * 4 + 2] * b[2 * 4 + c] + a[r * 4 + 3] * b[3 * 4 + c];
+			}
+		}
+	}
+
+	void PerspectiveFovLH(float yScale, float aspect, float nearZ, float farZ, float* out) noexcept
+	{
+		const float range = farZ / (farZ - nearZ);
+		const float m[16] =
+		{
+			yScale / aspect, 0.0f, 0.0f, 0.0f,
+			0.0f, yScale, 0.0f, 0.0f,
+			0.0f, 0.0f, range, 1.0f,
+			0.0f, 0.0f, -range * nearZ, 0.0f,
+		};
+
+		for (int k = 0; k < 16; ++k)
+		{
+			out[k] = m[k];
+		}
+	}
+
+	void Translation(float x, float y, float z, float* out) noexcept
+	{
+		const float m[16] =
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			x, y, z, 1.0f,
+		};
+
+		for (int k = 0; k < 16; ++k)
+		{
+			out[k] = m[k];
+		}
+	}
+
+	bool InsideClip(const float* viewProj, const Float3& p) noexcept
+	{
+		float clip[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			clip[c] = p.X * viewProj[c] + p.Y * viewProj[4 + c] + p.Z * viewProj[8 + c] + viewProj[12 + c];
+		}
+
+		const float w = clip[3];
+		return -w <= clip[0] && clip[0] <= w && -w <= clip[1] && clip[1] <= w && 0.0f <= clip[2] && clip[2] <= w;
+	}
+
+	bool AllCornersOutsideOnePlane(const Frustum& f, const Aabb& box) noexcept
+	{
+		for (const auto& p : f.Planes)
+		{
+			bool allOut = true;
+
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				const float x = (corner & 1) ? box.Max.X : box.Min.X;
+				const float y = (corner & 2) ? box.Max.Y : box.Min.Y;
+				const float z = (corner & 4) ? box.Max.Z : box.Min.Z;
+				allOut = allOut && (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f);
+			}
+
+			if (allOut)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	Aabb Box(float x0, float y0, float z0, float x1, float y1, float z1) noexcept
+	{
+		return Aabb{ Float3{ x0, y0, z0 }, Float3{ x1, y1, z1 } };
+	}
+
+	void FrustumPlanes()
+	{
+		Matrix proj;
+		PerspectiveFovLH(1.0f, 1.0f, 0.5f, 100.0f, proj);
+		const Frustum f = Frustum::FromViewProj(proj);
+
+		PITCHSIM_CHECK(f.Intersects(Box(-1.0f, -1.0f, 9.0f, 1.0f, 1.0f, 11.0f)));
+		PITCHSIM_CHECK(!f.Intersects(Box(-1.0f, -1.0f, -11.0f, 1.0f, 1.0f, -9.0f)));
+		PITCHSIM_CHECK(!f.Intersects(Box(-1.0f, -1.0f, 101.0f, 1.0f, 1.0f, 120.0f)));
+		PITCHSIM_CHECK(!f.Intersects(Box(-1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.4f)));
+		PITCHSIM_CHECK(!f.Intersects(Box(12.0f, -1.0f, 9.0f, 14.0f, 1.0f, 11.0f)));
+		PITCHSIM_CHECK(!f.Intersects(Box(-1.0f, -14.0f, 9.0f, 1.0f, -12.0f, 11.0f)));
+		PITCHSIM_CHECK(f.Intersects(Box(9.0f, -1.0f, 9.0f, 14.0f, 1.0f, 11.0f)));
+		PITCHSIM_CHECK(f.Intersects(Box(-1.0f, -1.0f, 99.0f, 1.0f, 1.0f, 120.0f)));
+		PITCHSIM_CHECK(f.Intersects(Box(-500.0f, -500.0f, -500.0f, 500.0f, 500.0f, 500.0f)));
+
+		Matrix view;
+		Matrix viewProj;
+		Translation(0.0f, 0.0f, 20.0f, view);
+		Multiply(view, proj, viewProj);
+		const Frustum moved = Frustum::FromViewProj(viewProj);
+
+		PITCHSIM_CHECK(!moved.Intersects(Box(-1.0f, -1.0f, 90.0f, 1.0f, 1.0f, 95.0f)));
+		PITCHSIM_CHECK(moved.Intersects(Box(-1.0f, -1.0f, -15.0f, 1.0f, 1.0f, -10.0f)));
+	}
+
+	void FrustumAgreesWithClipSpace()
+	{
+		Matrix proj;
+		Matrix view;
+		Matrix viewProj;
+		PerspectiveFovLH(1.3f, 16.0f / 9.0f, 0.1f, 60.0f, proj);
+		Translation(-2.0f, -1.5f, 5.0f, view);
+		Multiply(view, proj, viewProj);
+		const Frustum f = Frustum::FromViewProj(viewProj);
+
+		std::mt19937 rng{ 33 };
+		std::uniform_real_distribution<float> center{ -80.0f, 80.0f };
+		std::uniform_real_distribution<float> half{ 0.01f, 10.0f };
+
+		int culled = 0;
+		for (int k = 0; k < 20000; ++k)
+		{
+			const Float3 c{ center(rng), center(rng), center(rng) };
+			const Float3 h{ half(rng), half(rng), half(rng) };
+			const Aabb box{ Float3{ c.X - h.X, c.Y - h.Y, c.Z - h.Z }, Float3{ c.X + h.X, c.Y + h.Y, c.Z + h.Z } };
+
+			const bool visible = f.Intersects(box);
+			culled += visible ? 0 : 1;
+
+			if (InsideClip(viewProj, c))
+			{
+				PITCHSIM_CHECK(visible);
+			}
+
+			PITCHSIM_CHECK(visible != AllCornersOutsideOnePlane(f, box));
+		}
+
+		PITCHSIM_CHECK(culled > 0);
+	}
+
+	void VisibilitySetMatchesModel()
+	{
+		std::mt19937 rng{ 64 };
+
+		for (std::size_t size : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 63 }, std::size_t{ 64 }, std::size_t{ 65 }, std::size_t{ 200 } })
+		{
+			VisibilitySet set;
+			set.Resize(size, true);
+			std::vector<bool> model(size, true);
+
+			PITCHSIM_CHECK(set.Count() == size);
+			PITCHSIM_CHECK(set.Any() == (size > 0));
+
+			std::uniform_int_distribution<std::size_t> index{ 0, size + 3 };
+			for (int step = 0; step < 2000; ++step)
+			{
+				const std::size_t i = index(rng);
+
+				switch (step % 3)
+				{
+				case 0:
+					set.Set(i, (step & 4) != 0);
+					if (i < size)
+					{
+						model[i] = (step & 4) != 0;
+					}
+					break;
+				case 1:
+					set.Toggle(i);
+					if (i < size)
+					{
+						model[i] = !model[i];
+					}
+					break;
+				default:
+					PITCHSIM_CHECK(set.Test(i) == (i < size && model[i]));
+					break;
+				}
+			}
+
+			std::vector<std::size_t> visited;
+			set.ForEach([&](std::size_t i) { visited.emplace_back(i); });
+
+			std::vector<std::size_t> expected;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				if (model[i])
+				{
+					expected.emplace_back(i);
+				}
+			}
+
+			PITCHSIM_CHECK(visited == expected);
+			PITCHSIM_CHECK(set.Count() == expected.size());
+
+			set.SetAll();
+			PITCHSIM_CHECK(set.Count() == size);
+
+			set.ClearAll();
+			PITCHSIM_CHECK(!set.Any());
+		}
+	}
+
+	void CullHonoursFilter()
+	{
+		Matrix proj;
+		PerspectiveFovLH(1.0f, 1.0f, 0.5f, 100.0f, proj);
+		const Frustum f = Frustum::FromViewProj(proj);
+
+		std::vector<Aabb> bounds;
+		for (int i = 0; i < 130; ++i)
+		{
+			const float z = (i % 3 == 0) ? -10.0f : 10.0f;
+			bounds.emplace_back(Box(-1.0f, -1.0f, z - 1.0f, 1.0f, 1.0f, z + 1.0f));
+		}
+
+		std::vector<std::uint32_t> out;
+		SceneCulling::Cull(bounds, nullptr, f, out);
+		PITCHSIM_CHECK(out.size() == 86);
+
+		VisibilitySet filter;
+		filter.Resize(bounds.size() + 10);
+		filter.Set(0, true);
+		filter.Set(1, true);
+		filter.Set(65, true);
+		filter.Set(128, true);
+		filter.Set(135, true);
+
+		SceneCulling::Cull(bounds, &filter, f, out);
+		PITCHSIM_CHECK((out == std::vector<std::uint32_t>{ 1, 65, 128 }));
+	}
+
+	void DrawListUsesLodWhenInSync()
+	{
+		std::vector<Float3> points;
+		for (int i = 0; i < 500; ++i)
+		{
+			const float t = 0.002f * static_cast<float>(i);
+			points.emplace_back(Float3{ 18.0f * t, 1.8f - t * t, 0.2f * t });
+		}
+
+		std::vector<QuantizedTrajectory> trajectories(3);
+		std::vector<PolylineLod> lods(3);
+
+		for (std::size_t k = 0; k < 3; ++k)
+		{
+			trajectories[k].Box = TrajectoryCodec::ComputeBox(points.data(), points.size());
+			trajectories[k].Samples.resize(points.size());
+			TrajectoryCodec::Encode(points.data(), points.size(), trajectories[k].Box, trajectories[k].Samples.data());
+		}
+
+		PolylineSimplifier::Build(points.data(), points.size(), lods[0]);
+		PolylineSimplifier::Build(points.data(), 100, lods[1]);
+
+		LodView view{};
+		view.PixelScale = PolylineSimplifier::PixelScaleFor(45.0f, 1080);
+		view.Eye = Float3{ -200.0f, 2.0f, 0.0f };
+
+		const std::vector<std::size_t> visible{ 500, 500, 0 };
+		std::vector<TrajectoryDraw> draws;
+		SceneCulling::BuildDrawList({ 0, 1, 2, 7 }, trajectories, lods, visible, view, draws);
+
+		PITCHSIM_CHECK(draws.size() == 2);
+		PITCHSIM_CHECK(draws[0].Index == 0 && draws[0].Range.Level > 0);
+		PITCHSIM_CHECK(draws[1].Index == 1 && draws[1].Range.Level == 0 && draws[1].Range.TailCount == 500);
+	}
+}
+
+int main()
+{
+	FrustumPlanes();
+	FrustumAgreesWithClipSpace();
+	VisibilitySetMatchesModel();
+	CullHonoursFilter();
+	DrawListUsesLodWhenInSync();
+
+	return PitchSimTest::Finish("SceneCullingTest");
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <memory_resource>
+#include <vector>
+
+#include "Check.hpp"
+#include "Physics.hpp"
+#include "SplineTessellator.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	std::pmr::vector<Float3> Line(std::size_t n)
+	{
+		std::pmr::vector<Float3> pts;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const float x = static_cast<float>(i) * 0.5f;
+			pts.emplace_back(Float3{ x, 1.0f + 0.25f * x, -0.1f * x });
+		}
+
+		return pts;
+	}
+
+	std::pmr::vector<Float3> Arc(std::size_t n, float radius)
+	{
+		std::pmr::vector<Float3> pts;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const float a = 1.5707963f * static_cast<float>(i) / static_cast<float>(n - 1);
+			pts.emplace_back(Float3{ radius * std::cos(a), radius * std::sin(a), 0.0f });
+		}
+
+		return pts;
+	}
+
+	void StraightRunKeepsInputResolution()
+	{
+		const auto pts = Line(32);
+
+		TessellationParams tp{};
+		std::pmr::vector<Float3> out;
+		SplineTessellator::Tessellate(pts, tp, out);
+
+		PITCHSIM_CHECK(out.size() == pts.size());
+		for (std::size_t i = 0; i < pts.size() && i < out.size(); ++i)
+		{
+			PITCHSIM_CHECK(out[i].X == pts[i].X && out[i].Y == pts[i].Y && out[i].Z == pts[i].Z);
+		}
+	}
+
+	void CurvedRunIsSubdivided()
+	{
+		const float radius = 2.0f;
+		const auto pts = Arc(9, radius);
+
+		TessellationParams tp{};
+		std::pmr::vector<Float3> out;
+		SplineTessellator::Tessellate(pts, tp, out);
+
+		PITCHSIM_CHECK(out.size() > pts.size());
+		PITCHSIM_CHECK(out.size() <= (pts.size() - 1) * static_cast<std::size_t>(tp.MaxSubdivide) + 1);
+		for (const Float3& p : out)
+		{
+			PITCHSIM_CHECK(std::abs(std::hypot(p.X, p.Y) - radius) < 0.01f);
+		}
+	}
+
+	void DistantEyeSubdividesLess()
+	{
+		const auto pts = Arc(9, 2.0f);
+
+		TessellationParams tp{};
+		tp.Tolerance_m = 0.0f;
+		tp.MaxTurn_rad = 3.2f;
+		tp.PixelScale = 1000.0f;
+
+		std::pmr::vector<Float3> nearOut;
+		tp.Eye = Float3{ 0.0f, 0.0f, 3.0f };
+		SplineTessellator::Tessellate(pts, tp, nearOut);
+
+		std::pmr::vector<Float3> farOut;
+		tp.Eye = Float3{ 0.0f, 0.0f, 300.0f };
+		SplineTessellator::Tessellate(pts, tp, farOut);
+
+		PITCHSIM_CHECK(nearOut.size() > pts.size());
+		PITCHSIM_CHECK(farOut.size() < nearOut.size());
+	}
+}
+
+int main()
+{
+	StraightRunKeepsInputResolution();
+	CurvedRunIsSubdivided();
+	DistantEyeSubdividesLess();
+
+	return PitchSimTest::Finish("SplineTessellatorTest");
+}
\ No newline at end of file
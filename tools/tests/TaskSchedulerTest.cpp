@@ -0,0 +1,144 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "TaskScheduler.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	void ParallelForCoversRange(TaskScheduler& scheduler)
+	{
+		std::vector<int> hits(10000, 0);
+
+		scheduler.ParallelFor(0, hits.size(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				++hits[i];
+			}
+		}, 16);
+
+		bool once = true;
+		for (int h : hits)
+		{
+			once = once && (h == 1);
+		}
+		PITCHSIM_CHECK(once);
+	}
+
+	void ParallelForRethrows(TaskScheduler& scheduler, std::size_t throwAt)
+	{
+		std::atomic<std::size_t> visited{ 0 };
+		bool caught = false;
+
+		try
+		{
+			scheduler.ParallelFor(0, 4096, [&](std::size_t begin, std::size_t end)
+			{
+				visited.fetch_add(end - begin);
+				if (begin <= throwAt && throwAt < end)
+				{
+					throw std::runtime_error{ "body" };
+				}
+			});
+		}
+		catch (const std::runtime_error&)
+		{
+			caught = true;
+		}
+
+		PITCHSIM_CHECK(caught);
+		PITCHSIM_CHECK(visited.load() <= 4096);
+	}
+
+	void TaskGroupRethrows(TaskScheduler& scheduler)
+	{
+		std::atomic<int> ran{ 0 };
+		std::atomic<bool> continued{ false };
+		bool caught = false;
+
+		{
+			TaskGroup group{ scheduler };
+
+			for (int i = 0; i < 64; ++i)
+			{
+				group.Run([&ran, i]()
+				{
+					ran.fetch_add(1);
+					if (i % 16 == 3)
+					{
+						throw std::runtime_error{ "task" };
+					}
+				});
+			}
+
+			group.Then([&continued]() { continued.store(true); });
+
+			try
+			{
+				group.Wait();
+			}
+			catch (const std::runtime_error&)
+			{
+				caught = true;
+			}
+
+			PITCHSIM_CHECK(group.IsDone());
+			group.Wait();
+		}
+
+		PITCHSIM_CHECK(caught);
+		PITCHSIM_CHECK(ran.load() == 64);
+
+		for (int spin = 0; spin < 100000 && !continued.load(); ++spin)
+		{
+			std::this_thread::yield();
+		}
+		PITCHSIM_CHECK(continued.load());
+	}
+
+	void NestedWaitOnWorker(TaskScheduler& scheduler)
+	{
+		std::atomic<bool> caught{ false };
+		TaskGroup outer{ scheduler };
+
+		outer.Run([&]()
+		{
+			TaskGroup inner{ scheduler };
+			inner.Run([]() { throw std::runtime_error{ "inner" }; });
+
+			try
+			{
+				inner.Wait();
+			}
+			catch (const std::runtime_error&)
+			{
+				caught.store(true);
+			}
+		});
+
+		outer.Wait();
+		PITCHSIM_CHECK(caught.load());
+	}
+}
+
+int main()
+{
+	for (unsigned workers : { 1u, 4u })
+	{
+		TaskScheduler scheduler{ workers };
+
+		ParallelForCoversRange(scheduler);
+		ParallelForRethrows(scheduler, 0);
+		ParallelForRethrows(scheduler, 4095);
+		TaskGroupRethrows(scheduler);
+		NestedWaitOnWorker(scheduler);
+	}
+
+	return PitchSimTest::Finish("TaskSchedulerTest");
+}
\ No newline at end of file
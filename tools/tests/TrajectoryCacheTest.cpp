@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <vector>
+
+#include "Check.hpp"
+#include "TrajectoryCache.hpp"
+#include "TrajectoryCodec.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	constexpr double PLATE_M = 18.44;
+	constexpr std::size_t SAMPLE_COUNT = 1000;
+
+	SimParams Pitch(std::uint32_t k)
+	{
+		SimParams p{};
+		p.InitialSpeed_mps = 35.0 + static_cast<double>(k);
+		p.SpinRPM = 1800.0 + 100.0 * static_cast<double>(k);
+		return p;
+	}
+
+	QuantizedTrajectory Trajectory(std::uint32_t k)
+	{
+		QuantizedTrajectory t;
+		t.Box = QuantizationBox{ Float3{ 0.0f, 0.0f, 0.0f }, Float3{ 18.44f, 2.0f, 1.0f } };
+		t.Samples.resize(SAMPLE_COUNT);
+		t.Samples.front().X = static_cast<std::uint16_t>(k);
+		return t;
+	}
+
+	PolylineLod Lod()
+	{
+		PolylineLod lod;
+		lod.SampleCount = SAMPLE_COUNT;
+		lod.Indices.resize(SAMPLE_COUNT / 4);
+		return lod;
+	}
+
+	void Insert(TrajectoryCache& cache, std::uint32_t k)
+	{
+		PlateResult hit{};
+		hit.Y_m = static_cast<double>(k);
+		cache.Insert(Pitch(k), PLATE_M, Trajectory(k), Lod(), SimStats{}, hit);
+	}
+
+	std::uint64_t OneEntryBytes()
+	{
+		TrajectoryCache cache(~std::uint64_t{ 0 });
+		Insert(cache, 0);
+		return cache.Stats().Bytes;
+	}
+
+	std::uint64_t CollidingHash(const SimParams&, double) noexcept
+	{
+		return 42;
+	}
+
+	void FindReturnsInsertedEntry()
+	{
+		TrajectoryCache cache(std::uint64_t{ 64 } * 1024 * 1024);
+		Insert(cache, 3);
+
+		const TrajectoryCache::Entry* e = cache.Find(Pitch(3), PLATE_M);
+		PITCHSIM_CHECK(e != nullptr);
+		if (e)
+		{
+			PITCHSIM_CHECK(e->Samples.size() == SAMPLE_COUNT);
+			PITCHSIM_CHECK(e->Samples.front().X == 3);
+			PITCHSIM_CHECK(e->Lod.SampleCount == SAMPLE_COUNT);
+			PITCHSIM_CHECK(e->Hit.Y_m == 3.0);
+		}
+
+		PITCHSIM_CHECK(cache.Find(Pitch(4), PLATE_M) == nullptr);
+		PITCHSIM_CHECK(cache.Find(Pitch(3), PLATE_M + 1.0) == nullptr);
+		PITCHSIM_CHECK(cache.Stats().Hits == 1);
+		PITCHSIM_CHECK(cache.Stats().Misses == 2);
+	}
+
+	void MovedInsertAdoptsBuffers()
+	{
+		TrajectoryCache cache(std::uint64_t{ 64 } * 1024 * 1024);
+
+		QuantizedTrajectory traj = Trajectory(5);
+		PolylineLod lod = Lod();
+		const QuantizedSample* samples = traj.Samples.data();
+		const std::uint32_t* indices = lod.Indices.data();
+
+		cache.Insert(Pitch(5), PLATE_M, std::move(traj), std::move(lod), SimStats{}, PlateResult{});
+
+		const TrajectoryCache::Entry* e = cache.Find(Pitch(5), PLATE_M);
+		PITCHSIM_CHECK(e != nullptr);
+		if (e)
+		{
+			PITCHSIM_CHECK(e->Samples.data() == samples);
+			PITCHSIM_CHECK(e->Lod.Indices.data() == indices);
+		}
+	}
+
+	void BudgetEvictsLeastRecentlyUsed()
+	{
+		const std::uint64_t entryBytes = OneEntryBytes();
+		TrajectoryCache cache(entryBytes * 3);
+
+		Insert(cache, 0);
+		Insert(cache, 1);
+		Insert(cache, 2);
+		PITCHSIM_CHECK(cache.Stats().Entries == 3);
+		PITCHSIM_CHECK(cache.Stats().Evictions == 0);
+
+		PITCHSIM_CHECK(cache.Find(Pitch(0), PLATE_M) != nullptr);
+
+		Insert(cache, 3);
+		PITCHSIM_CHECK(cache.Stats().Entries == 3);
+		PITCHSIM_CHECK(cache.Stats().Evictions == 1);
+		PITCHSIM_CHECK(cache.Stats().Bytes <= cache.Stats().BudgetBytes);
+
+		PITCHSIM_CHECK(cache.Find(Pitch(1), PLATE_M) == nullptr);
+		PITCHSIM_CHECK(cache.Find(Pitch(0), PLATE_M) != nullptr);
+		PITCHSIM_CHECK(cache.Find(Pitch(2), PLATE_M) != nullptr);
+		PITCHSIM_CHECK(cache.Find(Pitch(3), PLATE_M) != nullptr);
+
+		cache.SetBudget(entryBytes);
+		PITCHSIM_CHECK(cache.Stats().Entries == 1);
+		PITCHSIM_CHECK(cache.Find(Pitch(3), PLATE_M) != nullptr);
+
+		cache.SetBudget(0);
+		PITCHSIM_CHECK(cache.Stats().Entries == 0);
+		PITCHSIM_CHECK(!cache.IsEnabled());
+		Insert(cache, 4);
+		PITCHSIM_CHECK(cache.Stats().Entries == 0);
+	}
+
+	void HashCollisionComparesParams()
+	{
+		TrajectoryCache cache(std::uint64_t{ 64 } * 1024 * 1024, &CollidingHash);
+
+		Insert(cache, 0);
+		PITCHSIM_CHECK(cache.Find(Pitch(1), PLATE_M) == nullptr);
+		PITCHSIM_CHECK(cache.Find(Pitch(0), PLATE_M + 1.0) == nullptr);
+
+		const TrajectoryCache::Entry* e = cache.Find(Pitch(0), PLATE_M);
+		PITCHSIM_CHECK(e != nullptr && e->Samples.front().X == 0);
+
+		Insert(cache, 1);
+		PITCHSIM_CHECK(cache.Stats().Entries == 1);
+		PITCHSIM_CHECK(cache.Find(Pitch(0), PLATE_M) == nullptr);
+
+		e = cache.Find(Pitch(1), PLATE_M);
+		PITCHSIM_CHECK(e != nullptr && e->Samples.front().X == 1);
+	}
+}
+
+int main()
+{
+	FindReturnsInsertedEntry();
+	MovedInsertAdoptsBuffers();
+	BudgetEvictsLeastRecentlyUsed();
+	HashCollisionComparesParams();
+
+	return PitchSimTest::Finish("TrajectoryCacheTest");
+}
\ No newline at end of file
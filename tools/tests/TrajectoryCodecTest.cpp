@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "Physics.hpp"
+#include "TrajectoryCodec.hpp"
+#include "TrajectoryPipeline.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	float Distance(const Float3& a, const Float3& b) noexcept
+	{
+		const float dx = a.X - b.X;
+		const float dy = a.Y - b.Y;
+		const float dz = a.Z - b.Z;
+		return std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	float Slack(const QuantizationBox& box) noexcept
+	{
+		const float reach = std::max({ std::abs(box.Min.X) + box.Extent.X, std::abs(box.Min.Y) + box.Extent.Y, std::abs(box.Min.Z) + box.Extent.Z });
+		return 4.0f * reach * 1.2e-7f;
+	}
+
+	float MaxRoundTripError(const std::vector<Float3>& points, const QuantizationBox& box)
+	{
+		std::vector<QuantizedSample> packed(points.size());
+		std::vector<Float3> decoded(points.size());
+
+		TrajectoryCodec::Encode(points.data(), points.size(), box, packed.data());
+		TrajectoryCodec::Decode(packed.data(), packed.size(), box, decoded.data());
+
+		float worst = 0.0f;
+		for (std::size_t i = 0; i < points.size(); ++i)
+		{
+			worst = std::max(worst, Distance(points[i], decoded[i]));
+		}
+
+		return worst;
+	}
+
+	void RandomPointsStayWithinBound()
+	{
+		std::mt19937 rng{ 29 };
+
+		for (float scale : { 0.01f, 1.0f, 18.44f, 250.0f })
+		{
+			std::uniform_real_distribution<float> offset{ -scale, scale };
+			std::uniform_real_distribution<float> coord{ 0.0f, scale };
+
+			const Float3 origin{ offset(rng), offset(rng), offset(rng) };
+
+			std::vector<Float3> points(20000);
+			for (Float3& p : points)
+			{
+				p = Float3{ origin.X + coord(rng), origin.Y + coord(rng), origin.Z + 0.25f * coord(rng) };
+			}
+
+			const QuantizationBox box = TrajectoryCodec::ComputeBox(points.data(), points.size());
+			PITCHSIM_CHECK(MaxRoundTripError(points, box) <= TrajectoryCodec::MaxError(box) + Slack(box));
+		}
+	}
+
+	void FlatAxisIsExact()
+	{
+		std::vector<Float3> points;
+		for (int i = 0; i < 100; ++i)
+		{
+			points.emplace_back(Float3{ 0.1f * static_cast<float>(i), 1.5f, -0.25f });
+		}
+
+		const QuantizationBox box = TrajectoryCodec::ComputeBox(points.data(), points.size());
+		const QuantizedSample q = TrajectoryCodec::Encode(points[37], box);
+		const Float3 d = TrajectoryCodec::Decode(q, box);
+
+		PITCHSIM_CHECK(d.Y == 1.5f);
+		PITCHSIM_CHECK(d.Z == -0.25f);
+		PITCHSIM_CHECK(MaxRoundTripError(points, box) <= TrajectoryCodec::MaxError(box) + Slack(box));
+	}
+
+	void PipelineOutputStaysWithinBound()
+	{
+		TrajectoryPipeline pipeline;
+
+		for (std::uint32_t k = 0; k < 16; ++k)
+		{
+			SimParams p{};
+			p.ReleaseHeight_cm = 150.0 + 2.0 * k;
+			p.InitialSpeed_mps = (110.0 + 3.0 * k) / 3.6;
+			p.Elevation_deg = -2.0 + 0.25 * k;
+			p.SpinRPM = 400.0 + 150.0 * k;
+			p.SpinAxis = DVec3{ std::cos(0.4 * k), std::sin(0.4 * k), 0.3 };
+			p.Method = (k % 2 == 0) ? Integrator::RK4 : Integrator::RK45;
+			p.StopOnGroundHit = true;
+
+			QuantizedTrajectory packed;
+			PlateResult hit{};
+			PITCHSIM_CHECK(pipeline.Build(p, &packed, nullptr, hit));
+
+			const auto& points = pipeline.Points();
+			PITCHSIM_CHECK(packed.Samples.size() == points.size());
+
+			float worst = 0.0f;
+			for (std::size_t i = 0; i < points.size(); ++i)
+			{
+				worst = std::max(worst, Distance(points[i], TrajectoryCodec::Decode(packed.Samples[i], packed.Box)));
+			}
+
+			PITCHSIM_CHECK(worst <= TrajectoryCodec::MaxError(packed.Box) + Slack(packed.Box));
+			PITCHSIM_CHECK(TrajectoryCodec::MaxError(packed.Box) < 0.001f);
+		}
+	}
+
+	void RequantizeKeepsBound()
+	{
+		std::vector<Float3> points;
+		for (int i = 0; i < 4000; ++i)
+		{
+			const float t = 0.00025f * static_cast<float>(i);
+			points.emplace_back(Float3{ 40.0f * t, 1.8f - 4.9f * t * t, 0.3f * std::sin(3.0f * t) });
+		}
+
+		const QuantizationBox tight = TrajectoryCodec::ComputeBox(points.data(), points.size());
+		const QuantizationBox loose{ Float3{ -10.0f, -10.0f, -10.0f }, Float3{ 50.0f, 30.0f, 20.0f } };
+
+		QuantizedTrajectory traj;
+		traj.Box = loose;
+		traj.Samples.resize(points.size());
+		TrajectoryCodec::Encode(points.data(), points.size(), loose, traj.Samples.data());
+
+		TrajectoryCodec::Requantize(traj);
+		PITCHSIM_CHECK(traj.Box.Extent.X <= tight.Extent.X + TrajectoryCodec::MaxError(loose) * 2.0f);
+
+		float worst = 0.0f;
+		for (std::size_t i = 0; i < points.size(); ++i)
+		{
+			worst = std::max(worst, Distance(points[i], TrajectoryCodec::Decode(traj.Samples[i], traj.Box)));
+		}
+
+		PITCHSIM_CHECK(worst <= TrajectoryCodec::MaxError(loose) + TrajectoryCodec::MaxError(traj.Box) + Slack(loose));
+	}
+}
+
+int main()
+{
+	RandomPointsStayWithinBound();
+	FlatAxisIsExact();
+	PipelineOutputStaysWithinBound();
+	RequantizeKeepsBound();
+
+	return PitchSimTest::Finish("TrajectoryCodecTest");
+}
\ No newline at end of file
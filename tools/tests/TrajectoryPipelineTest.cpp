@@ -0,0 +1,49 @@
+#include <cmath>
+#include <cstdint>
+
+#include "Check.hpp"
+#include "TrajectoryPipeline.hpp"
+
+using namespace PitchSim;
+
+namespace
+{
+	PlateResult BuildHit(Integrator method, std::uint32_t stride)
+	{
+		SimParams p{};
+		p.Method = method;
+		p.OutputStride = stride;
+		p.StopOnGroundHit = true;
+
+		TrajectoryPipeline pipeline;
+		PlateResult hit{};
+		PITCHSIM_CHECK(pipeline.Build(p, nullptr, nullptr, hit));
+
+		return hit;
+	}
+
+	void PlateTimeIgnoresOutputStride()
+	{
+		for (Integrator method : { Integrator::Euler, Integrator::RK4, Integrator::RK45 })
+		{
+			const PlateResult fine = BuildHit(method, 1);
+			PITCHSIM_CHECK(fine.Crossed);
+			PITCHSIM_CHECK(fine.Termination == SimTermination::Plate);
+
+			for (std::uint32_t stride : { 3u, 7u, 50u })
+			{
+				const PlateResult coarse = BuildHit(method, stride);
+				PITCHSIM_CHECK(coarse.Crossed);
+				PITCHSIM_CHECK(std::abs(coarse.Time_s - fine.Time_s) < 1e-4);
+				PITCHSIM_CHECK(std::abs(coarse.Y_m - fine.Y_m) < 1e-3);
+			}
+		}
+	}
+}
+
+int main()
+{
+	PlateTimeIgnoresOutputStride();
+
+	return PitchSimTest::Finish("TrajectoryPipelineTest");
+}
\ No newline at end of file
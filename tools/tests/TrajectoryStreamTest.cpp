@@ -0,0 +1,108 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "TrajectoryStream.hpp"
+
+using namespace PitchSim;
+using namespace std::chrono_literals;
+
+namespace
+{
+	void BlockedProducerResumesInOrder()
+	{
+		TrajectoryStream stream{ 256 };
+		stream.Reset(SimParams{});
+
+		constexpr std::size_t COUNT = 20000;
+		std::vector<Float3> points(COUNT);
+		for (std::size_t i = 0; i < COUNT; ++i)
+		{
+			points[i] = Float3{ static_cast<float>(i), 0.0f, 0.0f };
+		}
+
+		bool consumed = false;
+		std::thread producer{ [&]()
+		{
+			StreamSink sink{ stream };
+			for (std::size_t at = 0; at < COUNT; at += 100)
+			{
+				consumed = sink.Consume(points.data() + at, 100);
+			}
+			stream.Finished.store(true, std::memory_order_release);
+		} };
+
+		std::vector<Float3> out;
+		Float3 buf[64];
+
+		while (out.size() < COUNT)
+		{
+			const std::size_t n = stream.Ring.TryPop(buf, 64);
+			out.insert(out.end(), buf, buf + n);
+
+			if (n > 0)
+			{
+				stream.SignalDrained();
+			}
+			else
+			{
+				std::this_thread::sleep_for(100us);
+			}
+		}
+
+		producer.join();
+
+		bool ordered = true;
+		for (std::size_t i = 0; i < COUNT; ++i)
+		{
+			ordered = ordered && out[i].X == static_cast<float>(i);
+		}
+
+		PITCHSIM_CHECK(consumed);
+		PITCHSIM_CHECK(ordered);
+		PITCHSIM_CHECK(stream.Finished.load());
+	}
+
+	void CancelWakesBlockedProducer()
+	{
+		TrajectoryStream stream{ 64 };
+		stream.Reset(SimParams{});
+
+		std::vector<Float3> points(1000, Float3{ 1.0f, 2.0f, 3.0f });
+		std::atomic<bool> returned{ false };
+		bool result = true;
+
+		std::thread producer{ [&]()
+		{
+			StreamSink sink{ stream };
+			result = sink.Consume(points.data(), points.size());
+			returned.store(true);
+		} };
+
+		while (stream.Ring.SizeApprox() < stream.Ring.Capacity())
+		{
+			std::this_thread::sleep_for(1ms);
+		}
+
+		std::this_thread::sleep_for(20ms);
+		PITCHSIM_CHECK(!returned.load());
+
+		stream.Cancel.store(true, std::memory_order_relaxed);
+		stream.SignalDrained();
+		producer.join();
+
+		PITCHSIM_CHECK(returned.load());
+		PITCHSIM_CHECK(!result);
+	}
+}
+
+int main()
+{
+	BlockedProducerResumesInOrder();
+	CancelWakesBlockedProducer();
+
+	return PitchSimTest::Finish("TrajectoryStreamTest");
+}
\ No newline at end of file
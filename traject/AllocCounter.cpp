@@ -0,0 +1,141 @@
+#include "AllocCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace PitchSim::AllocCounter
+{
+	namespace
+	{
+		std::atomic<std::uint64_t> g_Allocations{ 0 };
+		std::atomic<std::uint64_t> g_Frees{ 0 };
+		std::atomic<std::uint64_t> g_Bytes{ 0 };
+	}
+
+#ifdef PITCHSIM_COUNT_ALLOCS
+	namespace Detail
+	{
+		void* Allocate(std::size_t size, std::size_t align, bool nothrow)
+		{
+			if (size == 0)
+			{
+				size = 1;
+			}
+
+			void* p = nullptr;
+
+			for (;;)
+			{
+				if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				{
+					p = std::malloc(size);
+				}
+				else
+				{
+#ifdef _MSC_VER
+					p = _aligned_malloc(size, align);
+#else
+					p = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+				}
+
+				if (p)
+				{
+					break;
+				}
+
+				std::new_handler handler = std::get_new_handler();
+				if (!handler)
+				{
+					if (nothrow)
+					{
+						return nullptr;
+					}
+
+					throw std::bad_alloc();
+				}
+
+				handler();
+			}
+
+			g_Allocations.fetch_add(1, std::memory_order_relaxed);
+			g_Bytes.fetch_add(size, std::memory_order_relaxed);
+			return p;
+		}
+
+		void Free(void* p, std::size_t align) noexcept
+		{
+			if (!p)
+			{
+				return;
+			}
+
+			g_Frees.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef _MSC_VER
+			if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			{
+				_aligned_free(p);
+				return;
+			}
+#else
+			(void)align;
+#endif
+			std::free(p);
+		}
+	}
+#endif
+
+	bool IsEnabled() noexcept
+	{
+#ifdef PITCHSIM_COUNT_ALLOCS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	Snapshot Read() noexcept
+	{
+		Snapshot s{};
+		s.Allocations = g_Allocations.load(std::memory_order_relaxed);
+		s.Frees = g_Frees.load(std::memory_order_relaxed);
+		s.BytesAllocated = g_Bytes.load(std::memory_order_relaxed);
+		return s;
+	}
+
+	std::uint64_t Allocations() noexcept
+	{
+		return g_Allocations.load(std::memory_order_relaxed);
+	}
+}
+
+#ifdef PITCHSIM_COUNT_ALLOCS
+namespace
+{
+	constexpr std::size_t DEFAULT_ALIGN = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+void* operator new(std::size_t size) { return PitchSim::AllocCounter::Detail::Allocate(size, DEFAULT_ALIGN, false); }
+void* operator new[](std::size_t size) { return PitchSim::AllocCounter::Detail::Allocate(size, DEFAULT_ALIGN, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return PitchSim::AllocCounter::Detail::Allocate(size, DEFAULT_ALIGN, true); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return PitchSim::AllocCounter::Detail::Allocate(size, DEFAULT_ALIGN, true); }
+void* operator new(std::size_t size, std::align_val_t align) { return PitchSim::AllocCounter::Detail::Allocate(size, static_cast<std::size_t>(align), false); }
+void* operator new[](std::size_t size, std::align_val_t align) { return PitchSim::AllocCounter::Detail::Allocate(size, static_cast<std::size_t>(align), false); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return PitchSim::AllocCounter::Detail::Allocate(size, static_cast<std::size_t>(align), true); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return PitchSim::AllocCounter::Detail::Allocate(size, static_cast<std::size_t>(align), true); }
+
+void operator delete(void* p) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete[](void* p) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete(void* p, std::size_t) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete[](void* p, std::size_t) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { PitchSim::AllocCounter::Detail::Free(p, DEFAULT_ALIGN); }
+void operator delete(void* p, std::align_val_t align) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+void operator delete[](void* p, std::align_val_t align) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept { PitchSim::AllocCounter::Detail::Free(p, static_cast<std::size_t>(align)); }
+#endif
\ No newline at end of file
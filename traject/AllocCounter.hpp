@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#if !defined(PITCHSIM_COUNT_ALLOCS) && defined(_DEBUG)
+#define PITCHSIM_COUNT_ALLOCS 1
+#endif
+
+namespace PitchSim::AllocCounter
+{
+	struct Snapshot
+	{
+		std::uint64_t Allocations{ 0 };
+		std::uint64_t Frees{ 0 };
+		std::uint64_t BytesAllocated{ 0 };
+	};
+
+	bool IsEnabled() noexcept;
+	Snapshot Read() noexcept;
+	std::uint64_t Allocations() noexcept;
+}
\ No newline at end of file
@@ -1,8 +1,18 @@
 #include "App.hpp"
 
 #include <thread>
+#include <limits>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
 
 #include "PitchConfig.hpp"
+#include "PitchLibrary.hpp"
+#include "ConfigDiff.hpp"
+#include "AllocCounter.hpp"
+#include "SplineTessellator.hpp"
+#include "Profiler.hpp"
+#include "MemoryTracker.hpp"
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
@@ -24,6 +34,11 @@ namespace
 	}
 }
 
+App::~App()
+{
+	CancelAllStreams();
+}
+
 std::optional<std::wstring> GetValueForKey(std::wstring key, const std::vector<AppParam>& p)
 {
 	std::optional<std::wstring> v;
@@ -42,7 +57,7 @@ std::optional<std::wstring> GetValueForKey(std::wstring key, const std::vector<A
 
 void App::RestartAnimationForIndex(std::size_t i) noexcept
 {
-	if (i >= m_TrajectoryVertsList.size())
+	if (i >= m_Trajectories.size())
 	{
 		return;
 	}
@@ -52,7 +67,7 @@ void App::RestartAnimationForIndex(std::size_t i) noexcept
 		RecalcTrajectForIndex(i);
 	}
 
-	const std::size_t n = m_TrajectoryVertsList[i].size();
+	const std::size_t n = m_Trajectories[i].Samples.size();
 
 	if (i < m_TimeElapsed_s.size())
 	{
@@ -69,7 +84,7 @@ void App::RestartAnimationForIndex(std::size_t i) noexcept
 
 void App::RestartAnimationForAll() noexcept
 {
-	for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
+	for (std::size_t i = 0; i < m_Trajectories.size(); ++i)
 	{
 		RestartAnimationForIndex(i);
 	}
@@ -77,12 +92,12 @@ void App::RestartAnimationForAll() noexcept
 
 void App::RestartAnimationForIndexWithoutRecompute(std::size_t i) noexcept
 {
-	if (i >= m_TrajectoryVertsList.size())
+	if (i >= m_Trajectories.size())
 	{
 		return;
 	}
 
-	const std::size_t n = m_TrajectoryVertsList[i].size();
+	const std::size_t n = m_Trajectories[i].Samples.size();
 
 	if (i < m_TimeElapsed_s.size())
 	{
@@ -99,7 +114,7 @@ void App::RestartAnimationForIndexWithoutRecompute(std::size_t i) noexcept
 
 void App::RestartAnimationForAllWithoutRecompute() noexcept
 {
-	for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
+	for (std::size_t i = 0; i < m_Trajectories.size(); ++i)
 	{
 		RestartAnimationForIndexWithoutRecompute(i);
 	}
@@ -133,26 +148,96 @@ namespace
 		return r;
 	}
 
+	const XMFLOAT4 PALETTE[] =
+	{
+		{0.90f, 0.30f, 0.30f, 1.0f}, //
+		{0.30f, 0.85f, 0.40f, 1.0f}, //
+		{0.30f, 0.50f, 0.95f, 1.0f}, //
+		{0.95f, 0.65f, 0.20f, 1.0f}, //IW
+		{0.80f, 0.40f, 0.85f, 1.0f}, //}[^
+		{0.95f, 0.85f, 0.25f, 1.0f}, //F
+		{0.35f, 0.85f, 0.85f, 1.0f}, //VA
+		{0.80f, 0.55f, 0.35f, 1.0f}, //uE
+	};
+
+	constexpr std::size_t PALETTE_COUNT = sizeof(PALETTE) / sizeof(PALETTE[0]);
+
+	constexpr float LABEL_SIZE_PX = 18.0f;
+
+	constexpr double MAX_FRAME_DT_S = 0.1;
+
+	//1y[W̐L[̐
+	constexpr std::size_t FILTER_PAGE_SIZE = 8;
+
+	//𒴂鋅ł̓OŒ\A[J[ŗʎq܂ōς܂Ă󂯎
+	constexpr std::size_t LIVE_STREAM_LIMIT = 64;
+
+	constexpr std::uint64_t BYTES_PER_MB = 1024 * 1024;
+
+	constexpr double DEFAULT_TIME_SCALE = 1.0 / 3.0;
+	constexpr int DEFAULT_SUBDIVIDE = 8;
+	constexpr double DEFAULT_PLATE_DISTANCE_M = 18.44;
+	constexpr std::uint64_t DEFAULT_MEMORY_BUDGET_MB = 1024;
+	constexpr std::uint64_t DEFAULT_TRAJECTORY_CACHE_MB = 128;
+
+	constexpr std::size_t ENV_WATCH_ID = 0;
+	constexpr std::size_t PITCH_WATCH_ID = 1;
+
+	//GfB^̕ۑrǂ܂Ȃ悤AŌ̕ύXʒm炱ꂾ󂢂Ăǂݒ
+	constexpr auto CONFIG_RELOAD_DELAY = std::chrono::milliseconds(150);
+
+	//__܂ł̋̂̊ȏ㓮Aʊ̋e덷ς̂ŕ
+	constexpr float RETESSELLATE_VIEW_RATIO = 0.1f;
+
 	inline XMFLOAT4 Palette(std::size_t idx) noexcept
 	{
-		static const XMFLOAT4 k[] =
+		idx %= DxRenderer::PALETTE_SIZE;
+
+		if (idx < PALETTE_COUNT)
 		{
-			{0.90f, 0.30f, 0.30f, 1.0f}, //
-			{0.30f, 0.85f, 0.40f, 1.0f}, //
-			{0.30f, 0.50f, 0.95f, 1.0f}, //
-			{0.95f, 0.65f, 0.20f, 1.0f}, //IW
-			{0.80f, 0.40f, 0.85f, 1.0f}, //}[^
-			{0.95f, 0.85f, 0.25f, 1.0f}, //F
-			{0.35f, 0.85f, 0.85f, 1.0f}, //VA
-			{0.80f, 0.55f, 0.35f, 1.0f}, //uE
-		};
+			return PALETTE[idx];
+		}
+
+		//ŒFg؂物ŐF񂵂Č̕tF
+		const float h = std::fmod(static_cast<float>(idx - PALETTE_COUNT) * 0.618034f + 0.05f, 1.0f) * 6.0f;
+		const int sector = static_cast<int>(h);
+		const float f = h - static_cast<float>(sector);
+		const float v = 0.95f;
+		const float p = v * 0.4f;
+		const float q = v * (1.0f - 0.6f * f);
+		const float t = v * (1.0f - 0.6f * (1.0f - f));
+
+		switch (sector % 6)
+		{
+			case 0: return XMFLOAT4{ v, t, p, 1.0f };
+			case 1: return XMFLOAT4{ q, v, p, 1.0f };
+			case 2: return XMFLOAT4{ p, v, t, 1.0f };
+			case 3: return XMFLOAT4{ p, q, v, 1.0f };
+			case 4: return XMFLOAT4{ t, p, v, 1.0f };
+			default: return XMFLOAT4{ v, p, q, 1.0f };
+		}
+	}
+
+	//Xg[~O͋OŜ͈̔͂Ȃ̂ŁA܂Œ̔ŗʎq
+	inline QuantizationBox StreamingBox(const SimParams& p) noexcept
+	{
+		const float releaseY = static_cast<float>((p.ReleaseHeight_cm + 25.4) * 0.01);
+		const float plate = static_cast<float>(p.PlateDistance_m);
 
-		return k[idx % (sizeof(k) / sizeof(k[0]))];
+		return QuantizationBox
+		{
+			Float3{ -0.5f, -2.0f, -4.0f },
+			Float3{ plate + 1.0f, releaseY + 5.0f, 8.0f }
+		};
 	}
 
-	inline double KmphToMps(double kmh) noexcept
+	//N̗DxtɎgA[X_{ۂ܂ł̑܂Ȕ͈
+	inline Aabb PriorBounds(const SimParams& p) noexcept
 	{
-		return kmh / 3.6;
+		const float releaseY = static_cast<float>((p.ReleaseHeight_cm + 25.4) * 0.01);
+		const float plate = static_cast<float>(p.PlateDistance_m);
+
+		return Aabb{ Float3{ 0.0f, 0.0f, -1.0f }, Float3{ plate, releaseY, 1.0f } };
 	}
 
 	bool ProjectToScreen(const XMFLOAT3& world, const XMMATRIX& view, const XMMATRIX& proj, std::uint32_t width, std::uint32_t height, XMFLOAT2& out) noexcept
@@ -203,247 +288,455 @@ namespace
 		return Float3{ a.X + (b.X - a.X) * t, a.Y + (b.Y - a.Y) * t, a.Z + (b.Z - a.Z) * t };
 	}
 
-	inline Float3 CatmullRom(const Float3& p0, const Float3& p1, const Float3& p2, const Float3& p3, float t) noexcept
+}
+
+bool App::IsPitchRequireRecalc(std::size_t i)
+{
+	if (i >= m_Pitches.size())
 	{
-		const float t2 = t * t;
-		const float t3 = t2 * t;
+		return false;
+	}
 
-		float cx = 0.5f * (2.0f * p1.X + (-p0.X + p2.X) * t + (2.0f * p0.X - 5.0f * p1.X + 4.0f * p2.X - p3.X) * t2 + (-p0.X + 3.0f * p1.X - 3.0f * p2.X + p3.X) * t3);
-		float cy = 0.5f * (2.0f * p1.Y + (-p0.Y + p2.Y) * t + (2.0f * p0.Y - 5.0f * p1.Y + 4.0f * p2.Y - p3.Y) * t2 + (-p0.Y + 3.0f * p1.Y - 3.0f * p2.Y + p3.Y) * t3);
-		float cz = 0.5f * (2.0f * p1.Z + (-p0.Z + p2.Z) * t + (2.0f * p0.Z - 5.0f * p1.Z + 4.0f * p2.Z - p3.Z) * t2 + (-p0.Z + 3.0f * p1.Z - 3.0f * p2.Z + p3.Z) * t3);
+	return i < m_Samplers.size() && m_Samplers[i].IsRandom();
+}
+
+SimParams App::ResolveParamsForIndex(std::size_t i)
+{
+	SimParams p = TrajectoryPipeline::Resolve(m_Pitches[i], m_Samplers[i], m_SamplerRng, m_Params);
+	p.OutputStride = m_OutputStride;
 
-		return Float3{ cx, cy, cz };
+	//ƃxɏoxE]E]ς̂ŕ蒼
+	if (m_Samplers[i].IsRandom())
+	{
+		m_LabelTextDirty = true;
 	}
 
-	inline const Float3& ClampIdx(const std::vector<Float3>& v, int i) noexcept
+	return p;
+}
+
+SimParams App::ParamsForIndex(std::size_t i) const
+{
+	SimParams p = ResolvePitchParams(m_Pitches[i], m_Params);
+	p.OutputStride = m_OutputStride;
+	return p;
+}
+
+void App::BuildSpotForIndex(std::size_t i)
+{
+	auto& circle = m_CircleVertsList[i];
+	circle.clear();
+
+	//{ۂ̒ʉߓ_̓V~[Vɋ߂Ă̂ŁA_ǂݒȂ
+	const PlateResult& hit = m_PlateHits[i];
+	if (!hit.Crossed)
 	{
-		if (i < 0)
-		{
-			return v.front();
-		}
+		return;
+	}
+
+	PITCHSIM_PROFILE_SCOPE("BuildCircle");
 
-		if (i >= static_cast<int>(v.size()))
+	const XMFLOAT4 base = Palette(i);
+	const float r = static_cast<float>(m_Params.Radius_mm * 1e-3);
+	const int segs = 48;
+	const XMFLOAT4 fillCol{ base.x, base.y, base.z, 0.35f };
+	circle.reserve(segs * 3);
+
+	auto addTri = [&](const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
 		{
-			return v.back();
-		}
+			circle.emplace_back(DxRenderer::Vertex{ p0, fillCol });
+			circle.emplace_back(DxRenderer::Vertex{ p1, fillCol });
+			circle.emplace_back(DxRenderer::Vertex{ p2, fillCol });
+		};
+
+	const float cx = m_PlateDistance_m;
+	const float cy = static_cast<float>(hit.Y_m);
+	const float cz = static_cast<float>(hit.Z_m);
+
+	constexpr float PI = 3.14159265358979323846f;
 
-		return v[static_cast<std::size_t>(i)];
+	for (int s = 0; s < segs; ++s)
+	{
+		float a0 = 2.0f * PI * (static_cast<float>(s) / segs);
+		float a1 = 2.0f * PI * (static_cast<float>(s + 1) / segs);
+		XMFLOAT3 p0{ cx, cy, cz };
+		XMFLOAT3 p1{ cx, cy + r * std::cos(a0), cz + r * std::sin(a0) };
+		XMFLOAT3 p2{ cx, cy + r * std::cos(a1), cz + r * std::sin(a1) };
+		addTri(p0, p1, p2);
 	}
 }
 
-namespace
+void App::RecalcTrajectForIndex(std::size_t i)
 {
-	inline bool SetRandomValue(PitchSim::Config::PitchEntry& pe)
+	if (i >= m_Pitches.size())
 	{
-		if (pe.IsRandomAxisX && pe.XMin.has_value() && pe.XMax.has_value())
-		{
-			pe.Axis.X = App::GenerateRandom(pe.XMin.value(), pe.XMax.value());
-		}
-		else if (pe.IsRandomAxisX)
-		{
-			return false;
-		}
+		return;
+	}
 
-		if (pe.IsRandomAxisY && pe.YMin.has_value() && pe.YMax.has_value())
-		{
-			pe.Axis.Y = App::GenerateRandom(pe.YMin.value(), pe.YMax.value());
-		}
-		else if (pe.IsRandomAxisY)
-		{
-			return false;
-		}
+	StartStreamForIndex(i, ResolveParamsForIndex(i));
+}
 
-		if (pe.IsRandomAxisZ && pe.ZMin.has_value() && pe.ZMax.has_value())
-		{
-			pe.Axis.Z = App::GenerateRandom(pe.ZMin.value(), pe.ZMax.value());
-		}
-		else if(pe.IsRandomAxisZ)
-		{
-			return false;
-		}
+bool App::IsStreaming(std::size_t i) const noexcept
+{
+	return i < m_Streams.size() && m_Streams[i].Active;
+}
 
-		if (pe.IsRandomAzimuth && pe.AzimuthMin.has_value() && pe.AzimuthMax.has_value())
-		{
-			pe.Azimuth_deg = App::GenerateRandom(pe.AzimuthMin.value(), pe.AzimuthMax.value());
-		}
-		else if(pe.IsRandomAzimuth)
-		{
-			return false;
-		}
+void App::StartStreamForIndex(std::size_t i, const SimParams& p)
+{
+	CancelStreamForIndex(i);
 
-		if (pe.IsRandomElevation && pe.ElevationMin.has_value() && pe.ElevationMax.has_value())
-		{
-			pe.Elevation_deg = App::GenerateRandom(pe.ElevationMin.value(), pe.ElevationMax.value());
-		}
-		else if (pe.IsRandomElevation)
-		{
-			return false;
-		}
+	PitchStream& s = m_Streams[i];
+	s.Params = p;
+	s.Complete = false;
+	s.Cacheable = false;
+	s.Dt_s = p.Dt_s * static_cast<double>(std::max<std::uint32_t>(1, p.OutputStride));
 
-		if (pe.IsRandomRelease && pe.ReleaseMin.has_value() && pe.ReleaseMax.has_value())
-		{
-			pe.Release_cm = App::GenerateRandom(pe.ReleaseMin.value(), pe.ReleaseMax.value());
-		}
-		else if (pe.IsRandomRelease)
+	//p[^ŌvZς݂̋OLbVɂ΁AV~[VɂgBň͓lɖ߂Ȃ̂ŒTȂ
+	const TrajectoryCache::Entry* cached = IsPitchRequireRecalc(i) ? nullptr : m_TrajectoryCache.Find(p, m_PlateDistance_m);
+	if (cached)
+	{
+		RestoreCachedForIndex(i, *cached);
+		return;
+	}
+
+	if (m_ActiveStreamCount == 0)
+	{
+		m_RerollAllocMark = AllocCounter::Allocations();
+		m_RerollSelfMark = m_StatsSelfAllocs;
+	}
+
+	auto& traj = m_Trajectories[i];
+	const std::size_t previousCount = traj.Samples.size();
+
+	traj.Samples.clear();
+	traj.Box = StreamingBox(p);
+	traj.PaletteIndex = static_cast<std::uint32_t>(i);
+	m_Bounds[i] = SceneCulling::BoundsOf(traj.Box);
+	m_PlateHits[i] = PlateResult{};
+	m_CircleVertsList[i].clear();
+	m_TimeElapsed_s[i] = 0.0;
+	m_VisibleCounts[i] = 0;
+	m_TrajDuration_s[i] = 0.0;
+
+	const bool buffered = m_Trajectories.size() > LIVE_STREAM_LIMIT;
+	const std::size_t ringCapacity = buffered ? 1 : TrajectoryStream::DEFAULT_RING_CAPACITY;
+
+	//ÕXg[^XNĂ΃OƎg
+	if (!s.Stream || s.Stream.use_count() > 1 || s.Stream->Ring.Capacity() != ringCapacity)
+	{
+		s.Stream = std::make_shared<TrajectoryStream>(ringCapacity);
+	}
+
+	s.Stream->Reset(p, buffered);
+	s.Active = true;
+	s.ExpectedCount = TrajectorySimulator::EstimateSampleCount(p);
+	++m_ActiveStreamCount;
+
+	if (!buffered)
+	{
+		const std::size_t capacityHint = std::max(s.ExpectedCount, previousCount);
+		traj.Samples.reserve(capacityHint);
+		m_Renderer.ResetStreamingTrajectory(i, capacityHint);
+	}
+
+	//V~[V̓[J[XbhŐi߁A`NPʂŃOɗ
+	m_Scheduler.Submit([stream = s.Stream]()
+	{
+		PITCHSIM_PROFILE_SCOPE("StreamTask");
+
+		if (!stream->Cancel.load(std::memory_order_relaxed))
 		{
-			return false;
+			//_̋L^É͈E{ےʉ߂̌o1̑ōς܂Aʎq͋܂͈͂Œڍs
+			thread_local TrajectoryPipeline pipeline;
+			StreamSink sink{ *stream };
+
+			pipeline.Build(stream->Params, &stream->Packed, &stream->Lod, stream->Hit, &stream->Stats, stream->Buffered ? nullptr : &sink);
 		}
 
-		if (pe.IsRandomRpm && pe.RpmMin.has_value() && pe.RpmMax.has_value())
+		stream->Finished.store(true, std::memory_order_release);
+	});
+
+	m_Animate = true;
+}
+
+void App::CancelStreamForIndex(std::size_t i) noexcept
+{
+	if (!IsStreaming(i))
+	{
+		return;
+	}
+
+	PitchStream& s = m_Streams[i];
+	s.Stream->Cancel.store(true, std::memory_order_relaxed);
+	s.Stream->SignalDrained();
+	s.Active = false;
+	--m_ActiveStreamCount;
+	m_Renderer.ReleaseStreamingTrajectory(i);
+}
+
+void App::CancelAllStreams() noexcept
+{
+	for (std::size_t i = 0; i < m_Streams.size(); ++i)
+	{
+		CancelStreamForIndex(i);
+	}
+}
+
+void App::PumpStreams()
+{
+	PITCHSIM_PROFILE_SCOPE("PumpStreams");
+
+	if (m_StreamScratch.empty())
+	{
+		m_StreamScratch.resize(TrajectorySimulator::CHUNK_SIZE * 16);
+	}
+
+	for (std::size_t i = 0; i < m_Streams.size(); ++i)
+	{
+		PitchStream& s = m_Streams[i];
+		if (!s.Active)
 		{
-			pe.Rpm = App::GenerateRandom(pe.RpmMin.value(), pe.RpmMax.value());
+			continue;
 		}
-		else if(pe.IsRandomRpm)
+
+		const bool finished = s.Stream->Finished.load(std::memory_order_acquire);
+
+		auto& traj = m_Trajectories[i];
+		const std::size_t first = traj.Samples.size();
+
+		std::size_t budget = finished ? std::numeric_limits<std::size_t>::max() : s.Stream->Ring.Capacity() * 4;
+
+		while (budget > 0)
 		{
-			return false;
+			const std::size_t n = s.Stream->Ring.TryPop(m_StreamScratch.data(), std::min(budget, m_StreamScratch.size()));
+			if (n == 0)
+			{
+				break;
+			}
+
+			const std::size_t at = traj.Samples.size();
+			traj.Samples.resize(at + n);
+			TrajectoryCodec::Encode(m_StreamScratch.data(), n, traj.Box, traj.Samples.data() + at);
+
+			budget -= n;
 		}
 
-		if (pe.IsRandomSpeed && pe.SpeedMin.has_value() && pe.SpeedMax.has_value())
+		if (traj.Samples.size() > first)
 		{
-			pe.Speed_kmh = App::GenerateRandom(pe.SpeedMin.value(), pe.SpeedMax.value());
+			//tŖĂ郏[J[N
+			s.Stream->SignalDrained();
+			m_Renderer.AppendStreamingTrajectory(i, traj.Samples, first);
 		}
-		else if (pe.IsRandomSpeed)
+
+		if (finished)
 		{
-			return false;
+			FinalizeStreamForIndex(i);
 		}
-
-		return true;
 	}
 }
 
-bool App::IsPitchRequireRecalc(std::size_t i)
+void App::FinalizeStreamForIndex(std::size_t i)
 {
-	if (i >= m_Pitches.size())
+	PITCHSIM_PROFILE_SCOPE("FinalizeStream");
+
+	PitchStream& s = m_Streams[i];
+	s.Active = false;
+
+	const SimStats& stats = s.Stream->Stats;
+	m_SimTotals.Add(stats);
+
+	//܂ŉĖ{ۂɓ͂Ȃ͐ݒ̌肪^킵̂Œm点
+	if (stats.Termination == SimTermination::StepCap)
 	{
-		return false;
+		OutputDebugStringA(std::format("pitch {} hit the step cap ({} steps) without reaching the plate\n", i, stats.Steps).c_str());
 	}
 
-	const auto& x = m_Pitches[i];
+	auto& traj = m_Trajectories[i];
 
-	return (x.IsRandomAxisX || x.IsRandomAxisY || x.IsRandomAxisZ || x.IsRandomAzimuth || x.IsRandomElevation || x.IsRandomRelease || x.IsRandomRpm || x.IsRandomSpeed);
-}
+	//Xg[~Oŗ_͉͈̔͂ŗʎqĂ̂ŁA[J[Og͈̔͂ŋlߒ̂ɍւ
+	std::swap(traj.Samples, s.Stream->Packed.Samples);
+	traj.Box = s.Stream->Packed.Box;
+	std::swap(m_Lods[i], s.Stream->Lod);
+	m_PlateHits[i] = s.Stream->Hit;
+	s.Stats = stats;
+	s.Complete = true;
 
-void App::RecalcTrajectForIndex(std::size_t i)
-{
-	using namespace PitchSim;
-	using namespace PitchSim::Config;
+	//LbVւ͓_̂Ă鎞ɈڂBň͓xƓlɂȂȂ̂œȂ
+	s.Cacheable = stats.Termination != SimTermination::Cancelled && !IsPitchRequireRecalc(i);
 
-	if (i >= m_Pitches.size())
+	m_Renderer.ReleaseStreamingTrajectory(i);
+	CompleteTrajectoryForIndex(i);
+
+	if (--m_ActiveStreamCount == 0)
 	{
-		return;
+		m_LastRerollAllocs = (AllocCounter::Allocations() - m_RerollAllocMark) - (m_StatsSelfAllocs - m_RerollSelfMark);
+
+		if (!m_BuildCostReported)
+		{
+			ReportBuildCost();
+		}
 	}
+}
 
-	PitchEntry& pe = m_Pitches[i];
+void App::RestoreCachedForIndex(std::size_t i, const TrajectoryCache::Entry& cached)
+{
+	PITCHSIM_PROFILE_SCOPE("RestoreCached");
 
-	SetRandomValue(pe);
+	auto& traj = m_Trajectories[i];
+	traj.Box = cached.Box;
+	traj.PaletteIndex = static_cast<std::uint32_t>(i);
+	traj.Samples.assign(cached.Samples.begin(), cached.Samples.end());
+	m_Lods[i] = cached.Lod;
+	m_PlateHits[i] = cached.Hit;
+	m_Streams[i].Stats = cached.Stats;
+	m_Streams[i].Cacheable = false;
 
-	SimParams p = m_Params;
-	p.InitialSpeed_mps = KmphToMps(pe.Speed_kmh);
-	p.SpinAxis = pe.Axis;
-	p.SpinRPM = pe.Rpm;
+	m_TimeElapsed_s[i] = 0.0;
+	m_VisibleCounts[i] = 0;
+	m_Streams[i].Complete = true;
 
-	if (pe.Release_cm.has_value())
-	{
-		p.ReleaseHeight_cm = pe.Release_cm.value();
-	}
+	CompleteTrajectoryForIndex(i);
+	m_Animate = true;
+}
+
+void App::CompleteTrajectoryForIndex(std::size_t i)
+{
+	auto& traj = m_Trajectories[i];
+	const std::size_t ns = traj.Samples.size();
+
+	//JOp̔͋̔aLĒe_̉~܂߂
+	const float r = static_cast<float>(m_Params.Radius_mm * 1e-3);
+	Aabb bounds = (m_Lods[i].SampleCount == ns) ? SceneCulling::BoundsOf(m_Lods[i]) : SceneCulling::BoundsOf(traj.Box);
+	bounds.Min = Float3{ bounds.Min.X - r, bounds.Min.Y - r, bounds.Min.Z - r };
+	bounds.Max = Float3{ bounds.Max.X + r, bounds.Max.Y + r, bounds.Max.Z + r };
+	m_Bounds[i] = bounds;
+	++m_LabelGeneration;
 
-	if (pe.Elevation_deg.has_value())
+	BuildSpotForIndex(i);
+
+	m_TrajDuration_s[i] = (ns >= 2) ? (static_cast<double>(ns - 1) * m_Streams[i].Dt_s) : 0.0;
+
+	if (m_FirstPitch_ms < 0.0)
 	{
-		p.Elevation_deg = pe.Elevation_deg.value();
+		m_FirstPitch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartupBegin).count();
 	}
 
-	if (pe.Azimuth_deg.has_value())
 	{
-		p.Azimuth_deg = pe.Azimuth_deg.value();
+		PITCHSIM_PROFILE_SCOPE("UploadPacked");
+		m_Renderer.UpdatePackedTrajectory(i, traj, m_Lods[i]);
+		m_Renderer.UpdatePackedSpot(i, m_CircleVertsList[i]);
 	}
+}
 
-	std::vector<Float3> pts;
-	m_Simulator.Simulate(p, pts);
+SampleFootprint App::BuildFootprint() const noexcept
+{
+	//CPU GPU̗ʎq_ALOD̍풓A[J[ƂɓWJO̍WꎞIɎ
+	SampleFootprint fp{};
+	fp.ResidentBytes = sizeof(QuantizedSample) * 2 + sizeof(std::uint32_t);
+	fp.ScratchBytes = sizeof(Float3);
+	fp.ScratchSlots = m_Scheduler.WorkerCount();
+	return fp;
+}
 
-	XMFLOAT4 base = Palette(static_cast<std::size_t>(i));
-	XMFLOAT4 white{ 1.0f, 1.0f, 1.0f, 1.0f };
+void App::ReportBuildCost()
+{
+	m_BuildCostReported = true;
 
-	std::vector<DxRenderer::Vertex> verts;
-	verts.reserve(pts.size());
-	const std::size_t n = pts.size();
+	std::uint64_t samples = 0;
+	std::uint64_t bytes = 0;
 
-	for (std::size_t k = 0; k < n; ++k)
+	for (std::size_t i = 0; i < m_Trajectories.size(); ++i)
 	{
-		float t = (n > 1) ? static_cast<float>(k) / static_cast<float>(n - 1) : 0.0f;
-		XMFLOAT4 col = Lerp(base, white, t);
-		verts.emplace_back(DxRenderer::Vertex{ XMFLOAT3{pts[k].X, pts[k].Y, pts[k].Z }, col });
+		const std::size_t n = m_Trajectories[i].Samples.size();
+		samples += n;
+		bytes += m_Trajectories[i].Samples.capacity() * sizeof(QuantizedSample) + n * sizeof(QuantizedSample) + m_Lods[i].Indices.capacity() * sizeof(std::uint32_t);
 	}
 
-	const float plateX = m_PlateDistance_m;
-	const std::size_t vn = verts.size();
-	std::optional<XMFLOAT3> hit;
+	m_BuildActualSamples = samples;
+	m_BuildActualBytes = bytes;
 
-	if (vn >= 2)
-	{
-		for (std::size_t k = 1; k < vn; ++k)
-		{
-			const auto& a = verts[k - 1].Pos;
-			const auto& b = verts[k].Pos;
+	OutputDebugStringA(std::format("build actual: {} pitches, {} steps, {} force evals, {} samples, {:.1f} MB resident (estimate {} steps, {} samples, {:.1f} MB)\n",
+		m_SimTotals.Runs, m_SimTotals.Steps, m_SimTotals.ForceEvals, samples, static_cast<double>(bytes) / BYTES_PER_MB,
+		m_BuildPlan.Steps, m_BuildPlan.Samples, static_cast<double>(m_BuildPlan.Bytes) / BYTES_PER_MB).c_str());
 
-			if (a.x <= plateX && b.x >= plateX)
-			{
-				float t = (std::abs(b.x - a.x) > 1e-6f) ? ((plateX - a.x) / (b.x - a.x)) : 0.0f;
-				t = std::clamp(t, 0.0f, 1.0f);
-				hit = XMFLOAT3
-				{
-					plateX,
-					a.y + (b.y - a.y) * t,
-					a.z + (b.z - a.z) * t
-				};
+	const TrajectoryCacheStats& cache = m_TrajectoryCache.Stats();
+	OutputDebugStringA(std::format("trajectory cache: {} hits, {} misses, {} entries, {:.1f} / {:.0f} MB, {} evictions\n",
+		cache.Hits, cache.Misses, cache.Entries, static_cast<double>(cache.Bytes) / BYTES_PER_MB, static_cast<double>(cache.BudgetBytes) / BYTES_PER_MB, cache.Evictions).c_str());
 
-				break;
-			}
-		}
+	if (m_AllReady_ms < 0.0)
+	{
+		ReportStartup();
 	}
+}
+
+void App::ReportStartup()
+{
+	m_AllReady_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartupBegin).count();
 
-	std::vector<DxRenderer::Vertex> circle;
+	OutputDebugStringA(std::format("startup: first frame {:.1f} ms, first pitch {:.1f} ms, all {} pitches ready {:.1f} ms\n",
+		m_FirstFrame_ms, m_FirstPitch_ms, m_Trajectories.size(), m_AllReady_ms).c_str());
+}
+
+Frustum App::ViewFrustum() const
+{
+	XMFLOAT4X4 viewProj{};
+	XMStoreFloat4x4(&viewProj, XMMatrixMultiply(m_Camera.GetViewMatrix(), m_Camera.GetProjMatrix()));
+	return Frustum::FromViewProj(&viewProj._11);
+}
 
-	if (hit.has_value())
+void App::OrderByPriority(std::vector<std::uint32_t>& indices, const std::vector<SimParams>& params) const
+{
+	//i荞݂ŕ\ɓ鋅ɌvZAc͌̏Ōɉ
+	const Frustum frustum = ViewFrustum();
+
+	std::stable_partition(indices.begin(), indices.end(), [&](std::uint32_t i)
 	{
-		const float r = static_cast<float>(m_Params.Radius_mm * 1e-3);
-		const int segs = 48;
-		const XMFLOAT4 fillCol{ base.x, base.y, base.z, 0.35f };
-		circle.reserve(segs * 3);
+		const bool shown = !m_FilterSingle || m_FilterSet.Test(i);
+		return shown && frustum.Intersects(PriorBounds(params[i]));
+	});
+}
 
-		auto addTri = [&](const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
-			{
-				circle.emplace_back(DxRenderer::Vertex{ p0, fillCol });
-				circle.emplace_back(DxRenderer::Vertex{ p1, fillCol });
-				circle.emplace_back(DxRenderer::Vertex{ p2, fillCol });
-			};
+bool App::LoadPitchList(std::vector<PitchSim::Config::PitchEntry>& outList, std::vector<PitchSim::Config::ParseError>& errors)
+{
+	using namespace PitchSim;
+	using namespace PitchSim::Config;
 
-		const float cx = hit->x;
-		const float cy = hit->y;
-		const float cz = hit->z;
+	const std::string pitchPath = ConvertWStringToString(m_PitchConfigFilePath);
+	bool loaded = false;
+	{
+		PITCHSIM_PROFILE_SCOPE("ParseConfig");
 
-		constexpr float PI = 3.14159265358979323846f;
+		//.pslibpitch_snapshotŕϊς݂̃XibvVbgB}bvēWJ邾ŉ͂͂Ȃ
+		if (pitchPath.ends_with(".pslib"))
+		{
+			PitchLibrary library;
+			std::string error;
 
-		for (int s = 0; s < segs; ++s)
+			loaded = library.Open(pitchPath, &error);
+			if (loaded)
+			{
+				library.MaterializeAll(outList);
+			}
+			else
+			{
+				errors.emplace_back(ParseError{ 0, 0, error });
+			}
+		}
+		else
 		{
-			float a0 = 2.0f * PI * (static_cast<float>(s) / segs);
-			float a1 = 2.0f * PI * (static_cast<float>(s + 1) / segs);
-			XMFLOAT3 p0{ cx, cy, cz };
-			XMFLOAT3 p1{ cx, cy + r * std::cos(a0), cz + r * std::sin(a0) };
-			XMFLOAT3 p2{ cx, cy + r * std::cos(a1), cz + r * std::sin(a1) };
-			addTri(p0, p1, p2);
+			loaded = LoadPitchConfigFileEx(pitchPath, outList, &errors);
 		}
 	}
 
-	const std::size_t ns = verts.size();
-	double trajSec = (ns >= 2) ? (static_cast<double>(ns - 1) * p.Dt_s) : 0.0;
+	//ǂ߂Ȃ͔΂đ邪Asƌo͂Ɏc
+	for (const auto& e : errors)
+	{
+		OutputDebugStringA((FormatParseError(pitchPath, e) + "\n").c_str());
+	}
 
-	m_TrajectoryVertsList[i] = std::move(verts);
-	m_CircleVertsList[i] = std::move(circle);
-	m_TimeElapsed_s[i] = 0.0;
-	m_VisibleCounts[i] = (ns > 0 ? 1u : 0u);
-	m_TrajDuration_s[i] = trajSec;
+	//fobKo͂ł͋CtȂ̂ŁAŏ1͉ʂɂo
+	m_PitchNotice = errors.empty() ? std::wstring{} : std::format(L"{} problem(s) in the pitch list: {}", errors.size(), Utf8ToWString(FormatParseError(pitchPath, errors.front())));
 
-	m_PackedDirty = true;
+	return loaded;
 }
 
 void App::ReloadConfigAndBuild()
@@ -451,191 +744,253 @@ void App::ReloadConfigAndBuild()
 	using namespace PitchSim;
 	using namespace PitchSim::Config;
 
-	m_Pitches.clear();
+	PITCHSIM_PROFILE_SCOPE("ReloadConfigAndBuild");
 
-	if (!LoadPitchConfigFileEx(ConvertWStringToString(m_PitchConfigFilePath), m_Pitches, 8))
+	const std::string pitchPath = ConvertWStringToString(m_PitchConfigFilePath);
+	std::vector<PitchEntry> next;
+	std::vector<ParseError> errors;
+	const bool loaded = LoadPitchList(next, errors);
+
+	if (!loaded)
 	{
-		MessageBox(m_HWND, L"LoadPitchConfigFileEx() Failed to load file.", m_PitchConfigFilePath.c_str(), MB_OK | MB_ICONERROR);
+		std::wstring message = L"LoadPitchConfigFileEx() Failed to load file.";
+
+		if (!errors.empty())
+		{
+			const auto failure = std::find_if(errors.begin(), errors.end(), [](const ParseError& e) { return !e.Warning; });
+			const std::string first = FormatParseError(pitchPath, (failure != errors.end()) ? *failure : errors.front());
+			message += L"\n";
+			message += std::wstring(first.begin(), first.end());
+		}
+
+		MessageBox(m_HWND, message.c_str(), m_PitchConfigFilePath.c_str(), MB_OK | MB_ICONERROR);
 		throw std::exception();
 	}
 
-	std::size_t N = m_Pitches.size();
+	CancelAllStreams();
+	m_Pitches.clear();
+
+	ApplyPitchList(std::move(next));
+}
 
-	m_TrajectoryVertsList.clear();
-	m_VisibleCounts.clear();
-	m_TimeElapsed_s.clear();
-	m_TrajDuration_s.clear();
-	m_CircleVertsList.clear();
+void App::ApplyPitchList(std::vector<PitchSim::Config::PitchEntry>&& next)
+{
+	using namespace PitchSim;
+	using namespace PitchSim::Config;
 
-	m_TrajectoryVertsList.resize(N);
-	m_VisibleCounts.resize(N);
-	m_TimeElapsed_s.resize(N);
-	m_TrajDuration_s.resize(N);
-	m_CircleVertsList.resize(N);
+	PITCHSIM_PROFILE_SCOPE("ApplyPitchList");
 
-	//[v񉻂L
-	auto& x = *this;
-#ifndef _DEBUG
-#pragma	omp parallel for schedule(static) default(none) shared(x)
-#endif
-	for (int i = 0; i < static_cast<int>(N); ++i)
+	//p̂͑IĂBrŎ~߂͓_񂪌Ă
+	const std::size_t previousCount = m_Pitches.size();
+	std::vector<bool> complete(previousCount, false);
+
+	for (std::size_t j = 0; j < previousCount && j < m_Streams.size(); ++j)
 	{
-		PitchEntry& pe = x.m_Pitches[i];
+		complete[j] = m_Streams[j].Complete;
+	}
 
-		SetRandomValue(pe);
+	CancelAllStreams();
 
-		SimParams p = x.m_Params;
-		p.InitialSpeed_mps = KmphToMps(pe.Speed_kmh);
-		p.SpinAxis = pe.Axis;
-		p.SpinRPM = pe.Rpm;
+	DiffPitchLists(m_Pitches, next, m_PitchDiff);
+	const std::vector<std::uint32_t>& source = m_PitchDiff.Source;
+	const std::size_t N = next.size();
 
-		if (pe.Release_cm.has_value())
+	//`̕ςĂȂ͑O̒lƈpAxƓ薼ւ
+	for (std::size_t i = 0; i < N; ++i)
+	{
+		if (source[i] != NO_SOURCE)
 		{
-			p.ReleaseHeight_cm = pe.Release_cm.value();
+			PitchEntry& previous = m_Pitches[source[i]];
+			previous.Label.swap(next[i].Label);
+			previous.Pitcher.swap(next[i].Pitcher);
+			next[i] = std::move(previous);
 		}
+	}
 
-		if (pe.Elevation_deg.has_value())
-		{
-			p.Elevation_deg = pe.Elevation_deg.value();
-		}
+	m_Pitches = std::move(next);
 
-		if (pe.Azimuth_deg.has_value())
-		{
-			p.Azimuth_deg = pe.Azimuth_deg.value();
-		}
+	//͓̈ǂݍݎɈxgݗĂĂAɂ͍ڂƂ̔Ȃ
+	m_Samplers.clear();
+	m_Samplers.reserve(N);
+
+	for (const PitchEntry& pe : m_Pitches)
+	{
+		m_Samplers.push_back(PitchSampler::Compile(pe));
+	}
+
+	//V~[Vn߂OɎ菇Eo͓_EʂςA𒴂Ȃo͂Ԉ
+	m_OutputStride = 1;
+	m_BuildPlan = BuildCostPlan{};
+	m_BuildCostReported = false;
+	m_BuildActualSamples = 0;
+	m_BuildActualBytes = 0;
+
+	std::vector<SimParams> params(N);
+
+	//p͗Ȃ
+	for (std::size_t i = 0; i < N; ++i)
+	{
+		params[i] = (source[i] != NO_SOURCE) ? ParamsForIndex(i) : ResolveParamsForIndex(i);
+		CostEstimator::Accumulate(m_BuildPlan, CostEstimator::Estimate(params[i]));
+	}
 
-		std::vector<Float3> pts;
-		m_Simulator.Simulate(p, pts);
+	CostEstimator::Finish(m_BuildPlan, BuildFootprint(), m_MemoryBudget_MB * BYTES_PER_MB, m_Params.Dt_s, m_DecimateOverBudget);
+	m_OutputStride = m_BuildPlan.OutputStride;
 
-		XMFLOAT4 base = Palette(static_cast<std::size_t>(i));
-		XMFLOAT4 white{ 1.0f, 1.0f, 1.0f, 1.0f };
+	OutputDebugStringA(std::format("build estimate: {} pitches, {} steps, {} force evals, {} samples, {:.1f} MB (undecimated {:.1f} MB, budget {} MB, output stride {})\n",
+		m_BuildPlan.Pitches, m_BuildPlan.Steps, m_BuildPlan.ForceEvals, m_BuildPlan.Samples, static_cast<double>(m_BuildPlan.Bytes) / BYTES_PER_MB,
+		static_cast<double>(m_BuildPlan.FullBytes) / BYTES_PER_MB, m_MemoryBudget_MB, m_OutputStride).c_str());
 
-		std::vector<DxRenderer::Vertex> verts;
-		verts.reserve(pts.size());
-		const std::size_t n = pts.size();
+	if (m_BuildPlan.OverBudget)
+	{
+		OutputDebugStringA(std::format("build estimate exceeds the memory budget ({:.1f} MB > {} MB); raise DT or MEMORYBUDGET\n",
+			static_cast<double>(m_BuildPlan.Bytes) / BYTES_PER_MB, m_MemoryBudget_MB).c_str());
+	}
+
+	//p[^ǑvZƈvAIĂ͓_GPU͈̔͂̂܂܎g
+	std::vector<std::uint32_t> kept(N, NO_SOURCE);
+	std::size_t reused = 0;
+
+	for (std::size_t i = 0; i < N; ++i)
+	{
+		params[i].OutputStride = m_OutputStride;
 
-		for (std::size_t k = 0; k < n; ++k)
+		const std::uint32_t j = source[i];
+		if (j != NO_SOURCE && complete[j] && m_Streams[j].Params == params[i])
 		{
-			float t = (n > 1) ? static_cast<float>(k) / static_cast<float>(n - 1) : 0.0f;
-			XMFLOAT4 col = Lerp(base, white, t);
-			verts.emplace_back(DxRenderer::Vertex{ XMFLOAT3{pts[k].X, pts[k].Y, pts[k].Z }, col });
+			kept[i] = j;
+			++reused;
 		}
+	}
 
-		const float plateX = m_PlateDistance_m;
-		const std::size_t vn = verts.size();
-		std::optional<XMFLOAT3> hit;
+	const auto remap = [N](auto& slots, const std::vector<std::uint32_t>& from, auto make)
+	{
+		std::remove_reference_t<decltype(slots)> out;
+		out.reserve(N);
 
-		if (vn >= 2)
+		for (std::size_t i = 0; i < N; ++i)
 		{
-			for (std::size_t k = 1; k < vn; ++k)
+			if (from[i] != NO_SOURCE)
 			{
-				const auto& a = verts[k - 1].Pos;
-				const auto& b = verts[k].Pos;
-
-				if (a.x <= plateX && b.x >= plateX)
-				{
-					float t = (std::abs(b.x - a.x) > 1e-6f) ? ((plateX - a.x) / (b.x - a.x)) : 0.0f;
-					t = std::clamp(t, 0.0f, 1.0f);
-					hit = XMFLOAT3
-					{
-						plateX,
-						a.y + (b.y - a.y) * t,
-						a.z + (b.z - a.z) * t
-					};
-
-					break;
-				}
+				out.emplace_back(std::move(slots[from[i]]));
+			}
+			else
+			{
+				out.emplace_back(make());
 			}
 		}
 
-		std::vector<DxRenderer::Vertex> circle;
+		slots.swap(out);
+	};
 
-		if (hit.has_value())
+	//pꂸɎ̂Ă鋅̓_́ARs[ɂ̂܂܃LbVֈڂ
+	std::vector<bool> carried(previousCount, false);
+	for (const std::uint32_t j : kept)
+	{
+		if (j != NO_SOURCE)
 		{
-			const float r = static_cast<float>(x.m_Params.Radius_mm * 1e-3);
-			const int segs = 48;
-			const XMFLOAT4 fillCol{ base.x, base.y, base.z, 0.35f };
-			circle.reserve(segs * 3);
+			carried[j] = true;
+		}
+	}
 
-			auto addTri = [&](const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
-			{
-				circle.emplace_back(DxRenderer::Vertex{ p0, fillCol });
-				circle.emplace_back(DxRenderer::Vertex{ p1, fillCol });
-				circle.emplace_back(DxRenderer::Vertex{ p2, fillCol });
-			};
+	for (std::size_t j = 0; j < previousCount && j < m_Streams.size(); ++j)
+	{
+		const PitchStream& s = m_Streams[j];
+		if (!carried[j] && complete[j] && s.Cacheable)
+		{
+			PITCHSIM_PROFILE_SCOPE("CacheInsert");
+			m_TrajectoryCache.Insert(s.Params, s.Params.PlateDistance_m, std::move(m_Trajectories[j]), std::move(m_Lods[j]), s.Stats, m_PlateHits[j]);
+		}
+	}
 
-			const float cx = hit->x;
-			const float cy = hit->y;
-			const float cz = hit->z;
+	remap(m_Trajectories, kept, [] { return QuantizedTrajectory{}; });
+	remap(m_Lods, kept, [] { return PolylineLod{}; });
+	remap(m_Bounds, kept, [] { return Aabb{}; });
+	remap(m_PlateHits, kept, [] { return PlateResult{}; });
+	remap(m_VisibleCounts, kept, [] { return std::size_t{ 0 }; });
+	remap(m_TimeElapsed_s, kept, [] { return 0.0; });
+	remap(m_TrajDuration_s, kept, [] { return 0.0; });
+	remap(m_CircleVertsList, kept, [] { return std::pmr::vector<DxRenderer::Vertex>{ MemoryTracker::Resource(MemoryTag::Spots) }; });
+	remap(m_Streams, source, [] { return PitchStream{}; });
+	m_Renderer.RemapPackedSlots(kept);
+
+	m_ActiveStreamCount = 0;
+	m_SimTotals = SimStatsTotals{};
+
+	if (N != previousCount)
+	{
+		m_FilterSet.Resize(N);
+		m_FilterPage = 0;
+	}
 
-			constexpr float PI = 3.14159265358979323846f;
+	m_LabelTextDirty = true;
+	++m_LabelGeneration;
+	m_FrameScheduler.Invalidate(RedrawReason::Data);
 
-			for (int s = 0; s < segs; ++s)
-			{
-				float a0 = 2.0f * PI * (static_cast<float>(s) / segs);
-				float a1 = 2.0f * PI * (static_cast<float>(s + 1) / segs);
-				XMFLOAT3 p0{ cx, cy, cz };
-				XMFLOAT3 p1{ cx, cy + r * std::cos(a0), cz + r * std::sin(a0) };
-				XMFLOAT3 p2{ cx, cy + r * std::cos(a1), cz + r * std::sin(a1) };
-				addTri(p0, p1, p2);
-			}
+	//^XN͓ɑ̂ŁAĂ鋅瓊Đɕ`悳悤ɂ
+	std::vector<std::uint32_t> order;
+	for (std::size_t i = 0; i < N; ++i)
+	{
+		if (kept[i] == NO_SOURCE)
+		{
+			order.emplace_back(static_cast<std::uint32_t>(i));
 		}
-
-		const std::size_t ns = verts.size();
-		double trajSec = (ns >= 2) ? (static_cast<double>(ns - 1) * p.Dt_s) : 0.0;
-
-		x.m_TrajectoryVertsList[i] = std::move(verts);
-		x.m_CircleVertsList[i] = std::move(circle);
-		x.m_TimeElapsed_s[i] = 0.0;
-		x.m_VisibleCounts[i] = (ns > 0 ? 1u : 0u);
-		x.m_TrajDuration_s[i] = trajSec;
 	}
 
-	RebuildPackedVBs();
-	m_Animate = true;
-}
+	OrderByPriority(order, params);
 
-bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
-{
-	WNDCLASSEX wc{ sizeof(WNDCLASSEX) };
-	wc.style = CS_CLASSDC;
-	wc.lpfnWndProc = WndProc;
-	wc.hInstance = hInstance;
-	wc.lpszClassName = WINDOW_CLASS_NAME;
-
-	wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+	for (const std::uint32_t i : order)
+	{
+		StartStreamForIndex(i, params[i]);
+	}
 
-	if (!RegisterClassEx(&wc))
+	//ʒu͐Fς̂ŁAe_̉~蒼
+	for (std::size_t i = 0; i < N; ++i)
 	{
-		return false;
+		if (kept[i] != NO_SOURCE && kept[i] != i)
+		{
+			m_Trajectories[i].PaletteIndex = static_cast<std::uint32_t>(i);
+			BuildSpotForIndex(i);
+			m_Renderer.UpdatePackedSpot(i, m_CircleVertsList[i]);
+		}
 	}
 
-	UINT w = 1280;
-	UINT h = 720;
-	RECT rc{ 0, 0, static_cast<LONG>(w), static_cast<LONG>(h) };
-	AdjustWindowRect(&rc, WS_OVERLAPPEDWINDOW, FALSE);
-	m_HWND = CreateWindow(WINDOW_CLASS_NAME, L"Pitch Trajectory - DirectX 11", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, rc.right - rc.left, rc.bottom - rc.top, nullptr, nullptr, hInstance, nullptr);
+	if (previousCount > 0)
+	{
+		OutputDebugStringA(std::format("pitch list applied: {} pitches, {} reused ({} moved), {} re-simulated, {} added, {} removed\n",
+			N, reused, m_PitchDiff.Moved, N - reused, m_PitchDiff.Added, m_PitchDiff.Removed).c_str());
+	}
 
-	if (!m_HWND)
+	if (m_ActiveStreamCount == 0)
 	{
-		return false;
+		ReportBuildCost();
 	}
 
-	auto c = GetValueForKey(L"env", param);
-	auto p = GetValueForKey(L"pitch", param);
+	m_Animate = true;
+}
 
-	if (c.has_value())
+bool App::LoadEnvironment(bool initial)
+{
+	PitchSim::Config::EnvironmentSettings es{};
+	std::vector<PitchSim::Config::ParseError> envErrors;
+	const std::string envPath = ConvertWStringToString(m_EnvConfigFilePath);
+
+	const bool envLoaded = PitchSim::Config::LoadEnvConfigFile(envPath, es, &envErrors);
+
+	for (const auto& e : envErrors)
 	{
-		m_EnvConfigFilePath = c.value();
+		OutputDebugStringA((PitchSim::Config::FormatParseError(envPath, e) + "\n").c_str());
 	}
 
-	if (p.has_value())
+	m_EnvNotice = envErrors.empty() ? std::wstring{} : std::format(L"{} problem(s) in the environment: {}", envErrors.size(), Utf8ToWString(PitchSim::Config::FormatParseError(envPath, envErrors.front())));
+
+	//ǂݒł͏̃t@C͂񂾂Ȃ̂ŁAs獡̐ݒۂ
+	if (!initial && !envLoaded)
 	{
-		m_PitchConfigFilePath = p.value();
+		return false;
 	}
 
-	ShowWindow(m_HWND, SW_SHOW);
-
+	m_Params = SimParams{};
 	m_Params.ReleaseHeight_cm = 180.0;
 	m_Params.InitialSpeed_mps = 0;
 	m_Params.Elevation_deg = 0;
@@ -655,9 +1010,15 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 	m_StrikeZoneHeight_m = 0.45;
 	m_StrikeZoneSizeHeight_m = 0.72;
 
-	PitchSim::Config::EnvironmentSettings es{};
+	m_TimeScale = DEFAULT_TIME_SCALE;
+	m_Subdivide = DEFAULT_SUBDIVIDE;
+	m_PlateDistance_m = DEFAULT_PLATE_DISTANCE_M;
+	m_MemoryBudget_MB = DEFAULT_MEMORY_BUDGET_MB;
+	m_DecimateOverBudget = true;
+
+	std::uint64_t cache_MB = DEFAULT_TRAJECTORY_CACHE_MB;
 
-	if (PitchSim::Config::LoadEnvConfigFile(ConvertWStringToString(m_EnvConfigFilePath), es))
+	if (envLoaded)
 	{
 		if (es.Pressure_hPa.has_value())
 		{
@@ -704,7 +1065,7 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 			m_Params.Mass_kg = es.Mass_kg.value();
 		}
 		
-		if (es.MsaaCount.has_value())
+		if (initial && es.MsaaCount.has_value())
 		{
 			m_Renderer.SetMSAACount(es.MsaaCount.value());
 		}
@@ -718,12 +1079,208 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 		{
 			m_PlateDistance_m = es.PlateDistance_m.value();
 		}
+
+		if (es.Method.has_value())
+		{
+			m_Params.Method = es.Method.value();
+		}
+
+		if (es.Tolerance_m.has_value())
+		{
+			m_Params.Tolerance_m = es.Tolerance_m.value();
+		}
+
+		if (es.MemoryBudget_MB.has_value())
+		{
+			m_MemoryBudget_MB = es.MemoryBudget_MB.value();
+		}
+
+		if (es.DecimateOverBudget.has_value())
+		{
+			m_DecimateOverBudget = es.DecimateOverBudget.value();
+		}
+
+		if (es.TrajectoryCache_MB.has_value())
+		{
+			cache_MB = es.TrajectoryCache_MB.value();
+		}
+	}
+
+	m_TrajectoryCache.SetBudget(cache_MB * BYTES_PER_MB);
+
+	m_Params.PlateDistance_m = m_PlateDistance_m;
+
+	return envLoaded;
+}
+
+void App::StartConfigWatch()
+{
+	m_ConfigWatcher.Stop();
+
+	//ĎłȂĂ\͑̂ŁAm点邾ɂ
+	if (!m_ConfigWatcher.Watch(ConvertWStringToString(m_EnvConfigFilePath)) || !m_ConfigWatcher.Watch(ConvertWStringToString(m_PitchConfigFilePath)))
+	{
+		m_ConfigWatcher.Stop();
+		OutputDebugStringA("config watch unavailable; edits to the config files need a restart\n");
+	}
+}
+
+void App::PollConfigChanges()
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	if (m_ConfigWatcher.Poll(m_WatchChanged))
+	{
+		for (const std::size_t id : m_WatchChanged)
+		{
+			m_EnvChanged |= (id == ENV_WATCH_ID);
+			m_PitchesChanged |= (id == PITCH_WATCH_ID);
+		}
+
+		m_ReloadDue = now + CONFIG_RELOAD_DELAY;
+	}
+
+	if ((m_EnvChanged || m_PitchesChanged) && now >= m_ReloadDue)
+	{
+		HotReloadConfig();
+	}
+}
+
+void App::HotReloadConfig()
+{
+	using namespace PitchSim::Config;
+
+	PITCHSIM_PROFILE_SCOPE("HotReloadConfig");
+
+	const bool envChanged = m_EnvChanged;
+	const bool pitchesChanged = m_PitchesChanged;
+	m_EnvChanged = false;
+	m_PitchesChanged = false;
+
+	bool rebuild = false;
+
+	if (envChanged)
+	{
+		const SimParams previousParams = m_Params;
+		const double previousPlate_m = m_PlateDistance_m;
+		const std::uint64_t previousBudget_MB = m_MemoryBudget_MB;
+		const bool previousDecimate = m_DecimateOverBudget;
+
+		if (LoadEnvironment(false))
+		{
+			//̕ύX͑SɌ̂ŁASxɃ[J[֓ĕɌvZ
+			rebuild = !(m_Params == previousParams) || m_MemoryBudget_MB != previousBudget_MB || m_DecimateOverBudget != previousDecimate;
+
+			if (m_PlateDistance_m != previousPlate_m)
+			{
+				BuildGroundGrid();
+				m_Camera.SetCenter(XMFLOAT3(m_PlateDistance_m / 2.0f, 0.0f, 0.0f));
+			}
+
+			BuildStrikeZone();
+			Recompute();
+		}
+		else
+		{
+			OutputDebugStringA("envconfig reload failed; keeping the current environment\n");
+		}
+	}
+
+	std::vector<PitchEntry> next;
+
+	if (pitchesChanged)
+	{
+		std::vector<ParseError> errors;
+
+		if (LoadPitchList(next, errors))
+		{
+			rebuild = true;
+		}
+		else
+		{
+			OutputDebugStringA("pitch list reload failed; keeping the current pitches\n");
+			next = m_Pitches;
+		}
+	}
+	else
+	{
+		next = m_Pitches;
+	}
+
+	if (rebuild)
+	{
+		ApplyPitchList(std::move(next));
+	}
+
+	m_FrameScheduler.Invalidate(RedrawReason::Data);
+}
+
+bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
+{
+	m_StartupBegin = std::chrono::steady_clock::now();
+
+	WNDCLASSEX wc{ sizeof(WNDCLASSEX) };
+	wc.style = CS_CLASSDC;
+	wc.lpfnWndProc = WndProc;
+	wc.hInstance = hInstance;
+	wc.lpszClassName = WINDOW_CLASS_NAME;
+
+	wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+
+	if (!RegisterClassEx(&wc))
+	{
+		return false;
+	}
+
+	UINT w = 1280;
+	UINT h = 720;
+	RECT rc{ 0, 0, static_cast<LONG>(w), static_cast<LONG>(h) };
+	AdjustWindowRect(&rc, WS_OVERLAPPEDWINDOW, FALSE);
+	m_HWND = CreateWindow(WINDOW_CLASS_NAME, L"Pitch Trajectory - DirectX 11", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, rc.right - rc.left, rc.bottom - rc.top, nullptr, nullptr, hInstance, nullptr);
+
+	if (!m_HWND)
+	{
+		return false;
+	}
+
+	m_SamplerRng.Seed(static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) ^ static_cast<std::uint64_t>(__rdtsc()));
+
+	Profiler::SetThreadName("main");
+
+	auto c = GetValueForKey(L"env", param);
+	auto p = GetValueForKey(L"pitch", param);
+	auto tr = GetValueForKey(L"trace", param);
+
+	if (c.has_value())
+	{
+		m_EnvConfigFilePath = c.value();
+	}
+
+	if (p.has_value())
+	{
+		m_PitchConfigFilePath = p.value();
+	}
+
+	if (tr.has_value())
+	{
+		m_TraceFilePath = tr.value();
 	}
 
+	ShowWindow(m_HWND, SW_SHOW);
+
+	LoadEnvironment(true);
+
 	if (!m_Renderer.Initialize(m_HWND, w, h))
 	{
-		return false;
+		return false;
+	}
+
+	std::vector<XMFLOAT4> palette(DxRenderer::PALETTE_SIZE);
+	for (std::size_t k = 0; k < palette.size(); ++k)
+	{
+		palette[k] = Palette(k);
 	}
+	m_Renderer.SetPalette(palette.data(), palette.size());
 
 	m_Camera.SetViewportSize(w, h);
 	m_Camera.SetProjection(60.0f, 0.01f, 500.0f);
@@ -731,6 +1288,13 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 	m_Camera.SetRadiusLimits(3.0f, 60.0f);
 	
 	BuildGroundGrid();
+	BuildStrikeZone();
+
+	//̌vZ҂ɒnʂƃXgCN][̍ŏ̃t[o
+	m_LastTick = std::chrono::steady_clock::now();
+	RenderFrame();
+	m_FrameScheduler.OnFrameRendered(FrameScheduler::Clock::now());
+	m_FirstFrame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartupBegin).count();
 
 	try
 	{
@@ -741,7 +1305,7 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 		return false;
 	}
 
-	BuildStrikeZone();
+	StartConfigWatch();
 
 	Recompute();
 
@@ -752,53 +1316,108 @@ bool App::Initialize(HINSTANCE hInstance, std::vector<AppParam>& param)
 
 void App::Recompute()
 {
-	std::vector<Float3> pts;
-	m_Simulator.Simulate(m_Params, pts);
+	PITCHSIM_PROFILE_SCOPE("Recompute");
+
+	auto& pts = m_RecomputePts;
+	{
+		PITCHSIM_PROFILE_SCOPE("Simulate");
+		m_Simulator.Simulate(m_Params, pts);
+	}
+
+	RetessellateLine();
+}
+
+bool App::IsTessellationStale() const noexcept
+{
+	if (m_RecomputePts.size() < 4 || m_Subdivide <= 1)
+	{
+		return false;
+	}
+
+	const XMFLOAT3 eye = m_Camera.GetEyePosition();
+	const XMFLOAT3 center = m_Camera.GetCenter();
+	const float radius = std::hypot(eye.x - center.x, eye.y - center.y, eye.z - center.z);
+	const float moved = std::hypot(eye.x - m_TessEye.X, eye.y - m_TessEye.Y, eye.z - m_TessEye.Z);
+
+	const float pixelScale = PolylineSimplifier::PixelScaleFor(m_Camera.GetFovYDeg(), m_Renderer.GetHeight());
+
+	return moved > RETESSELLATE_VIEW_RATIO * radius || std::abs(pixelScale - m_TessPixelScale) > RETESSELLATE_VIEW_RATIO * m_TessPixelScale;
+}
+
+void App::RetessellateLine()
+{
+	PITCHSIM_PROFILE_SCOPE("RetessellateLine");
 
-	std::vector<Float3> drawPts;
+	const auto& pts = m_RecomputePts;
+	auto& drawPts = m_RecomputeDrawPts;
 	if (pts.size() < 4 || m_Subdivide <= 1)
 	{
 		drawPts = pts;
 	}
 	else
 	{
-		drawPts.reserve(pts.size() * static_cast<std::size_t>(m_Subdivide));
-		const int n = static_cast<int>(pts.size());
-		for (int i = 0; i < n - 1; ++i)
+		PITCHSIM_PROFILE_SCOPE("Tessellate");
+
+		const XMFLOAT3 eye = m_Camera.GetEyePosition();
+
+		TessellationParams tp{};
+		tp.MaxSubdivide = m_Subdivide;
+		tp.Eye = Float3{ eye.x, eye.y, eye.z };
+		tp.PixelScale = PolylineSimplifier::PixelScaleFor(m_Camera.GetFovYDeg(), m_Renderer.GetHeight());
+
+		m_TessEye = tp.Eye;
+		m_TessPixelScale = tp.PixelScale;
+
+		// ZOg`NɕAe`N̉ϒo͂ɘA
+		const std::size_t segs = pts.size() - 1;
+		const std::size_t chunkCount = std::min<std::size_t>(segs, static_cast<std::size_t>(m_Scheduler.WorkerCount()) * 4);
+		const std::size_t chunkSize = (segs + chunkCount - 1) / chunkCount;
+		while (m_RecomputeChunks.size() < chunkCount)
 		{
-			const Float3& p0 = ClampIdx(pts, i - 1);
-			const Float3& p1 = ClampIdx(pts, i);
-			const Float3& p2 = ClampIdx(pts, i + 1);
-			const Float3& p3 = ClampIdx(pts, i + 2);
+			m_RecomputeChunks.emplace_back(MemoryTracker::Resource(MemoryTag::Tessellation));
+		}
 
-			for (int s = 0; s < m_Subdivide; ++s)
+		m_Scheduler.ParallelFor(0, chunkCount, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t c = begin; c < end; ++c)
 			{
-				float t = static_cast<float>(s) / static_cast<float>(m_Subdivide);
-				drawPts.emplace_back(CatmullRom(p0, p1, p2, p3, t));
+				auto& chunk = m_RecomputeChunks[c];
+				chunk.clear();
+				SplineTessellator::TessellateRange(pts, c * chunkSize, std::min(segs, (c + 1) * chunkSize), tp, chunk);
 			}
-		}
+		});
 
+		drawPts.clear();
+		for (std::size_t c = 0; c < chunkCount; ++c)
+		{
+			drawPts.insert(drawPts.end(), m_RecomputeChunks[c].begin(), m_RecomputeChunks[c].end());
+		}
 		drawPts.emplace_back(pts.back());
 	}
 
-	m_Vertices.clear();
-	m_Vertices.reserve(drawPts.size());
-
 	const std::size_t n = drawPts.size();
-	for (std::size_t i = 0; i < n; ++i)
+	m_Vertices.resize(n);
+
+	m_Scheduler.ParallelFor(0, n, [&](std::size_t begin, std::size_t end)
 	{
-		float t = (n > 1) ? static_cast<float>(i) / static_cast<float>(n - 1) : 0.0f;
-		XMFLOAT4 col
+		PITCHSIM_PROFILE_SCOPE("Colorize");
+
+		for (std::size_t i = begin; i < end; ++i)
 		{
-			0.1f * (1.0f - t) + 0.8f * t,
-			0.9f * (1.0f - t) + 1.0f * t,
-			1.0f,
-			1.0f
-		};
+			float t = (n > 1) ? static_cast<float>(i) / static_cast<float>(n - 1) : 0.0f;
+			XMFLOAT4 col
+			{
+				0.1f * (1.0f - t) + 0.8f * t,
+				0.9f * (1.0f - t) + 1.0f * t,
+				1.0f,
+				1.0f
+			};
 
-		m_Vertices.emplace_back(DxRenderer::Vertex{ XMFLOAT3{drawPts[i].X, drawPts[i].Y, drawPts[i].Z}, col });
-	}
+			m_Vertices[i] = DxRenderer::Vertex{ XMFLOAT3{drawPts[i].X, drawPts[i].Y, drawPts[i].Z}, col };
+		}
+	}, 4096);
 
+	PITCHSIM_PROFILE_SCOPE("UploadLine");
 	m_Renderer.UploadLineVertices(m_Vertices);
 }
 
@@ -813,10 +1432,16 @@ void App::UpdateAnimation(double dt_s)
 
 	bool allDone = true;
 
-	for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
+	for (std::size_t i = 0; i < m_Trajectories.size(); ++i)
 	{
-		const auto& verts = m_TrajectoryVertsList[i];
-		const std::size_t n = verts.size();
+		const std::size_t n = m_Trajectories[i].Samples.size();
+		const bool streaming = IsStreaming(i);
+
+		if (streaming)
+		{
+			allDone = false;
+		}
+
 		if (n <= 1)
 		{
 			m_VisibleCounts[i] = static_cast<std::size_t>(n);
@@ -827,7 +1452,13 @@ void App::UpdateAnimation(double dt_s)
 		{
 			m_TimeElapsed_s[i] += dtSim;
 
-			std::size_t count = static_cast<size_t>(m_TimeElapsed_s[i] / m_Params.Dt_s) + 1;
+			//vZǂĂȂԂ͓ς݂̓_܂łŎ~߂
+			if (streaming)
+			{
+				m_TimeElapsed_s[i] = std::min(m_TimeElapsed_s[i], static_cast<double>(n - 1) * m_Streams[i].Dt_s);
+			}
+
+			std::size_t count = static_cast<size_t>(m_TimeElapsed_s[i] / m_Streams[i].Dt_s) + 1;
 
 			if (count > n)
 			{
@@ -864,138 +1495,412 @@ int App::Run(std::vector<AppParam>& param)
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
+			continue;
 		}
-		else
+
+		PollConfigChanges();
+
+		m_FrameScheduler.SetContinuous(m_Animate || m_ActiveStreamCount > 0);
+
+		const auto decision = m_FrameScheduler.Poll(FrameScheduler::Clock::now());
+		if (!decision.RenderNow)
 		{
-			auto now = std::chrono::steady_clock::now();
-			double dt_s = std::chrono::duration<double>(now - m_LastTick).count();
-			m_LastTick = now;
-			UpdateAnimation(dt_s);
+			//`悪vȂԂ͓͂̕`掞܂ŃXbh𖰂点
+			DWORD waitMs = decision.WaitForever ? INFINITE : static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(decision.Wait).count());
 
-			if (m_PackedDirty)
+			//ݒt@C̕ύXʒmłNBǂݒ҂̊Ԃ͂̎ɋN
+			m_ConfigWatcher.WaitHandles(m_WatchHandles);
+
+			if (m_EnvChanged || m_PitchesChanged)
 			{
-				RebuildPackedVBs();
+				const auto untilReload = std::chrono::ceil<std::chrono::milliseconds>(m_ReloadDue - std::chrono::steady_clock::now()).count();
+				waitMs = std::min(waitMs, static_cast<DWORD>(std::max<long long>(untilReload, 0)));
 			}
 
-			m_Renderer.BeginFrame();
+			MsgWaitForMultipleObjectsEx(static_cast<DWORD>(m_WatchHandles.size()), m_WatchHandles.data(), waitMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+			continue;
+		}
+
+		RenderFrame();
+		m_FrameScheduler.OnFrameRendered(FrameScheduler::Clock::now());
+	}
 
-			DxRenderer::CbScene cb{ XMMatrixTranspose(XMMatrixMultiply(m_Camera.GetViewMatrix(), m_Camera.GetProjMatrix())) };
-			m_Renderer.UpdateSceneCB(cb);
+	WriteProfile();
 
-			m_Renderer.DrawGroundLineList(m_GroundVerts.size());
+	if (MemoryTracker::IsEnabled())
+	{
+		OutputDebugStringA(MemoryTracker::FormatReport().c_str());
+	}
 
-			if (m_ShowStrikeZone)
-			{
-				m_Renderer.DrawStrikeZoneLineList(m_StrikeVerts.size());
-			}
+	return static_cast<int>(msg.wParam);
+}
+
+void App::WriteProfile()
+{
+	if (!Profiler::IsEnabled())
+	{
+		return;
+	}
+
+	const std::string tracePath = ConvertWStringToString(m_TraceFilePath);
+	const std::string summary = Profiler::FormatSummary(Profiler::Summarize());
+
+	OutputDebugStringA(summary.c_str());
+
+	//Wv\̓g[X̉ɃeLXgłc
+	std::ofstream ofs{ tracePath + ".summary.txt", std::ios::binary | std::ios::trunc };
+	ofs << summary;
+
+	if (!Profiler::WriteChromeTrace(tracePath))
+	{
+		OutputDebugStringA("Profiler: failed to write trace file.\n");
+	}
+}
+
+void App::RenderFrame()
+{
+	PITCHSIM_PROFILE_SCOPE("RenderFrame");
+
+	using Ms = std::chrono::duration<double, std::milli>;
+
+	auto now = std::chrono::steady_clock::now();
+	const auto frameStart = now;
+
+	//ҋ@̍ŏ̃t[ŃAj[V΂Ȃ悤oߎԂ}
+	double dt_s = std::min(std::chrono::duration<double>(now - m_LastTick).count(), MAX_FRAME_DT_S);
+	m_LastTick = now;
+
+	PumpStreams();
+	auto t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Pack, Ms(t - now).count());
+	now = t;
+
+	UpdateAnimation(dt_s);
+
+	//e덷͎_̋Ō܂̂ŁAJ傫𕪊
+	if (IsTessellationStale())
+	{
+		RetessellateLine();
+	}
+	t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Update, Ms(t - now).count());
+	now = t;
+
+	m_Renderer.BeginFrame();
+
+	DxRenderer::CbScene cb{ XMMatrixTranspose(XMMatrixMultiply(m_Camera.GetViewMatrix(), m_Camera.GetProjMatrix())) };
+	m_Renderer.UpdateSceneCB(cb);
+
+	m_Renderer.DrawGroundLineList(m_GroundVerts.size());
+
+	XMFLOAT4X4 viewProj{};
+	XMStoreFloat4x4(&viewProj, XMMatrixMultiply(m_Camera.GetViewMatrix(), m_Camera.GetProjMatrix()));
+	const Frustum frustum = Frustum::FromViewProj(&viewProj._11);
+
+	//tB^Ǝňxi荞݁AOEe_ExŋL
+	{
+		PITCHSIM_PROFILE_SCOPE("Cull");
+		SceneCulling::Cull(m_Bounds, m_FilterSingle ? &m_FilterSet : nullptr, frustum, m_CulledIndices);
+	}
+
+	const XMFLOAT3 eye = m_Camera.GetEyePosition();
+	LodView lodView{};
+	lodView.Eye = Float3{ eye.x, eye.y, eye.z };
+	lodView.PixelScale = PolylineSimplifier::PixelScaleFor(m_Camera.GetFovYDeg(), m_Renderer.GetHeight());
+	lodView.NearZ = m_Camera.GetNearZ();
+
+	if (m_ShowStrikeZone)
+	{
+		m_Renderer.DrawStrikeZoneLineList(m_StrikeVerts.size());
+	}
 
-			for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
+	m_PackedIndices.clear();
+	for (std::uint32_t i : m_CulledIndices)
+	{
+		if (IsStreaming(i))
+		{
+			m_Renderer.DrawStreamingTrajectory(i, m_VisibleCounts[i], m_Trajectories[i], m_Streams[i].ExpectedCount);
+		}
+		else
+		{
+			m_PackedIndices.emplace_back(i);
+		}
+	}
+
+	{
+		PITCHSIM_PROFILE_SCOPE("BuildDrawList");
+		SceneCulling::BuildDrawList(m_PackedIndices, m_Trajectories, m_Lods, m_VisibleCounts, lodView, m_DrawList);
+	}
+
+	t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Pack, Ms(t - now).count());
+	now = t;
+
+	{
+		PITCHSIM_PROFILE_SCOPE("DrawTrajectories");
+		m_Renderer.DrawPackedTrajectories(m_DrawList);
+	}
+
+	if (m_ShowBalls)
+	{
+		PITCHSIM_PROFILE_SCOPE("DrawSpots");
+
+		m_SpotIndices.clear();
+		for (std::uint32_t i : m_PackedIndices)
+		{
+			const auto& samples = m_Trajectories[i].Samples;
+			const bool finished = (!m_Animate) || (i < m_VisibleCounts.size() && m_VisibleCounts[i] >= samples.size());
+			if (finished && i < m_CircleVertsList.size() && !m_CircleVertsList[i].empty())
 			{
-				if (m_FilterSingle && !std::ranges::contains(m_FilterIndexList, i))
-				{
-					continue;
-				}
-				m_Renderer.DrawPackedTrajectory(i, m_VisibleCounts[i]);
+				m_SpotIndices.emplace_back(i);
 			}
+		}
+
+		m_Renderer.DrawPackedSpots(m_SpotIndices);
+	}
+
+	t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Draw, Ms(t - now).count());
+	now = t;
+
+	if (m_ShowLabels)
+	{
+		DrawLabels(viewProj);
+	}
+
+	const std::uint64_t allocs = AllocCounter::Allocations();
+	m_LastFrameAllocs = allocs - m_FrameAllocMark;
+
+	if (m_ShowStats)
+	{
+		PITCHSIM_PROFILE_SCOPE("StatsOverlay");
+		DrawStatsOverlay();
+		m_StatsSelfAllocs += AllocCounter::Allocations() - allocs;
+	}
+
+	if (!m_PitchNotice.empty() || !m_EnvNotice.empty())
+	{
+		DrawConfigNotice();
+	}
+
+	m_FrameAllocMark = AllocCounter::Allocations();
+
+	t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Text, Ms(t - now).count());
+	now = t;
+
+	{
+		PITCHSIM_PROFILE_SCOPE("Present");
+		m_Renderer.EndFrame();
+	}
+
+	t = std::chrono::steady_clock::now();
+	m_FrameTimings.Add(FramePhase::Draw, Ms(t - now).count());
+	m_FrameTimings.Add(FramePhase::Total, Ms(t - frameStart).count());
+	m_FrameTimings.CommitFrame();
+}
+
+void App::RebuildLabelText()
+{
+	const std::size_t n = m_Trajectories.size();
+	m_Renderer.ResetTextLabels(n);
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		std::wstring label = (i < m_Pitches.size()) ? Utf8ToWString(m_Pitches[i].Label) : std::format(L"Pitch {}", i + 1);
+
+		double speedKmh = (i < m_Pitches.size()) ? m_Pitches[i].Speed_kmh : m_Params.InitialSpeed_mps * 3.6;
+		double rpm = (i < m_Pitches.size()) ? m_Pitches[i].Rpm : m_Params.SpinRPM;
+		double x = (i < m_Pitches.size()) ? m_Pitches[i].Axis.X : m_Params.SpinAxis.X;
+		double y = (i < m_Pitches.size()) ? m_Pitches[i].Axis.Y : m_Params.SpinAxis.Y;
+		double z = (i < m_Pitches.size()) ? m_Pitches[i].Axis.Z : m_Params.SpinAxis.Z;
+		double e = (i < m_Pitches.size()) ? m_Pitches[i].Elevation_deg.has_value() ? m_Pitches[i].Elevation_deg.value() : m_Params.Elevation_deg : m_Params.Elevation_deg;
+		double a = (i < m_Pitches.size()) ? m_Pitches[i].Azimuth_deg.has_value() ? m_Pitches[i].Azimuth_deg.value() : m_Params.Azimuth_deg : m_Params.Azimuth_deg;
+
+		std::wstring text;
+
+		if (!m_ShowDetail)
+		{
+			text = std::format(L"{}: {} {:.0f} km/h {:.0f} RPM", i + 1, label, speedKmh, rpm);
+		}
+		else
+		{
+			text = std::format(L"{}: {} {:.1f} km/h {:.1f} RPM Axis({:.5f}, {:.5f}, {:.5f}) Elevation={:.5f} Azimuth={:.5f}", i + 1, label, speedKmh, rpm, x, y, z, e, a);
+		}
+
+		m_Renderer.SetTextLabel(i, text, LABEL_SIZE_PX);
+	}
+
+	m_LabelTextDirty = false;
+	++m_LabelGeneration;
+}
+
+void App::DrawLabels(const XMFLOAT4X4& viewProj)
+{
+	PITCHSIM_PROFILE_SCOPE("DrawLabels");
+
+	if (m_LabelTextDirty)
+	{
+		RebuildLabelText();
+	}
+
+	m_LabelKey.Ids.clear();
 
-			if (m_ShowBalls)
+	for (std::uint32_t i : m_PackedIndices)
+	{
+		const auto& traj = m_Trajectories[i];
+		if (traj.Samples.empty() || IsStreaming(i))
+		{
+			continue;
+		}
+
+		const bool finished = (!m_Animate) || (i >= m_VisibleCounts.size()) || (m_VisibleCounts[i] >= traj.Samples.size());
+		if (finished)
+		{
+			m_LabelKey.Ids.emplace_back(i);
+		}
+	}
+
+	const std::uint32_t w = m_Renderer.GetWidth();
+	const std::uint32_t h = m_Renderer.GetHeight();
+
+	m_LabelKey.Generation = m_LabelGeneration;
+	m_LabelKey.ViewWidth = w;
+	m_LabelKey.ViewHeight = h;
+	std::memcpy(m_LabelKey.ViewProj.data(), &viewProj, sizeof(viewProj));
+
+	//_EʁEΏہEgׂđOƓȂ瓊ezu蒼Ȃ
+	if (!m_LabelPlacer.IsLayoutCurrent(m_LabelKey))
+	{
+		const auto view = m_Camera.GetViewMatrix();
+		const auto proj = m_Camera.GetProjMatrix();
+
+		m_LabelRequests.clear();
+
+		for (std::uint32_t i : m_LabelKey.Ids)
+		{
+			const auto& traj = m_Trajectories[i];
+			XMFLOAT3 endPos = ToF3(TrajectoryCodec::Decode(traj.Samples.back(), traj.Box));
+			XMFLOAT2 sp{};
+
+			if (!ProjectToScreen(endPos, view, proj, w, h, sp))
 			{
-				for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
-				{
-					if (m_FilterSingle && !std::ranges::contains(m_FilterIndexList, i))
-					{
-						continue;
-					}
-
-					const auto& verts = m_TrajectoryVertsList[i];
-					const bool finished = (!m_Animate) || (i < m_VisibleCounts.size() && m_VisibleCounts[i] >= verts.size());
-					if (finished && i < m_CircleVertsList.size() && !m_CircleVertsList[i].empty())
-					{
-						m_Renderer.DrawPackedSpot(i);
-					}
-				}
+				continue;
 			}
 
-			if (m_ShowLabels)
-			{
-				const auto view = m_Camera.GetViewMatrix();
-				const auto proj = m_Camera.GetProjMatrix();
+			const XMFLOAT2 size = m_Renderer.GetTextLabelSize(i);
+			m_LabelRequests.emplace_back(LabelRequest{ i, sp.x, sp.y, size.x, size.y });
+		}
 
-				m_Renderer.BeginText();
+		m_LabelPlacer.Place(m_LabelKey, m_LabelRequests, m_LabelPlacements);
+	}
 
-				for (std::size_t i = 0; i < m_TrajectoryVertsList.size(); ++i)
-				{
-					if (m_FilterSingle && !std::ranges::contains(m_FilterIndexList, i))
-					{
-						continue;
-					}
-
-					const auto& verts = m_TrajectoryVertsList[i];
-					if (verts.empty())
-					{
-						continue;
-					}
-
-					bool finished = (!m_Animate);
-					if (!finished)
-					{
-						if (i < m_VisibleCounts.size())
-						{
-							finished = (m_VisibleCounts[i] >= verts.size());
-						}
-						else
-						{
-							finished = true;
-						}
-					}
-					if (!finished)
-					{
-						continue;
-					}
-
-					XMFLOAT3 endPos = verts.back().Pos;
-					XMFLOAT2 sp{};
-
-					if (!ProjectToScreen(endPos, view, proj, m_Renderer.GetWidth(), m_Renderer.GetHeight(), sp))
-					{
-						continue;
-					}
-
-					std::wstring label = (i < m_Pitches.size()) ? Utf8ToWString(m_Pitches[i].Label) : std::format(L"Pitch {}", i + 1);
-
-					double speedKmh = (i < m_Pitches.size()) ? m_Pitches[i].Speed_kmh : m_Params.InitialSpeed_mps * 3.6;
-					double rpm = (i < m_Pitches.size()) ? m_Pitches[i].Rpm : m_Params.SpinRPM;
-					double x = (i < m_Pitches.size()) ? m_Pitches[i].Axis.X : m_Params.SpinAxis.X;
-					double y = (i < m_Pitches.size()) ? m_Pitches[i].Axis.Y : m_Params.SpinAxis.Y;
-					double z = (i < m_Pitches.size()) ? m_Pitches[i].Axis.Z : m_Params.SpinAxis.Z;
-					double e = (i < m_Pitches.size()) ? m_Pitches[i].Elevation_deg.has_value() ? m_Pitches[i].Elevation_deg.value() : m_Params.Elevation_deg : m_Params.Elevation_deg;
-					double a = (i < m_Pitches.size()) ? m_Pitches[i].Azimuth_deg.has_value() ? m_Pitches[i].Azimuth_deg.value() : m_Params.Azimuth_deg : m_Params.Azimuth_deg;
-
-					std::wstring text;
-
-					if (!m_ShowDetail)
-					{
-						text = std::format(L"{}: {} {:.0f} km/h {:.0f} RPM", i + 1, label, speedKmh, rpm);
-					}
-					else
-					{
-						text = std::format(L"{}: {} {:.1f} km/h {:.1f} RPM Axis({:.5f}, {:.5f}, {:.5f}) Elevation={:.5f} Azimuth={:.5f}", i + 1, label, speedKmh, rpm, x, y, z, e, a);
-					}
-
-					D2D1_COLOR_F col = D2D1::ColorF(1.0f, 1.0f, 1.0f, 0.98f);
-
-					sp.y -= i * 16.0f;
-					m_Renderer.DrawTextLabel(text, sp.x + 8.0f, sp.y - 18.0f, 18.0f, col);
-				}
+	const D2D1_COLOR_F col = D2D1::ColorF(1.0f, 1.0f, 1.0f, 0.98f);
 
-				m_Renderer.EndText();
-			}
+	m_Renderer.BeginText();
+
+	for (const LabelPlacement& p : m_LabelPlacements)
+	{
+		m_Renderer.DrawTextLabelSlot(p.Id, p.X, p.Y, col);
+	}
+
+	m_Renderer.EndText();
+}
+
+void App::DrawStatsOverlay()
+{
+	const D2D1_COLOR_F col = D2D1::ColorF(1.0f, 1.0f, 0.6f, 0.95f);
+	float y = 8.0f;
+
+	auto line = [&](const std::wstring& text)
+		{
+			m_Renderer.DrawTextLabel(text, 8.0f, y, 14.0f, col);
+			y += 18.0f;
+		};
+
+	m_Renderer.BeginText();
+
+	if (AllocCounter::IsEnabled())
+	{
+		const auto a = AllocCounter::Read();
+		line(std::format(L"allocs: frame {} / re-roll {} / total {} (live {})", m_LastFrameAllocs, m_LastRerollAllocs, a.Allocations, a.Allocations - a.Frees));
+	}
+	else
+	{
+		line(L"allocs: counting disabled");
+	}
+
+	line(std::format(L"scene: {} pitches, {} in view, {} draws, page {}", m_Trajectories.size(), m_CulledIndices.size(), m_DrawList.size(), m_FilterPage + 1));
+
+	line(std::format(L"sim: {} runs, {} steps ({} max), {} force evals, {:.2f} ms avg / {:.2f} ms max",
+		m_SimTotals.Runs, m_SimTotals.Steps, m_SimTotals.MaxSteps, m_SimTotals.ForceEvals, m_SimTotals.MeanWallMs(), static_cast<double>(m_SimTotals.MaxWallNs) * 1e-6));
+	line(std::format(L"sim end: plate {} / ground {} / step cap {} / peak {} points",
+		m_SimTotals.Count(SimTermination::Plate), m_SimTotals.Count(SimTermination::Ground), m_SimTotals.Count(SimTermination::StepCap), m_SimTotals.PeakOutput));
+	line(std::format(L"build: estimate {} samples {:.1f} MB / actual {} samples {:.1f} MB, stride {}, budget {} MB{}",
+		m_BuildPlan.Samples, static_cast<double>(m_BuildPlan.Bytes) / BYTES_PER_MB, m_BuildActualSamples, static_cast<double>(m_BuildActualBytes) / BYTES_PER_MB,
+		m_OutputStride, m_MemoryBudget_MB, m_BuildPlan.OverBudget ? L" (over)" : L""));
+
+	const TrajectoryCacheStats& cache = m_TrajectoryCache.Stats();
+	line(std::format(L"cache: {} hits / {} misses ({:.0f}%), {} entries {:.1f} / {:.0f} MB, {} evictions",
+		cache.Hits, cache.Misses, cache.HitRate() * 100.0, cache.Entries, static_cast<double>(cache.Bytes) / BYTES_PER_MB, static_cast<double>(cache.BudgetBytes) / BYTES_PER_MB, cache.Evictions));
 
-			m_Renderer.EndFrame();
+	if (MemoryTracker::IsEnabled())
+	{
+		for (std::size_t k = 0; k < MemoryTracker::TAG_COUNT; ++k)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(k);
+			const char* name = ToString(tag);
+			const auto m = MemoryTracker::Read(tag);
+			line(std::format(L"mem {}: {:.1f} MB (peak {:.1f}) allocs {}", std::wstring(name, name + std::strlen(name)),
+				static_cast<double>(m.CurrentBytes) / BYTES_PER_MB, static_cast<double>(m.PeakBytes) / BYTES_PER_MB, m.Allocations));
 		}
 	}
 
-	return static_cast<int>(msg.wParam);
+	line(std::format(L"startup: first frame {:.1f} ms / first pitch {:.1f} ms / all ready {:.1f} ms", m_FirstFrame_ms, m_FirstPitch_ms, m_AllReady_ms));
+
+	line(std::format(L"frames: {} rendered, {}", m_FrameScheduler.FramesRendered(), m_FrameScheduler.IsFocused() ? L"focused" : L"background"));
+
+	constexpr std::pair<FramePhase, const wchar_t*> PHASES[] =
+	{
+		{ FramePhase::Update, L"update" },
+		{ FramePhase::Pack, L"pack" },
+		{ FramePhase::Draw, L"draw" },
+		{ FramePhase::Text, L"text" },
+		{ FramePhase::Total, L"total" },
+	};
+
+	for (const auto& [phase, name] : PHASES)
+	{
+		const auto p = m_FrameTimings.Query(phase);
+		line(std::format(L"{}: p50 {:.2f} / p95 {:.2f} / p99 {:.2f} / max {:.2f} ms", name, p.P50, p.P95, p.P99, p.Max));
+	}
+
+	const auto workers = m_Scheduler.GetWorkerStats();
+	for (std::size_t w = 0; w < workers.size(); ++w)
+	{
+		line(std::format(L"worker {}: {:.1f}% tasks {} steals {}", w, workers[w].Utilization * 100.0, workers[w].TasksExecuted, workers[w].Steals));
+	}
+
+	m_Renderer.EndText();
+}
+
+void App::DrawConfigNotice()
+{
+	const D2D1_COLOR_F col = D2D1::ColorF(1.0f, 0.6f, 0.3f, 0.95f);
+	float y = static_cast<float>(m_Renderer.GetHeight()) - 26.0f;
+
+	m_Renderer.BeginText();
+
+	for (const std::wstring* notice : { &m_PitchNotice, &m_EnvNotice })
+	{
+		if (!notice->empty())
+		{
+			m_Renderer.DrawTextLabel(*notice, 8.0f, y, 14.0f, col);
+			y -= 18.0f;
+		}
+	}
+
+	m_Renderer.EndText();
 }
 
 LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -1022,6 +1927,7 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 			m_Renderer.Resize(w, h);
 			m_Camera.SetViewportSize(w, h);
+			m_FrameScheduler.Invalidate(RedrawReason::Resize);
 			return 0;
 		}
 
@@ -1032,6 +1938,7 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			m_MouseDown = true;
 			SetCapture(hwnd);
 			m_Camera.BeginDrag(x, y);
+			m_FrameScheduler.Invalidate(RedrawReason::Input);
 			return 0;
 		}
 
@@ -1042,6 +1949,7 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 				int x = static_cast<int>(LOWORD(lParam));
 				int y = static_cast<int>(HIWORD(lParam));
 				m_Camera.UpdateDrag(x, y);
+				m_FrameScheduler.Invalidate(RedrawReason::Input);
 			}
 
 			return 0;
@@ -1052,6 +1960,7 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			m_MouseDown = false;
 			ReleaseCapture();
 			m_Camera.EndDrag();
+			m_FrameScheduler.Invalidate(RedrawReason::Input);
 			return 0;
 		}
 
@@ -1059,19 +1968,19 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		{
 			int delta = GET_WHEEL_DELTA_WPARAM(wParam);
 			m_Camera.OnMouseWheel(delta);
+			m_FrameScheduler.Invalidate(RedrawReason::Input);
 			return 0;
 		}
 
 		case WM_KEYDOWN:
 		{
+			m_FrameScheduler.Invalidate(RedrawReason::Input);
+
 			if (wParam == VK_SPACE)
 			{
 				if (m_FilterSingle)
 				{
-					for (std::size_t i : m_FilterIndexList)
-					{
-						RestartAnimationForIndex(i);
-					}
+					m_FilterSet.ForEach([this](std::size_t i) { RestartAnimationForIndex(i); });
 				}
 				else
 				{
@@ -1084,6 +1993,11 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 				m_ShowLabels = !m_ShowLabels;
 				return 0;
 			}
+			else if (wParam == 'I')
+			{
+				m_ShowStats = !m_ShowStats;
+				return 0;
+			}
 			else if (wParam == 'C')
 			{
 				m_ShowBalls = !m_ShowBalls;
@@ -1091,58 +2005,39 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			}
 			else if ((wParam >= '1' && wParam <= '8') || (wParam >= VK_NUMPAD1 && wParam <= VK_NUMPAD8))
 			{
-				int idx = wParam <= '8' ? static_cast<int>(wParam - '1') : static_cast<int>(wParam - VK_NUMPAD1);
-				if (idx >= 0 && idx < static_cast<int>(m_TrajectoryVertsList.size()))
+				//L[݂͌̃y[W̔ԍƂĈ
+				std::size_t idx = m_FilterPage * FILTER_PAGE_SIZE + (wParam <= '8' ? static_cast<std::size_t>(wParam - '1') : static_cast<std::size_t>(wParam - VK_NUMPAD1));
+				if (idx < m_Trajectories.size())
 				{
 					m_FilterSingle = true;
-
-					if (!std::ranges::contains(m_FilterIndexList, idx))
-					{
-						m_FilterIndexList.emplace_back(idx);
-					}
-					else
-					{
-						m_FilterIndexList.erase(std::remove(m_FilterIndexList.begin(), m_FilterIndexList.end(), idx));
-					}
-
-					for (auto i : m_FilterIndexList)
-					{
-						RestartAnimationForIndex(i);
-					}
+					m_FilterSet.Toggle(idx);
+					m_FilterSet.ForEach([this](std::size_t i) { RestartAnimationForIndex(i); });
 				}
 
 				return 0;
 			}
 			else if (wParam >= VK_F1 && wParam <= VK_F8)
 			{
-				int idx = static_cast<int>(wParam - VK_F1);
-				if (idx >= 0 && idx < static_cast<int>(m_TrajectoryVertsList.size()))
+				std::size_t idx = m_FilterPage * FILTER_PAGE_SIZE + static_cast<std::size_t>(wParam - VK_F1);
+				if (idx < m_Trajectories.size())
 				{
 					m_FilterSingle = true;
-
-					if (!std::ranges::contains(m_FilterIndexList, idx))
-					{
-						m_FilterIndexList.emplace_back(idx);
-					}
-					else
-					{
-						m_FilterIndexList.erase(std::remove(m_FilterIndexList.begin(), m_FilterIndexList.end(), idx));
-					}
-
-					for (auto i : m_FilterIndexList)
-					{
-						RestartAnimationForIndexWithoutRecompute(i);
-					}
+					m_FilterSet.Toggle(idx);
+					m_FilterSet.ForEach([this](std::size_t i) { RestartAnimationForIndexWithoutRecompute(i); });
 				}
 
 				return 0;
 			}
+			else if (wParam == VK_PRIOR || wParam == VK_NEXT)
+			{
+				const std::size_t pages = std::max<std::size_t>(1, (m_Trajectories.size() + FILTER_PAGE_SIZE - 1) / FILTER_PAGE_SIZE);
+				m_FilterPage = (wParam == VK_NEXT) ? (m_FilterPage + 1) % pages : (m_FilterPage + pages - 1) % pages;
+
+				return 0;
+			}
 			else if (wParam == VK_F9)
 			{
-				for (auto i : m_FilterIndexList)
-				{
-					RestartAnimationForIndexWithoutRecompute(i);
-				}
+				m_FilterSet.ForEach([this](std::size_t i) { RestartAnimationForIndexWithoutRecompute(i); });
 
 				return 0;
 			}
@@ -1155,13 +2050,14 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			else if (wParam == VK_TAB)
 			{
 				m_ShowDetail = !m_ShowDetail;
+				m_LabelTextDirty = true;
 
 				return 0;
 			}
 			else if (wParam == '0' || wParam == VK_NUMPAD0)
 			{
 				m_FilterSingle = false;
-				m_FilterIndexList.clear();
+				m_FilterSet.ClearAll();
 
 				RestartAnimationForAll();
 
@@ -1170,7 +2066,7 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			else if (wParam == '9' || wParam == VK_NUMPAD9)
 			{
 				m_FilterSingle = true;
-				m_FilterIndexList.clear();
+				m_FilterSet.ClearAll();
 				RestartAnimationForAll();
 				return 0;
 			}
@@ -1229,13 +2125,19 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			}
 			else if (wParam == 'R')
 			{
+				if (m_Trajectories.empty())
+				{
+					return 0;
+				}
+
 				static std::random_device r{};
-				static std::uniform_int_distribution<int> g{ 0, static_cast<int>(m_TrajectoryVertsList.size()) - 1};
+				std::uniform_int_distribution<std::size_t> g{ 0, m_Trajectories.size() - 1 };
 
+				const std::size_t idx = g(r);
 				m_FilterSingle = true;
-				m_FilterIndexList.clear();
-				m_FilterIndexList.emplace_back(g(r));
-				RestartAnimationForIndex(m_FilterIndexList[0]);
+				m_FilterSet.ClearAll();
+				m_FilterSet.Set(idx, true);
+				RestartAnimationForIndex(idx);
 				return 0;
 			}
 			else
@@ -1244,6 +2146,20 @@ LRESULT App::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			}
 		}
 
+		case WM_SETFOCUS:
+		case WM_KILLFOCUS:
+		{
+			m_FrameScheduler.SetFocused(msg == WM_SETFOCUS);
+			return 0;
+		}
+
+		case WM_PAINT:
+		{
+			ValidateRect(hwnd, nullptr);
+			m_FrameScheduler.Invalidate(RedrawReason::Resize);
+			return 0;
+		}
+
 		case WM_DESTROY:
 		{
 			PostQuitMessage(0);
@@ -1326,17 +2242,3 @@ void App::BuildStrikeZone()
 
 	m_Renderer.UploadStrikeZoneVertices(m_StrikeVerts);
 }
-
-double App::GenerateRandom(double min, double max)
-{
-	thread_local std::mt19937_64 gen{ static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) ^ static_cast<uint64_t>(__rdtsc())};
-	std::uniform_real_distribution<double> dist{ min, max };
-	return dist(gen);
-}
-
-void App::RebuildPackedVBs()
-{
-	m_Renderer.BuildPackedTrajectories(m_TrajectoryVertsList);
-	m_Renderer.BuildPackedSpots(m_CircleVertsList);
-	m_PackedDirty = false;
-}
\ No newline at end of file
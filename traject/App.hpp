@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <chrono>
@@ -16,7 +17,19 @@
 #include "DxRenderer.hpp"
 #include "Camera.hpp"
 #include "TrajectorySimulator.hpp"
+#include "CostEstimator.hpp"
+#include "MemoryTracker.hpp"
+#include "TrajectoryStream.hpp"
+#include "TaskScheduler.hpp"
+#include "SceneCulling.hpp"
+#include "LabelLayout.hpp"
+#include "FrameScheduler.hpp"
 #include "PitchConfig.hpp"
+#include "ConfigDiff.hpp"
+#include "ConfigWatcher.hpp"
+#include "PitchSampler.hpp"
+#include "TrajectoryCache.hpp"
+#include "TrajectoryPipeline.hpp"
 #include "Physics.hpp"
 
 struct AppParam
@@ -33,7 +46,7 @@ class App
 public:
 	App() = default;
 	App(const App&) = delete;
-	~App() = default;
+	~App();
 
 	App& operator=(const App&) = delete;
 
@@ -42,8 +55,6 @@ public:
 
 	LRESULT HandleMessage(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam);
 
-	static double GenerateRandom(double min, double max);
-
 	inline double GetPlateDistance()
 	{
 		return m_PlateDistance_m;
@@ -51,9 +62,17 @@ public:
 
 private:
 	void Recompute();
+	void RetessellateLine();
+	bool IsTessellationStale() const noexcept;
 	void BuildGroundGrid();
 	void UpdateAnimation(double dt_s);
 	void ReloadConfigAndBuild();
+	bool LoadPitchList(std::vector<PitchSim::Config::PitchEntry>& outList, std::vector<PitchSim::Config::ParseError>& errors);
+	void ApplyPitchList(std::vector<PitchSim::Config::PitchEntry>&& next);
+	bool LoadEnvironment(bool initial);
+	void StartConfigWatch();
+	void PollConfigChanges();
+	void HotReloadConfig();
 	void RestartAnimationForIndex(std::size_t i) noexcept;
 	void RestartAnimationForAll() noexcept;
 	void BuildStrikeZone();
@@ -62,21 +81,57 @@ private:
 	void RestartAnimationForIndexWithoutRecompute(std::size_t i) noexcept;
 	void RestartAnimationForAllWithoutRecompute() noexcept;
 
-	void RebuildPackedVBs();
+	PitchSim::SimParams ResolveParamsForIndex(std::size_t i);
+	PitchSim::SimParams ParamsForIndex(std::size_t i) const;
+	void BuildSpotForIndex(std::size_t i);
+	void StartStreamForIndex(std::size_t i, const PitchSim::SimParams& p);
+	void CancelStreamForIndex(std::size_t i) noexcept;
+	void CancelAllStreams() noexcept;
+	void FinalizeStreamForIndex(std::size_t i);
+	void RestoreCachedForIndex(std::size_t i, const PitchSim::TrajectoryCache::Entry& cached);
+	void CompleteTrajectoryForIndex(std::size_t i);
+	void OrderByPriority(std::vector<std::uint32_t>& indices, const std::vector<PitchSim::SimParams>& params) const;
+	PitchSim::Frustum ViewFrustum() const;
+	PitchSim::SampleFootprint BuildFootprint() const noexcept;
+	void ReportBuildCost();
+	void ReportStartup();
+	void PumpStreams();
+	bool IsStreaming(std::size_t i) const noexcept;
+	void RenderFrame();
+	void WriteProfile();
+	void DrawStatsOverlay();
+	void DrawConfigNotice();
+	void RebuildLabelText();
+	void DrawLabels(const DirectX::XMFLOAT4X4& viewProj);
+
+	struct PitchStream
+	{
+		std::shared_ptr<PitchSim::TrajectoryStream> Stream;
+		bool Active{ false };
+		std::size_t ExpectedCount{ 0 };
+		double Dt_s{ 0.0 };
+		PitchSim::SimParams Params;
+		PitchSim::SimStats Stats;
+		bool Complete{ false };
+		bool Cacheable{ false };
+	};
 
 	std::wstring m_EnvConfigFilePath{ L"envconfig.txt" };
 	std::wstring m_PitchConfigFilePath{ L"pitches.txt" };
+	std::wstring m_TraceFilePath{ L"trace.json" };
 
 	HWND m_HWND{ nullptr };
 	DxRenderer m_Renderer;
 	OrbitCamera m_Camera;
 	PitchSim::TrajectorySimulator m_Simulator;
-	std::vector<DxRenderer::Vertex> m_Vertices;
+	std::pmr::vector<DxRenderer::Vertex> m_Vertices{ PitchSim::MemoryTracker::Resource(PitchSim::MemoryTag::Tessellation) };
 	std::vector<DxRenderer::Vertex> m_GroundVerts;
 	std::vector<std::size_t> m_VisibleCounts;
 	std::vector<PitchSim::Config::PitchEntry> m_Pitches;
+	std::vector<PitchSim::PitchSampler> m_Samplers;
+	PitchSim::SamplerRng m_SamplerRng;
 	std::vector<DxRenderer::Vertex> m_StrikeVerts;
-	std::vector<std::vector<DxRenderer::Vertex>> m_CircleVertsList;
+	std::vector<std::pmr::vector<DxRenderer::Vertex>> m_CircleVertsList;
 
 	bool m_ShowStrikeZone{ true };
 	PitchSim::SimParams m_Params;
@@ -87,7 +142,8 @@ private:
 	bool m_ShowDetail{ false };
 	double m_StrikeZoneHeight_m;
 	double m_StrikeZoneSizeHeight_m;
-	std::vector<std::size_t> m_FilterIndexList;
+	PitchSim::VisibilitySet m_FilterSet;
+	std::size_t m_FilterPage{ 0 };
 	int m_Subdivide{ 8 };
 	double m_PlateDistance_m{ 18.44 };
 
@@ -97,10 +153,73 @@ private:
 	bool m_Animate{ true };
 	std::chrono::steady_clock::time_point m_LastTick;
 
+	std::chrono::steady_clock::time_point m_StartupBegin;
+	double m_FirstFrame_ms{ -1.0 };
+	double m_FirstPitch_ms{ -1.0 };
+	double m_AllReady_ms{ -1.0 };
+
 	std::vector<double> m_TimeElapsed_s;
 	std::vector<double> m_TrajDuration_s;
 
-	std::vector<std::vector<DxRenderer::Vertex>> m_TrajectoryVertsList;
+	std::vector<PitchSim::QuantizedTrajectory> m_Trajectories;
+	std::vector<PitchSim::PolylineLod> m_Lods;
+	std::vector<PitchSim::Aabb> m_Bounds;
+	std::vector<PitchSim::PlateResult> m_PlateHits;
+
+	PitchSim::TaskScheduler m_Scheduler;
+	std::vector<PitchStream> m_Streams;
+	std::vector<PitchSim::Float3> m_StreamScratch;
+	std::size_t m_ActiveStreamCount{ 0 };
+	PitchSim::SimStatsTotals m_SimTotals;
+
+	PitchSim::BuildCostPlan m_BuildPlan;
+	std::uint64_t m_MemoryBudget_MB{ 1024 };
+	bool m_DecimateOverBudget{ true };
+	std::uint32_t m_OutputStride{ 1 };
+	bool m_BuildCostReported{ false };
+	std::uint64_t m_BuildActualSamples{ 0 };
+	std::uint64_t m_BuildActualBytes{ 0 };
+
+	PitchSim::TrajectoryCache m_TrajectoryCache;
+
+	PitchSim::ConfigWatcher m_ConfigWatcher;
+	std::vector<std::size_t> m_WatchChanged;
+	std::vector<HANDLE> m_WatchHandles;
+	PitchSim::Config::PitchListDiff m_PitchDiff;
+	std::chrono::steady_clock::time_point m_ReloadDue;
+	bool m_EnvChanged{ false };
+	bool m_PitchesChanged{ false };
+
+	std::pmr::vector<PitchSim::Float3> m_RecomputePts{ PitchSim::MemoryTracker::Resource(PitchSim::MemoryTag::SimPoints) };
+	std::pmr::vector<PitchSim::Float3> m_RecomputeDrawPts{ PitchSim::MemoryTracker::Resource(PitchSim::MemoryTag::Tessellation) };
+	std::vector<std::pmr::vector<PitchSim::Float3>> m_RecomputeChunks;
+	PitchSim::Float3 m_TessEye{};
+	float m_TessPixelScale{ 0.0f };
+
+	std::vector<std::uint32_t> m_CulledIndices;
+	std::vector<std::uint32_t> m_PackedIndices;
+	std::vector<std::uint32_t> m_SpotIndices;
+	std::vector<PitchSim::TrajectoryDraw> m_DrawList;
+
+	PitchSim::FrameScheduler m_FrameScheduler;
+	PitchSim::FrameTimings m_FrameTimings;
+
+	PitchSim::LabelPlacer m_LabelPlacer;
+	bool m_LabelTextDirty{ true };
+	std::uint64_t m_LabelGeneration{ 0 };
+	PitchSim::LabelLayoutKey m_LabelKey;
+	std::vector<PitchSim::LabelRequest> m_LabelRequests;
+	std::vector<PitchSim::LabelPlacement> m_LabelPlacements;
+
+	bool m_ShowStats{ false };
+	std::wstring m_PitchNotice;
+	std::wstring m_EnvNotice;
+	std::uint64_t m_FrameAllocMark{ 0 };
+	std::uint64_t m_LastFrameAllocs{ 0 };
+	std::uint64_t m_RerollAllocMark{ 0 };
+	std::uint64_t m_RerollSelfMark{ 0 };
+	std::uint64_t m_LastRerollAllocs{ 0 };
+	std::uint64_t m_StatsSelfAllocs{ 0 };
 
 	/*
 		V~[VԕύXꍇ
@@ -108,6 +227,4 @@ private:
 		ftHg1.0/3.0ۂ̑x1/3Ƃă_
 	*/
 	double m_TimeScale{ 1.0 / 3.0 };
-
-	bool m_PackedDirty{ false };
 };
\ No newline at end of file
@@ -156,4 +156,14 @@ XMFLOAT3 OrbitCamera::GetEyePosition() const noexcept
 XMFLOAT3 OrbitCamera::GetCenter() const noexcept
 {
 	return m_Center;
+}
+
+float OrbitCamera::GetFovYDeg() const noexcept
+{
+	return m_FovYDeg;
+}
+
+float OrbitCamera::GetNearZ() const noexcept
+{
+	return m_NearZ;
 }
\ No newline at end of file
@@ -33,6 +33,9 @@ public:
 
 	DirectX::XMFLOAT3 GetCenter() const noexcept;
 
+	float GetFovYDeg() const noexcept;
+	float GetNearZ() const noexcept;
+
 private:
 	float m_YawRad;
 	float m_PitchRad;
@@ -0,0 +1,168 @@
+#include "ConfigDiff.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <unordered_map>
+
+namespace PitchSim::Config
+{
+	namespace
+	{
+		struct FieldView
+		{
+			bool IsRandom;
+			std::optional<double> Fixed;
+			std::optional<double> Min;
+			std::optional<double> Max;
+		};
+
+		constexpr std::size_t FIELD_COUNT = PITCH_FIELD_COUNT;
+
+		inline void Fields(const PitchEntry& e, FieldView (&out)[FIELD_COUNT]) noexcept
+		{
+			out[0] = FieldView{ e.IsRandomSpeed, e.Speed_kmh, e.SpeedMin, e.SpeedMax };
+			out[1] = FieldView{ e.IsRandomAxisX, e.Axis.X, e.XMin, e.XMax };
+			out[2] = FieldView{ e.IsRandomAxisY, e.Axis.Y, e.YMin, e.YMax };
+			out[3] = FieldView{ e.IsRandomAxisZ, e.Axis.Z, e.ZMin, e.ZMax };
+			out[4] = FieldView{ e.IsRandomRpm, e.Rpm, e.RpmMin, e.RpmMax };
+			out[5] = FieldView{ e.IsRandomRelease, e.Release_cm, e.ReleaseMin, e.ReleaseMax };
+			out[6] = FieldView{ e.IsRandomElevation, e.Elevation_deg, e.ElevationMin, e.ElevationMax };
+			out[7] = FieldView{ e.IsRandomAzimuth, e.Azimuth_deg, e.AzimuthMin, e.AzimuthMax };
+		}
+
+		inline void Mix(std::uint64_t& h, std::uint64_t v) noexcept
+		{
+			h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+		}
+
+		inline void Mix(std::uint64_t& h, const std::optional<double>& v) noexcept
+		{
+			Mix(h, v.has_value() ? std::bit_cast<std::uint64_t>(*v + 0.0) : 0x7FF8DEADBEEF0001ull);
+		}
+
+		inline void MixValue(std::uint64_t& h, double v) noexcept
+		{
+			Mix(h, std::bit_cast<std::uint64_t>(v + 0.0));
+		}
+	}
+
+	bool SameDefinition(const PitchEntry& a, const PitchEntry& b) noexcept
+	{
+		FieldView fa[FIELD_COUNT];
+		FieldView fb[FIELD_COUNT];
+		Fields(a, fa);
+		Fields(b, fb);
+
+		for (std::size_t k = 0; k < FIELD_COUNT; ++k)
+		{
+			if (fa[k].IsRandom != fb[k].IsRandom)
+			{
+				return false;
+			}
+
+			const bool same = fa[k].IsRandom ? (fa[k].Min == fb[k].Min && fa[k].Max == fb[k].Max && a.Sampling[k] == b.Sampling[k]) : (fa[k].Fixed == fb[k].Fixed);
+			if (!same)
+			{
+				return false;
+			}
+		}
+
+		return a.IsRandomAxisSphere == b.IsRandomAxisSphere && a.Correlations == b.Correlations;
+	}
+
+	std::uint64_t HashDefinition(const PitchEntry& e) noexcept
+	{
+		FieldView f[FIELD_COUNT];
+		Fields(e, f);
+
+		std::uint64_t h = 0;
+
+		for (std::size_t k = 0; k < FIELD_COUNT; ++k)
+		{
+			Mix(h, f[k].IsRandom ? 1u : 0u);
+
+			if (f[k].IsRandom)
+			{
+				Mix(h, f[k].Min);
+				Mix(h, f[k].Max);
+				Mix(h, static_cast<std::uint64_t>(e.Sampling[k].Kind));
+				MixValue(h, e.Sampling[k].Mean);
+				MixValue(h, e.Sampling[k].Sigma);
+			}
+			else
+			{
+				Mix(h, f[k].Fixed);
+			}
+		}
+
+		Mix(h, e.IsRandomAxisSphere ? 1u : 0u);
+
+		for (const FieldCorrelation& c : e.Correlations)
+		{
+			Mix(h, (static_cast<std::uint64_t>(c.A) << 8) | static_cast<std::uint64_t>(c.B));
+			MixValue(h, c.Rho);
+		}
+
+		return h;
+	}
+
+	void DiffPitchLists(const std::vector<PitchEntry>& previous, const std::vector<PitchEntry>& next, PitchListDiff& out)
+	{
+		out = PitchListDiff{};
+		out.Source.assign(next.size(), NO_SOURCE);
+
+		std::vector<bool> used(previous.size(), false);
+		const std::size_t common = std::min(previous.size(), next.size());
+
+		for (std::size_t i = 0; i < common; ++i)
+		{
+			if (SameDefinition(previous[i], next[i]))
+			{
+				out.Source[i] = static_cast<std::uint32_t>(i);
+				used[i] = true;
+				++out.Matched;
+			}
+		}
+
+		if (out.Matched < next.size())
+		{
+			std::unordered_multimap<std::uint64_t, std::uint32_t> pool;
+			pool.reserve(previous.size() - out.Matched);
+
+			for (std::size_t j = 0; j < previous.size(); ++j)
+			{
+				if (!used[j])
+				{
+					pool.emplace(HashDefinition(previous[j]), static_cast<std::uint32_t>(j));
+				}
+			}
+
+			for (std::size_t i = 0; i < next.size(); ++i)
+			{
+				if (out.Source[i] != NO_SOURCE)
+				{
+					continue;
+				}
+
+				auto [it, end] = pool.equal_range(HashDefinition(next[i]));
+
+				for (; it != end; ++it)
+				{
+					if (SameDefinition(previous[it->second], next[i]))
+					{
+						out.Source[i] = it->second;
+						used[it->second] = true;
+						++out.Matched;
+						++out.Moved;
+						pool.erase(it);
+						break;
+					}
+				}
+			}
+		}
+
+		out.Added = next.size() - out.Matched;
+		out.Removed = previous.size() - out.Matched;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PitchConfig.hpp"
+
+namespace PitchSim::Config
+{
+	constexpr std::uint32_t NO_SOURCE = 0xFFFFFFFFu;
+
+	struct PitchListDiff
+	{
+		std::vector<std::uint32_t> Source;
+		std::size_t Matched{ 0 };
+		std::size_t Moved{ 0 };
+		std::size_t Added{ 0 };
+		std::size_t Removed{ 0 };
+	};
+
+	bool SameDefinition(const PitchEntry& a, const PitchEntry& b) noexcept;
+	std::uint64_t HashDefinition(const PitchEntry& e) noexcept;
+
+	void DiffPitchLists(const std::vector<PitchEntry>& previous, const std::vector<PitchEntry>& next, PitchListDiff& out);
+}
\ No newline at end of file
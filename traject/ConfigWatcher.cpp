@@ -0,0 +1,369 @@
+#include "ConfigWatcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace PitchSim
+{
+	namespace
+	{
+		constexpr std::size_t EVENT_BUFFER_SIZE = 16 * 1024;
+
+		inline void SplitPath(const std::string& path, std::string& dir, std::string& name)
+		{
+			const std::size_t slash = path.find_last_of("/\\");
+
+			if (slash == std::string::npos)
+			{
+				dir = ".";
+				name = path;
+			}
+			else
+			{
+				dir = (slash == 0) ? path.substr(0, 1) : path.substr(0, slash);
+				name = path.substr(slash + 1);
+			}
+		}
+
+		inline bool EqualsName(const std::string& a, const char* b, std::size_t length) noexcept
+		{
+			if (a.size() != length)
+			{
+				return false;
+			}
+
+#ifdef _WIN32
+			for (std::size_t i = 0; i < length; ++i)
+			{
+				const char x = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+				const char y = (b[i] >= 'A' && b[i] <= 'Z') ? static_cast<char>(b[i] - 'A' + 'a') : b[i];
+
+				if (x != y)
+				{
+					return false;
+				}
+			}
+
+			return true;
+#else
+			return std::memcmp(a.data(), b, length) == 0;
+#endif
+		}
+
+		inline void AddUnique(std::vector<std::size_t>& changed, std::size_t id)
+		{
+			if (std::find(changed.begin(), changed.end(), id) == changed.end())
+			{
+				changed.push_back(id);
+			}
+		}
+	}
+
+	struct ConfigWatcher::Directory
+	{
+		std::string Path;
+		std::vector<WatchedFile> Files;
+#ifdef _WIN32
+		HANDLE Handle{ INVALID_HANDLE_VALUE };
+		HANDLE Event{ nullptr };
+		OVERLAPPED Overlapped{};
+		alignas(DWORD) unsigned char Buffer[EVENT_BUFFER_SIZE];
+		bool Pending{ false };
+#else
+		int Wd{ -1 };
+#endif
+	};
+
+	ConfigWatcher::ConfigWatcher() = default;
+
+	ConfigWatcher::~ConfigWatcher()
+	{
+		Stop();
+	}
+
+	ConfigWatcher::Directory* ConfigWatcher::FindDirectory(const std::string& path) noexcept
+	{
+		for (auto& d : m_Directories)
+		{
+			if (d->Path == path)
+			{
+				return d.get();
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool ConfigWatcher::Watch(const std::string& path)
+	{
+		std::string dirPath;
+		std::string name;
+		SplitPath(path, dirPath, name);
+
+		if (name.empty())
+		{
+			return false;
+		}
+
+		Directory* dir = FindDirectory(dirPath);
+
+		if (!dir)
+		{
+			auto created = std::make_unique<Directory>();
+			created->Path = dirPath;
+
+			if (!OpenDirectory(*created))
+			{
+				return false;
+			}
+
+			dir = m_Directories.emplace_back(std::move(created)).get();
+		}
+
+		dir->Files.emplace_back(WatchedFile{ name, m_FileCount++ });
+		return true;
+	}
+
+	void ConfigWatcher::Stop() noexcept
+	{
+		for (auto& d : m_Directories)
+		{
+			CloseDirectory(*d);
+		}
+
+		m_Directories.clear();
+		m_FileCount = 0;
+
+#ifndef _WIN32
+		if (m_Fd >= 0)
+		{
+			close(m_Fd);
+			m_Fd = -1;
+		}
+#endif
+	}
+
+	void ConfigWatcher::MarkChanged(const Directory& dir, const char* name, std::size_t length, std::vector<std::size_t>& changed) const
+	{
+		for (const WatchedFile& f : dir.Files)
+		{
+			if (EqualsName(f.Name, name, length))
+			{
+				AddUnique(changed, f.Id);
+			}
+		}
+	}
+
+	void ConfigWatcher::MarkAll(const Directory& dir, std::vector<std::size_t>& changed) const
+	{
+		for (const WatchedFile& f : dir.Files)
+		{
+			AddUnique(changed, f.Id);
+		}
+	}
+
+#ifdef _WIN32
+	namespace
+	{
+		inline bool IssueRead(HANDLE handle, OVERLAPPED& overlapped, void* buffer) noexcept
+		{
+			const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+			return ReadDirectoryChangesW(handle, buffer, static_cast<DWORD>(EVENT_BUFFER_SIZE), FALSE, filter, nullptr, &overlapped, nullptr) != FALSE;
+		}
+	}
+
+	bool ConfigWatcher::OpenDirectory(Directory& dir)
+	{
+		dir.Handle = CreateFileA(dir.Path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (dir.Handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		dir.Event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		dir.Overlapped = OVERLAPPED{};
+		dir.Overlapped.hEvent = dir.Event;
+		dir.Pending = dir.Event && IssueRead(dir.Handle, dir.Overlapped, dir.Buffer);
+
+		if (!dir.Pending)
+		{
+			CloseDirectory(dir);
+			return false;
+		}
+
+		return true;
+	}
+
+	void ConfigWatcher::CloseDirectory(Directory& dir) noexcept
+	{
+		if (dir.Handle != INVALID_HANDLE_VALUE)
+		{
+			if (dir.Pending)
+			{
+				CancelIo(dir.Handle);
+				DWORD bytes = 0;
+				GetOverlappedResult(dir.Handle, &dir.Overlapped, &bytes, TRUE);
+			}
+
+			CloseHandle(dir.Handle);
+			dir.Handle = INVALID_HANDLE_VALUE;
+		}
+
+		if (dir.Event)
+		{
+			CloseHandle(dir.Event);
+			dir.Event = nullptr;
+		}
+
+		dir.Pending = false;
+	}
+
+	void ConfigWatcher::WaitHandles(std::vector<void*>& out) const
+	{
+		out.clear();
+
+		for (const auto& d : m_Directories)
+		{
+			if (d->Pending)
+			{
+				out.push_back(d->Event);
+			}
+		}
+	}
+
+	bool ConfigWatcher::Poll(std::vector<std::size_t>& changed)
+	{
+		changed.clear();
+
+		for (auto& d : m_Directories)
+		{
+			Directory& dir = *d;
+
+			while (dir.Pending)
+			{
+				DWORD bytes = 0;
+				if (!GetOverlappedResult(dir.Handle, &dir.Overlapped, &bytes, FALSE))
+				{
+					if (GetLastError() != ERROR_IO_INCOMPLETE)
+					{
+						dir.Pending = false;
+					}
+
+					break;
+				}
+
+				if (bytes == 0)
+				{
+					MarkAll(dir, changed);
+				}
+				else
+				{
+					std::size_t offset = 0;
+
+					for (;;)
+					{
+						const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(dir.Buffer + offset);
+						const int wideLength = static_cast<int>(info->FileNameLength / sizeof(wchar_t));
+
+						char name[MAX_PATH * 3];
+						const int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, name, static_cast<int>(sizeof(name)), nullptr, nullptr);
+						if (length > 0)
+						{
+							MarkChanged(dir, name, static_cast<std::size_t>(length), changed);
+						}
+
+						if (info->NextEntryOffset == 0)
+						{
+							break;
+						}
+
+						offset += info->NextEntryOffset;
+					}
+				}
+
+				ResetEvent(dir.Event);
+				dir.Pending = IssueRead(dir.Handle, dir.Overlapped, dir.Buffer);
+			}
+		}
+
+		return !changed.empty();
+	}
+#else
+	bool ConfigWatcher::OpenDirectory(Directory& dir)
+	{
+		if (m_Fd < 0)
+		{
+			m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (m_Fd < 0)
+			{
+				return false;
+			}
+		}
+
+		dir.Wd = inotify_add_watch(m_Fd, dir.Path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		return dir.Wd >= 0;
+	}
+
+	void ConfigWatcher::CloseDirectory(Directory& dir) noexcept
+	{
+		if (m_Fd >= 0 && dir.Wd >= 0)
+		{
+			inotify_rm_watch(m_Fd, dir.Wd);
+		}
+
+		dir.Wd = -1;
+	}
+
+	bool ConfigWatcher::Poll(std::vector<std::size_t>& changed)
+	{
+		changed.clear();
+
+		if (m_Fd < 0)
+		{
+			return false;
+		}
+
+		alignas(inotify_event) char buffer[EVENT_BUFFER_SIZE];
+
+		for (;;)
+		{
+			const ssize_t n = read(m_Fd, buffer, sizeof(buffer));
+			if (n <= 0)
+			{
+				break;
+			}
+
+			for (ssize_t offset = 0; offset < n;)
+			{
+				const auto* ev = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+
+				for (const auto& d : m_Directories)
+				{
+					if (ev->mask & IN_Q_OVERFLOW)
+					{
+						MarkAll(*d, changed);
+					}
+					else if (d->Wd == ev->wd && ev->len > 0)
+					{
+						MarkChanged(*d, ev->name, std::strlen(ev->name), changed);
+					}
+				}
+			}
+		}
+
+		return !changed.empty();
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PitchSim
+{
+	class ConfigWatcher
+	{
+	public:
+		ConfigWatcher();
+		ConfigWatcher(const ConfigWatcher&) = delete;
+		~ConfigWatcher();
+		ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+		bool Watch(const std::string& path);
+		void Stop() noexcept;
+
+		bool Poll(std::vector<std::size_t>& changed);
+
+		std::size_t FileCount() const noexcept { return m_FileCount; }
+
+#ifdef _WIN32
+		void WaitHandles(std::vector<void*>& out) const;
+#else
+		int WaitFd() const noexcept { return m_Fd; }
+#endif
+
+	private:
+		struct Directory;
+
+		struct WatchedFile
+		{
+			std::string Name;
+			std::size_t Id{ 0 };
+		};
+
+		Directory* FindDirectory(const std::string& path) noexcept;
+		bool OpenDirectory(Directory& dir);
+		void CloseDirectory(Directory& dir) noexcept;
+		void MarkChanged(const Directory& dir, const char* name, std::size_t length, std::vector<std::size_t>& changed) const;
+		void MarkAll(const Directory& dir, std::vector<std::size_t>& changed) const;
+
+		std::vector<std::unique_ptr<Directory>> m_Directories;
+		std::size_t m_FileCount{ 0 };
+#ifndef _WIN32
+		int m_Fd{ -1 };
+#endif
+	};
+}
\ No newline at end of file
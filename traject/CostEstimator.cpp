@@ -0,0 +1,139 @@
+#include "CostEstimator.hpp"
+#include "TrajectorySimulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PitchSim
+{
+	namespace
+	{
+		constexpr double PI = 3.14159265358979323846;
+
+		constexpr double FLIGHT_MARGIN = 1.05;
+		constexpr double ADAPTIVE_REFERENCE_STEP_S = 0.05;
+		constexpr double ADAPTIVE_REFERENCE_TOLERANCE_M = 1e-6;
+		constexpr double ADAPTIVE_STEP_CEILING_S = 0.1;
+		constexpr std::uint64_t ADAPTIVE_EVALS_PER_STEP = 6;
+
+		std::uint64_t EvalsPerStep(Integrator method) noexcept
+		{
+			switch (method)
+			{
+				case Integrator::Euler: return 1;
+				case Integrator::Heun: return 2;
+				default: return 4;
+			}
+		}
+	}
+
+	double CostEstimator::EstimateFlightTime(const SimParams& params) noexcept
+	{
+		const double vx = std::max(1.0, params.InitialSpeed_mps * std::cos(params.Elevation_deg * (PI / 180.0)));
+		const TrajectorySimulator::ForceParams f = TrajectorySimulator::MakeForceParams(params);
+		const double k = 0.5 * f.Rho * PI * f.Radius_m * f.Radius_m / f.Mass_kg * DragCoeffFromRPM(f.SpinRPM);
+
+		if (k * params.PlateDistance_m < 1e-9)
+		{
+			return FLIGHT_MARGIN * params.PlateDistance_m / vx;
+		}
+
+		return FLIGHT_MARGIN * std::expm1(k * params.PlateDistance_m) / (k * vx);
+	}
+
+	SimCostEstimate CostEstimator::Estimate(const SimParams& params) noexcept
+	{
+		SimCostEstimate e{};
+		e.Flight_s = EstimateFlightTime(params);
+
+		const double dt = std::max(1e-9, params.Dt_s);
+		const std::uint64_t outputs = static_cast<std::uint64_t>(e.Flight_s / dt) + 1;
+		e.Samples = DecimatedSamples(outputs + 1, std::max<std::uint32_t>(1, params.OutputStride));
+
+		if (params.Method == Integrator::RK45)
+		{
+			const double tol = std::max(1e-12, params.Tolerance_m);
+			const double h = std::min(ADAPTIVE_STEP_CEILING_S, ADAPTIVE_REFERENCE_STEP_S * std::pow(tol / ADAPTIVE_REFERENCE_TOLERANCE_M, 0.2));
+			e.Steps = static_cast<std::uint64_t>(std::ceil(e.Flight_s / h)) + 1;
+			e.ForceEvals = e.Steps * ADAPTIVE_EVALS_PER_STEP + 1;
+		}
+		else
+		{
+			e.Steps = outputs;
+			e.ForceEvals = e.Steps * EvalsPerStep(params.Method);
+		}
+
+		return e;
+	}
+
+	std::uint64_t CostEstimator::DecimatedSamples(std::uint64_t samples, std::uint32_t stride) noexcept
+	{
+		if (samples <= 1 || stride <= 1)
+		{
+			return samples;
+		}
+
+		return (samples - 2) / stride + 2;
+	}
+
+	void CostEstimator::Accumulate(BuildCostPlan& plan, const SimCostEstimate& estimate) noexcept
+	{
+		++plan.Pitches;
+		plan.Steps += estimate.Steps;
+		plan.ForceEvals += estimate.ForceEvals;
+		plan.FullSamples += estimate.Samples;
+		plan.MaxSamples = std::max(plan.MaxSamples, estimate.Samples);
+	}
+
+	std::uint64_t CostEstimator::EstimateBytes(const BuildCostPlan& plan, const SampleFootprint& footprint, std::uint32_t stride) noexcept
+	{
+		stride = std::max<std::uint32_t>(1, stride);
+
+		const std::uint64_t resident = (stride > 1) ? (plan.FullSamples / stride + 2 * plan.Pitches) : plan.FullSamples;
+		const std::uint64_t scratch = DecimatedSamples(plan.MaxSamples, stride) * std::min<std::uint64_t>(footprint.ScratchSlots, plan.Pitches);
+
+		return resident * footprint.ResidentBytes + scratch * footprint.ScratchBytes;
+	}
+
+	void CostEstimator::Finish(BuildCostPlan& plan, const SampleFootprint& footprint, std::uint64_t budgetBytes, double outputDt_s, bool decimate) noexcept
+	{
+		plan.BudgetBytes = budgetBytes;
+		plan.FullBytes = EstimateBytes(plan, footprint, 1);
+		plan.OutputStride = 1;
+		plan.OverBudget = false;
+
+		if (budgetBytes > 0 && plan.FullBytes > budgetBytes)
+		{
+			if (decimate)
+			{
+				const double interval = MAX_OUTPUT_INTERVAL_S / std::max(1e-9, outputDt_s);
+				const std::uint32_t maxStride = static_cast<std::uint32_t>(std::clamp(interval, 1.0, static_cast<double>(MAX_OUTPUT_STRIDE)));
+
+				std::uint32_t lo = 1;
+				std::uint32_t hi = maxStride;
+
+				while (lo < hi)
+				{
+					const std::uint32_t mid = lo + (hi - lo) / 2;
+
+					if (EstimateBytes(plan, footprint, mid) <= budgetBytes)
+					{
+						hi = mid;
+					}
+					else
+					{
+						lo = mid + 1;
+					}
+				}
+
+				plan.OutputStride = lo;
+			}
+
+			plan.OverBudget = EstimateBytes(plan, footprint, plan.OutputStride) > budgetBytes;
+		}
+
+		const std::uint32_t s = plan.OutputStride;
+		plan.Samples = (s > 1) ? (plan.FullSamples / s + 2 * plan.Pitches) : plan.FullSamples;
+		plan.Bytes = EstimateBytes(plan, footprint, s);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Physics.hpp"
+
+namespace PitchSim
+{
+	struct SimCostEstimate
+	{
+		double Flight_s{ 0.0 };
+		std::uint64_t Steps{ 0 };
+		std::uint64_t ForceEvals{ 0 };
+		std::uint64_t Samples{ 0 };
+	};
+
+	struct SampleFootprint
+	{
+		std::uint64_t ResidentBytes{ 0 };
+		std::uint64_t ScratchBytes{ 0 };
+		std::size_t ScratchSlots{ 0 };
+	};
+
+	struct BuildCostPlan
+	{
+		std::size_t Pitches{ 0 };
+		std::uint64_t Steps{ 0 };
+		std::uint64_t ForceEvals{ 0 };
+		std::uint64_t Samples{ 0 };
+		std::uint64_t Bytes{ 0 };
+		std::uint64_t MaxSamples{ 0 };
+		std::uint64_t FullSamples{ 0 };
+		std::uint64_t FullBytes{ 0 };
+		std::uint64_t BudgetBytes{ 0 };
+		std::uint32_t OutputStride{ 1 };
+		bool OverBudget{ false };
+	};
+
+	namespace CostEstimator
+	{
+		constexpr std::uint32_t MAX_OUTPUT_STRIDE = 4096;
+		constexpr double MAX_OUTPUT_INTERVAL_S = 0.005;
+
+		double EstimateFlightTime(const SimParams& params) noexcept;
+		SimCostEstimate Estimate(const SimParams& params) noexcept;
+		std::uint64_t DecimatedSamples(std::uint64_t samples, std::uint32_t stride) noexcept;
+		std::uint64_t EstimateBytes(const BuildCostPlan& plan, const SampleFootprint& footprint, std::uint32_t stride) noexcept;
+
+		void Accumulate(BuildCostPlan& plan, const SimCostEstimate& estimate) noexcept;
+		void Finish(BuildCostPlan& plan, const SampleFootprint& footprint, std::uint64_t budgetBytes, double outputDt_s, bool decimate) noexcept;
+	}
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "DxRenderer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -17,6 +18,7 @@ using namespace DirectX;
 namespace
 {
 	const wchar_t* SHADER_FILE = L"shaders\\Line.hlsl";
+	const wchar_t* TRAJECTORY_SHADER_FILE = L"shaders\\Trajectory.hlsl";
 }
 
 DxRenderer::DxRenderer() : m_Viewport{}, m_Width(0), m_Height(0)
@@ -152,7 +154,7 @@ void DxRenderer::SetMSAACount(int msaa)
 	m_MsaaCount = msaa;
 }
 
-void DxRenderer::UploadLineVertices(const std::vector<Vertex>& vertices)
+void DxRenderer::UploadLineVertices(const std::pmr::vector<Vertex>& vertices)
 {
 	if (!m_Vb)
 	{
@@ -450,6 +452,19 @@ bool DxRenderer::CreateShadersAndInputLayout()
 		return false;
 	}
 
+	ComPtr<ID3DBlob> btvs;
+	hr = D3DCompileFromFile(TRAJECTORY_SHADER_FILE, nullptr, nullptr, "VSMain", "vs_5_0", 0, 0, btvs.GetAddressOf(), err.ReleaseAndGetAddressOf());
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	hr = m_Device->CreateVertexShader(btvs->GetBufferPointer(), btvs->GetBufferSize(), nullptr, m_TrajVs.GetAddressOf());
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
 	D3D11_INPUT_ELEMENT_DESC idec[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
@@ -479,6 +494,20 @@ bool DxRenderer::CreateConstantBuffers()
 		return false;
 	}
 
+	cbd.ByteWidth = sizeof(CbTrajectory);
+	hr = m_Device->CreateBuffer(&cbd, nullptr, m_CbTrajectory.GetAddressOf());
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	cbd.ByteWidth = sizeof(CbPalette);
+	hr = m_Device->CreateBuffer(&cbd, nullptr, m_CbPalette.GetAddressOf());
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
 	return true;
 }
 
@@ -617,26 +646,117 @@ void DxRenderer::DrawTextLabel(const std::wstring& text, float x_px, float y_px,
 		return;
 	}
 
+	IDWriteTextFormat* fmt = GetTextFormat(size_px);
+	if (!fmt)
+	{
+		return;
+	}
+
+	m_D2DBrush->SetColor(color);
+
+	D2D1_RECT_F rc = D2D1::RectF(x_px, y_px, x_px + 800.0f, y_px + size_px * 1.4f);
+
+	D2D1_COLOR_F shadow = D2D1::ColorF{ 0, 0, 0, 0.65f };
+	m_D2DBrush->SetColor(shadow);
+	m_D2DContext->DrawTextW(text.c_str(), static_cast<UINT32>(text.size()), fmt, D2D1::RectF(rc.left + 1.0f, rc.top + 1.0f, rc.right + 1.0f, rc.bottom + 1.0f), m_D2DBrush.Get());
+
+	m_D2DBrush->SetColor(color);
+	m_D2DContext->DrawTextW(text.c_str(), static_cast<UINT32>(text.size()), fmt, rc, m_D2DBrush.Get());
+}
+
+IDWriteTextFormat* DxRenderer::GetTextFormat(float size_px) noexcept
+{
+	if (!m_DWriteFactory)
+	{
+		return nullptr;
+	}
+
+	for (const auto& e : m_TextFormats)
+	{
+		if (e.Size == size_px)
+		{
+			return e.Format.Get();
+		}
+	}
+
 	ComPtr<IDWriteTextFormat> fmt;
 	HRESULT hr = m_DWriteFactory->CreateTextFormat(m_DefaultFont.c_str(), nullptr, DWRITE_FONT_WEIGHT_SEMI_BOLD, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, size_px, L"ja-JP", fmt.GetAddressOf());
 	if (FAILED(hr))
 	{
-		return;
+		return nullptr;
 	}
 
 	fmt->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
 	fmt->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+	fmt->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
 
-	m_D2DBrush->SetColor(color);
+	try
+	{
+		m_TextFormats.emplace_back(TextFormatEntry{ size_px, fmt });
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
 
-	D2D1_RECT_F rc = D2D1::RectF(x_px, y_px, x_px + 800.0f, y_px + size_px * 1.4f);
+	return fmt.Get();
+}
 
-	D2D1_COLOR_F shadow = D2D1::ColorF{ 0, 0, 0, 0.65f };
-	m_D2DBrush->SetColor(shadow);
-	m_D2DContext->DrawTextW(text.c_str(), static_cast<UINT32>(text.size()), fmt.Get(), D2D1::RectF(rc.left + 1.0f, rc.top + 1.0f, rc.right + 1.0f, rc.bottom + 1.0f), m_D2DBrush.Get());
+void DxRenderer::ResetTextLabels(std::size_t slotCount)
+{
+	m_TextLabels.clear();
+	m_TextLabels.resize(slotCount);
+}
+
+void DxRenderer::SetTextLabel(std::size_t slot, const std::wstring& text, float size_px)
+{
+	if (slot >= m_TextLabels.size())
+	{
+		m_TextLabels.resize(slot + 1);
+	}
+
+	TextLabel& label = m_TextLabels[slot];
+	label.Layout.Reset();
+	label.Size = XMFLOAT2{ 0.0f, 0.0f };
+
+	IDWriteTextFormat* fmt = GetTextFormat(size_px);
+	if (!fmt)
+	{
+		return;
+	}
+
+	//`ς݂̃CAEgێĂAt[͂̕Ȃ
+	if (FAILED(m_DWriteFactory->CreateTextLayout(text.c_str(), static_cast<UINT32>(text.size()), fmt, 4096.0f, size_px * 1.4f, label.Layout.GetAddressOf())))
+	{
+		return;
+	}
+
+	DWRITE_TEXT_METRICS tm{};
+	if (SUCCEEDED(label.Layout->GetMetrics(&tm)))
+	{
+		label.Size = XMFLOAT2{ tm.widthIncludingTrailingWhitespace + 1.0f, tm.height + 1.0f };
+	}
+}
+
+XMFLOAT2 DxRenderer::GetTextLabelSize(std::size_t slot) const noexcept
+{
+	return (slot < m_TextLabels.size()) ? m_TextLabels[slot].Size : XMFLOAT2{ 0.0f, 0.0f };
+}
+
+void DxRenderer::DrawTextLabelSlot(std::size_t slot, float x_px, float y_px, const D2D1_COLOR_F& color) noexcept
+{
+	if (!m_D2DContext || !m_D2DBrush || slot >= m_TextLabels.size() || !m_TextLabels[slot].Layout)
+	{
+		return;
+	}
+
+	IDWriteTextLayout* layout = m_TextLabels[slot].Layout.Get();
+
+	m_D2DBrush->SetColor(D2D1::ColorF{ 0, 0, 0, 0.65f });
+	m_D2DContext->DrawTextLayout(D2D1::Point2F(x_px + 1.0f, y_px + 1.0f), layout, m_D2DBrush.Get());
 
 	m_D2DBrush->SetColor(color);
-	m_D2DContext->DrawTextW(text.c_str(), static_cast<UINT32>(text.size()), fmt.Get(), rc, m_D2DBrush.Get());
+	m_D2DContext->DrawTextLayout(D2D1::Point2F(x_px, y_px), layout, m_D2DBrush.Get());
 }
 
 void DxRenderer::EndText() noexcept
@@ -815,158 +935,535 @@ void DxRenderer::DrawCircleTriangles(std::size_t vertexCount) noexcept
 	m_Context->RSSetState(nullptr);
 }
 
-namespace
+bool DxRenderer::CreateSampleBuffer(std::size_t sampleCapacity, ComPtr<ID3D11Buffer>& buffer, ComPtr<ID3D11ShaderResourceView>& srv)
+{
+	buffer.Reset();
+	srv.Reset();
+
+	//VF[_[4oCgE2ǂނ̂Ŗ1]Ɋmۂ
+	const std::size_t bytes = (sampleCapacity * sizeof(PitchSim::QuantizedSample) + 3) / 4 * 4 + 4;
+
+	D3D11_BUFFER_DESC bd{};
+	bd.ByteWidth = static_cast<UINT>(bytes);
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+
+	if (FAILED(m_Device->CreateBuffer(&bd, nullptr, buffer.GetAddressOf())))
+	{
+		return false;
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+	sd.Format = DXGI_FORMAT_R32_TYPELESS;
+	sd.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+	sd.BufferEx.FirstElement = 0;
+	sd.BufferEx.NumElements = static_cast<UINT>(bytes / 4);
+	sd.BufferEx.Flags = D3D11_BUFFEREX_SRV_FLAG_RAW;
+
+	if (FAILED(m_Device->CreateShaderResourceView(buffer.Get(), &sd, srv.GetAddressOf())))
+	{
+		buffer.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void DxRenderer::UploadSamples(ID3D11Buffer* buffer, const PitchSim::QuantizedSample* samples, std::size_t first, std::size_t last) noexcept
+{
+	if (!buffer || first >= last)
+	{
+		return;
+	}
+
+	D3D11_BOX box{};
+	box.left = static_cast<UINT>(sizeof(PitchSim::QuantizedSample) * first);
+	box.right = static_cast<UINT>(sizeof(PitchSim::QuantizedSample) * last);
+	box.top = 0;
+	box.bottom = 1;
+	box.front = 0;
+	box.back = 1;
+
+	m_Context->UpdateSubresource(buffer, 0, &box, samples + first, 0, 0);
+}
+
+bool DxRenderer::BindQuantizedStrip(ID3D11ShaderResourceView* srv, const PitchSim::QuantizationBox& qbox, std::uint32_t paletteIndex, UINT first, UINT colorCount) noexcept
+{
+	if (!srv || !UpdateTrajectoryCb(qbox, paletteIndex, first, colorCount))
+	{
+		return false;
+	}
+
+	BindQuantizedPipeline(srv);
+	return true;
+}
+
+bool DxRenderer::UpdateTrajectoryCb(const PitchSim::QuantizationBox& qbox, std::uint32_t paletteIndex, UINT first, UINT colorCount) noexcept
 {
-	ComPtr<ID3D11Buffer> CreateImmutableVB(ID3D11Device* dev, const std::vector<DxRenderer::Vertex>& v)
+	constexpr float INV_QUANT_MAX = 1.0f / static_cast<float>(PitchSim::TrajectoryCodec::QUANT_MAX);
+
+	CbTrajectory cb{};
+	cb.BoxMin = XMFLOAT3{ qbox.Min.X, qbox.Min.Y, qbox.Min.Z };
+	cb.FirstSample = first;
+	cb.BoxStep = XMFLOAT3{ qbox.Extent.X * INV_QUANT_MAX, qbox.Extent.Y * INV_QUANT_MAX, qbox.Extent.Z * INV_QUANT_MAX };
+	cb.ColorCount = colorCount;
+	cb.PaletteIndex = paletteIndex;
+
+	D3D11_MAPPED_SUBRESOURCE ms{};
+	if (FAILED(m_Context->Map(m_CbTrajectory.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
 	{
-		Microsoft::WRL::ComPtr<ID3D11Buffer> buf;
-		if (v.empty())
+		return false;
+	}
+
+	std::memcpy(ms.pData, &cb, sizeof(cb));
+	m_Context->Unmap(m_CbTrajectory.Get(), 0);
+
+	return true;
+}
+
+void DxRenderer::BindQuantizedPipeline(ID3D11ShaderResourceView* srv) noexcept
+{
+	ID3D11Buffer* cbs[] = { m_CbScene.Get(), m_CbTrajectory.Get(), m_CbPalette.Get() };
+
+	m_Context->IASetInputLayout(nullptr);
+	m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);
+
+	m_Context->VSSetShader(m_TrajVs.Get(), nullptr, 0);
+	m_Context->VSSetConstantBuffers(0, 3, cbs);
+	m_Context->VSSetShaderResources(0, 1, &srv);
+	m_Context->PSSetShader(m_Ps.Get(), nullptr, 0);
+}
+
+void DxRenderer::UnbindQuantizedStrip() noexcept
+{
+	ID3D11ShaderResourceView* nullSrv = nullptr;
+	m_Context->VSSetShaderResources(0, 1, &nullSrv);
+}
+
+void DxRenderer::SetPalette(const XMFLOAT4* colors, std::size_t count)
+{
+	CbPalette cb{};
+
+	for (std::size_t k = 0; k < PALETTE_SIZE; ++k)
+	{
+		cb.Colors[k] = (count > 0) ? colors[k % count] : XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f };
+	}
+
+	D3D11_MAPPED_SUBRESOURCE ms{};
+	if (SUCCEEDED(m_Context->Map(m_CbPalette.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+	{
+		std::memcpy(ms.pData, &cb, sizeof(cb));
+		m_Context->Unmap(m_CbPalette.Get(), 0);
+	}
+}
+
+void DxRenderer::RemapPackedSlots(const std::vector<std::uint32_t>& source)
+{
+	//source[i]͐VXbgiֈpXbgBǂɂpȂXbg͈̔͂̓v[֕Ԃ
+	std::vector<PackedTrajectory> trajs(source.size());
+	std::vector<PoolRange> spots(source.size());
+	std::vector<bool> kept(m_PackedTrajs.size(), false);
+
+	for (std::size_t i = 0; i < source.size(); ++i)
+	{
+		const std::size_t j = source[i];
+		if (j >= m_PackedTrajs.size() || kept[j])
 		{
-			return buf;
+			continue;
 		}
 
-		D3D11_BUFFER_DESC bd{};
-		bd.ByteWidth = static_cast<UINT>(sizeof(DxRenderer::Vertex) * v.size());
-		bd.Usage = D3D11_USAGE_IMMUTABLE;
-		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		trajs[i] = m_PackedTrajs[j];
+		trajs[i].PaletteIndex = static_cast<std::uint32_t>(i);
+		kept[j] = true;
 
-		D3D11_SUBRESOURCE_DATA init{};
-		init.pSysMem = v.data();
+		if (j < m_PackedSpots.size())
+		{
+			spots[i] = m_PackedSpots[j];
+		}
+	}
 
-		if (SUCCEEDED(dev->CreateBuffer(&bd, &init, buf.GetAddressOf())))
+	for (std::size_t j = 0; j < m_PackedTrajs.size(); ++j)
+	{
+		if (!kept[j])
 		{
-			return buf;
+			ReleasePoolRange(m_SamplePool, m_PackedTrajs[j].Samples);
+			ReleasePoolRange(m_IndexPool, m_PackedTrajs[j].Indices);
+
+			if (j < m_PackedSpots.size())
+			{
+				ReleasePoolRange(m_SpotPool, m_PackedSpots[j]);
+			}
 		}
+	}
 
-		return {};
+	m_PackedTrajs.swap(trajs);
+	m_PackedSpots.swap(spots);
+
+	if (m_StreamVbs.size() > source.size())
+	{
+		m_StreamVbs.resize(source.size());
 	}
 }
 
-void DxRenderer::BuildPackedTrajectories(const std::vector<std::vector<Vertex>>& lists)
+void DxRenderer::UpdatePackedTrajectory(std::size_t index, const PitchSim::QuantizedTrajectory& trajectory, const PitchSim::PolylineLod& lod)
 {
-	m_VbTrajPacked.Reset();
-	m_TrajStarts.clear();
-	m_TrajCounts.clear();
+	if (index >= m_PackedTrajs.size())
+	{
+		m_PackedTrajs.resize(index + 1);
+	}
+
+	PackedTrajectory& t = m_PackedTrajs[index];
+	t.Box = trajectory.Box;
+	t.PaletteIndex = trajectory.PaletteIndex;
+
+	if (!AcquirePoolRange(m_SamplePool, t.Samples, trajectory.Samples.size()))
+	{
+		ReleasePoolRange(m_IndexPool, t.Indices);
+		return;
+	}
 
-	std::vector<Vertex> packed;
-	packed.reserve(1024);
-	std::size_t total = 0;
+	UploadPoolRange(m_SamplePool, t.Samples, trajectory.Samples.data());
 
-	m_TrajStarts.reserve(lists.size());
-	m_TrajCounts.reserve(lists.size());
+	//LODCfbNX̓v[̐ΈʒuŏĂނ̂ŁÃXbglߒ
+	auto& indices = m_PackedIndexScratch;
+	indices.clear();
 
-	for (const auto& v : lists)
+	if (lod.SampleCount == trajectory.Samples.size())
 	{
-		m_TrajStarts.emplace_back(static_cast<UINT>(total));
-		m_TrajCounts.emplace_back(static_cast<UINT>(v.size()));
-		total += v.size();
-		packed.insert(packed.end(), v.begin(), v.end());
+		const std::uint32_t base = static_cast<std::uint32_t>(t.Samples.Offset);
+		indices.reserve(lod.Indices.size());
+
+		for (std::uint32_t i : lod.Indices)
+		{
+			indices.emplace_back(base + i);
+		}
 	}
 
-	if (!packed.empty())
+	if (AcquirePoolRange(m_IndexPool, t.Indices, indices.size()))
 	{
-		m_VbTrajPacked = CreateImmutableVB(m_Device.Get(), packed);
+		UploadPoolRange(m_IndexPool, t.Indices, indices.data());
 	}
 }
 
-void DxRenderer::DrawPackedTrajectory(std::size_t index, std::size_t visibleCount) noexcept
+void DxRenderer::DrawPackedTrajectories(const std::vector<PitchSim::TrajectoryDraw>& draws) noexcept
 {
-	if (!m_VbTrajPacked)
+	if (!m_SamplePool.Srv || draws.empty())
 	{
 		return;
 	}
 
-	if (index >= m_TrajStarts.size())
+	//pCvCƃv[͈xݒ肵A`悲Ƃɂ͒萔obt@ւ
+	BindQuantizedPipeline(m_SamplePool.Srv.Get());
+	m_Context->IASetIndexBuffer(m_IndexPool.Buffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+
+	for (const auto& d : draws)
+	{
+		if (d.Index < m_PackedTrajs.size())
+		{
+			SubmitPackedRange(m_PackedTrajs[d.Index], d.Range);
+		}
+	}
+
+	UnbindQuantizedStrip();
+}
+
+void DxRenderer::SubmitPackedRange(const PackedTrajectory& t, const PitchSim::LodRange& range) noexcept
+{
+	if (t.Samples.Count == 0)
 	{
 		return;
 	}
 
-	const UINT start = m_TrajStarts[index];
-	const UINT full = m_TrajCounts[index];
-	const UINT count = static_cast<UINT>(std::min<std::size_t>(visibleCount, full));
-	if (count == 0)
+	const UINT start = static_cast<UINT>(t.Samples.Offset);
+	const UINT count = static_cast<UINT>(t.Samples.Count);
+
+	const bool indexed = range.IndexCount > 0 && m_IndexPool.Buffer && range.IndexOffset + range.IndexCount <= t.Indices.Count;
+	const UINT tailFirst = static_cast<UINT>(std::min<std::size_t>(range.TailFirst, count));
+	const UINT tailCount = static_cast<UINT>(std::min<std::size_t>(range.TailCount, count - tailFirst));
+
+	if ((!indexed && tailCount == 0) || !UpdateTrajectoryCb(t.Box, t.PaletteIndex, start, count))
+	{
+		return;
+	}
+
+	if (indexed)
+	{
+		m_Context->DrawIndexed(static_cast<UINT>(range.IndexCount), static_cast<UINT>(t.Indices.Offset + range.IndexOffset), 0);
+	}
+
+	if (tailCount > 0)
+	{
+		m_Context->Draw(tailCount, start + tailFirst);
+	}
+}
+
+void DxRenderer::UpdatePackedSpot(std::size_t index, const std::pmr::vector<Vertex>& vertices)
+{
+	if (index >= m_PackedSpots.size())
+	{
+		m_PackedSpots.resize(index + 1);
+	}
+
+	PoolRange& r = m_PackedSpots[index];
+
+	if (AcquirePoolRange(m_SpotPool, r, vertices.size()))
+	{
+		UploadPoolRange(m_SpotPool, r, vertices.data());
+	}
+}
+
+void DxRenderer::DrawPackedSpots(const std::vector<std::uint32_t>& indices) noexcept
+{
+	if (!m_SpotPool.Buffer || indices.empty())
 	{
 		return;
 	}
 
+	BindSpotPipeline();
+
+	for (std::uint32_t i : indices)
+	{
+		if (i < m_PackedSpots.size() && m_PackedSpots[i].Count > 0)
+		{
+			m_Context->Draw(static_cast<UINT>(m_PackedSpots[i].Count), static_cast<UINT>(m_PackedSpots[i].Offset));
+		}
+	}
+
+	UnbindSpotPipeline();
+}
+
+void DxRenderer::BindSpotPipeline() noexcept
+{
 	UINT stride = sizeof(Vertex);
 	UINT offset = 0;
-	ID3D11Buffer* vb = m_VbTrajPacked.Get();
+	ID3D11Buffer* vb = m_SpotPool.Buffer.Get();
+
+	m_Context->OMSetBlendState(m_BlendAlpha.Get(), nullptr, 0xFFFFFFFF);
+	m_Context->RSSetState(m_RsNoCull.Get());
 
 	m_Context->IASetInputLayout(m_InputLayout.Get());
 	m_Context->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
-	m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);
+	m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	m_Context->VSSetShader(m_Vs.Get(), nullptr, 0);
 	m_Context->PSSetShader(m_Ps.Get(), nullptr, 0);
 	m_Context->VSSetConstantBuffers(0, 1, m_CbScene.GetAddressOf());
+}
 
-	m_Context->Draw(count, start);
+void DxRenderer::UnbindSpotPipeline() noexcept
+{
+	m_Context->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
+	m_Context->RSSetState(nullptr);
 }
 
-void DxRenderer::BuildPackedSpots(const std::vector<std::vector<Vertex>>& lists)
+bool DxRenderer::CreatePoolBuffer(const BufferPool& pool, std::size_t capacity, ComPtr<ID3D11Buffer>& buffer, ComPtr<ID3D11ShaderResourceView>& srv)
 {
-	m_VbSpotPacked.Reset();
-	m_SpotStarts.clear();
-	m_SpotCounts.clear();
+	if (pool.BindFlags & D3D11_BIND_SHADER_RESOURCE)
+	{
+		return CreateSampleBuffer(capacity, buffer, srv);
+	}
+
+	buffer.Reset();
+	srv.Reset();
+
+	D3D11_BUFFER_DESC bd{};
+	bd.ByteWidth = static_cast<UINT>(pool.Stride * capacity);
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.BindFlags = pool.BindFlags;
 
-	std::vector<Vertex> packed;
-	packed.reserve(1024);
-	std::size_t total = 0;
+	return SUCCEEDED(m_Device->CreateBuffer(&bd, nullptr, buffer.GetAddressOf()));
+}
 
-	m_SpotStarts.reserve(lists.size());
-	m_SpotCounts.reserve(lists.size());
+bool DxRenderer::GrowPool(BufferPool& pool, std::size_t minFree)
+{
+	const std::size_t oldCapacity = pool.Ranges.Capacity();
+	const std::size_t newCapacity = std::max<std::size_t>({ oldCapacity * 2, oldCapacity + minFree, 4096 });
 
-	for (const auto& v : lists)
+	ComPtr<ID3D11Buffer> buffer;
+	ComPtr<ID3D11ShaderResourceView> srv;
+	if (!CreatePoolBuffer(pool, newCapacity, buffer, srv))
 	{
-		m_SpotStarts.emplace_back(static_cast<UINT>(total));
-		m_SpotCounts.emplace_back(static_cast<UINT>(v.size()));
-		total += v.size();
-		packed.insert(packed.end(), v.begin(), v.end());
+		return false;
 	}
 
-	if (!packed.empty())
+	//XbgGPUł̂܂ܕ̂ŁAeXbg̃ItZbg͕ςȂ
+	if (pool.Buffer && oldCapacity > 0)
 	{
-		m_VbSpotPacked = CreateImmutableVB(m_Device.Get(), packed);
+		D3D11_BOX box{};
+		box.left = 0;
+		box.right = static_cast<UINT>(pool.Stride * oldCapacity);
+		box.top = 0;
+		box.bottom = 1;
+		box.front = 0;
+		box.back = 1;
+
+		m_Context->CopySubresourceRegion(buffer.Get(), 0, 0, 0, 0, pool.Buffer.Get(), 0, &box);
 	}
+
+	pool.Buffer = buffer;
+	pool.Srv = srv;
+	pool.Ranges.Grow(newCapacity);
+
+	return true;
 }
 
-void DxRenderer::DrawPackedSpot(std::size_t index) noexcept
+bool DxRenderer::AcquirePoolRange(BufferPool& pool, PoolRange& range, std::size_t count)
 {
-	if (!m_VbSpotPacked)
+	if (count == 0)
+	{
+		ReleasePoolRange(pool, range);
+		return false;
+	}
+
+	const std::size_t reserve = (count + pool.Granularity - 1) / pool.Granularity * pool.Granularity;
+
+	//܂͈͂ĂĉߑłȂ΂̏ŏ
+	if (range.Offset != PitchSim::RangeAllocator::INVALID_OFFSET && range.Reserved >= count && range.Reserved <= reserve * 2)
+	{
+		range.Count = count;
+		return true;
+	}
+
+	ReleasePoolRange(pool, range);
+
+	std::size_t offset = pool.Ranges.Allocate(reserve);
+	if (offset == PitchSim::RangeAllocator::INVALID_OFFSET)
+	{
+		if (!GrowPool(pool, reserve))
+		{
+			return false;
+		}
+
+		offset = pool.Ranges.Allocate(reserve);
+		if (offset == PitchSim::RangeAllocator::INVALID_OFFSET)
+		{
+			return false;
+		}
+	}
+
+	range = PoolRange{ offset, reserve, count };
+	return true;
+}
+
+void DxRenderer::ReleasePoolRange(BufferPool& pool, PoolRange& range)
+{
+	if (range.Offset != PitchSim::RangeAllocator::INVALID_OFFSET)
+	{
+		pool.Ranges.Free(range.Offset, range.Reserved);
+	}
+
+	range = PoolRange{};
+}
+
+void DxRenderer::UploadPoolRange(const BufferPool& pool, const PoolRange& range, const void* data) noexcept
+{
+	if (!pool.Buffer || range.Count == 0)
 	{
 		return;
 	}
 
-	if (index >= m_SpotStarts.size())
+	D3D11_BOX box{};
+	box.left = static_cast<UINT>(pool.Stride * range.Offset);
+	box.right = static_cast<UINT>(pool.Stride * (range.Offset + range.Count));
+	box.top = 0;
+	box.bottom = 1;
+	box.front = 0;
+	box.back = 1;
+
+	m_Context->UpdateSubresource(pool.Buffer.Get(), 0, &box, data, 0, 0);
+}
+
+void DxRenderer::ResetStreamingTrajectory(std::size_t index, std::size_t expectedCount)
+{
+	if (index >= m_StreamVbs.size())
+	{
+		m_StreamVbs.resize(index + 1);
+	}
+
+	StreamingVb& s = m_StreamVbs[index];
+	s.Count = 0;
+
+	if (s.Buffer && s.Capacity >= expectedCount)
 	{
 		return;
 	}
 
-	const UINT start = m_SpotStarts[index];
-	const UINT count = m_SpotCounts[index];
-	if (count == 0)
+	s.Capacity = 0;
+
+	if (expectedCount == 0)
 	{
+		s.Buffer.Reset();
+		s.Srv.Reset();
 		return;
 	}
 
-	UINT stride = sizeof(Vertex);
-	UINT offset = 0;
-	ID3D11Buffer* vb = m_VbSpotPacked.Get();
+	if (CreateSampleBuffer(expectedCount, s.Buffer, s.Srv))
+	{
+		s.Capacity = expectedCount;
+	}
+}
 
-	m_Context->OMSetBlendState(m_BlendAlpha.Get(), nullptr, 0xFFFFFFFF);
-	m_Context->RSSetState(m_RsNoCull.Get());
+void DxRenderer::AppendStreamingTrajectory(std::size_t index, const std::pmr::vector<PitchSim::QuantizedSample>& samples, std::size_t first)
+{
+	if (index >= m_StreamVbs.size())
+	{
+		m_StreamVbs.resize(index + 1);
+	}
 
-	m_Context->IASetInputLayout(m_InputLayout.Get());
-	m_Context->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
-	m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	StreamingVb& s = m_StreamVbs[index];
+	const std::size_t total = samples.size();
 
-	m_Context->VSSetShader(m_Vs.Get(), nullptr, 0);
-	m_Context->PSSetShader(m_Ps.Get(), nullptr, 0);
-	m_Context->VSSetConstantBuffers(0, 1, m_CbScene.GetAddressOf());
+	if (total > s.Capacity)
+	{
+		const std::size_t capacity = std::max<std::size_t>({ total, s.Capacity * 2, 4096 });
 
-	m_Context->Draw(count, start);
+		ComPtr<ID3D11Buffer> buf;
+		ComPtr<ID3D11ShaderResourceView> srv;
+		if (!CreateSampleBuffer(capacity, buf, srv))
+		{
+			return;
+		}
 
-	m_Context->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
-	m_Context->RSSetState(nullptr);
+		s.Buffer = buf;
+		s.Srv = srv;
+		s.Capacity = capacity;
+		first = 0;
+	}
+
+	if (first < total)
+	{
+		UploadSamples(s.Buffer.Get(), samples.data(), first, total);
+	}
+
+	s.Count = total;
+}
+
+void DxRenderer::DrawStreamingTrajectory(std::size_t index, std::size_t visibleCount, const PitchSim::QuantizedTrajectory& trajectory, std::size_t colorCount) noexcept
+{
+	if (index >= m_StreamVbs.size() || !m_StreamVbs[index].Srv)
+	{
+		return;
+	}
+
+	const StreamingVb& s = m_StreamVbs[index];
+	const UINT count = static_cast<UINT>(std::min(visibleCount, s.Count));
+
+	if (count == 0 || !BindQuantizedStrip(s.Srv.Get(), trajectory.Box, trajectory.PaletteIndex, 0, static_cast<UINT>(colorCount)))
+	{
+		return;
+	}
+
+	m_Context->Draw(count, 0);
+	UnbindQuantizedStrip();
+}
+
+void DxRenderer::ReleaseStreamingTrajectory(std::size_t index) noexcept
+{
+	if (index >= m_StreamVbs.size())
+	{
+		return;
+	}
+
+	m_StreamVbs[index].Count = 0;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,11 @@
 #include <wrl/client.h>
 #include <DirectXMath.h>
 
+#include "TrajectoryCodec.hpp"
+#include "PolylineLod.hpp"
+#include "RangeAllocator.hpp"
+#include "SceneCulling.hpp"
+
 class DxRenderer
 {
 public:
@@ -29,6 +35,8 @@ public:
 		DirectX::XMMATRIX Mvp;
 	};
 
+	static constexpr std::size_t PALETTE_SIZE = 256;
+
 	DxRenderer();
 	DxRenderer(const DxRenderer&) = delete;
 	DxRenderer(DxRenderer&&) noexcept = default;
@@ -41,7 +49,7 @@ public:
 	void BeginFrame() noexcept;
 	void EndFrame() noexcept;
 	void UpdateSceneCB(const CbScene& cb);
-	void UploadLineVertices(const std::vector<Vertex>& vertices);
+	void UploadLineVertices(const std::pmr::vector<Vertex>& vertices);
 	void DrawLineStrip(std::size_t vertexCount) noexcept;
 	void UploadGroundVertices(const std::vector<Vertex>& vertices);
 	void DrawGroundLineList(std::size_t vertexCount) noexcept;
@@ -50,16 +58,30 @@ public:
 	void UploadCircleVertices(const std::vector<Vertex>& vertices);
 	void DrawCircleTriangles(std::size_t vertexCount) noexcept;
 
-	void BuildPackedTrajectories(const std::vector<std::vector<Vertex>>& lists);
-	void DrawPackedTrajectory(std::size_t index, std::size_t visibleCount) noexcept;
+	void SetPalette(const DirectX::XMFLOAT4* colors, std::size_t count);
+
+	void RemapPackedSlots(const std::vector<std::uint32_t>& source);
+
+	void UpdatePackedTrajectory(std::size_t index, const PitchSim::QuantizedTrajectory& trajectory, const PitchSim::PolylineLod& lod);
+	void DrawPackedTrajectories(const std::vector<PitchSim::TrajectoryDraw>& draws) noexcept;
+
+	void UpdatePackedSpot(std::size_t index, const std::pmr::vector<Vertex>& vertices);
+	void DrawPackedSpots(const std::vector<std::uint32_t>& indices) noexcept;
 
-	void BuildPackedSpots(const std::vector<std::vector<Vertex>>& lists);
-	void DrawPackedSpot(std::size_t index) noexcept;
+	void ResetStreamingTrajectory(std::size_t index, std::size_t expectedCount);
+	void AppendStreamingTrajectory(std::size_t index, const std::pmr::vector<PitchSim::QuantizedSample>& samples, std::size_t first);
+	void DrawStreamingTrajectory(std::size_t index, std::size_t visibleCount, const PitchSim::QuantizedTrajectory& trajectory, std::size_t colorCount) noexcept;
+	void ReleaseStreamingTrajectory(std::size_t index) noexcept;
 
 	void BeginText() noexcept;
 	void DrawTextLabel(const std::wstring& text, float x_px, float y_px, float size_px, const D2D1_COLOR_F& color) noexcept;
 	void EndText() noexcept;
 
+	void ResetTextLabels(std::size_t slotCount);
+	void SetTextLabel(std::size_t slot, const std::wstring& text, float size_px);
+	DirectX::XMFLOAT2 GetTextLabelSize(std::size_t slot) const noexcept;
+	void DrawTextLabelSlot(std::size_t slot, float x_px, float y_px, const D2D1_COLOR_F& color) noexcept;
+
 	std::uint32_t GetWidth() const noexcept;
 	std::uint32_t GetHeight() const noexcept;
 
@@ -75,11 +97,34 @@ private:
 
 	bool CreateTextResources();
 	bool CreateTextTargetBitmap();
+	IDWriteTextFormat* GetTextFormat(float size_px) noexcept;
 
 	bool CreateFixedStates();
 
 	void ResolveMsaa() noexcept;
 
+	bool CreateSampleBuffer(std::size_t sampleCapacity, Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srv);
+	void UploadSamples(ID3D11Buffer* buffer, const PitchSim::QuantizedSample* samples, std::size_t first, std::size_t last) noexcept;
+	bool BindQuantizedStrip(ID3D11ShaderResourceView* srv, const PitchSim::QuantizationBox& box, std::uint32_t paletteIndex, UINT first, UINT colorCount) noexcept;
+	void BindQuantizedPipeline(ID3D11ShaderResourceView* srv) noexcept;
+	bool UpdateTrajectoryCb(const PitchSim::QuantizationBox& box, std::uint32_t paletteIndex, UINT first, UINT colorCount) noexcept;
+	void UnbindQuantizedStrip() noexcept;
+
+	struct CbTrajectory
+	{
+		DirectX::XMFLOAT3 BoxMin;
+		UINT FirstSample;
+		DirectX::XMFLOAT3 BoxStep;
+		UINT ColorCount;
+		UINT PaletteIndex;
+		UINT Pad[3];
+	};
+
+	struct CbPalette
+	{
+		DirectX::XMFLOAT4 Colors[PALETTE_SIZE];
+	};
+
 	Microsoft::WRL::ComPtr<ID3D11Device> m_Device;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_Context;
 	Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
@@ -88,8 +133,11 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_Dsv;
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> m_Vs;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> m_Ps;
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> m_TrajVs;
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> m_InputLayout;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_CbScene;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> m_CbTrajectory;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> m_CbPalette;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_Vb;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VbGround;
 
@@ -100,6 +148,21 @@ private:
 	Microsoft::WRL::ComPtr<ID2D1Bitmap1> m_D2DTargetBitmap;
 	Microsoft::WRL::ComPtr<IDWriteFactory> m_DWriteFactory;
 
+	struct TextFormatEntry
+	{
+		float Size;
+		Microsoft::WRL::ComPtr<IDWriteTextFormat> Format;
+	};
+
+	struct TextLabel
+	{
+		Microsoft::WRL::ComPtr<IDWriteTextLayout> Layout;
+		DirectX::XMFLOAT2 Size{ 0.0f, 0.0f };
+	};
+
+	std::vector<TextFormatEntry> m_TextFormats;
+	std::vector<TextLabel> m_TextLabels;
+
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VbStrikeZone;
 
 	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VbCircle;
@@ -123,11 +186,55 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11Texture2D> m_ColorMsaaTex;
 	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_RtvMsaa;
 
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VbTrajPacked;
-	std::vector<UINT> m_TrajStarts;
-	std::vector<UINT> m_TrajCounts;
+	struct PoolRange
+	{
+		std::size_t Offset{ PitchSim::RangeAllocator::INVALID_OFFSET };
+		std::size_t Reserved{ 0 };
+		std::size_t Count{ 0 };
+	};
+
+	struct BufferPool
+	{
+		Microsoft::WRL::ComPtr<ID3D11Buffer> Buffer;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Srv;
+		PitchSim::RangeAllocator Ranges;
+		UINT Stride;
+		UINT BindFlags;
+		std::size_t Granularity;
+	};
+
+	struct PackedTrajectory
+	{
+		PoolRange Samples;
+		PoolRange Indices;
+		PitchSim::QuantizationBox Box{};
+		std::uint32_t PaletteIndex{ 0 };
+	};
+
+	bool CreatePoolBuffer(const BufferPool& pool, std::size_t capacity, Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& srv);
+	bool GrowPool(BufferPool& pool, std::size_t minFree);
+	bool AcquirePoolRange(BufferPool& pool, PoolRange& range, std::size_t count);
+	void ReleasePoolRange(BufferPool& pool, PoolRange& range);
+	void UploadPoolRange(const BufferPool& pool, const PoolRange& range, const void* data) noexcept;
+	void SubmitPackedRange(const PackedTrajectory& trajectory, const PitchSim::LodRange& range) noexcept;
+	void BindSpotPipeline() noexcept;
+	void UnbindSpotPipeline() noexcept;
+
+	BufferPool m_SamplePool{ {}, {}, PitchSim::RangeAllocator{}, sizeof(PitchSim::QuantizedSample), D3D11_BIND_SHADER_RESOURCE, 256 };
+	BufferPool m_IndexPool{ {}, {}, PitchSim::RangeAllocator{}, sizeof(std::uint32_t), D3D11_BIND_INDEX_BUFFER, 64 };
+	BufferPool m_SpotPool{ {}, {}, PitchSim::RangeAllocator{}, sizeof(Vertex), D3D11_BIND_VERTEX_BUFFER, 64 };
+
+	std::vector<PackedTrajectory> m_PackedTrajs;
+	std::vector<PoolRange> m_PackedSpots;
+	std::vector<std::uint32_t> m_PackedIndexScratch;
+
+	struct StreamingVb
+	{
+		Microsoft::WRL::ComPtr<ID3D11Buffer> Buffer;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Srv;
+		std::size_t Capacity{ 0 };
+		std::size_t Count{ 0 };
+	};
 
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_VbSpotPacked;
-	std::vector<UINT> m_SpotStarts;
-	std::vector<UINT> m_SpotCounts;
+	std::vector<StreamingVb> m_StreamVbs;
 };
\ No newline at end of file
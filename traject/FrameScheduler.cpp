@@ -0,0 +1,128 @@
+#include "FrameScheduler.hpp"
+
+#include <algorithm>
+
+namespace PitchSim
+{
+	void FrameScheduler::Invalidate(RedrawReason reason) noexcept
+	{
+		m_Pending |= static_cast<std::uint32_t>(reason);
+	}
+
+	void FrameScheduler::SetContinuous(bool continuous) noexcept
+	{
+		if (continuous && !m_Continuous)
+		{
+			Invalidate(RedrawReason::Animation);
+		}
+
+		m_Continuous = continuous;
+	}
+
+	void FrameScheduler::SetFocused(bool focused) noexcept
+	{
+		if (focused != m_Focused)
+		{
+			m_Focused = focused;
+			Invalidate(RedrawReason::Focus);
+		}
+	}
+
+	FrameScheduler::Decision FrameScheduler::Poll(Clock::time_point now) const noexcept
+	{
+		Decision d{};
+
+		if (m_Pending == 0 && !m_Continuous)
+		{
+			return d;
+		}
+
+		const Clock::duration interval = MinInterval();
+
+		if (!m_HasRendered || interval <= Clock::duration::zero())
+		{
+			d.RenderNow = true;
+			d.WaitForever = false;
+			return d;
+		}
+
+		const Clock::time_point due = m_LastFrame + interval;
+
+		if (now >= due)
+		{
+			d.RenderNow = true;
+			d.WaitForever = false;
+			return d;
+		}
+
+		d.WaitForever = false;
+		d.Wait = due - now;
+		return d;
+	}
+
+	void FrameScheduler::OnFrameRendered(Clock::time_point now) noexcept
+	{
+		m_Pending = 0;
+		m_LastFrame = now;
+		m_HasRendered = true;
+		++m_FramesRendered;
+	}
+
+	FrameScheduler::Clock::duration FrameScheduler::MinInterval() const noexcept
+	{
+		const double fps = m_Focused ? m_Policy.FocusedMaxFps : m_Policy.UnfocusedMaxFps;
+
+		if (fps <= 0.0)
+		{
+			return Clock::duration::zero();
+		}
+
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+	}
+
+	void FrameTimings::Add(FramePhase phase, double ms) noexcept
+	{
+		m_Current[static_cast<std::size_t>(phase)] += ms;
+	}
+
+	void FrameTimings::CommitFrame() noexcept
+	{
+		for (std::size_t p = 0; p < PHASE_COUNT; ++p)
+		{
+			m_Samples[p][m_Cursor] = static_cast<float>(m_Current[p]);
+			m_Current[p] = 0.0;
+		}
+
+		m_Cursor = (m_Cursor + 1) % WINDOW;
+		m_Count = std::min(m_Count + 1, WINDOW);
+	}
+
+	FrameTimings::Percentiles FrameTimings::Query(FramePhase phase) const noexcept
+	{
+		Percentiles out{};
+
+		if (m_Count == 0)
+		{
+			return out;
+		}
+
+		const auto& samples = m_Samples[static_cast<std::size_t>(phase)];
+		std::copy(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(m_Count), m_Scratch.begin());
+
+		const auto first = m_Scratch.begin();
+		const auto last = first + static_cast<std::ptrdiff_t>(m_Count);
+
+		auto at = [&](double q)
+		{
+			const auto k = static_cast<std::ptrdiff_t>(q * static_cast<double>(m_Count - 1) + 0.5);
+			std::nth_element(first, first + k, last);
+			return static_cast<double>(first[k]);
+		};
+
+		out.P50 = at(0.50);
+		out.P95 = at(0.95);
+		out.P99 = at(0.99);
+		out.Max = static_cast<double>(*std::max_element(first, last));
+		return out;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace PitchSim
+{
+	enum class RedrawReason : std::uint32_t
+	{
+		None = 0,
+		Input = 1u << 0,
+		Animation = 1u << 1,
+		Data = 1u << 2,
+		Resize = 1u << 3,
+		Focus = 1u << 4,
+	};
+
+	class FrameScheduler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Policy
+		{
+			double FocusedMaxFps{ 0.0 };
+			double UnfocusedMaxFps{ 10.0 };
+		};
+
+		struct Decision
+		{
+			bool RenderNow{ false };
+			bool WaitForever{ true };
+			Clock::duration Wait{ 0 };
+		};
+
+		FrameScheduler() noexcept = default;
+		explicit FrameScheduler(const Policy& policy) noexcept : m_Policy{ policy } {}
+
+		void SetPolicy(const Policy& policy) noexcept { m_Policy = policy; }
+
+		void Invalidate(RedrawReason reason) noexcept;
+		void SetContinuous(bool continuous) noexcept;
+		void SetFocused(bool focused) noexcept;
+
+		Decision Poll(Clock::time_point now) const noexcept;
+		void OnFrameRendered(Clock::time_point now) noexcept;
+
+		bool IsFocused() const noexcept { return m_Focused; }
+		std::uint32_t PendingReasons() const noexcept { return m_Pending; }
+		std::uint64_t FramesRendered() const noexcept { return m_FramesRendered; }
+
+	private:
+		Clock::duration MinInterval() const noexcept;
+
+		Policy m_Policy{};
+		std::uint32_t m_Pending{ static_cast<std::uint32_t>(RedrawReason::Data) };
+		bool m_Continuous{ false };
+		bool m_Focused{ true };
+		bool m_HasRendered{ false };
+		Clock::time_point m_LastFrame{};
+		std::uint64_t m_FramesRendered{ 0 };
+	};
+
+	enum class FramePhase : std::size_t
+	{
+		Update,
+		Pack,
+		Draw,
+		Text,
+		Total,
+		Count,
+	};
+
+	class FrameTimings
+	{
+	public:
+		static constexpr std::size_t WINDOW = 256;
+		static constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(FramePhase::Count);
+
+		struct Percentiles
+		{
+			double P50{ 0.0 };
+			double P95{ 0.0 };
+			double P99{ 0.0 };
+			double Max{ 0.0 };
+		};
+
+		void Add(FramePhase phase, double ms) noexcept;
+		void CommitFrame() noexcept;
+
+		Percentiles Query(FramePhase phase) const noexcept;
+		std::size_t SampleCount() const noexcept { return m_Count; }
+
+	private:
+		std::array<std::array<float, WINDOW>, PHASE_COUNT> m_Samples{};
+		std::array<double, PHASE_COUNT> m_Current{};
+		mutable std::array<float, WINDOW> m_Scratch{};
+		std::size_t m_Cursor{ 0 };
+		std::size_t m_Count{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "LabelLayout.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace PitchSim
+{
+	LabelPlacer::LabelPlacer() : m_Buckets(BUCKET_COUNT)
+	{}
+
+	bool LabelPlacer::IsLayoutCurrent(const LabelLayoutKey& key) const noexcept
+	{
+		return key.Generation == m_Key.Generation && key.ViewWidth == m_Key.ViewWidth && key.ViewHeight == m_Key.ViewHeight && key.Ids == m_Key.Ids && std::memcmp(key.ViewProj.data(), m_Key.ViewProj.data(), sizeof(key.ViewProj)) == 0;
+	}
+
+	void LabelPlacer::Place(const LabelLayoutKey& key, const std::vector<LabelRequest>& requests, std::vector<LabelPlacement>& out)
+	{
+		Clear();
+		out.clear();
+
+		m_Key = key;
+
+		const float viewWidth = static_cast<float>(key.ViewWidth);
+		const float viewHeight = static_cast<float>(key.ViewHeight);
+
+		for (const LabelRequest& q : requests)
+		{
+			const float w = q.Width;
+			const float h = q.Height;
+
+			const float right = q.AnchorX + Gap_px;
+			const float left = q.AnchorX - Gap_px - w;
+			const float above = q.AnchorY - h;
+			const float below = q.AnchorY + Padding_px;
+
+			bool placed = false;
+
+			for (int step = 0; step <= StackSteps && !placed; ++step)
+			{
+				const float lift = static_cast<float>(step) * h;
+				const float candidates[4][2] =
+				{
+					{ right, above - lift },
+					{ right, below + lift },
+					{ left, above - lift },
+					{ left, below + lift },
+				};
+
+				for (const auto& c : candidates)
+				{
+					const Rect r{ c[0] - Padding_px, c[1] - Padding_px, c[0] + w + Padding_px, c[1] + h + Padding_px };
+
+					if (r.X0 < 0.0f || r.Y0 < 0.0f || r.X1 > viewWidth || r.Y1 > viewHeight || Overlaps(r))
+					{
+						continue;
+					}
+
+					Insert(r);
+					out.emplace_back(LabelPlacement{ q.Id, c[0], c[1] });
+					placed = true;
+					break;
+				}
+			}
+		}
+	}
+
+	bool LabelPlacer::Overlaps(const Rect& r) const noexcept
+	{
+		const int cx0 = CellOf(r.X0);
+		const int cx1 = CellOf(r.X1);
+		const int cy0 = CellOf(r.Y0);
+		const int cy1 = CellOf(r.Y1);
+
+		for (int cy = cy0; cy <= cy1; ++cy)
+		{
+			for (int cx = cx0; cx <= cx1; ++cx)
+			{
+				for (std::uint32_t k : m_Buckets[BucketOf(cx, cy)])
+				{
+					const Rect& p = m_Placed[k];
+
+					if (r.X0 < p.X1 && p.X0 < r.X1 && r.Y0 < p.Y1 && p.Y0 < r.Y1)
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void LabelPlacer::Insert(const Rect& r)
+	{
+		const std::uint32_t id = static_cast<std::uint32_t>(m_Placed.size());
+		m_Placed.emplace_back(r);
+
+		const int cx0 = CellOf(r.X0);
+		const int cx1 = CellOf(r.X1);
+		const int cy0 = CellOf(r.Y0);
+		const int cy1 = CellOf(r.Y1);
+
+		for (int cy = cy0; cy <= cy1; ++cy)
+		{
+			for (int cx = cx0; cx <= cx1; ++cx)
+			{
+				const std::size_t b = BucketOf(cx, cy);
+				auto& bucket = m_Buckets[b];
+
+				if (bucket.empty())
+				{
+					m_Touched.emplace_back(static_cast<std::uint32_t>(b));
+				}
+
+				if (bucket.empty() || bucket.back() != id)
+				{
+					bucket.emplace_back(id);
+				}
+			}
+		}
+	}
+
+	void LabelPlacer::Clear() noexcept
+	{
+		for (std::uint32_t b : m_Touched)
+		{
+			m_Buckets[b].clear();
+		}
+
+		m_Touched.clear();
+		m_Placed.clear();
+	}
+
+	std::size_t LabelPlacer::BucketOf(int cx, int cy) noexcept
+	{
+		const std::uint32_t h = (static_cast<std::uint32_t>(cx) * 73856093u) ^ (static_cast<std::uint32_t>(cy) * 19349663u);
+		return h & (BUCKET_COUNT - 1);
+	}
+
+	int LabelPlacer::CellOf(float v) noexcept
+	{
+		return static_cast<int>(std::floor(v / CELL_SIZE_PX));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PitchSim
+{
+	struct LabelRequest
+	{
+		std::uint32_t Id{ 0 };
+		float AnchorX{ 0.0f };
+		float AnchorY{ 0.0f };
+		float Width{ 0.0f };
+		float Height{ 0.0f };
+	};
+
+	struct LabelPlacement
+	{
+		std::uint32_t Id{ 0 };
+		float X{ 0.0f };
+		float Y{ 0.0f };
+	};
+
+	struct LabelLayoutKey
+	{
+		std::uint64_t Generation{ ~std::uint64_t{ 0 } };
+		std::uint32_t ViewWidth{ 0 };
+		std::uint32_t ViewHeight{ 0 };
+		std::array<float, 16> ViewProj{};
+		std::vector<std::uint32_t> Ids;
+	};
+
+	class LabelPlacer
+	{
+	public:
+		static constexpr float CELL_SIZE_PX = 64.0f;
+		static constexpr std::size_t BUCKET_COUNT = 1024;
+
+		LabelPlacer();
+
+		bool IsLayoutCurrent(const LabelLayoutKey& key) const noexcept;
+		void Place(const LabelLayoutKey& key, const std::vector<LabelRequest>& requests, std::vector<LabelPlacement>& out);
+
+		float Gap_px{ 8.0f };
+		float Padding_px{ 2.0f };
+		int StackSteps{ 3 };
+
+	private:
+		struct Rect
+		{
+			float X0;
+			float Y0;
+			float X1;
+			float Y1;
+		};
+
+		bool Overlaps(const Rect& r) const noexcept;
+		void Insert(const Rect& r);
+		void Clear() noexcept;
+
+		static std::size_t BucketOf(int cx, int cy) noexcept;
+		static int CellOf(float v) noexcept;
+
+		std::vector<Rect> m_Placed;
+		std::vector<std::vector<std::uint32_t>> m_Buckets;
+		std::vector<std::uint32_t> m_Touched;
+		LabelLayoutKey m_Key;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "MappedFile.hpp"
+
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PitchSim
+{
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		Swap(other);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			Swap(other);
+		}
+
+		return *this;
+	}
+
+	void MappedFile::Swap(MappedFile& other) noexcept
+	{
+#ifdef _WIN32
+		std::swap(m_File, other.m_File);
+		std::swap(m_Mapping, other.m_Mapping);
+#else
+		std::swap(m_Fd, other.m_Fd);
+#endif
+		std::swap(m_Data, other.m_Data);
+		std::swap(m_Size, other.m_Size);
+		std::swap(m_Open, other.m_Open);
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& path) noexcept
+	{
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || static_cast<unsigned long long>(size.QuadPart) > static_cast<unsigned long long>(SIZE_MAX))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_File = file;
+		m_Size = static_cast<std::size_t>(size.QuadPart);
+		m_Open = true;
+
+		if (m_Size == 0)
+		{
+			return true;
+		}
+
+		m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_Mapping)
+		{
+			Close();
+			return false;
+		}
+
+		m_Data = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!m_Data)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close() noexcept
+	{
+		if (m_Data)
+		{
+			UnmapViewOfFile(m_Data);
+		}
+
+		if (m_Mapping)
+		{
+			CloseHandle(m_Mapping);
+		}
+
+		if (m_File)
+		{
+			CloseHandle(m_File);
+		}
+
+		m_File = nullptr;
+		m_Mapping = nullptr;
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Open = false;
+	}
+#else
+	bool MappedFile::Open(const std::string& path) noexcept
+	{
+		Close();
+
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat st{};
+		if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+		{
+			::close(fd);
+			return false;
+		}
+
+		m_Fd = fd;
+		m_Size = static_cast<std::size_t>(st.st_size);
+		m_Open = true;
+
+		if (m_Size == 0)
+		{
+			return true;
+		}
+
+		void* p = ::mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		::madvise(p, m_Size, MADV_SEQUENTIAL);
+		m_Data = static_cast<const char*>(p);
+		return true;
+	}
+
+	void MappedFile::Close() noexcept
+	{
+		if (m_Data)
+		{
+			::munmap(const_cast<char*>(m_Data), m_Size);
+		}
+
+		if (m_Fd >= 0)
+		{
+			::close(m_Fd);
+		}
+
+		m_Fd = -1;
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Open = false;
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace PitchSim
+{
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		~MappedFile();
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		bool Open(const std::string& path) noexcept;
+		void Close() noexcept;
+
+		bool IsOpen() const noexcept { return m_Open; }
+		const char* Data() const noexcept { return m_Data; }
+		std::size_t Size() const noexcept { return m_Size; }
+		std::string_view View() const noexcept { return std::string_view{ m_Data ? m_Data : "", m_Size }; }
+
+	private:
+		void Swap(MappedFile& other) noexcept;
+
+#ifdef _WIN32
+		void* m_File{ nullptr };
+		void* m_Mapping{ nullptr };
+#else
+		int m_Fd{ -1 };
+#endif
+		const char* m_Data{ nullptr };
+		std::size_t m_Size{ 0 };
+		bool m_Open{ false };
+	};
+}
\ No newline at end of file
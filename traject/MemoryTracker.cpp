@@ -0,0 +1,141 @@
+#include "MemoryTracker.hpp"
+
+#include <atomic>
+#include <cstdio>
+
+namespace PitchSim::MemoryTracker
+{
+#if PITCHSIM_TRACK_MEMORY
+	namespace
+	{
+		class TaggedResource final : public std::pmr::memory_resource
+		{
+		public:
+			TagStats Read() const noexcept
+			{
+				TagStats s{};
+				s.CurrentBytes = m_Current.load(std::memory_order_relaxed);
+				s.PeakBytes = m_Peak.load(std::memory_order_relaxed);
+				s.Allocations = m_Allocations.load(std::memory_order_relaxed);
+				s.Frees = m_Frees.load(std::memory_order_relaxed);
+				return s;
+			}
+
+		private:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override
+			{
+				void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+
+				const std::uint64_t current = m_Current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+				std::uint64_t peak = m_Peak.load(std::memory_order_relaxed);
+
+				while (current > peak && !m_Peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+				{
+				}
+
+				m_Allocations.fetch_add(1, std::memory_order_relaxed);
+				return p;
+			}
+
+			void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+			{
+				std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+				m_Current.fetch_sub(bytes, std::memory_order_relaxed);
+				m_Frees.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+			{
+				return this == &other;
+			}
+
+			std::atomic<std::uint64_t> m_Current{ 0 };
+			std::atomic<std::uint64_t> m_Peak{ 0 };
+			std::atomic<std::uint64_t> m_Allocations{ 0 };
+			std::atomic<std::uint64_t> m_Frees{ 0 };
+		};
+
+		TaggedResource* Resources() noexcept
+		{
+			static TaggedResource* resources = new TaggedResource[TAG_COUNT];
+			return resources;
+		}
+	}
+#endif
+
+	bool IsEnabled() noexcept
+	{
+#if PITCHSIM_TRACK_MEMORY
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	std::pmr::memory_resource* Resource(MemoryTag tag) noexcept
+	{
+#if PITCHSIM_TRACK_MEMORY
+		return &Resources()[static_cast<std::size_t>(tag) % TAG_COUNT];
+#else
+		static_cast<void>(tag);
+		return std::pmr::new_delete_resource();
+#endif
+	}
+
+	TagStats Read(MemoryTag tag) noexcept
+	{
+#if PITCHSIM_TRACK_MEMORY
+		return Resources()[static_cast<std::size_t>(tag) % TAG_COUNT].Read();
+#else
+		static_cast<void>(tag);
+		return TagStats{};
+#endif
+	}
+
+	TagStats ReadTotal() noexcept
+	{
+		TagStats total{};
+
+		for (std::size_t k = 0; k < TAG_COUNT; ++k)
+		{
+			const TagStats s = Read(static_cast<MemoryTag>(k));
+			total.CurrentBytes += s.CurrentBytes;
+			total.PeakBytes += s.PeakBytes;
+			total.Allocations += s.Allocations;
+			total.Frees += s.Frees;
+		}
+
+		return total;
+	}
+
+	std::string FormatReport()
+	{
+		if (!IsEnabled())
+		{
+			return "memory: tracking disabled\n";
+		}
+
+		std::string out;
+		char line[160];
+
+		std::snprintf(line, sizeof(line), "%-14s %12s %12s %10s %10s\n", "memory", "current MB", "peak MB", "allocs", "frees");
+		out += line;
+
+		auto row = [&](const char* name, const TagStats& s)
+		{
+			std::snprintf(line, sizeof(line), "%-14s %12.2f %12.2f %10llu %10llu\n", name,
+				static_cast<double>(s.CurrentBytes) / (1024.0 * 1024.0), static_cast<double>(s.PeakBytes) / (1024.0 * 1024.0),
+				static_cast<unsigned long long>(s.Allocations), static_cast<unsigned long long>(s.Frees));
+			out += line;
+		};
+
+		for (std::size_t k = 0; k < TAG_COUNT; ++k)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(k);
+			row(ToString(tag), Read(tag));
+		}
+
+		row("sum", ReadTotal());
+		return out;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+#if !defined(PITCHSIM_TRACK_MEMORY)
+#if defined(_DEBUG)
+#define PITCHSIM_TRACK_MEMORY 1
+#else
+#define PITCHSIM_TRACK_MEMORY 0
+#endif
+#endif
+
+namespace PitchSim
+{
+	enum class MemoryTag : std::uint8_t
+	{
+		SimPoints,
+		Samples,
+		Lod,
+		Spots,
+		Tessellation,
+		TrajectoryCache,
+		StateRecord,
+		Count
+	};
+
+	inline const char* ToString(MemoryTag tag) noexcept
+	{
+		switch (tag)
+		{
+			case MemoryTag::SimPoints: return "sim points";
+			case MemoryTag::Samples: return "samples";
+			case MemoryTag::Lod: return "lod";
+			case MemoryTag::Spots: return "spots";
+			case MemoryTag::Tessellation: return "tessellation";
+			case MemoryTag::TrajectoryCache: return "trajectory cache";
+			case MemoryTag::StateRecord: return "state record";
+			default: return "unknown";
+		}
+	}
+
+	namespace MemoryTracker
+	{
+		constexpr std::size_t TAG_COUNT = static_cast<std::size_t>(MemoryTag::Count);
+
+		struct TagStats
+		{
+			std::uint64_t CurrentBytes{ 0 };
+			std::uint64_t PeakBytes{ 0 };
+			std::uint64_t Allocations{ 0 };
+			std::uint64_t Frees{ 0 };
+		};
+
+		bool IsEnabled() noexcept;
+		std::pmr::memory_resource* Resource(MemoryTag tag) noexcept;
+		TagStats Read(MemoryTag tag) noexcept;
+		TagStats ReadTotal() noexcept;
+		std::string FormatReport();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "Physics.hpp"
+#include "TrajectorySimulator.hpp"
+
+namespace PitchSim
+{
+	constexpr std::size_t PARAMS_KEY_WORDS = 22;
+
+	using ParamsKey = std::array<std::uint64_t, PARAMS_KEY_WORDS>;
+
+	inline std::uint64_t KeyWord(double v) noexcept
+	{
+		return std::bit_cast<std::uint64_t>(v + 0.0);
+	}
+
+	inline ParamsKey MakeParamsKey(const SimParams& p) noexcept
+	{
+		return ParamsKey
+		{
+			TrajectorySimulator::VERSION,
+			KeyWord(p.ReleaseHeight_cm),
+			KeyWord(p.InitialSpeed_mps),
+			KeyWord(p.Elevation_deg),
+			KeyWord(p.Azimuth_deg),
+			KeyWord(p.SpinRPM),
+			KeyWord(p.SpinAxis.X),
+			KeyWord(p.SpinAxis.Y),
+			KeyWord(p.SpinAxis.Z),
+			KeyWord(p.Radius_mm),
+			KeyWord(p.Mass_kg),
+			KeyWord(p.AirTemp_C),
+			KeyWord(p.RelHumidity_pct),
+			KeyWord(p.Pressure_hPa),
+			p.UseAltitudePressure ? 1u : 0u,
+			KeyWord(p.Altitude_m),
+			KeyWord(p.Dt_s),
+			static_cast<std::uint64_t>(p.Method),
+			KeyWord(p.Tolerance_m),
+			p.OutputStride,
+			p.StopOnGroundHit ? 1u : 0u,
+			KeyWord(p.PlateDistance_m),
+		};
+	}
+
+	inline void MixKeyWord(std::uint64_t& h, std::uint64_t v) noexcept
+	{
+		h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+	}
+
+	inline std::uint64_t HashParamsKey(const ParamsKey& key) noexcept
+	{
+		std::uint64_t h = 0;
+		for (const std::uint64_t w : key)
+		{
+			MixKeyWord(h, w);
+		}
+
+		return h;
+	}
+}
\ No newline at end of file
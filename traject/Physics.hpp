@@ -13,6 +13,8 @@ namespace PitchSim
 		double X;
 		double Y;
 		double Z;
+
+		bool operator==(const DVec3&) const noexcept = default;
 	};
 
 	struct Float3
@@ -22,6 +24,18 @@ namespace PitchSim
 		float Z;
 	};
 
+	inline constexpr double PLATE_DISTANCE_M = 18.44;
+	inline constexpr double G_STANDARD = 9.80665;
+	inline constexpr double MOUND_OFFSET_M = 0.254;
+
+	enum class Integrator : std::uint8_t
+	{
+		Euler,
+		Heun,
+		RK4,
+		RK45
+	};
+
 	struct SimParams
 	{
 		double ReleaseHeight_cm = 170.0;
@@ -42,12 +56,14 @@ namespace PitchSim
 		double Altitude_m = 0.0;
 
 		double Dt_s = 0.0005;
+		Integrator Method = Integrator::RK4;
+		double Tolerance_m = 1e-6;
+		std::uint32_t OutputStride = 1;
 		bool StopOnGroundHit = false;
-	};
+		double PlateDistance_m = PLATE_DISTANCE_M;
 
-	inline constexpr double PLATE_DISTANCE_M = 18.44;
-	inline constexpr double G_STANDARD = 9.80665;
-	inline constexpr double MOUND_OFFSET_M = 0.254;
+		bool operator==(const SimParams&) const noexcept = default;
+	};
 
 	inline DVec3 Add(const DVec3& a, const DVec3& b) noexcept
 	{
@@ -1,49 +1,57 @@
 #include "PitchConfig.hpp"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <string>
 #include <string_view>
-#include <algorithm>
-#include <cctype>
-#include <limits>
-#include <map>
+#include <system_error>
+#include <utility>
+
+#include "MappedFile.hpp"
 
 namespace PitchSim::Config
 {
 	namespace
 	{
-		inline void TrimInPlace(std::string& s)
+		inline bool IsSpace(char c) noexcept
 		{
-			auto issp = [](unsigned char c) {return std::isspace(c) != 0; };
-			s.erase(s.begin(), std::find_if(s.begin(), s.end(), [&](unsigned char c) {return !issp(c); }));
-			s.erase(std::find_if(s.rbegin(), s.rend(), [&](unsigned char c) {return !issp(c); }).base(), s.end());
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
 		}
 
-		inline void StripUtf8Bom(std::string& s) noexcept
+		inline std::string_view Trim(std::string_view s) noexcept
 		{
-			if (s.size() >= 3 && static_cast<unsigned char>(s[0]) == 0xEF && static_cast<unsigned char>(s[1]) == 0xBB && static_cast<unsigned char>(s[2]) == 0xBF)
+			std::size_t b = 0;
+			std::size_t e = s.size();
+
+			while (b < e && IsSpace(s[b]))
+			{
+				++b;
+			}
+
+			while (e > b && IsSpace(s[e - 1]))
 			{
-				s.erase(0, 3);
+				--e;
 			}
+
+			return s.substr(b, e - b);
 		}
 
-		inline bool StartsWith(const std::string s, const char* prefix)
+		inline char ToUpper(char c) noexcept
 		{
-			return s.rfind(prefix, 0) == 0;
+			return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
 		}
 
-		inline bool StartsWithCI(const std::string& s, const char* prefix)
+		inline bool EqualsCI(std::string_view a, std::string_view b) noexcept
 		{
-			const std::size_t n = std::strlen(prefix);
-			if (s.size() < n)
+			if (a.size() != b.size())
 			{
 				return false;
 			}
 
-			for (std::size_t i = 0; i < n; ++i)
+			for (std::size_t i = 0; i < a.size(); ++i)
 			{
-				if (std::tolower(static_cast<unsigned char>(s[i])) != std::tolower(static_cast<unsigned char>(prefix[i])))
+				if (ToUpper(a[i]) != ToUpper(b[i]))
 				{
 					return false;
 				}
@@ -52,1064 +60,1014 @@ namespace PitchSim::Config
 			return true;
 		}
 
-		inline std::vector<std::string> SplitTopLevelCsv(const std::string& s)
+		inline bool StartsWithCI(std::string_view s, std::string_view prefix) noexcept
 		{
-			std::vector<std::string> out;
-			std::string cur;
-			int depth = 0;
-			for (char ch : s)
-			{
-				if (ch == '(')
-				{
-					++depth;
-					cur.push_back(ch);
-				}
-				else if (ch == ')')
-				{
-					depth = std::max(0, depth - 1);
-					cur.push_back(ch);
-				}
-				else if (ch == ',' && depth == 0)
-				{
-					TrimInPlace(cur);
-					if (!cur.empty())
-					{
-						out.emplace_back(cur);
-					}
-
-					cur.clear();
-				}
-				else
-				{
-					cur.push_back(ch);
-				}
-			}
+			return s.size() >= prefix.size() && EqualsCI(s.substr(0, prefix.size()), prefix);
+		}
 
-			TrimInPlace(cur);
-			if (!cur.empty())
+		inline std::string_view StripUtf8Bom(std::string_view s) noexcept
+		{
+			if (s.size() >= 3 && static_cast<unsigned char>(s[0]) == 0xEF && static_cast<unsigned char>(s[1]) == 0xBB && static_cast<unsigned char>(s[2]) == 0xBF)
 			{
-				out.emplace_back(cur);
+				s.remove_prefix(3);
 			}
 
-			return out;
+			return s;
 		}
 
-		inline bool ParseAxis(const std::string& token, PitchSim::DVec3& out)
+		//stodƓǂ߂鏊܂ł𐔒lƂBɎctrailingɕԂAĂяoŌxɂ
+		template <typename T>
+		inline bool ParseNumber(std::string_view s, T& out, const char*& trailing) noexcept
 		{
-			auto lp = token.find('(');
-			auto rp = token.find(')');
-			if (lp == std::string::npos || rp == std::string::npos || rp < lp)
+			s = Trim(s);
+
+			if (s.size() >= 2 && s[0] == '+' && s[1] != '-')
+			{
+				s.remove_prefix(1);
+			}
+
+			if (s.empty())
 			{
 				return false;
 			}
 
-			std::string inside = token.substr(lp + 1, rp - lp - 1);
-			std::replace(inside.begin(), inside.end(), ',', ' ');
-			std::istringstream iss(inside);
-			double x = 0.0;
-			double y = 0.0;
-			double z = 0.0;
-			if (!(iss >> x >> y >> z))
+			T v{};
+			const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+
+			if (ec != std::errc{} || ptr == s.data())
 			{
 				return false;
 			}
-			out = PitchSim::DVec3{ x, y, z };
+
+			if (ptr != s.data() + s.size() && !trailing)
+			{
+				trailing = ptr;
+			}
+
+			out = v;
 			return true;
 		}
 
-		inline bool ParseLineKV(const std::string& line, double& speed_kmh, PitchSim::DVec3& axis, double& rpm)
+		template <typename T>
+		inline bool Assign(std::string_view value, std::optional<T>& out, const char*& trailing) noexcept
 		{
-			std::string s = line;
-			TrimInPlace(s);
-			if (s.empty())
+			T v{};
+			if (!ParseNumber(value, v, trailing))
 			{
 				return false;
 			}
 
-			std::vector<std::string> toks = SplitTopLevelCsv(s);
+			out = v;
+			return true;
+		}
+
+		class ErrorLog
+		{
+		public:
+			explicit ErrorLog(std::vector<ParseError>* out) noexcept : m_Out{ out } {}
 
-			if (toks.size() < 3)
+			void Add(std::size_t line, std::string_view lineText, const char* at, std::string_view message)
 			{
-				return false;
+				++m_Count;
+				Report(line, lineText, at, message, false);
 			}
 
-			bool okSpeed = false;
-			bool okAxis = false;
-			bool okRpm = false;
+			void Warn(std::size_t line, std::string_view lineText, const char* at, std::string_view message)
+			{
+				Report(line, lineText, at, message, true);
+			}
 
-			for (const std::string& tRaw : toks)
+			std::size_t Count() const noexcept
 			{
-				std::string t = tRaw;
-				TrimInPlace(t);
+				return m_Count;
+			}
 
-				if (StartsWithCI(t, "Speed="))
-				{
-					std::string v = t.substr(6);
-					TrimInPlace(v);
-					try
-					{
-						speed_kmh = std::stod(v);
-						okSpeed = true;
-					}
-					catch (...)
-					{
-						return false;
-					}
-				}
-				else if (StartsWithCI(t, "Axis="))
-				{
-					okAxis = ParseAxis(t, axis);
-					if (!okAxis)
-					{
-						return false;
-					}
-				}
-				else if (StartsWithCI(t, "RPM="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
-					{
-						rpm = std::stod(v);
-						okRpm = true;
-					}
-					catch (...)
-					{
-						return false;
-					}
-				}
-				else
+		private:
+			void Report(std::size_t line, std::string_view lineText, const char* at, std::string_view message, bool warning)
+			{
+				if (!m_Out || m_Out->size() >= MAX_REPORTED_ERRORS)
 				{
-					//
+					return;
 				}
+
+				const std::size_t column = (at >= lineText.data() && at <= lineText.data() + lineText.size()) ? static_cast<std::size_t>(at - lineText.data()) + 1 : 1;
+				m_Out->emplace_back(ParseError{ line, column, std::string{ message }, warning });
 			}
 
-			return okSpeed && okAxis && okRpm;
+			std::vector<ParseError>* m_Out;
+			std::size_t m_Count{ 0 };
+		};
+
+		//ľœǂݎ̂Ă؂܂Ő؂oČxɂ
+		inline void WarnTrailing(ErrorLog& log, std::size_t line, std::string_view lineText, const char* at)
+		{
+			std::string_view rest = lineText.substr(static_cast<std::size_t>(at - lineText.data()));
+			rest = Trim(rest.substr(0, rest.find_first_of(",:)]")));
+
+			std::string message{ "ignored \"" };
+			message.append(rest);
+			message += "\" after the number";
+			log.Warn(line, lineText, rest.data(), message);
 		}
 
-		inline bool ParseAxisEx(const std::string& token, PitchEntry& entry)
+		template <typename Fn>
+		inline void ForEachLine(std::string_view text, Fn&& fn)
 		{
-			auto lp = token.find('(');
-			auto rp = token.find(')');
-			if (lp == std::string::npos || rp == std::string::npos || rp < lp)
-			{
-				return false;
-			}
+			text = StripUtf8Bom(text);
 
-			std::string inside = token.substr(lp + 1, rp - lp - 1);
-			std::replace(inside.begin(), inside.end(), ',', ' ');
-			std::istringstream iss(inside);
-			std::string exprX;
-			std::string exprY;
-			std::string exprZ;
-			double x = 0.0;
-			double y = 0.0;
-			double z = 0.0;
+			std::size_t lineNo = 0;
+			std::size_t pos = 0;
 
-			if (!(iss >> exprX >> exprY >> exprZ))
+			while (pos < text.size())
 			{
-				return false;
+				const std::size_t nl = text.find('\n', pos);
+				const std::size_t end = (nl == std::string_view::npos) ? text.size() : nl;
+
+				fn(++lineNo, text.substr(pos, end - pos));
+				pos = end + 1;
 			}
-			else
+		}
+
+		enum class ValueKind : std::uint8_t
+		{
+			Invalid,
+			Fixed,
+			Random
+		};
+
+		struct ScalarValue
+		{
+			ValueKind Kind{ ValueKind::Invalid };
+			double Value{ 0.0 };
+			double Min{ 0.0 };
+			double Max{ 0.0 };
+			FieldSampling Sampling{};
+			const char* Trailing{ nullptr };
+		};
+
+		inline bool ParseArguments(std::string_view inner, double* out, std::size_t count, const char*& trailing) noexcept
+		{
+			for (std::size_t k = 0; k < count; ++k)
 			{
-				std::string& v = exprX;
+				const std::size_t comma = inner.find(',');
+				const bool last = (k + 1 == count);
 
-				if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
+				if (last != (comma == std::string_view::npos) || !ParseNumber(inner.substr(0, comma), out[k], trailing))
 				{
-					std::string minStr;
-					std::string maxStr;
-					std::size_t posBegin = v.find_first_of('[');
-					std::size_t posEnd = v.find_first_of(']');
-					std::size_t posSeparete = v.find_first_of(':');
-					if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-					{
-						return false;
-					}
-					minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-					maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-					try
-					{
-						double min = std::stod(minStr);
-						double max = std::stod(maxStr);
-						entry.IsRandomAxisX = true;
-						entry.XMax = max;
-						entry.XMin = min;
-					}
-					catch (...)
-					{
-						return false;
-					}
+					return false;
 				}
-				else
+
+				inner = last ? std::string_view{} : inner.substr(comma + 1);
+			}
+
+			return true;
+		}
+
+		inline bool IsRandomSyntax(std::string_view v) noexcept
+		{
+			return StartsWithCI(v, "RAND[") || StartsWithCI(v, "NORMAL(") || StartsWithCI(v, "TRUNCNORMAL(");
+		}
+
+		inline ScalarValue ParseScalar(std::string_view v, bool allowRandom) noexcept
+		{
+			ScalarValue r{};
+			v = Trim(v);
+
+			//NORMAL(,W΍)  TRUNCNORMAL(,W΍,,)BMin/Maxɂ͖ڈ͈̔͂Ă
+			if (StartsWithCI(v, "NORMAL(") || StartsWithCI(v, "TRUNCNORMAL("))
+			{
+				if (!allowRandom || v.back() != ')')
 				{
-					try
-					{
-						x = std::stod(exprX);
-					}
-					catch (...)
-					{
-						return false;
-					}
+					return r;
 				}
 
-				v = exprY;
-				if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-				{
-					std::string minStr;
-					std::string maxStr;
-					std::size_t posBegin = v.find_first_of('[');
-					std::size_t posEnd = v.find_first_of(']');
-					std::size_t posSeparete = v.find_first_of(':');
-					if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-					{
-						return false;
-					}
-					minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-					maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
+				const bool trunc = StartsWithCI(v, "TRUNCNORMAL(");
+				const std::size_t open = v.find('(');
+				double args[4]{};
 
-					try
-					{
-						double min = std::stod(minStr);
-						double max = std::stod(maxStr);
-						entry.IsRandomAxisY = true;
-						entry.YMax = max;
-						entry.YMin = min;
-					}
-					catch (...)
-					{
-						return false;
-					}
-				}
-				else
+				if (!ParseArguments(v.substr(open + 1, v.size() - open - 2), args, trunc ? 4 : 2, r.Trailing) || !(args[1] > 0.0) || (trunc && !(args[2] < args[3])))
 				{
-					try
-					{
-						y = std::stod(exprY);
-					}
-					catch (...)
-					{
-						return false;
-					}
+					return r;
 				}
 
-				v = exprZ;
-				if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
+				r.Kind = ValueKind::Random;
+				r.Sampling = FieldSampling{ trunc ? SampleKind::TruncNormal : SampleKind::Normal, args[0], args[1] };
+				r.Min = trunc ? args[2] : args[0] - NORMAL_RANGE_SIGMA * args[1];
+				r.Max = trunc ? args[3] : args[0] + NORMAL_RANGE_SIGMA * args[1];
+				return r;
+			}
+
+			if (StartsWithCI(v, "RAND["))
+			{
+				if (!allowRandom || v.back() != ']')
 				{
-					std::string minStr;
-					std::string maxStr;
-					std::size_t posBegin = v.find_first_of('[');
-					std::size_t posEnd = v.find_first_of(']');
-					std::size_t posSeparete = v.find_first_of(':');
-					if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-					{
-						return false;
-					}
-					minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-					maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
+					return r;
+				}
 
-					try
-					{
-						double min = std::stod(minStr);
-						double max = std::stod(maxStr);
-						entry.IsRandomAxisZ = true;
-						entry.ZMax = max;
-						entry.ZMin = min;
-					}
-					catch (...)
-					{
-						return false;
-					}
+				const std::string_view inner = v.substr(5, v.size() - 6);
+				const std::size_t sep = inner.find(':');
+
+				if (sep == std::string_view::npos || inner.find(':', sep + 1) != std::string_view::npos)
+				{
+					return r;
 				}
-				else
+
+				if (ParseNumber(inner.substr(0, sep), r.Min, r.Trailing) && ParseNumber(inner.substr(sep + 1), r.Max, r.Trailing))
 				{
-					try
-					{
-						z = std::stod(exprZ);
-					}
-					catch (...)
-					{
-						return false;
-					}
+					r.Kind = ValueKind::Random;
 				}
+
+				return r;
 			}
 
-			entry.Axis = PitchSim::DVec3{ x, y, z };
-			return true;
+			if (ParseNumber(v, r.Value, r.Trailing))
+			{
+				r.Kind = ValueKind::Fixed;
+			}
+
+			return r;
 		}
 
-		inline bool ParseLineKV(const std::string& line, PitchEntry& entry)
+		struct RangeField
 		{
-			std::string s = line;
-			TrimInPlace(s);
-			if (s.empty())
+			PitchField Field;
+			bool PitchEntry::* IsRandom;
+			std::optional<double> PitchEntry::* Min;
+			std::optional<double> PitchEntry::* Max;
+		};
+
+		constexpr RangeField SPEED_RANGE{ PitchField::Speed, &PitchEntry::IsRandomSpeed, &PitchEntry::SpeedMin, &PitchEntry::SpeedMax };
+		constexpr RangeField RPM_RANGE{ PitchField::Rpm, &PitchEntry::IsRandomRpm, &PitchEntry::RpmMin, &PitchEntry::RpmMax };
+		constexpr RangeField RELEASE_RANGE{ PitchField::Release, &PitchEntry::IsRandomRelease, &PitchEntry::ReleaseMin, &PitchEntry::ReleaseMax };
+		constexpr RangeField ELEVATION_RANGE{ PitchField::Elevation, &PitchEntry::IsRandomElevation, &PitchEntry::ElevationMin, &PitchEntry::ElevationMax };
+		constexpr RangeField AZIMUTH_RANGE{ PitchField::Azimuth, &PitchEntry::IsRandomAzimuth, &PitchEntry::AzimuthMin, &PitchEntry::AzimuthMax };
+
+		constexpr RangeField AXIS_RANGES[3] =
+		{
+			{ PitchField::AxisX, &PitchEntry::IsRandomAxisX, &PitchEntry::XMin, &PitchEntry::XMax },
+			{ PitchField::AxisY, &PitchEntry::IsRandomAxisY, &PitchEntry::YMin, &PitchEntry::YMax },
+			{ PitchField::AxisZ, &PitchEntry::IsRandomAxisZ, &PitchEntry::ZMin, &PitchEntry::ZMax },
+		};
+
+		inline void SetRange(PitchEntry& e, const RangeField& f, const ScalarValue& v) noexcept
+		{
+			e.*f.IsRandom = true;
+			e.*f.Min = v.Min;
+			e.*f.Max = v.Max;
+			e.Sampling[static_cast<std::size_t>(f.Field)] = v.Sampling;
+		}
+
+		enum class PitchKey : std::uint8_t
+		{
+			Unknown,
+			Speed,
+			Axis,
+			Rpm,
+			Release,
+			Elevation,
+			Azimuth,
+			Pitcher,
+			Correlate
+		};
+
+		inline PitchKey ClassifyKey(std::string_view key) noexcept
+		{
+			if (EqualsCI(key, "Speed"))
 			{
-				return false;
+				return PitchKey::Speed;
 			}
 
-			std::vector<std::string> toks = SplitTopLevelCsv(s);
-			if (toks.empty())
+			if (EqualsCI(key, "Axis"))
 			{
-				return false;
+				return PitchKey::Axis;
 			}
 
-			bool okSpeed = false;
-			bool okAxis = false;
-			bool okRpm = false;
+			if (EqualsCI(key, "RPM"))
+			{
+				return PitchKey::Rpm;
+			}
 
-			for (const std::string& tRaw : toks)
+			if (EqualsCI(key, "Release") || EqualsCI(key, "ReleaseHeight"))
 			{
-				std::string t = tRaw;
-				TrimInPlace(t);
+				return PitchKey::Release;
+			}
 
-				if (StartsWithCI(t, "Speed="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-					{
-						std::string minStr;
-						std::string maxStr;
-						std::size_t posBegin = v.find_first_of('[');
-						std::size_t posEnd = v.find_first_of(']');
-						std::size_t posSeparete = v.find_first_of(':');
-						if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-						{
-							return false;
-						}
-						minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-						maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-						try
-						{
-							double min = std::stod(minStr);
-							double max = std::stod(maxStr);
-							entry.IsRandomSpeed = true;
-							entry.SpeedMax = max;
-							entry.SpeedMin = min;
-							okSpeed = true;
-
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-					else
-					{
-						try
-						{
-							entry.Speed_kmh = std::stod(v);
-							okSpeed = true;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-				}
-				else if (StartsWithCI(t, "Axis="))
-				{
-					if (!ParseAxisEx(t, entry))
-					{
-						return false;
-					}
+			if (EqualsCI(key, "Elevation"))
+			{
+				return PitchKey::Elevation;
+			}
 
-					okAxis = true;
-				}
-				else if (StartsWithCI(t, "RPM="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-					{
-						std::string minStr;
-						std::string maxStr;
-						std::size_t posBegin = v.find_first_of('[');
-						std::size_t posEnd = v.find_first_of(']');
-						std::size_t posSeparete = v.find_first_of(':');
-						if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-						{
-							return false;
-						}
-						minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-						maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-						try
-						{
-							double min = std::stod(minStr);
-							double max = std::stod(maxStr);
-							entry.IsRandomRpm = true;
-							entry.RpmMax = max;
-							entry.RpmMin = min;
-							okRpm = true;
-
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-					else
-					{
-						try
-						{
-							entry.Rpm = std::stod(v);
-							okRpm = true;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-				}
-				else if (StartsWithCI(t, "Release=") || StartsWithCI(t, "ReleaseHeight="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-					{
-						std::string minStr;
-						std::string maxStr;
-						std::size_t posBegin = v.find_first_of('[');
-						std::size_t posEnd = v.find_first_of(']');
-						std::size_t posSeparete = v.find_first_of(':');
-						if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-						{
-							return false;
-						}
-						minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-						maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-						try
-						{
-							double min = std::stod(minStr);
-							double max = std::stod(maxStr);
-							entry.IsRandomRelease = true;
-							entry.ReleaseMax = max;
-							entry.ReleaseMin = min;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-					else
-					{
-						try
-						{
-							double val = std::stod(v);
-							entry.Release_cm = val;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-				}
-				else if (StartsWithCI(t, "Elevation="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-					{
-						std::string minStr;
-						std::string maxStr;
-						std::size_t posBegin = v.find_first_of('[');
-						std::size_t posEnd = v.find_first_of(']');
-						std::size_t posSeparete = v.find_first_of(':');
-						if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-						{
-							return false;
-						}
-						minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-						maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-						try
-						{
-							double min = std::stod(minStr);
-							double max = std::stod(maxStr);
-							entry.IsRandomElevation = true;
-							entry.ElevationMax = max;
-							entry.ElevationMin = min;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-					else
-					{
-						try
-						{
-							double val = std::stod(v);
-							entry.Elevation_deg = val;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-				}
-				else if (StartsWithCI(t, "Azimuth="))
+			if (EqualsCI(key, "Azimuth"))
+			{
+				return PitchKey::Azimuth;
+			}
+
+			if (EqualsCI(key, "Pitcher"))
+			{
+				return PitchKey::Pitcher;
+			}
+
+			if (EqualsCI(key, "Correlate"))
+			{
+				return PitchKey::Correlate;
+			}
+
+			return PitchKey::Unknown;
+		}
+
+		struct TokenError
+		{
+			const char* At{ nullptr };
+			const char* Message{ nullptr };
+		};
+
+		//͊ʂ̒J}󔒂ŋ؂BRAND[..]̒͋؂Ȃ
+		inline std::size_t FindClosingParen(std::string_view v) noexcept
+		{
+			int depth = 0;
+
+			for (std::size_t i = 0; i < v.size(); ++i)
+			{
+				if (v[i] == '(')
 				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					if (StartsWithCI(v, "RAND[") && v[v.length() - 1] == ']')
-					{
-						std::string minStr;
-						std::string maxStr;
-						std::size_t posBegin = v.find_first_of('[');
-						std::size_t posEnd = v.find_first_of(']');
-						std::size_t posSeparete = v.find_first_of(':');
-						if (posSeparete == v.npos || v.find_last_of(':') != posSeparete || posEnd == v.npos || posBegin == v.npos)
-						{
-							return false;
-						}
-						minStr = v.substr(posBegin + 1, posSeparete - posBegin - 1);
-						maxStr = v.substr(posSeparete + 1, v.length() - posSeparete - 1);
-
-						try
-						{
-							double min = std::stod(minStr);
-							double max = std::stod(maxStr);
-							entry.IsRandomAzimuth = true;
-							entry.AzimuthMax = max;
-							entry.AzimuthMin = min;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}
-					else
-					{
-						try
-						{
-							double val = std::stod(v);
-							entry.Azimuth_deg = val;
-						}
-						catch (...)
-						{
-							return false;
-						}
-					}	
+					++depth;
 				}
-				else
+				else if (v[i] == ')' && --depth == 0)
 				{
-					//
+					return i;
 				}
 			}
 
-			return okSpeed && okAxis && okRpm;
+			return std::string_view::npos;
 		}
 
-		inline bool ParseLineKV(const std::string& line, double& speed_kmh, PitchSim::DVec3& axis, double& rpm, std::optional<double>& release_cm, std::optional<double>& elevation_deg, std::optional<double>& azimuth_deg)
+		inline bool ParseAxis(std::string_view v, PitchEntry& e, bool allowRandom, const char*& trailing, TokenError& err) noexcept
 		{
-			std::string s = line;
-			TrimInPlace(s);
-			if (s.empty())
+			v = Trim(v);
+
+			//SPHERE͋ʏňlȌBƂ͈̖̔͂͌ڈƂ-1..1Ă
+			if (EqualsCI(v, "SPHERE"))
 			{
-				return false;
+				if (!allowRandom)
+				{
+					err = TokenError{ v.data(), "Axis=SPHERE is not supported here" };
+					return false;
+				}
+
+				ScalarValue unit{ ValueKind::Random, 0.0, -1.0, 1.0, FieldSampling{} };
+				for (const RangeField& f : AXIS_RANGES)
+				{
+					SetRange(e, f, unit);
+				}
+
+				e.IsRandomAxisSphere = true;
+				return true;
 			}
 
-			std::vector<std::string> toks = SplitTopLevelCsv(s);
-			if (toks.empty())
+			const std::size_t rp = (!v.empty() && v.front() == '(') ? FindClosingParen(v) : std::string_view::npos;
+			if (rp == std::string_view::npos || !Trim(v.substr(rp + 1)).empty())
 			{
+				err = TokenError{ v.data(), "Axis must be written as (x, y, z) or SPHERE" };
 				return false;
 			}
 
-			bool okSpeed = false;
-			bool okAxis = false;
-			bool okRpm = false;
+			const std::string_view inner = v.substr(1, rp - 1);
+			std::string_view parts[3];
+			std::size_t count = 0;
+			std::size_t start = 0;
+			int bracket = 0;
 
-			for (const std::string& tRaw : toks)
+			for (std::size_t i = 0; i <= inner.size(); ++i)
 			{
-				std::string t = tRaw;
-				TrimInPlace(t);
+				const bool end = (i == inner.size());
+				const char c = end ? ',' : inner[i];
 
-				if (StartsWithCI(t, "Speed="))
+				if (c == '[' || c == '(')
 				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
-					{
-						speed_kmh = std::stod(v);
-						okSpeed = true;
-					}
-					catch (...)
-					{
-						return false;
-					}
+					++bracket;
 				}
-				else if (StartsWithCI(t, "Axis="))
+				else if (c == ']' || c == ')')
 				{
-					if (!ParseAxis(t, axis))
-					{
-						return false;
-					}
-
-					okAxis = true;
+					bracket = std::max(0, bracket - 1);
 				}
-				else if (StartsWithCI(t, "RPM="))
+				else if (end || (bracket == 0 && (c == ',' || IsSpace(c))))
 				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
-					{
-						rpm = std::stod(v);
-						okRpm = true;
-					}
-					catch (...)
-					{
-						return false;
-					}
-				}
-				else if (StartsWithCI(t, "Release=") || StartsWithCI(t, "ReleaseHeight="))
-				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
+					const std::string_view part = inner.substr(start, i - start);
+					start = i + 1;
+
+					if (part.empty())
 					{
-						double val = std::stod(v);
-						release_cm = val;
+						continue;
 					}
-					catch (...)
+
+					if (count == 3)
 					{
+						err = TokenError{ part.data(), "Axis has more than three components" };
 						return false;
 					}
+
+					parts[count++] = part;
 				}
-				else if (StartsWithCI(t, "Elevation="))
+			}
+
+			if (count != 3)
+			{
+				err = TokenError{ inner.data(), "Axis needs three components" };
+				return false;
+			}
+
+			double xyz[3]{ 0.0, 0.0, 0.0 };
+
+			for (std::size_t k = 0; k < 3; ++k)
+			{
+				const ScalarValue s = ParseScalar(parts[k], allowRandom);
+				trailing = trailing ? trailing : s.Trailing;
+
+				if (s.Kind == ValueKind::Invalid)
 				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
-					{
-						double val = std::stod(v);
-						elevation_deg = val;
-					}
-					catch (...)
-					{
-						return false;
-					}
+					err = TokenError{ parts[k].data(), (IsRandomSyntax(parts[k]) && !allowRandom) ? "random values are not supported here" : "invalid Axis component" };
+					return false;
 				}
-				else if (StartsWithCI(t, "Azimuth="))
+
+				if (s.Kind == ValueKind::Random)
 				{
-					std::string v = t.substr(t.find('=') + 1);
-					TrimInPlace(v);
-					try
-					{
-						double val = std::stod(v);
-						azimuth_deg = val;
-					}
-					catch (...)
-					{
-						return false;
-					}
+					SetRange(e, AXIS_RANGES[k], s);
 				}
 				else
 				{
-					//
+					xyz[k] = s.Value;
 				}
 			}
 
-			return okSpeed && okAxis && okRpm;
+			e.Axis = PitchSim::DVec3{ xyz[0], xyz[1], xyz[2] };
+			return true;
 		}
-	}
 
-	bool LoadPitchConfigFile(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::size_t maxCount)
-	{
-		outList.clear();
-
-		std::ifstream ifs(pathUtf8, std::ios::in);
-		if (!ifs)
+		inline bool ApplyScalar(const ScalarValue& s, PitchEntry& e, const RangeField& range, double& fixed) noexcept
 		{
-			return false;
-		}
+			if (s.Kind == ValueKind::Random)
+			{
+				SetRange(e, range, s);
+			}
+			else
+			{
+				fixed = s.Value;
+			}
 
-		std::string line;
-		std::string currentLabel;
-		bool firstLine = true;
+			return s.Kind != ValueKind::Invalid;
+		}
 
-		while (std::getline(ifs, line))
+		inline bool ApplyScalar(const ScalarValue& s, PitchEntry& e, const RangeField& range, std::optional<double>& fixed) noexcept
 		{
-			if (firstLine)
+			if (s.Kind == ValueKind::Random)
+			{
+				SetRange(e, range, s);
+			}
+			else if (s.Kind == ValueKind::Fixed)
 			{
-				StripUtf8Bom(line);
-				firstLine = false;
+				fixed = s.Value;
 			}
 
-			TrimInPlace(line);
-			if (line.empty())
+			return s.Kind != ValueKind::Invalid;
+		}
+
+		struct EntryState
+		{
+			bool Speed{ false };
+			bool Axis{ false };
+			bool Rpm{ false };
+			std::string_view Pitcher;
+			FieldCorrelation Correlations[MAX_CORRELATIONS]{};
+			std::size_t CorrelationCount{ 0 };
+			const char* Trailing{ nullptr };
+		};
+
+		inline bool ToCorrelatedField(std::string_view name, PitchField& out) noexcept
+		{
+			switch (ClassifyKey(Trim(name)))
 			{
-				continue;
+				case PitchKey::Speed: out = PitchField::Speed; return true;
+				case PitchKey::Rpm: out = PitchField::Rpm; return true;
+				case PitchKey::Release: out = PitchField::Release; return true;
+				case PitchKey::Elevation: out = PitchField::Elevation; return true;
+				case PitchKey::Azimuth: out = PitchField::Azimuth; return true;
+				default: return false;
 			}
+		}
+
+		//Correlate=(Speed,RPM,0.6) ̌`B2̗ڂ𑊊֌WňꏏɈ
+		inline bool ParseCorrelation(std::string_view v, EntryState& state, TokenError& err) noexcept
+		{
+			v = Trim(v);
 
-			if (line[0] == '/')
+			const std::size_t rp = (!v.empty() && v.front() == '(') ? FindClosingParen(v) : std::string_view::npos;
+			const std::string_view inner = (rp == std::string_view::npos) ? std::string_view{} : v.substr(1, rp - 1);
+			const std::size_t c0 = inner.find(',');
+			const std::size_t c1 = (c0 == std::string_view::npos) ? c0 : inner.find(',', c0 + 1);
+
+			FieldCorrelation c{};
+			if (c1 == std::string_view::npos || !Trim(v.substr(rp + 1)).empty()
+				|| !ToCorrelatedField(inner.substr(0, c0), c.A) || !ToCorrelatedField(inner.substr(c0 + 1, c1 - c0 - 1), c.B)
+				|| !ParseNumber(inner.substr(c1 + 1), c.Rho, state.Trailing) || c.A == c.B || !(c.Rho >= -1.0 && c.Rho <= 1.0))
 			{
-				continue;
+				err = TokenError{ v.data(), "Correlate must be (field, field, rho) with two different fields and -1 <= rho <= 1" };
+				return false;
 			}
 
-			if (line[0] == '#')
+			if (state.CorrelationCount == MAX_CORRELATIONS)
 			{
-				currentLabel = line.substr(1);
-				TrimInPlace(currentLabel);
-				continue;
+				err = TokenError{ v.data(), "too many Correlate= entries" };
+				return false;
 			}
 
-			if (!currentLabel.empty())
+			state.Correlations[state.CorrelationCount++] = c;
+			return true;
+		}
+
+		inline bool IsFieldRandom(const PitchEntry& e, PitchField f) noexcept
+		{
+			switch (f)
 			{
-				double spd = 0.0;
-				PitchSim::DVec3 axis{ 0.0, 0.0, 0.0 };
-				double rpm = 0.0;
+				case PitchField::Speed: return e.IsRandomSpeed;
+				case PitchField::Rpm: return e.IsRandomRpm;
+				case PitchField::Release: return e.IsRandomRelease;
+				case PitchField::Elevation: return e.IsRandomElevation;
+				case PitchField::Azimuth: return e.IsRandomAzimuth;
+				default: return false;
+			}
+		}
+
+		inline const char* ValidateCorrelations(const PitchEntry& e, const EntryState& state) noexcept
+		{
+			bool used[PITCH_FIELD_COUNT]{};
 
-				std::optional<double> rel;
-				std::optional<double> elv;
-				std::optional<double> azm;
+			for (std::size_t k = 0; k < state.CorrelationCount; ++k)
+			{
+				const FieldCorrelation& c = state.Correlations[k];
 
-				if (ParseLineKV(line, spd, axis, rpm, rel, elv, azm))
+				if (!IsFieldRandom(e, c.A) || !IsFieldRandom(e, c.B))
 				{
-					PitchEntry e;
-					e.Label = currentLabel;
-					e.Speed_kmh = spd;
-					e.Axis = axis;
-					e.Rpm = rpm;
-					e.Release_cm = rel;
-					e.Elevation_deg = elv;
-					e.Azimuth_deg = azm;
-
-					outList.emplace_back(e);
-					currentLabel.clear();
-
-					if (outList.size() >= maxCount)
-					{
-						break;
-					}
+					return "Correlate fields must both be random";
 				}
-				else
+
+				bool& a = used[static_cast<std::size_t>(c.A)];
+				bool& b = used[static_cast<std::size_t>(c.B)];
+				if (a || b)
 				{
-					currentLabel.clear();
+					return "a field can appear in only one Correlate=";
 				}
-			}
-			else
-			{
-				//
-			}
-		}
 
-		return !outList.empty();
-	}
+				a = b = true;
+			}
 
-	bool LoadPitchConfigFileEx(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::size_t maxCount)
-	{
-		outList.clear();
+			return nullptr;
+		}
 
-		std::ifstream ifs(pathUtf8, std::ios::in);
-		if (!ifs)
+		inline bool ParseEntryToken(std::string_view token, PitchEntry& e, bool allowRandom, EntryState& state, TokenError& err) noexcept
 		{
-			return false;
-		}
+			const std::size_t eq = token.find('=');
+			if (eq == std::string_view::npos)
+			{
+				return true;
+			}
 
-		std::string line;
-		std::string currentLabel;
-		bool firstLine = true;
+			const PitchKey key = ClassifyKey(Trim(token.substr(0, eq)));
+			const std::string_view value = Trim(token.substr(eq + 1));
 
-		while (std::getline(ifs, line))
-		{
-			if (firstLine)
+			if (key == PitchKey::Unknown)
 			{
-				StripUtf8Bom(line);
-				firstLine = false;
+				return true;
 			}
 
-			TrimInPlace(line);
-			if (line.empty())
+			if (key == PitchKey::Axis)
 			{
-				continue;
+				state.Axis = ParseAxis(value, e, allowRandom, state.Trailing, err);
+				return state.Axis;
 			}
 
-			if (line[0] == '/')
+			if (key == PitchKey::Pitcher)
 			{
-				continue;
+				state.Pitcher = value;
+				return true;
 			}
 
-			if (line[0] == '#')
+			if (key == PitchKey::Correlate)
 			{
-				currentLabel = line.substr(1);
-				TrimInPlace(currentLabel);
-				continue;
+				return allowRandom ? ParseCorrelation(value, state, err) : (err = TokenError{ value.data(), "Correlate= is not supported here" }, false);
 			}
 
-			if (!currentLabel.empty())
+			const ScalarValue s = ParseScalar(value, allowRandom);
+			state.Trailing = state.Trailing ? state.Trailing : s.Trailing;
+			bool ok = false;
+
+			switch (key)
 			{
-				PitchSim::DVec3 axis{ 0.0, 0.0, 0.0 };
+				case PitchKey::Speed:
+					ok = state.Speed = ApplyScalar(s, e, SPEED_RANGE, e.Speed_kmh);
+					break;
 
-				std::optional<double> rel;
-				std::optional<double> elv;
-				std::optional<double> azm;
+				case PitchKey::Rpm:
+					ok = state.Rpm = ApplyScalar(s, e, RPM_RANGE, e.Rpm);
+					break;
 
-				PitchEntry pe{};
+				case PitchKey::Release:
+					ok = ApplyScalar(s, e, RELEASE_RANGE, e.Release_cm);
+					break;
 
-				if (ParseLineKV(line, pe))
-				{
-					pe.Label = currentLabel;
-					outList.emplace_back(pe);
-					currentLabel.clear();
+				case PitchKey::Elevation:
+					ok = ApplyScalar(s, e, ELEVATION_RANGE, e.Elevation_deg);
+					break;
 
-					if (outList.size() >= maxCount)
-					{
-						break;
-					}
+				case PitchKey::Azimuth:
+					ok = ApplyScalar(s, e, AZIMUTH_RANGE, e.Azimuth_deg);
+					break;
+
+				default:
+					break;
+			}
+
+			if (!ok)
+			{
+				const char* message = "invalid number";
+
+				if (IsRandomSyntax(value) && !allowRandom)
+				{
+					message = "random values are not supported here";
 				}
-				else
+				else if (StartsWithCI(value, "RAND["))
 				{
-					currentLabel.clear();
+					message = "RAND[] must be RAND[min:max]";
+				}
+				else if (StartsWithCI(value, "NORMAL("))
+				{
+					message = "NORMAL() must be NORMAL(mean,sigma) with sigma > 0";
+				}
+				else if (StartsWithCI(value, "TRUNCNORMAL("))
+				{
+					message = "TRUNCNORMAL() must be TRUNCNORMAL(mean,sigma,min,max) with sigma > 0 and min < max";
 				}
-			}
-			else
-			{
-				//
-			}
-		}
 
-		return !outList.empty();
-	}
+				err = TokenError{ value.data(), message };
+			}
 
-	bool LoadEnvConfigFile(const std::string& pathUtf8, EnvironmentSettings& outSettings)
-	{
-		std::ifstream ifs(pathUtf8);
-		if (!ifs)
-		{
-			return false;
+			return ok;
 		}
 
-		std::string line;
-		std::map<std::string, std::string> set;
-		while (std::getline(ifs, line))
+		inline bool ParseEntryLine(std::string_view line, PitchEntry& e, bool allowRandom, EntryState& state, TokenError& err) noexcept
 		{
-			TrimInPlace(line);
-			if (line[0] == '#')
+			std::size_t start = 0;
+			int depth = 0;
+
+			for (std::size_t i = 0; i <= line.size(); ++i)
 			{
-				continue;
+				const bool end = (i == line.size());
+				const char c = end ? ',' : line[i];
+
+				if (c == '(')
+				{
+					++depth;
+				}
+				else if (c == ')')
+				{
+					depth = std::max(0, depth - 1);
+				}
+				else if (end || (c == ',' && depth == 0))
+				{
+					const std::string_view token = Trim(line.substr(start, i - start));
+					start = i + 1;
+
+					if (!token.empty() && !ParseEntryToken(token, e, allowRandom, state, err))
+					{
+						return false;
+					}
+				}
 			}
 
-			if (line.empty())
+			if (!state.Speed || !state.Axis || !state.Rpm)
 			{
-				continue;
+				err = TokenError{ line.data(), !state.Speed ? "missing Speed=" : (!state.Axis ? "missing Axis=" : "missing RPM=") };
+				return false;
 			}
 
-			std::size_t n = line.find('=');
-			if (n == std::string::npos)
+			if (const char* message = ValidateCorrelations(e, state))
 			{
-				continue;
+				err = TokenError{ line.data(), message };
+				return false;
 			}
 
-			std::string key{};
-			std::string value{};
-			std::string keyUpper{};
-			std::string valueUpper{};
-
-			key = line.substr(0, n);
-			value = line.substr(n + 1, line.length() - key.length() - 1);
-
-			keyUpper.resize(key.size());
-			valueUpper.resize(value.size());
-
-			std::transform(key.begin(), key.end(), keyUpper.begin(), [](unsigned char c) {return std::toupper(c); });
-			std::transform(value.begin(), value.end(), valueUpper.begin(), [](unsigned char c) {return std::toupper(c); });
-
-			set[key] = value;
+			return true;
 		}
 
-		EnvironmentSettings& s = outSettings;
-
-		constexpr auto PRESSURE_SETTING_KEY = "PRESSURE";
-		constexpr auto PRESSURE_USEHEIGHT_KEY = "USEHEIGHT";
-		constexpr auto HEIGHT_KEY = "HEIGHT";
-		constexpr auto SPEED_SCALE_KEY = "SPEED";
-		constexpr auto AIR_TEMP_KEY = "TEMP";
-		constexpr auto DT_KEY = "DT";
-		constexpr auto RELHUMID_KEY = "HUMID";
-		constexpr auto RADIUS_KEY = "RADIUS";
-		constexpr auto MASS_KEY = "MASS";
-		constexpr auto ZONE_HEIGHT_KEY = "ZONEHEIGHT";
-		constexpr auto ZONE_SIZE_HEIGHT_KEY = "ZONESIZEHEIGHT";
-		constexpr auto MSAA_COUNT_KEY = "MSAA";
-		constexpr auto QUALITY_KEY = "QUALITY";
-		constexpr auto PLATE_DIST_KEY = "DISTANCE";
-
-		if (set[PRESSURE_SETTING_KEY] != "")
+		inline bool ApplyEnvSetting(std::string_view key, std::string_view value, EnvironmentSettings& s, const char*& trailing) noexcept
 		{
-			try
+			if (EqualsCI(key, "PRESSURE"))
 			{
-				s.Pressure_hPa = std::stod(set[PRESSURE_SETTING_KEY]);
+				return Assign(value, s.Pressure_hPa, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "USEHEIGHT"))
 			{
+				if (EqualsCI(value, "TRUE"))
+				{
+					s.UseHeightPressure = true;
+					return true;
+				}
+
+				if (EqualsCI(value, "FALSE"))
+				{
+					s.UseHeightPressure = false;
+					return true;
+				}
+
 				return false;
 			}
-		}
 
-		if (set[PRESSURE_USEHEIGHT_KEY] != "")
-		{
-			if (set[PRESSURE_USEHEIGHT_KEY] == "TRUE")
+			if (EqualsCI(key, "HEIGHT"))
 			{
-				s.UseHeightPressure = true;
+				return Assign(value, s.Height_m, trailing);
 			}
-			else if (set[PRESSURE_USEHEIGHT_KEY] == "FALSE")
+
+			if (EqualsCI(key, "SPEED"))
 			{
-				s.UseHeightPressure = false;
+				double scale = 0.0;
+				if (!ParseNumber(value, scale, trailing))
+				{
+					return false;
+				}
+
+				s.PitchSpeedScale = 1 / scale;
+				return true;
 			}
-			else
+
+			if (EqualsCI(key, "TEMP"))
 			{
-				return false;
+				return Assign(value, s.AirTemp_C, trailing);
 			}
-		}
 
-		if (set[HEIGHT_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "DT"))
 			{
-				s.Height_m = std::stod(set[HEIGHT_KEY]);
+				return Assign(value, s.Dt_s, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "HUMID"))
 			{
-				return false;
+				return Assign(value, s.RelHumid_pct, trailing);
 			}
-		}
 
-		if (set[SPEED_SCALE_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "RADIUS"))
 			{
-				s.PitchSpeedScale = (1 / std::stod(set[SPEED_SCALE_KEY]));
+				return Assign(value, s.Radius_mm, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "MASS"))
 			{
-				return false;
+				return Assign(value, s.Mass_kg, trailing);
 			}
-		}
 
-		if (set[AIR_TEMP_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "ZONEHEIGHT"))
 			{
-				s.AirTemp_C = std::stod(set[AIR_TEMP_KEY]);
+				return Assign(value, s.ZoneHeight_m, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "ZONESIZEHEIGHT"))
 			{
-				return false;
+				return Assign(value, s.ZoneSizeHeight_m, trailing);
 			}
-		}
 
-		if (set[DT_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "MSAA"))
 			{
-				s.Dt_s = std::stod(set[DT_KEY]);
+				return Assign(value, s.MsaaCount, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "QUALITY"))
 			{
-				return false;
+				return Assign(value, s.GraphicQuality, trailing);
 			}
-		}
 
-		if (set[RELHUMID_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "DISTANCE"))
 			{
-				s.RelHumid_pct = std::stod(set[RELHUMID_KEY]);
+				return Assign(value, s.PlateDistance_m, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "INTEGRATOR"))
 			{
+				constexpr std::pair<std::string_view, PitchSim::Integrator> METHODS[] =
+				{
+					{ "EULER", PitchSim::Integrator::Euler },
+					{ "HEUN", PitchSim::Integrator::Heun },
+					{ "RK4", PitchSim::Integrator::RK4 },
+					{ "RK45", PitchSim::Integrator::RK45 },
+				};
+
+				for (const auto& [name, method] : METHODS)
+				{
+					if (EqualsCI(value, name))
+					{
+						s.Method = method;
+						return true;
+					}
+				}
+
 				return false;
 			}
-		}
 
-		if (set[RADIUS_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "TOLERANCE"))
 			{
-				s.Radius_mm = std::stod(set[RADIUS_KEY]);
+				return Assign(value, s.Tolerance_m, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "MEMORYBUDGET"))
 			{
-				return false;
+				return Assign(value, s.MemoryBudget_MB, trailing);
 			}
-		}
 
-		if (set[MASS_KEY] != "")
-		{
-			try
+			if (EqualsCI(key, "TRAJECTORYCACHE"))
 			{
-				s.Mass_kg = std::stod(set[MASS_KEY]);
+				return Assign(value, s.TrajectoryCache_MB, trailing);
 			}
-			catch (...)
+
+			if (EqualsCI(key, "MEMORYPOLICY"))
 			{
+				if (EqualsCI(value, "DECIMATE"))
+				{
+					s.DecimateOverBudget = true;
+					return true;
+				}
+
+				if (EqualsCI(value, "WARN"))
+				{
+					s.DecimateOverBudget = false;
+					return true;
+				}
+
 				return false;
 			}
+
+			return true;
 		}
 
-		if (set[ZONE_HEIGHT_KEY] != "")
+		inline bool OpenForParse(const std::string& pathUtf8, MappedFile& file, std::vector<ParseError>* errors)
 		{
-			try
+			if (file.Open(pathUtf8))
 			{
-				s.ZoneHeight_m = std::stod(set[ZONE_HEIGHT_KEY]);
+				return true;
 			}
-			catch (...)
+
+			if (errors)
 			{
-				return false;
+				errors->emplace_back(ParseError{ 0, 0, "cannot open file" });
 			}
+
+			return false;
 		}
+	}
+
+	bool ParsePitchConfig(std::string_view text, std::vector<PitchEntry>& outList, bool allowRandom, std::vector<ParseError>* errors)
+	{
+		outList.clear();
+
+		ErrorLog log{ errors };
+		std::string_view currentLabel;
 
-		if (set[ZONE_SIZE_HEIGHT_KEY] != "")
+		//xs͎̋s܂Ńt@C̈ʒuoĂAɂ
+		ForEachLine(text, [&](std::size_t lineNo, std::string_view raw)
 		{
-			try
+			const std::string_view line = Trim(raw);
+
+			if (line.empty() || line[0] == '/')
 			{
-				s.ZoneSizeHeight_m = std::stod(set[ZONE_SIZE_HEIGHT_KEY]);
+				return;
 			}
-			catch (...)
+
+			if (line[0] == '#')
 			{
-				return false;
+				currentLabel = Trim(line.substr(1));
+				return;
 			}
-		}
 
-		if (set[MSAA_COUNT_KEY] != "")
-		{
-			try
+			if (currentLabel.empty())
 			{
-				s.MsaaCount = std::stoi(set[MSAA_COUNT_KEY]);
+				//
+				return;
 			}
-			catch (...)
+
+			PitchEntry& pe = outList.emplace_back();
+			EntryState state{};
+			TokenError err{};
+
+			if (ParseEntryLine(line, pe, allowRandom, state, err))
 			{
-				return false;
+				pe.Label.assign(currentLabel.data(), currentLabel.size());
+				pe.Pitcher.assign(state.Pitcher.data(), state.Pitcher.size());
+				pe.Correlations.assign(state.Correlations, state.Correlations + state.CorrelationCount);
+
+				if (state.Trailing)
+				{
+					WarnTrailing(log, lineNo, raw, state.Trailing);
+				}
 			}
-		}
+			else
+			{
+				outList.pop_back();
+				log.Add(lineNo, raw, err.At, err.Message);
+			}
+
+			currentLabel = std::string_view{};
+		});
+
+		return !outList.empty();
+	}
+
+	bool ParseEnvConfig(std::string_view text, EnvironmentSettings& outSettings, std::vector<ParseError>* errors)
+	{
+		ErrorLog log{ errors };
 
-		if (set[QUALITY_KEY] != "")
+		ForEachLine(text, [&](std::size_t lineNo, std::string_view raw)
 		{
-			try
+			const std::string_view line = Trim(raw);
+
+			if (line.empty() || line[0] == '#')
 			{
-				s.GraphicQuality = std::stoi(set[QUALITY_KEY]);
+				return;
 			}
-			catch (...)
+
+			const std::size_t eq = line.find('=');
+			if (eq == std::string_view::npos)
 			{
-				return false;
+				return;
 			}
-		}
 
-		if (set[PLATE_DIST_KEY] != "")
-		{
-			try
+			const std::string_view key = Trim(line.substr(0, eq));
+			const std::string_view value = Trim(line.substr(eq + 1));
+
+			if (value.empty())
 			{
-				s.PlateDistance_m = std::stod(set[PLATE_DIST_KEY]);
+				return;
 			}
-			catch (...)
+
+			const char* trailing = nullptr;
+
+			if (!ApplyEnvSetting(key, value, outSettings, trailing))
 			{
-				return false;
+				std::string message{ "invalid value for " };
+				message.append(key);
+				log.Add(lineNo, raw, value.data(), message);
+			}
+			else if (trailing)
+			{
+				WarnTrailing(log, lineNo, raw, trailing);
 			}
+		});
+
+		return log.Count() == 0;
+	}
+
+	bool LoadPitchConfigFile(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::vector<ParseError>* errors)
+	{
+		outList.clear();
+
+		MappedFile file;
+		if (!OpenForParse(pathUtf8, file, errors))
+		{
+			return false;
 		}
 
-		return true;
+		return ParsePitchConfig(file.View(), outList, false, errors);
+	}
+
+	bool LoadPitchConfigFileEx(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::vector<ParseError>* errors)
+	{
+		outList.clear();
+
+		MappedFile file;
+		if (!OpenForParse(pathUtf8, file, errors))
+		{
+			return false;
+		}
+
+		return ParsePitchConfig(file.View(), outList, true, errors);
+	}
+
+	bool LoadEnvConfigFile(const std::string& pathUtf8, EnvironmentSettings& outSettings, std::vector<ParseError>* errors)
+	{
+		MappedFile file;
+		if (!OpenForParse(pathUtf8, file, errors))
+		{
+			return false;
+		}
+
+		return ParseEnvConfig(file.View(), outSettings, errors);
+	}
+
+	std::string FormatParseError(const std::string& path, const ParseError& error)
+	{
+		std::string out = path;
+		out += '(';
+		out += std::to_string(error.Line);
+		out += ',';
+		out += std::to_string(error.Column);
+		out += error.Warning ? "): warning: " : "): ";
+		out += error.Message;
+		return out;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 #include <optional>
@@ -9,9 +10,53 @@
 
 namespace PitchSim::Config
 {
+	enum class PitchField : std::uint8_t
+	{
+		Speed,
+		AxisX,
+		AxisY,
+		AxisZ,
+		Rpm,
+		Release,
+		Elevation,
+		Azimuth,
+		Count
+	};
+
+	constexpr std::size_t PITCH_FIELD_COUNT = static_cast<std::size_t>(PitchField::Count);
+
+	enum class SampleKind : std::uint8_t
+	{
+		Uniform,
+		Normal,
+		TruncNormal
+	};
+
+	struct FieldSampling
+	{
+		SampleKind Kind{ SampleKind::Uniform };
+		double Mean{ 0.0 };
+		double Sigma{ 0.0 };
+
+		bool operator==(const FieldSampling&) const noexcept = default;
+	};
+
+	struct FieldCorrelation
+	{
+		PitchField A{ PitchField::Speed };
+		PitchField B{ PitchField::Rpm };
+		double Rho{ 0.0 };
+
+		bool operator==(const FieldCorrelation&) const noexcept = default;
+	};
+
+	constexpr double NORMAL_RANGE_SIGMA = 3.0;
+	constexpr std::size_t MAX_CORRELATIONS = 4;
+
 	struct PitchEntry
 	{
 		std::string Label;
+		std::string Pitcher;
 		bool IsRandomSpeed = false;
 		double Speed_kmh = 0.0;
 		std::optional<double> SpeedMin;
@@ -47,6 +92,10 @@ namespace PitchSim::Config
 		std::optional<double> Azimuth_deg;
 		std::optional<double> AzimuthMin;
 		std::optional<double> AzimuthMax;
+
+		FieldSampling Sampling[PITCH_FIELD_COUNT]{};
+		bool IsRandomAxisSphere = false;
+		std::vector<FieldCorrelation> Correlations;
 	};
 
 	struct EnvironmentSettings
@@ -65,11 +114,31 @@ namespace PitchSim::Config
 		std::optional<int> MsaaCount;
 		std::optional<int> GraphicQuality;
 		std::optional<double> PlateDistance_m;
+		std::optional<PitchSim::Integrator> Method;
+		std::optional<double> Tolerance_m;
+		std::optional<std::uint64_t> MemoryBudget_MB;
+		std::optional<bool> DecimateOverBudget;
+		std::optional<std::uint64_t> TrajectoryCache_MB;
 	};
 
-	bool LoadPitchConfigFile(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::size_t maxCount = 8);
+	struct ParseError
+	{
+		std::size_t Line{ 0 };
+		std::size_t Column{ 0 };
+		std::string Message;
+		bool Warning{ false };
+	};
+
+	constexpr std::size_t MAX_REPORTED_ERRORS = 100;
+
+	bool ParsePitchConfig(std::string_view text, std::vector<PitchEntry>& outList, bool allowRandom, std::vector<ParseError>* errors = nullptr);
+	bool ParseEnvConfig(std::string_view text, EnvironmentSettings& outSettings, std::vector<ParseError>* errors = nullptr);
+
+	bool LoadPitchConfigFile(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::vector<ParseError>* errors = nullptr);
+
+	bool LoadEnvConfigFile(const std::string& pathUtf8, EnvironmentSettings& outSettings, std::vector<ParseError>* errors = nullptr);
 
-	bool LoadEnvConfigFile(const std::string& pathUtf8, EnvironmentSettings& outSettings);
+	bool LoadPitchConfigFileEx(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::vector<ParseError>* errors = nullptr);
 
-	bool LoadPitchConfigFileEx(const std::string& pathUtf8, std::vector<PitchEntry>& outList, std::size_t maxCount);
+	std::string FormatParseError(const std::string& path, const ParseError& error);
 }
\ No newline at end of file
@@ -0,0 +1,550 @@
+#include "PitchLibrary.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+namespace PitchSim
+{
+	static_assert(std::endian::native == std::endian::little, "PitchLibrary snapshots are stored little-endian");
+
+	namespace
+	{
+		enum class Section : std::uint32_t
+		{
+			Fields,
+			Flags = static_cast<std::uint32_t>(PitchField::Count),
+			DistributionIds,
+			Distributions,
+			Ranges,
+			Correlations,
+			LabelIds,
+			PitcherIds,
+			StringOffsets,
+			StringBytes,
+			LabelIndex,
+			PitcherIndex,
+			Count
+		};
+
+		constexpr std::size_t SECTION_COUNT = static_cast<std::size_t>(Section::Count);
+		constexpr std::size_t SECTION_ALIGN = 8;
+
+		struct SectionRef
+		{
+			std::uint64_t Offset;
+			std::uint64_t Size;
+		};
+
+		struct Header
+		{
+			char Magic[8];
+			std::uint32_t Version;
+			std::uint32_t SectionCount;
+			std::uint32_t EntryCount;
+			std::uint32_t StringCount;
+			std::uint32_t DistributionCount;
+			std::uint32_t RangeCount;
+			std::uint32_t CorrelationCount;
+			std::uint32_t Reserved;
+			std::uint64_t FileSize;
+			std::uint64_t SourceHash;
+			SectionRef Sections[SECTION_COUNT];
+		};
+
+		static_assert(sizeof(Header) % SECTION_ALIGN == 0);
+
+		constexpr std::size_t Index(Section s) noexcept
+		{
+			return static_cast<std::size_t>(s);
+		}
+
+		constexpr std::size_t FieldSection(std::size_t field) noexcept
+		{
+			return Index(Section::Fields) + field;
+		}
+
+		struct FieldAccess
+		{
+			bool Config::PitchEntry::* IsRandom;
+			std::optional<double> Config::PitchEntry::* Min;
+			std::optional<double> Config::PitchEntry::* Max;
+		};
+
+		constexpr FieldAccess FIELD_ACCESS[PitchLibrary::FIELD_COUNT] =
+		{
+			{ &Config::PitchEntry::IsRandomSpeed, &Config::PitchEntry::SpeedMin, &Config::PitchEntry::SpeedMax },
+			{ &Config::PitchEntry::IsRandomAxisX, &Config::PitchEntry::XMin, &Config::PitchEntry::XMax },
+			{ &Config::PitchEntry::IsRandomAxisY, &Config::PitchEntry::YMin, &Config::PitchEntry::YMax },
+			{ &Config::PitchEntry::IsRandomAxisZ, &Config::PitchEntry::ZMin, &Config::PitchEntry::ZMax },
+			{ &Config::PitchEntry::IsRandomRpm, &Config::PitchEntry::RpmMin, &Config::PitchEntry::RpmMax },
+			{ &Config::PitchEntry::IsRandomRelease, &Config::PitchEntry::ReleaseMin, &Config::PitchEntry::ReleaseMax },
+			{ &Config::PitchEntry::IsRandomElevation, &Config::PitchEntry::ElevationMin, &Config::PitchEntry::ElevationMax },
+			{ &Config::PitchEntry::IsRandomAzimuth, &Config::PitchEntry::AzimuthMin, &Config::PitchEntry::AzimuthMax },
+		};
+
+		inline double FixedValue(const Config::PitchEntry& e, std::size_t field) noexcept
+		{
+			switch (static_cast<PitchField>(field))
+			{
+				case PitchField::Speed: return e.Speed_kmh;
+				case PitchField::AxisX: return e.Axis.X;
+				case PitchField::AxisY: return e.Axis.Y;
+				case PitchField::AxisZ: return e.Axis.Z;
+				case PitchField::Rpm: return e.Rpm;
+				case PitchField::Release: return e.Release_cm.value_or(0.0);
+				case PitchField::Elevation: return e.Elevation_deg.value_or(0.0);
+				case PitchField::Azimuth: return e.Azimuth_deg.value_or(0.0);
+				default: return 0.0;
+			}
+		}
+
+		inline void SetError(std::string* error, const char* message)
+		{
+			if (error)
+			{
+				*error = message;
+			}
+		}
+
+		class SnapshotWriter
+		{
+		public:
+			explicit SnapshotWriter(std::string& buffer) noexcept : m_Buffer(buffer) {}
+
+			template <typename T>
+			SectionRef Write(const std::vector<T>& values)
+			{
+				m_Buffer.resize((m_Buffer.size() + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN, '\0');
+
+				const SectionRef ref{ m_Buffer.size(), values.size() * sizeof(T) };
+				if (ref.Size > 0)
+				{
+					m_Buffer.append(reinterpret_cast<const char*>(values.data()), ref.Size);
+				}
+
+				return ref;
+			}
+
+		private:
+			std::string& m_Buffer;
+		};
+
+		template <typename T>
+		inline bool MapSection(const MappedFile& file, const SectionRef& ref, std::size_t expectedCount, std::span<const T>& out) noexcept
+		{
+			if (ref.Offset % alignof(T) != 0 || ref.Offset > file.Size() || ref.Size > file.Size() - ref.Offset || ref.Size != expectedCount * sizeof(T))
+			{
+				return false;
+			}
+
+			out = std::span<const T>{ reinterpret_cast<const T*>(file.Data() + ref.Offset), expectedCount };
+			return true;
+		}
+	}
+
+	std::uint64_t PitchLibrary::HashSource(std::string_view text) noexcept
+	{
+		std::uint64_t h = 14695981039346656037ull;
+
+		for (const char c : text)
+		{
+			h ^= static_cast<unsigned char>(c);
+			h *= 1099511628211ull;
+		}
+
+		return h;
+	}
+
+	bool PitchLibrary::Compile(const std::vector<Config::PitchEntry>& entries, std::uint64_t sourceHash, const std::string& path, std::string* error)
+	{
+		const std::size_t n = entries.size();
+		if (n == 0)
+		{
+			SetError(error, "no pitches to compile");
+			return false;
+		}
+
+		std::vector<std::string_view> strings;
+		strings.reserve(n * 2);
+		for (const Config::PitchEntry& e : entries)
+		{
+			strings.emplace_back(e.Label);
+			strings.emplace_back(e.Pitcher);
+		}
+
+		std::sort(strings.begin(), strings.end());
+		strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+		const auto stringId = [&](std::string_view s) noexcept
+		{
+			return static_cast<std::uint32_t>(std::lower_bound(strings.begin(), strings.end(), s) - strings.begin());
+		};
+
+		std::vector<std::uint32_t> stringOffsets;
+		std::vector<char> stringBytes;
+		stringOffsets.reserve(strings.size() + 1);
+		for (const std::string_view s : strings)
+		{
+			stringOffsets.push_back(static_cast<std::uint32_t>(stringBytes.size()));
+			stringBytes.insert(stringBytes.end(), s.begin(), s.end());
+		}
+		stringOffsets.push_back(static_cast<std::uint32_t>(stringBytes.size()));
+
+		std::vector<double> fields[FIELD_COUNT];
+		for (std::vector<double>& f : fields)
+		{
+			f.reserve(n);
+		}
+
+		std::vector<std::uint8_t> flags(n, 0);
+		std::vector<std::uint32_t> distributionIds(n, NO_DISTRIBUTION);
+		std::vector<PitchDistribution> distributions;
+		std::vector<PitchRange> ranges;
+		std::vector<PitchCorrelation> correlations;
+		std::vector<std::uint32_t> labelIds(n);
+		std::vector<std::uint32_t> pitcherIds(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const Config::PitchEntry& e = entries[i];
+			PitchDistribution dist{ 0, static_cast<std::uint32_t>(ranges.size()), static_cast<std::uint32_t>(correlations.size()), static_cast<std::uint32_t>(e.Correlations.size()) };
+
+			for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+			{
+				fields[f].push_back(FixedValue(e, f));
+
+				const FieldAccess& access = FIELD_ACCESS[f];
+				if (e.*access.IsRandom)
+				{
+					dist.FieldMask |= 1u << f;
+					const Config::FieldSampling& s = e.Sampling[f];
+					ranges.push_back(PitchRange{ (e.*access.Min).value_or(0.0), (e.*access.Max).value_or(0.0), s.Mean, s.Sigma, static_cast<std::uint32_t>(s.Kind), 0 });
+				}
+			}
+
+			for (const Config::FieldCorrelation& c : e.Correlations)
+			{
+				correlations.push_back(PitchCorrelation{ static_cast<std::uint32_t>(c.A) | (static_cast<std::uint32_t>(c.B) << 8), 0, c.Rho });
+			}
+
+			if (dist.FieldMask != 0)
+			{
+				distributionIds[i] = static_cast<std::uint32_t>(distributions.size());
+				distributions.push_back(dist);
+			}
+
+			flags[i] = static_cast<std::uint8_t>((e.Release_cm ? HAS_RELEASE : 0) | (e.Elevation_deg ? HAS_ELEVATION : 0) | (e.Azimuth_deg ? HAS_AZIMUTH : 0) | (e.IsRandomAxisSphere ? HAS_AXIS_SPHERE : 0));
+			labelIds[i] = stringId(e.Label);
+			pitcherIds[i] = stringId(e.Pitcher);
+		}
+
+		const auto buildIndex = [n](const std::vector<std::uint32_t>& ids)
+		{
+			std::vector<std::uint32_t> index(n);
+			std::iota(index.begin(), index.end(), 0u);
+			std::stable_sort(index.begin(), index.end(), [&](std::uint32_t a, std::uint32_t b) noexcept { return ids[a] < ids[b]; });
+			return index;
+		};
+
+		Header header{};
+		std::memcpy(header.Magic, MAGIC, sizeof(header.Magic));
+		header.Version = VERSION;
+		header.SectionCount = static_cast<std::uint32_t>(SECTION_COUNT);
+		header.EntryCount = static_cast<std::uint32_t>(n);
+		header.StringCount = static_cast<std::uint32_t>(strings.size());
+		header.DistributionCount = static_cast<std::uint32_t>(distributions.size());
+		header.RangeCount = static_cast<std::uint32_t>(ranges.size());
+		header.CorrelationCount = static_cast<std::uint32_t>(correlations.size());
+		header.SourceHash = sourceHash;
+
+		std::string buffer(sizeof(Header), '\0');
+		SnapshotWriter writer{ buffer };
+
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			header.Sections[FieldSection(f)] = writer.Write(fields[f]);
+		}
+
+		header.Sections[Index(Section::Flags)] = writer.Write(flags);
+		header.Sections[Index(Section::DistributionIds)] = writer.Write(distributionIds);
+		header.Sections[Index(Section::Distributions)] = writer.Write(distributions);
+		header.Sections[Index(Section::Ranges)] = writer.Write(ranges);
+		header.Sections[Index(Section::Correlations)] = writer.Write(correlations);
+		header.Sections[Index(Section::LabelIds)] = writer.Write(labelIds);
+		header.Sections[Index(Section::PitcherIds)] = writer.Write(pitcherIds);
+		header.Sections[Index(Section::StringOffsets)] = writer.Write(stringOffsets);
+		header.Sections[Index(Section::StringBytes)] = writer.Write(stringBytes);
+		header.Sections[Index(Section::LabelIndex)] = writer.Write(buildIndex(labelIds));
+		header.Sections[Index(Section::PitcherIndex)] = writer.Write(buildIndex(pitcherIds));
+
+		header.FileSize = buffer.size();
+		std::memcpy(buffer.data(), &header, sizeof(Header));
+
+		std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+		if (!ofs)
+		{
+			SetError(error, "cannot create snapshot file");
+			return false;
+		}
+
+		ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if (!ofs)
+		{
+			SetError(error, "failed to write snapshot file");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool PitchLibrary::Open(const std::string& path, std::string* error)
+	{
+		Close();
+
+		if (!m_File.Open(path))
+		{
+			SetError(error, "cannot open snapshot file");
+			return false;
+		}
+
+		Header header{};
+		if (m_File.Size() < sizeof(Header))
+		{
+			SetError(error, "snapshot is truncated");
+			Close();
+			return false;
+		}
+
+		std::memcpy(&header, m_File.Data(), sizeof(Header));
+
+		if (std::memcmp(header.Magic, MAGIC, sizeof(header.Magic)) != 0)
+		{
+			SetError(error, "not a pitch library snapshot");
+			Close();
+			return false;
+		}
+
+		if (header.Version != VERSION || header.SectionCount != SECTION_COUNT)
+		{
+			SetError(error, "unsupported snapshot version");
+			Close();
+			return false;
+		}
+
+		if (header.FileSize != m_File.Size() || header.EntryCount == 0)
+		{
+			SetError(error, "snapshot size does not match header");
+			Close();
+			return false;
+		}
+
+		const std::size_t n = header.EntryCount;
+		const SectionRef* sections = header.Sections;
+		std::span<const std::uint32_t> stringOffsets;
+		std::span<const char> stringBytes;
+		bool ok = true;
+
+		for (std::size_t f = 0; f < FIELD_COUNT && ok; ++f)
+		{
+			std::span<const double> column;
+			ok = MapSection(m_File, sections[FieldSection(f)], n, column);
+			m_Fields[f] = column.data();
+		}
+
+		ok = ok && MapSection(m_File, sections[Index(Section::Flags)], n, m_Flags);
+		ok = ok && MapSection(m_File, sections[Index(Section::DistributionIds)], n, m_DistributionIds);
+		ok = ok && MapSection(m_File, sections[Index(Section::Distributions)], header.DistributionCount, m_Distributions);
+		ok = ok && MapSection(m_File, sections[Index(Section::Ranges)], header.RangeCount, m_Ranges);
+		ok = ok && MapSection(m_File, sections[Index(Section::Correlations)], header.CorrelationCount, m_Correlations);
+		ok = ok && MapSection(m_File, sections[Index(Section::LabelIds)], n, m_LabelIds);
+		ok = ok && MapSection(m_File, sections[Index(Section::PitcherIds)], n, m_PitcherIds);
+		ok = ok && MapSection(m_File, sections[Index(Section::StringOffsets)], std::size_t{ header.StringCount } + 1, stringOffsets);
+		ok = ok && MapSection(m_File, sections[Index(Section::StringBytes)], sections[Index(Section::StringBytes)].Size, stringBytes);
+		ok = ok && MapSection(m_File, sections[Index(Section::LabelIndex)], n, m_LabelIndex);
+		ok = ok && MapSection(m_File, sections[Index(Section::PitcherIndex)], n, m_PitcherIndex);
+
+		ok = ok && std::is_sorted(stringOffsets.begin(), stringOffsets.end()) && stringOffsets.back() == stringBytes.size();
+
+		for (const PitchDistribution& d : m_Distributions)
+		{
+			ok = ok && std::size_t{ d.FirstRange } + std::popcount(d.FieldMask) <= m_Ranges.size()
+				&& std::size_t{ d.FirstCorrelation } + d.CorrelationCount <= m_Correlations.size();
+		}
+
+		for (const PitchRange& r : m_Ranges)
+		{
+			ok = ok && r.Kind <= static_cast<std::uint32_t>(Config::SampleKind::TruncNormal);
+		}
+
+		for (const PitchCorrelation& c : m_Correlations)
+		{
+			ok = ok && (c.Fields & 0xFFu) < FIELD_COUNT && (c.Fields >> 8) < FIELD_COUNT;
+		}
+
+		for (std::size_t i = 0; i < n && ok; ++i)
+		{
+			ok = m_LabelIds[i] < header.StringCount && m_PitcherIds[i] < header.StringCount && m_LabelIndex[i] < n && m_PitcherIndex[i] < n
+				&& (m_DistributionIds[i] == NO_DISTRIBUTION || m_DistributionIds[i] < m_Distributions.size());
+		}
+
+		if (!ok)
+		{
+			SetError(error, "snapshot section table is corrupt");
+			Close();
+			return false;
+		}
+
+		m_Count = n;
+		m_StringCount = header.StringCount;
+		m_SourceHash = header.SourceHash;
+		m_StringOffsets = stringOffsets;
+		m_StringBytes = std::string_view{ stringBytes.data(), stringBytes.size() };
+		return true;
+	}
+
+	void PitchLibrary::Close() noexcept
+	{
+		m_File.Close();
+		m_Count = 0;
+		m_StringCount = 0;
+		m_SourceHash = 0;
+		std::fill(std::begin(m_Fields), std::end(m_Fields), nullptr);
+		m_Flags = {};
+		m_DistributionIds = {};
+		m_Distributions = {};
+		m_Ranges = {};
+		m_Correlations = {};
+		m_LabelIds = {};
+		m_PitcherIds = {};
+		m_StringOffsets = {};
+		m_StringBytes = {};
+		m_LabelIndex = {};
+		m_PitcherIndex = {};
+	}
+
+	const PitchDistribution* PitchLibrary::Distribution(std::size_t index) const noexcept
+	{
+		const std::uint32_t id = m_DistributionIds[index];
+		return id == NO_DISTRIBUTION ? nullptr : &m_Distributions[id];
+	}
+
+	std::string_view PitchLibrary::String(std::uint32_t id) const noexcept
+	{
+		return m_StringBytes.substr(m_StringOffsets[id], m_StringOffsets[id + 1] - m_StringOffsets[id]);
+	}
+
+	bool PitchLibrary::FindString(std::string_view s, std::uint32_t& id) const noexcept
+	{
+		std::uint32_t lo = 0;
+		std::uint32_t hi = static_cast<std::uint32_t>(m_StringCount);
+
+		while (lo < hi)
+		{
+			const std::uint32_t mid = lo + (hi - lo) / 2;
+			if (String(mid) < s)
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+
+		id = lo;
+		return lo < m_StringCount && String(lo) == s;
+	}
+
+	std::span<const std::uint32_t> PitchLibrary::Find(std::span<const std::uint32_t> index, std::span<const std::uint32_t> ids, std::string_view s) const noexcept
+	{
+		std::uint32_t id = 0;
+		if (!FindString(s, id))
+		{
+			return {};
+		}
+
+		const auto lo = std::partition_point(index.begin(), index.end(), [&](std::uint32_t e) noexcept { return ids[e] < id; });
+		const auto hi = std::partition_point(lo, index.end(), [&](std::uint32_t e) noexcept { return ids[e] == id; });
+		return std::span<const std::uint32_t>{ lo, hi };
+	}
+
+	std::span<const std::uint32_t> PitchLibrary::FindByLabel(std::string_view label) const noexcept
+	{
+		return Find(m_LabelIndex, m_LabelIds, label);
+	}
+
+	std::span<const std::uint32_t> PitchLibrary::FindByPitcher(std::string_view pitcher) const noexcept
+	{
+		return Find(m_PitcherIndex, m_PitcherIds, pitcher);
+	}
+
+	void PitchLibrary::Materialize(std::size_t index, Config::PitchEntry& out) const
+	{
+		out = Config::PitchEntry{};
+		out.Label.assign(Label(index));
+		out.Pitcher.assign(Pitcher(index));
+
+		out.Speed_kmh = Value(PitchField::Speed, index);
+		out.Axis = DVec3{ Value(PitchField::AxisX, index), Value(PitchField::AxisY, index), Value(PitchField::AxisZ, index) };
+		out.Rpm = Value(PitchField::Rpm, index);
+
+		const std::uint8_t flags = m_Flags[index];
+		if (flags & HAS_RELEASE)
+		{
+			out.Release_cm = Value(PitchField::Release, index);
+		}
+
+		if (flags & HAS_ELEVATION)
+		{
+			out.Elevation_deg = Value(PitchField::Elevation, index);
+		}
+
+		if (flags & HAS_AZIMUTH)
+		{
+			out.Azimuth_deg = Value(PitchField::Azimuth, index);
+		}
+
+		out.IsRandomAxisSphere = (flags & HAS_AXIS_SPHERE) != 0;
+
+		const PitchDistribution* dist = Distribution(index);
+		if (!dist)
+		{
+			return;
+		}
+
+		const PitchRange* range = &m_Ranges[dist->FirstRange];
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			if (dist->FieldMask & (1u << f))
+			{
+				const FieldAccess& access = FIELD_ACCESS[f];
+				out.*access.IsRandom = true;
+				out.*access.Min = range->Min;
+				out.*access.Max = range->Max;
+				out.Sampling[f] = Config::FieldSampling{ static_cast<Config::SampleKind>(range->Kind), range->Mean, range->Sigma };
+				++range;
+			}
+		}
+
+		for (const PitchCorrelation& c : m_Correlations.subspan(dist->FirstCorrelation, dist->CorrelationCount))
+		{
+			out.Correlations.push_back(Config::FieldCorrelation{ static_cast<PitchField>(c.Fields & 0xFFu), static_cast<PitchField>(c.Fields >> 8), c.Rho });
+		}
+	}
+
+	void PitchLibrary::MaterializeAll(std::vector<Config::PitchEntry>& out) const
+	{
+		out.clear();
+		out.reserve(m_Count);
+
+		for (std::size_t i = 0; i < m_Count; ++i)
+		{
+			Materialize(i, out.emplace_back());
+		}
+	}
+}
\ No newline at end of file
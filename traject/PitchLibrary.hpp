@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "PitchConfig.hpp"
+
+namespace PitchSim
+{
+	using Config::PitchField;
+
+	struct PitchRange
+	{
+		double Min;
+		double Max;
+		double Mean;
+		double Sigma;
+		std::uint32_t Kind;
+		std::uint32_t Reserved;
+	};
+
+	struct PitchCorrelation
+	{
+		std::uint32_t Fields;
+		std::uint32_t Reserved;
+		double Rho;
+	};
+
+	struct PitchDistribution
+	{
+		std::uint32_t FieldMask;
+		std::uint32_t FirstRange;
+		std::uint32_t FirstCorrelation;
+		std::uint32_t CorrelationCount;
+	};
+
+	class PitchLibrary
+	{
+	public:
+		static constexpr char MAGIC[8] = { 'P', 'S', 'L', 'I', 'B', '\0', '\0', '\0' };
+		static constexpr std::uint32_t VERSION = 2;
+		static constexpr std::uint32_t NO_DISTRIBUTION = 0xFFFFFFFFu;
+		static constexpr std::size_t FIELD_COUNT = static_cast<std::size_t>(PitchField::Count);
+
+		static constexpr std::uint8_t HAS_RELEASE = 1u << 0;
+		static constexpr std::uint8_t HAS_ELEVATION = 1u << 1;
+		static constexpr std::uint8_t HAS_AZIMUTH = 1u << 2;
+		static constexpr std::uint8_t HAS_AXIS_SPHERE = 1u << 3;
+
+		PitchLibrary() = default;
+		PitchLibrary(const PitchLibrary&) = delete;
+		PitchLibrary(PitchLibrary&&) noexcept = default;
+		~PitchLibrary() = default;
+		PitchLibrary& operator=(const PitchLibrary&) = delete;
+		PitchLibrary& operator=(PitchLibrary&&) noexcept = default;
+
+		static bool Compile(const std::vector<Config::PitchEntry>& entries, std::uint64_t sourceHash, const std::string& path, std::string* error = nullptr);
+		static std::uint64_t HashSource(std::string_view text) noexcept;
+
+		bool Open(const std::string& path, std::string* error = nullptr);
+		void Close() noexcept;
+
+		bool IsOpen() const noexcept { return m_File.IsOpen() && m_Count > 0; }
+		std::size_t Size() const noexcept { return m_Count; }
+		std::uint64_t SourceHash() const noexcept { return m_SourceHash; }
+		std::size_t StringCount() const noexcept { return m_StringCount; }
+		std::size_t DistributionCount() const noexcept { return m_Distributions.size(); }
+
+		double Value(PitchField field, std::size_t index) const noexcept { return m_Fields[static_cast<std::size_t>(field)][index]; }
+		std::uint8_t Flags(std::size_t index) const noexcept { return m_Flags[index]; }
+		const PitchDistribution* Distribution(std::size_t index) const noexcept;
+		std::string_view Label(std::size_t index) const noexcept { return String(m_LabelIds[index]); }
+		std::string_view Pitcher(std::size_t index) const noexcept { return String(m_PitcherIds[index]); }
+
+		std::span<const std::uint32_t> FindByLabel(std::string_view label) const noexcept;
+		std::span<const std::uint32_t> FindByPitcher(std::string_view pitcher) const noexcept;
+
+		void Materialize(std::size_t index, Config::PitchEntry& out) const;
+		void MaterializeAll(std::vector<Config::PitchEntry>& out) const;
+
+	private:
+		std::string_view String(std::uint32_t id) const noexcept;
+		bool FindString(std::string_view s, std::uint32_t& id) const noexcept;
+		std::span<const std::uint32_t> Find(std::span<const std::uint32_t> index, std::span<const std::uint32_t> ids, std::string_view s) const noexcept;
+
+		MappedFile m_File;
+		std::size_t m_Count{ 0 };
+		std::size_t m_StringCount{ 0 };
+		std::uint64_t m_SourceHash{ 0 };
+
+		const double* m_Fields[FIELD_COUNT]{};
+		std::span<const std::uint8_t> m_Flags;
+		std::span<const std::uint32_t> m_DistributionIds;
+		std::span<const PitchDistribution> m_Distributions;
+		std::span<const PitchRange> m_Ranges;
+		std::span<const PitchCorrelation> m_Correlations;
+		std::span<const std::uint32_t> m_LabelIds;
+		std::span<const std::uint32_t> m_PitcherIds;
+		std::span<const std::uint32_t> m_StringOffsets;
+		std::string_view m_StringBytes;
+		std::span<const std::uint32_t> m_LabelIndex;
+		std::span<const std::uint32_t> m_PitcherIndex;
+	};
+}
\ No newline at end of file
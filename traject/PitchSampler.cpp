@@ -0,0 +1,376 @@
+#include "PitchSampler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <optional>
+
+namespace PitchSim
+{
+	namespace
+	{
+		struct FieldRange
+		{
+			bool Config::PitchEntry::* IsRandom;
+			std::optional<double> Config::PitchEntry::* Min;
+			std::optional<double> Config::PitchEntry::* Max;
+		};
+
+		constexpr FieldRange FIELD_RANGES[PitchSampler::FIELD_COUNT] =
+		{
+			{ &Config::PitchEntry::IsRandomSpeed, &Config::PitchEntry::SpeedMin, &Config::PitchEntry::SpeedMax },
+			{ &Config::PitchEntry::IsRandomAxisX, &Config::PitchEntry::XMin, &Config::PitchEntry::XMax },
+			{ &Config::PitchEntry::IsRandomAxisY, &Config::PitchEntry::YMin, &Config::PitchEntry::YMax },
+			{ &Config::PitchEntry::IsRandomAxisZ, &Config::PitchEntry::ZMin, &Config::PitchEntry::ZMax },
+			{ &Config::PitchEntry::IsRandomRpm, &Config::PitchEntry::RpmMin, &Config::PitchEntry::RpmMax },
+			{ &Config::PitchEntry::IsRandomRelease, &Config::PitchEntry::ReleaseMin, &Config::PitchEntry::ReleaseMax },
+			{ &Config::PitchEntry::IsRandomElevation, &Config::PitchEntry::ElevationMin, &Config::PitchEntry::ElevationMax },
+			{ &Config::PitchEntry::IsRandomAzimuth, &Config::PitchEntry::AzimuthMin, &Config::PitchEntry::AzimuthMax },
+		};
+
+		constexpr std::size_t Index(PitchField f) noexcept
+		{
+			return static_cast<std::size_t>(f);
+		}
+
+		inline void SetField(Config::PitchEntry& e, PitchField f, double v) noexcept
+		{
+			switch (f)
+			{
+				case PitchField::Speed: e.Speed_kmh = v; break;
+				case PitchField::AxisX: e.Axis.X = v; break;
+				case PitchField::AxisY: e.Axis.Y = v; break;
+				case PitchField::AxisZ: e.Axis.Z = v; break;
+				case PitchField::Rpm: e.Rpm = v; break;
+				case PitchField::Release: e.Release_cm = v; break;
+				case PitchField::Elevation: e.Elevation_deg = v; break;
+				case PitchField::Azimuth: e.Azimuth_deg = v; break;
+				default: break;
+			}
+		}
+
+		inline std::uint64_t SplitMix(std::uint64_t& x) noexcept
+		{
+			std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		inline double NormalCdf(double z) noexcept
+		{
+			return 0.5 * std::erfc(-z * std::numbers::sqrt2 * 0.5);
+		}
+
+		inline double NormalQuantile(double p) noexcept
+		{
+			constexpr double A[6] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+			constexpr double B[5] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+			constexpr double C[6] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+			constexpr double D[4] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+			constexpr double P_LOW = 0.02425;
+
+			const double q = p - 0.5;
+			const double r = q * q;
+			const double central = (((((A[0] * r + A[1]) * r + A[2]) * r + A[3]) * r + A[4]) * r + A[5]) * q
+				/ (((((B[0] * r + B[1]) * r + B[2]) * r + B[3]) * r + B[4]) * r + 1.0);
+
+			const double pt = std::clamp(std::min(p, 1.0 - p), 1e-300, 0.5);
+			const double t = std::sqrt(-2.0 * std::log(pt));
+			const double tail = (((((C[0] * t + C[1]) * t + C[2]) * t + C[3]) * t + C[4]) * t + C[5])
+				/ ((((D[0] * t + D[1]) * t + D[2]) * t + D[3]) * t + 1.0);
+
+			const double signedTail = (q < 0.0) ? tail : -tail;
+			return (std::abs(q) <= 0.5 - P_LOW) ? central : signedTail;
+		}
+
+		void Normals(SamplerRng& rng, double* z, std::size_t count) noexcept
+		{
+			const std::size_t half = (count + 1) / 2;
+			double u[PitchSampler::BLOCK];
+			double v[PitchSampler::BLOCK];
+			double w[PitchSampler::BLOCK];
+			rng.Fill(u, half);
+			rng.Fill(v, half);
+
+			for (std::size_t k = 0; k < half; ++k)
+			{
+				const double r = std::sqrt(-2.0 * std::log(u[k]));
+				const double t = 2.0 * std::numbers::pi * v[k];
+				z[k] = r * std::cos(t);
+				w[k] = r * std::sin(t);
+			}
+
+			std::copy(w, w + (count - half), z + half);
+		}
+
+		void ApplyUniform(const double* u, double* out, std::size_t count, double lo, double span) noexcept
+		{
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				out[k] = lo + span * u[k];
+			}
+		}
+
+		void ApplyNormal(const double* z, double* out, std::size_t count, double mean, double sigma) noexcept
+		{
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				out[k] = mean + sigma * z[k];
+			}
+		}
+
+		void ApplyTruncated(const double* u, double* out, std::size_t count, double mean, double sigma, double pLo, double pSpan, double min, double max) noexcept
+		{
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				out[k] = std::clamp(mean + sigma * NormalQuantile(pLo + pSpan * u[k]), min, max);
+			}
+		}
+
+		void CdfInPlace(double* z, std::size_t count) noexcept
+		{
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				z[k] = NormalCdf(z[k]);
+			}
+		}
+	}
+
+	void SamplerRng::Seed(std::uint64_t seed) noexcept
+	{
+		for (std::size_t l = 0; l < LANES; ++l)
+		{
+			m_S0[l] = SplitMix(seed);
+			m_S1[l] = SplitMix(seed);
+			m_S2[l] = SplitMix(seed);
+			m_S3[l] = SplitMix(seed);
+		}
+	}
+
+	void SamplerRng::Next(double* out) noexcept
+	{
+		for (std::size_t l = 0; l < LANES; ++l)
+		{
+			const std::uint64_t r = m_S0[l] + m_S3[l];
+			const std::uint64_t t = m_S1[l] << 17;
+
+			m_S2[l] ^= m_S0[l];
+			m_S3[l] ^= m_S1[l];
+			m_S1[l] ^= m_S2[l];
+			m_S0[l] ^= m_S3[l];
+			m_S2[l] ^= t;
+			m_S3[l] = (m_S3[l] << 45) | (m_S3[l] >> 19);
+
+			out[l] = std::bit_cast<double>((r >> 12) | 0x3FF0000000000000ull) - (1.0 - 0x1.0p-53);
+		}
+	}
+
+	void SamplerRng::Fill(double* out, std::size_t count) noexcept
+	{
+		std::size_t k = 0;
+		for (; k + LANES <= count; k += LANES)
+		{
+			Next(out + k);
+		}
+
+		if (k < count)
+		{
+			double tail[LANES];
+			Next(tail);
+			std::copy(tail, tail + (count - k), out + k);
+		}
+	}
+
+	PitchSampler PitchSampler::Compile(const Config::PitchEntry& entry)
+	{
+		PitchSampler s{};
+
+		const auto marginal = [&](std::size_t f)
+		{
+			const FieldRange& r = FIELD_RANGES[f];
+			const Config::FieldSampling& fs = entry.Sampling[f];
+
+			Marginal m{};
+			m.Field = static_cast<PitchField>(f);
+			m.Kind = fs.Kind;
+			m.Min = *(entry.*r.Min);
+			m.Max = *(entry.*r.Max);
+			m.Mean = fs.Mean;
+			m.Sigma = fs.Sigma;
+
+			if (m.Kind == SampleKind::TruncNormal)
+			{
+				m.PLo = NormalCdf((m.Min - m.Mean) / m.Sigma);
+				m.PSpan = NormalCdf((m.Max - m.Mean) / m.Sigma) - m.PLo;
+			}
+
+			return m;
+		};
+
+		std::uint32_t pending = 0;
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			const FieldRange& r = FIELD_RANGES[f];
+			if (entry.*r.IsRandom && (entry.*r.Min).has_value() && (entry.*r.Max).has_value())
+			{
+				pending |= 1u << f;
+			}
+		}
+
+		s.m_RandomMask = pending;
+
+		constexpr std::uint32_t AXIS_MASK = (1u << Index(PitchField::AxisX)) | (1u << Index(PitchField::AxisY)) | (1u << Index(PitchField::AxisZ));
+		if (entry.IsRandomAxisSphere && (pending & AXIS_MASK) == AXIS_MASK)
+		{
+			s.m_Ops.push_back(Op{ OpKind::Sphere });
+			pending &= ~AXIS_MASK;
+		}
+
+		for (const Config::FieldCorrelation& c : entry.Correlations)
+		{
+			const std::uint32_t pair = (1u << Index(c.A)) | (1u << Index(c.B));
+			if ((pending & pair) == pair)
+			{
+				s.m_Ops.push_back(Op{ OpKind::Correlated, c.Rho, marginal(Index(c.A)), marginal(Index(c.B)) });
+				pending &= ~pair;
+			}
+		}
+
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			if (pending & (1u << f))
+			{
+				s.m_Ops.push_back(Op{ OpKind::Independent, 0.0, marginal(f) });
+			}
+		}
+
+		return s;
+	}
+
+	void PitchSampler::Sample(std::size_t count, double* const* out, SamplerRng& rng) const noexcept
+	{
+		double u[BLOCK];
+		double z[BLOCK];
+
+		const auto fromUniform = [&](const Marginal& m, const double* src, double* dst, std::size_t n)
+		{
+			if (m.Kind == SampleKind::TruncNormal)
+			{
+				ApplyTruncated(src, dst, n, m.Mean, m.Sigma, m.PLo, m.PSpan, m.Min, m.Max);
+			}
+			else
+			{
+				ApplyUniform(src, dst, n, m.Min, m.Max - m.Min);
+			}
+		};
+
+		const auto fromNormal = [&](const Marginal& m, double* src, double* dst, std::size_t n)
+		{
+			if (m.Kind == SampleKind::Normal)
+			{
+				ApplyNormal(src, dst, n, m.Mean, m.Sigma);
+				return;
+			}
+
+			CdfInPlace(src, n);
+			fromUniform(m, src, dst, n);
+		};
+
+		for (std::size_t base = 0; base < count; base += BLOCK)
+		{
+			const std::size_t n = std::min(BLOCK, count - base);
+
+			for (const Op& op : m_Ops)
+			{
+				if (op.Kind == OpKind::Sphere)
+				{
+					double* x = out[Index(PitchField::AxisX)] + base;
+					double* y = out[Index(PitchField::AxisY)] + base;
+					double* w = out[Index(PitchField::AxisZ)] + base;
+					rng.Fill(u, n);
+					rng.Fill(z, n);
+
+					for (std::size_t k = 0; k < n; ++k)
+					{
+						const double c = 2.0 * u[k] - 1.0;
+						const double r = std::sqrt(std::max(0.0, 1.0 - c * c));
+						const double t = 2.0 * std::numbers::pi * z[k];
+						x[k] = r * std::cos(t);
+						y[k] = r * std::sin(t);
+						w[k] = c;
+					}
+				}
+				else if (op.Kind == OpKind::Correlated)
+				{
+					Normals(rng, u, n);
+					Normals(rng, z, n);
+
+					const double c = std::sqrt(std::max(0.0, 1.0 - op.Rho * op.Rho));
+					for (std::size_t k = 0; k < n; ++k)
+					{
+						z[k] = op.Rho * u[k] + c * z[k];
+					}
+
+					fromNormal(op.A, u, out[Index(op.A.Field)] + base, n);
+					fromNormal(op.B, z, out[Index(op.B.Field)] + base, n);
+				}
+				else if (op.A.Kind == SampleKind::Normal)
+				{
+					Normals(rng, z, n);
+					ApplyNormal(z, out[Index(op.A.Field)] + base, n, op.A.Mean, op.A.Sigma);
+				}
+				else
+				{
+					rng.Fill(u, n);
+					fromUniform(op.A, u, out[Index(op.A.Field)] + base, n);
+				}
+			}
+		}
+	}
+
+	void PitchSampler::SampleOne(Config::PitchEntry& entry, SamplerRng& rng) const noexcept
+	{
+		if (m_RandomMask == 0)
+		{
+			return;
+		}
+
+		double values[FIELD_COUNT]{};
+		double* out[FIELD_COUNT]{};
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			out[f] = &values[f];
+		}
+
+		Sample(1, out, rng);
+
+		for (std::size_t f = 0; f < FIELD_COUNT; ++f)
+		{
+			if (m_RandomMask & (1u << f))
+			{
+				SetField(entry, static_cast<PitchField>(f), values[f]);
+			}
+		}
+	}
+
+	void SampleBatch(const PitchSampler& sampler, std::size_t count, std::vector<double> (&out)[PitchSampler::FIELD_COUNT], SamplerRng& rng)
+	{
+		double* columns[PitchSampler::FIELD_COUNT]{};
+		for (std::size_t f = 0; f < PitchSampler::FIELD_COUNT; ++f)
+		{
+			if (sampler.RandomMask() & (1u << f))
+			{
+				out[f].resize(count);
+				columns[f] = out[f].data();
+			}
+			else
+			{
+				out[f].clear();
+			}
+		}
+
+		sampler.Sample(count, columns, rng);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PitchConfig.hpp"
+
+namespace PitchSim
+{
+	using Config::PitchField;
+	using Config::SampleKind;
+
+	class SamplerRng
+	{
+	public:
+		static constexpr std::size_t LANES = 8;
+
+		SamplerRng() noexcept { Seed(0x9E3779B97F4A7C15ull); }
+		explicit SamplerRng(std::uint64_t seed) noexcept { Seed(seed); }
+
+		void Seed(std::uint64_t seed) noexcept;
+		void Fill(double* out, std::size_t count) noexcept;
+
+	private:
+		void Next(double* out) noexcept;
+
+		std::uint64_t m_S0[LANES]{};
+		std::uint64_t m_S1[LANES]{};
+		std::uint64_t m_S2[LANES]{};
+		std::uint64_t m_S3[LANES]{};
+	};
+
+	class PitchSampler
+	{
+	public:
+		static constexpr std::size_t BLOCK = 256;
+		static constexpr std::size_t FIELD_COUNT = Config::PITCH_FIELD_COUNT;
+
+		static PitchSampler Compile(const Config::PitchEntry& entry);
+
+		bool IsRandom() const noexcept { return m_RandomMask != 0; }
+		std::uint32_t RandomMask() const noexcept { return m_RandomMask; }
+		std::size_t OpCount() const noexcept { return m_Ops.size(); }
+
+		void Sample(std::size_t count, double* const* out, SamplerRng& rng) const noexcept;
+		void SampleOne(Config::PitchEntry& entry, SamplerRng& rng) const noexcept;
+
+	private:
+		enum class OpKind : std::uint8_t
+		{
+			Independent,
+			Correlated,
+			Sphere
+		};
+
+		struct Marginal
+		{
+			PitchField Field{ PitchField::Speed };
+			SampleKind Kind{ SampleKind::Uniform };
+			double Min{ 0.0 };
+			double Max{ 0.0 };
+			double Mean{ 0.0 };
+			double Sigma{ 0.0 };
+			double PLo{ 0.0 };
+			double PSpan{ 1.0 };
+		};
+
+		struct Op
+		{
+			OpKind Kind{ OpKind::Independent };
+			double Rho{ 0.0 };
+			Marginal A{};
+			Marginal B{};
+		};
+
+		std::vector<Op> m_Ops;
+		std::uint32_t m_RandomMask{ 0 };
+	};
+
+	void SampleBatch(const PitchSampler& sampler, std::size_t count, std::vector<double> (&out)[PitchSampler::FIELD_COUNT], SamplerRng& rng);
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "PolylineLod.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PitchSim
+{
+	namespace
+	{
+		inline float DistanceToSegment(const Float3& p, const Float3& a, const Float3& b) noexcept
+		{
+			const float abx = b.X - a.X;
+			const float aby = b.Y - a.Y;
+			const float abz = b.Z - a.Z;
+			const float apx = p.X - a.X;
+			const float apy = p.Y - a.Y;
+			const float apz = p.Z - a.Z;
+
+			const float len2 = abx * abx + aby * aby + abz * abz;
+			float t = (len2 > 0.0f) ? (apx * abx + apy * aby + apz * abz) / len2 : 0.0f;
+			t = std::clamp(t, 0.0f, 1.0f);
+
+			const float dx = apx - abx * t;
+			const float dy = apy - aby * t;
+			const float dz = apz - abz * t;
+
+			return std::sqrt(dx * dx + dy * dy + dz * dz);
+		}
+
+		inline float DistanceToBox(const Float3& p, const Float3& lo, const Float3& hi) noexcept
+		{
+			const float dx = std::max({ lo.X - p.X, 0.0f, p.X - hi.X });
+			const float dy = std::max({ lo.Y - p.Y, 0.0f, p.Y - hi.Y });
+			const float dz = std::max({ lo.Z - p.Z, 0.0f, p.Z - hi.Z });
+
+			return std::sqrt(dx * dx + dy * dy + dz * dz);
+		}
+
+		struct Span
+		{
+			std::uint32_t First;
+			std::uint32_t Last;
+			float ParentError;
+		};
+	}
+
+	std::size_t PolylineLod::LevelSize(std::size_t level) const noexcept
+	{
+		if (level == 0 || level >= LevelError.size())
+		{
+			return SampleCount;
+		}
+
+		return LevelOffsets[level] - LevelOffsets[level - 1];
+	}
+
+	const std::uint32_t* PolylineLod::LevelIndices(std::size_t level) const noexcept
+	{
+		if (level == 0 || level >= LevelError.size())
+		{
+			return nullptr;
+		}
+
+		return Indices.data() + LevelOffsets[level - 1];
+	}
+
+	namespace PolylineSimplifier
+	{
+		void Build(const Float3* points, std::size_t count, PolylineLod& out)
+		{
+			out.SampleCount = count;
+			out.LevelError.clear();
+			out.LevelOffsets.clear();
+			out.Indices.clear();
+
+			out.LevelError.emplace_back(0.0f);
+			out.LevelOffsets.emplace_back(0u);
+
+			if (count == 0)
+			{
+				return;
+			}
+
+			out.BoundsMin = points[0];
+			out.BoundsMax = points[0];
+
+			for (std::size_t i = 1; i < count; ++i)
+			{
+				out.BoundsMin = Float3{ std::min(out.BoundsMin.X, points[i].X), std::min(out.BoundsMin.Y, points[i].Y), std::min(out.BoundsMin.Z, points[i].Z) };
+				out.BoundsMax = Float3{ std::max(out.BoundsMax.X, points[i].X), std::max(out.BoundsMax.Y, points[i].Y), std::max(out.BoundsMax.Z, points[i].Z) };
+			}
+
+			if (count <= 2)
+			{
+				return;
+			}
+
+			thread_local std::pmr::vector<float> importance{ MemoryTracker::Resource(MemoryTag::Lod) };
+			thread_local std::pmr::vector<Span> stack{ MemoryTracker::Resource(MemoryTag::Lod) };
+
+			importance.assign(count, 0.0f);
+			importance.front() = std::numeric_limits<float>::infinity();
+			importance.back() = std::numeric_limits<float>::infinity();
+
+			stack.clear();
+			stack.emplace_back(Span{ 0, static_cast<std::uint32_t>(count - 1), std::numeric_limits<float>::infinity() });
+
+			while (!stack.empty())
+			{
+				const Span s = stack.back();
+				stack.pop_back();
+
+				if (s.Last - s.First < 2)
+				{
+					continue;
+				}
+
+				float maxDist = -1.0f;
+				std::uint32_t maxIdx = s.First + 1;
+
+				for (std::uint32_t k = s.First + 1; k < s.Last; ++k)
+				{
+					const float d = DistanceToSegment(points[k], points[s.First], points[s.Last]);
+					if (d > maxDist)
+					{
+						maxDist = d;
+						maxIdx = k;
+					}
+				}
+
+				const float err = std::min(maxDist, s.ParentError);
+				importance[maxIdx] = err;
+
+				stack.emplace_back(Span{ s.First, maxIdx, err });
+				stack.emplace_back(Span{ maxIdx, s.Last, err });
+			}
+
+			std::size_t prevSize = count;
+			float tol = PolylineLod::BASE_TOLERANCE_M;
+
+			for (std::size_t level = 1; level < PolylineLod::MAX_LEVELS; ++level, tol *= 2.0f)
+			{
+				const std::size_t start = out.Indices.size();
+
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					if (importance[i] > tol)
+					{
+						out.Indices.emplace_back(static_cast<std::uint32_t>(i));
+					}
+				}
+
+				const std::size_t size = out.Indices.size() - start;
+
+				if (size * 4 > prevSize * 3)
+				{
+					out.Indices.resize(start);
+					continue;
+				}
+
+				out.LevelError.emplace_back(tol);
+				out.LevelOffsets.emplace_back(static_cast<std::uint32_t>(out.Indices.size()));
+				prevSize = size;
+
+				if (size <= 2)
+				{
+					break;
+				}
+			}
+		}
+
+		float ProjectedError(const PolylineLod& lod, std::size_t level, const LodView& view) noexcept
+		{
+			if (level == 0 || level >= lod.LevelCount())
+			{
+				return 0.0f;
+			}
+
+			const float dist = std::max(view.NearZ, DistanceToBox(view.Eye, lod.BoundsMin, lod.BoundsMax));
+			return lod.LevelError[level] * view.PixelScale / dist;
+		}
+
+		std::size_t SelectLevel(const PolylineLod& lod, const LodView& view) noexcept
+		{
+			for (std::size_t level = lod.LevelCount(); level-- > 1;)
+			{
+				if (ProjectedError(lod, level, view) <= view.MaxPixelError)
+				{
+					return level;
+				}
+			}
+
+			return 0;
+		}
+
+		LodRange SelectRange(const PolylineLod& lod, const LodView& view, std::size_t visibleCount) noexcept
+		{
+			LodRange r{};
+			visibleCount = std::min(visibleCount, lod.SampleCount);
+
+			if (visibleCount == 0)
+			{
+				return r;
+			}
+
+			r.Level = SelectLevel(lod, view);
+
+			if (r.Level == 0)
+			{
+				r.TailFirst = 0;
+				r.TailCount = static_cast<std::uint32_t>(visibleCount);
+				return r;
+			}
+
+			const std::uint32_t head = static_cast<std::uint32_t>(visibleCount - 1);
+			const std::uint32_t* idx = lod.LevelIndices(r.Level);
+			const std::size_t size = lod.LevelSize(r.Level);
+			r.IndexOffset = lod.LevelOffsets[r.Level - 1];
+
+			r.IndexCount = static_cast<std::size_t>(std::upper_bound(idx, idx + size, head) - idx);
+
+			const std::uint32_t last = (r.IndexCount > 0) ? idx[r.IndexCount - 1] : 0u;
+			r.TailFirst = last;
+			r.TailCount = head - last + 1;
+
+			if (r.TailCount == 1 && r.IndexCount > 0)
+			{
+				r.TailCount = 0;
+			}
+
+			return r;
+		}
+
+		float PixelScaleFor(float fovYDeg, std::uint32_t viewportHeight) noexcept
+		{
+			constexpr float PI = 3.14159265358979323846f;
+
+			const float halfFov = 0.5f * fovYDeg * (PI / 180.0f);
+			return static_cast<float>(viewportHeight) / (2.0f * std::tan(halfFov));
+		}
+	}
+}
\ No newline at end of file
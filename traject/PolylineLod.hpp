@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "MemoryTracker.hpp"
+#include "Physics.hpp"
+
+namespace PitchSim
+{
+	struct PolylineLod
+	{
+		static constexpr float BASE_TOLERANCE_M = 0.0005f;
+		static constexpr std::size_t MAX_LEVELS = 16;
+
+		std::size_t SampleCount{ 0 };
+		Float3 BoundsMin{ 0.0f, 0.0f, 0.0f };
+		Float3 BoundsMax{ 0.0f, 0.0f, 0.0f };
+
+		std::pmr::vector<float> LevelError{ MemoryTracker::Resource(MemoryTag::Lod) };
+		std::pmr::vector<std::uint32_t> LevelOffsets{ MemoryTracker::Resource(MemoryTag::Lod) };
+		std::pmr::vector<std::uint32_t> Indices{ MemoryTracker::Resource(MemoryTag::Lod) };
+
+		std::size_t LevelCount() const noexcept { return LevelError.size(); }
+		std::size_t LevelSize(std::size_t level) const noexcept;
+		const std::uint32_t* LevelIndices(std::size_t level) const noexcept;
+	};
+
+	struct LodView
+	{
+		Float3 Eye{ 0.0f, 0.0f, 0.0f };
+		float PixelScale{ 1.0f };
+		float MaxPixelError{ 1.0f };
+		float NearZ{ 0.01f };
+	};
+
+	struct LodRange
+	{
+		std::size_t Level{ 0 };
+		std::size_t IndexOffset{ 0 };
+		std::size_t IndexCount{ 0 };
+		std::uint32_t TailFirst{ 0 };
+		std::uint32_t TailCount{ 0 };
+	};
+
+	namespace PolylineSimplifier
+	{
+		void Build(const Float3* points, std::size_t count, PolylineLod& out);
+
+		float ProjectedError(const PolylineLod& lod, std::size_t level, const LodView& view) noexcept;
+		std::size_t SelectLevel(const PolylineLod& lod, const LodView& view) noexcept;
+		LodRange SelectRange(const PolylineLod& lod, const LodView& view, std::size_t visibleCount) noexcept;
+
+		float PixelScaleFor(float fovYDeg, std::uint32_t viewportHeight) noexcept;
+	}
+}
\ No newline at end of file
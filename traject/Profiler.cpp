@@ -0,0 +1,355 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace PitchSim::Profiler
+{
+#if PITCHSIM_PROFILE
+	namespace
+	{
+		constexpr std::uint32_t MAX_DEPTH = 64;
+		constexpr std::size_t CHUNK_CAPACITY = 4096;
+		constexpr std::size_t MAX_CHUNKS_PER_THREAD = 256;
+
+		struct Event
+		{
+			const char* Name;
+			std::uint64_t BeginNs;
+			std::uint64_t DurationNs;
+			std::uint64_t SelfNs;
+			std::uint32_t Depth;
+		};
+
+		struct Chunk
+		{
+			Event Events[CHUNK_CAPACITY];
+			std::atomic<std::size_t> Count{ 0 };
+			std::atomic<Chunk*> Next{ nullptr };
+		};
+
+		struct ThreadBuffer
+		{
+			~ThreadBuffer()
+			{
+				Chunk* c = Head.Next.load(std::memory_order_relaxed);
+				while (c)
+				{
+					Chunk* next = c->Next.load(std::memory_order_relaxed);
+					delete c;
+					c = next;
+				}
+			}
+
+			std::uint32_t Id{ 0 };
+			char Name[32]{};
+
+			Chunk Head;
+			Chunk* Tail{ &Head };
+			std::size_t ChunkCount{ 1 };
+			std::atomic<std::uint64_t> Dropped{ 0 };
+
+			std::uint32_t Depth{ 0 };
+			std::uint64_t ChildNs[MAX_DEPTH]{};
+		};
+
+		struct Registry
+		{
+			std::mutex Mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+		};
+
+		Registry& GetRegistry() noexcept
+		{
+			static Registry* registry = new Registry;
+			return *registry;
+		}
+
+		thread_local ThreadBuffer* t_Buffer = nullptr;
+
+		ThreadBuffer& LocalBuffer() noexcept
+		{
+			if (!t_Buffer)
+			{
+				auto buffer = std::make_unique<ThreadBuffer>();
+				t_Buffer = buffer.get();
+
+				Registry& r = GetRegistry();
+				std::lock_guard<std::mutex> lk{ r.Mutex };
+				buffer->Id = static_cast<std::uint32_t>(r.Buffers.size());
+				std::snprintf(buffer->Name, sizeof(buffer->Name), "thread %u", buffer->Id);
+				r.Buffers.emplace_back(std::move(buffer));
+			}
+
+			return *t_Buffer;
+		}
+
+		void Push(ThreadBuffer& tb, const Event& ev) noexcept
+		{
+			Chunk* c = tb.Tail;
+			std::size_t n = c->Count.load(std::memory_order_relaxed);
+
+			if (n == CHUNK_CAPACITY)
+			{
+				if (tb.ChunkCount >= MAX_CHUNKS_PER_THREAD)
+				{
+					tb.Dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				Chunk* next = new (std::nothrow) Chunk;
+				if (!next)
+				{
+					tb.Dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				c->Next.store(next, std::memory_order_release);
+				tb.Tail = next;
+				++tb.ChunkCount;
+				c = next;
+				n = 0;
+			}
+
+			c->Events[n] = ev;
+			c->Count.store(n + 1, std::memory_order_release);
+		}
+
+		template <typename Fn>
+		void ForEachEvent(const ThreadBuffer& tb, Fn&& fn)
+		{
+			for (const Chunk* c = &tb.Head; c; c = c->Next.load(std::memory_order_acquire))
+			{
+				const std::size_t n = c->Count.load(std::memory_order_acquire);
+				for (std::size_t k = 0; k < n; ++k)
+				{
+					fn(c->Events[k]);
+				}
+			}
+		}
+
+		void AppendJsonString(std::string& out, const char* s)
+		{
+			out += '"';
+			for (; *s; ++s)
+			{
+				const char ch = *s;
+				if (ch == '"' || ch == '\\')
+				{
+					out += '\\';
+					out += ch;
+				}
+				else if (static_cast<unsigned char>(ch) < 0x20)
+				{
+					out += ' ';
+				}
+				else
+				{
+					out += ch;
+				}
+			}
+			out += '"';
+		}
+	}
+
+	namespace Detail
+	{
+		std::uint64_t NowNs() noexcept
+		{
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		std::uint32_t Enter() noexcept
+		{
+			ThreadBuffer& tb = LocalBuffer();
+			const std::uint32_t depth = tb.Depth++;
+			if (depth < MAX_DEPTH)
+			{
+				tb.ChildNs[depth] = 0;
+			}
+
+			return depth;
+		}
+
+		void Leave(const char* name, std::uint64_t beginNs, std::uint32_t depth) noexcept
+		{
+			const std::uint64_t endNs = NowNs();
+			ThreadBuffer& tb = *t_Buffer;
+			tb.Depth = depth;
+
+			if (depth >= MAX_DEPTH)
+			{
+				tb.Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			const std::uint64_t duration = endNs - beginNs;
+			const std::uint64_t children = std::min(tb.ChildNs[depth], duration);
+
+			if (depth > 0)
+			{
+				tb.ChildNs[depth - 1] += duration;
+			}
+
+			Push(tb, Event{ name, beginNs, duration, duration - children, depth });
+		}
+	}
+
+	bool IsEnabled() noexcept
+	{
+		return true;
+	}
+
+	void SetThreadName(const char* name) noexcept
+	{
+		ThreadBuffer& tb = LocalBuffer();
+
+		std::lock_guard<std::mutex> lk{ GetRegistry().Mutex };
+		std::snprintf(tb.Name, sizeof(tb.Name), "%s", name);
+	}
+
+	Summary Summarize()
+	{
+		Summary summary{};
+		std::unordered_map<std::string, SummaryRow> rows;
+
+		Registry& r = GetRegistry();
+		std::lock_guard<std::mutex> lk{ r.Mutex };
+		summary.Threads = r.Buffers.size();
+
+		for (const auto& tb : r.Buffers)
+		{
+			summary.Dropped += tb->Dropped.load(std::memory_order_relaxed);
+
+			ForEachEvent(*tb, [&](const Event& ev)
+			{
+				SummaryRow& row = rows[ev.Name];
+				++row.Calls;
+				row.TotalMs += static_cast<double>(ev.DurationNs) * 1e-6;
+				row.SelfMs += static_cast<double>(ev.SelfNs) * 1e-6;
+				row.MaxMs = std::max(row.MaxMs, static_cast<double>(ev.DurationNs) * 1e-6);
+				++summary.Events;
+			});
+		}
+
+		summary.Rows.reserve(rows.size());
+		for (auto& [name, row] : rows)
+		{
+			row.Name = name;
+			summary.Rows.emplace_back(std::move(row));
+		}
+
+		std::sort(summary.Rows.begin(), summary.Rows.end(), [](const SummaryRow& a, const SummaryRow& b) { return a.TotalMs > b.TotalMs; });
+		return summary;
+	}
+
+	bool WriteChromeTrace(const std::string& path)
+	{
+		std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+		if (!ofs)
+		{
+			return false;
+		}
+
+		Registry& r = GetRegistry();
+		std::lock_guard<std::mutex> lk{ r.Mutex };
+
+		std::uint64_t originNs = std::numeric_limits<std::uint64_t>::max();
+		for (const auto& tb : r.Buffers)
+		{
+			ForEachEvent(*tb, [&](const Event& ev) { originNs = std::min(originNs, ev.BeginNs); });
+		}
+
+		std::string out;
+		out.reserve(1u << 16);
+		out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first = true;
+		auto separator = [&]()
+		{
+			if (!first)
+			{
+				out += ",\n";
+			}
+			first = false;
+		};
+
+		char buf[128];
+
+		for (const auto& tb : r.Buffers)
+		{
+			separator();
+			std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", tb->Id);
+			out += buf;
+			AppendJsonString(out, tb->Name);
+			out += "}}";
+
+			ForEachEvent(*tb, [&](const Event& ev)
+			{
+				separator();
+				out += "{\"ph\":\"X\",\"pid\":1,";
+				std::snprintf(buf, sizeof(buf), "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":", tb->Id, static_cast<double>(ev.BeginNs - originNs) * 1e-3, static_cast<double>(ev.DurationNs) * 1e-3);
+				out += buf;
+				AppendJsonString(out, ev.Name);
+				out += '}';
+
+				if (out.size() >= (1u << 16) - 256)
+				{
+					ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+					out.clear();
+				}
+			});
+		}
+
+		out += "\n]}\n";
+		ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+		return static_cast<bool>(ofs);
+	}
+#else
+	bool IsEnabled() noexcept
+	{
+		return false;
+	}
+
+	void SetThreadName(const char*) noexcept
+	{
+	}
+
+	Summary Summarize()
+	{
+		return Summary{};
+	}
+
+	bool WriteChromeTrace(const std::string&)
+	{
+		return false;
+	}
+#endif
+
+	std::string FormatSummary(const Summary& summary)
+	{
+		std::string out;
+		char buf[256];
+
+		std::snprintf(buf, sizeof(buf), "%-32s %10s %12s %12s %10s %10s\n", "scope", "calls", "total ms", "self ms", "mean us", "max ms");
+		out += buf;
+
+		for (const auto& row : summary.Rows)
+		{
+			const double meanUs = (row.Calls > 0) ? (row.TotalMs * 1e3 / static_cast<double>(row.Calls)) : 0.0;
+			std::snprintf(buf, sizeof(buf), "%-32.32s %10llu %12.3f %12.3f %10.2f %10.3f\n", row.Name.c_str(), static_cast<unsigned long long>(row.Calls), row.TotalMs, row.SelfMs, meanUs, row.MaxMs);
+			out += buf;
+		}
+
+		std::snprintf(buf, sizeof(buf), "%llu events on %zu threads, %llu dropped\n", static_cast<unsigned long long>(summary.Events), summary.Threads, static_cast<unsigned long long>(summary.Dropped));
+		out += buf;
+		return out;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if !defined(PITCHSIM_PROFILE)
+#define PITCHSIM_PROFILE 0
+#endif
+
+namespace PitchSim::Profiler
+{
+	struct SummaryRow
+	{
+		std::string Name;
+		std::uint64_t Calls{ 0 };
+		double TotalMs{ 0.0 };
+		double SelfMs{ 0.0 };
+		double MaxMs{ 0.0 };
+	};
+
+	struct Summary
+	{
+		std::vector<SummaryRow> Rows;
+		std::uint64_t Events{ 0 };
+		std::uint64_t Dropped{ 0 };
+		std::size_t Threads{ 0 };
+	};
+
+	bool IsEnabled() noexcept;
+	void SetThreadName(const char* name) noexcept;
+
+	Summary Summarize();
+	std::string FormatSummary(const Summary& summary);
+	bool WriteChromeTrace(const std::string& path);
+
+#if PITCHSIM_PROFILE
+	namespace Detail
+	{
+		std::uint64_t NowNs() noexcept;
+		std::uint32_t Enter() noexcept;
+		void Leave(const char* name, std::uint64_t beginNs, std::uint32_t depth) noexcept;
+	}
+
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name) noexcept : m_Name{ name }, m_Depth{ Detail::Enter() }, m_BeginNs{ Detail::NowNs() } {}
+		Scope(const Scope&) = delete;
+		~Scope() { Detail::Leave(m_Name, m_BeginNs, m_Depth); }
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* m_Name;
+		std::uint32_t m_Depth;
+		std::uint64_t m_BeginNs;
+	};
+#endif
+}
+
+#if PITCHSIM_PROFILE
+#define PITCHSIM_PROFILE_JOIN2(a, b) a##b
+#define PITCHSIM_PROFILE_JOIN(a, b) PITCHSIM_PROFILE_JOIN2(a, b)
+#define PITCHSIM_PROFILE_SCOPE(name) ::PitchSim::Profiler::Scope PITCHSIM_PROFILE_JOIN(profileScope_, __LINE__){ name }
+#else
+#define PITCHSIM_PROFILE_SCOPE(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "RangeAllocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace PitchSim
+{
+	RangeAllocator::RangeAllocator(std::size_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	std::size_t RangeAllocator::Allocate(std::size_t count) noexcept
+	{
+		if (count == 0)
+		{
+			return INVALID_OFFSET;
+		}
+
+		std::size_t best = m_FreeRanges.size();
+
+		for (std::size_t k = 0; k < m_FreeRanges.size(); ++k)
+		{
+			const std::size_t n = m_FreeRanges[k].Count;
+
+			if (n >= count && (best == m_FreeRanges.size() || n < m_FreeRanges[best].Count))
+			{
+				best = k;
+
+				if (n == count)
+				{
+					break;
+				}
+			}
+		}
+
+		if (best == m_FreeRanges.size())
+		{
+			return INVALID_OFFSET;
+		}
+
+		Range& r = m_FreeRanges[best];
+		const std::size_t offset = r.Offset;
+
+		if (r.Count == count)
+		{
+			m_FreeRanges.erase(m_FreeRanges.begin() + static_cast<std::ptrdiff_t>(best));
+		}
+		else
+		{
+			r.Offset += count;
+			r.Count -= count;
+		}
+
+		m_FreeCount -= count;
+		return offset;
+	}
+
+	void RangeAllocator::Free(std::size_t offset, std::size_t count)
+	{
+		if (count == 0 || offset == INVALID_OFFSET || offset + count > m_Capacity)
+		{
+			return;
+		}
+
+		auto it = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), offset, [](const Range& r, std::size_t o) { return r.Offset < o; });
+
+		assert(it == m_FreeRanges.begin() || std::prev(it)->Offset + std::prev(it)->Count <= offset);
+		assert(it == m_FreeRanges.end() || offset + count <= it->Offset);
+
+		const bool mergePrev = it != m_FreeRanges.begin() && std::prev(it)->Offset + std::prev(it)->Count == offset;
+		const bool mergeNext = it != m_FreeRanges.end() && offset + count == it->Offset;
+
+		if (mergePrev && mergeNext)
+		{
+			std::prev(it)->Count += count + it->Count;
+			m_FreeRanges.erase(it);
+		}
+		else if (mergePrev)
+		{
+			std::prev(it)->Count += count;
+		}
+		else if (mergeNext)
+		{
+			it->Offset = offset;
+			it->Count += count;
+		}
+		else
+		{
+			m_FreeRanges.insert(it, Range{ offset, count });
+		}
+
+		m_FreeCount += count;
+	}
+
+	void RangeAllocator::Grow(std::size_t newCapacity)
+	{
+		if (newCapacity <= m_Capacity)
+		{
+			return;
+		}
+
+		const std::size_t oldCapacity = m_Capacity;
+		m_Capacity = newCapacity;
+		Free(oldCapacity, newCapacity - oldCapacity);
+	}
+
+	void RangeAllocator::Reset(std::size_t capacity)
+	{
+		m_FreeRanges.clear();
+		m_Capacity = capacity;
+		m_FreeCount = capacity;
+
+		if (capacity > 0)
+		{
+			m_FreeRanges.emplace_back(Range{ 0, capacity });
+		}
+	}
+
+	std::size_t RangeAllocator::LargestFreeRange() const noexcept
+	{
+		std::size_t largest = 0;
+
+		for (const Range& r : m_FreeRanges)
+		{
+			largest = std::max(largest, r.Count);
+		}
+
+		return largest;
+	}
+}
\ No newline at end of file
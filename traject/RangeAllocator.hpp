@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace PitchSim
+{
+	class RangeAllocator
+	{
+	public:
+		static constexpr std::size_t INVALID_OFFSET = std::numeric_limits<std::size_t>::max();
+
+		explicit RangeAllocator(std::size_t capacity = 0);
+		RangeAllocator(const RangeAllocator&) = default;
+		RangeAllocator(RangeAllocator&&) noexcept = default;
+		~RangeAllocator() = default;
+		RangeAllocator& operator=(const RangeAllocator&) = default;
+		RangeAllocator& operator=(RangeAllocator&&) noexcept = default;
+
+		std::size_t Allocate(std::size_t count) noexcept;
+		void Free(std::size_t offset, std::size_t count);
+
+		void Grow(std::size_t newCapacity);
+		void Reset(std::size_t capacity);
+
+		std::size_t Capacity() const noexcept { return m_Capacity; }
+		std::size_t FreeCount() const noexcept { return m_FreeCount; }
+		std::size_t UsedCount() const noexcept { return m_Capacity - m_FreeCount; }
+		std::size_t FreeRangeCount() const noexcept { return m_FreeRanges.size(); }
+		std::size_t LargestFreeRange() const noexcept;
+
+	private:
+		struct Range
+		{
+			std::size_t Offset;
+			std::size_t Count;
+		};
+
+		std::vector<Range> m_FreeRanges;
+		std::size_t m_Capacity{ 0 };
+		std::size_t m_FreeCount{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,736 @@
+#include "ResultStore.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PitchSim
+{
+	static_assert(std::endian::native == std::endian::little, "result stores are written little-endian");
+
+	namespace
+	{
+		constexpr std::uint32_t RECORD_MAGIC = 0x31525350u;
+		constexpr std::uint32_t HAS_TRAJECTORY = 1u << 0;
+		constexpr std::size_t RECORD_ALIGN = 8;
+
+		struct LogHeader
+		{
+			char Magic[8];
+			std::uint32_t Version;
+			std::uint32_t Reserved;
+		};
+
+		struct IndexHeader
+		{
+			char Magic[8];
+			std::uint32_t Version;
+			std::uint32_t Reserved;
+			std::uint64_t Count;
+			std::uint64_t LogBytes;
+		};
+
+		struct RecordHeader
+		{
+			std::uint32_t Magic;
+			std::uint32_t Flags;
+			std::uint64_t Hash;
+			std::uint64_t Key[PARAMS_KEY_WORDS];
+			std::uint32_t Crossed;
+			std::uint32_t Termination;
+			std::uint64_t Steps;
+			double Y_m;
+			double Z_m;
+			double Time_s;
+			QuantizationBox Box;
+			std::uint32_t SampleCount;
+			std::uint32_t Reserved;
+		};
+
+		static_assert(sizeof(RecordHeader) % RECORD_ALIGN == 0);
+		static_assert(sizeof(LogHeader) % RECORD_ALIGN == 0);
+		static_assert(sizeof(IndexHeader) % RECORD_ALIGN == 0);
+
+		constexpr std::uint64_t Align(std::uint64_t n) noexcept
+		{
+			return (n + RECORD_ALIGN - 1) & ~std::uint64_t{ RECORD_ALIGN - 1 };
+		}
+
+		constexpr std::uint64_t RecordBytes(std::uint32_t sampleCount) noexcept
+		{
+			return sizeof(RecordHeader) + Align(std::uint64_t{ sampleCount } * sizeof(QuantizedSample)) + sizeof(std::uint64_t);
+		}
+
+		std::uint64_t Checksum(const char* data, std::size_t size) noexcept
+		{
+			std::uint64_t h = 0xCBF29CE484222325ull;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				h ^= static_cast<unsigned char>(data[i]);
+				h *= 0x100000001B3ull;
+			}
+
+			return h;
+		}
+
+		inline void SetError(std::string* error, const char* message)
+		{
+			if (error)
+			{
+				*error = message;
+			}
+		}
+	}
+
+	class ResultStore::LogLock
+	{
+	public:
+		explicit LogLock(const std::string& path) noexcept;
+		LogLock(const LogLock&) = delete;
+		LogLock& operator=(const LogLock&) = delete;
+		~LogLock();
+
+		bool IsHeld() const noexcept { return m_Held; }
+		bool Size(std::uint64_t& size) const noexcept;
+		bool Write(std::uint64_t offset, const char* data, std::size_t size) noexcept;
+		bool Truncate(std::uint64_t size) noexcept;
+
+	private:
+#ifdef _WIN32
+		HANDLE m_File{ INVALID_HANDLE_VALUE };
+#else
+		int m_Fd{ -1 };
+#endif
+		bool m_Held{ false };
+	};
+
+#ifdef _WIN32
+	namespace
+	{
+		constexpr DWORD LOCK_OFFSET_HIGH = 0x7FFFFFFF;
+
+		inline OVERLAPPED LockRegion() noexcept
+		{
+			OVERLAPPED ov{};
+			ov.Offset = MAXDWORD;
+			ov.OffsetHigh = LOCK_OFFSET_HIGH;
+			return ov;
+		}
+	}
+
+	ResultStore::LogLock::LogLock(const std::string& path) noexcept
+	{
+		m_File = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_File == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		OVERLAPPED ov = LockRegion();
+		m_Held = LockFileEx(m_File, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov) != FALSE;
+	}
+
+	ResultStore::LogLock::~LogLock()
+	{
+		if (m_File == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		if (m_Held)
+		{
+			OVERLAPPED ov = LockRegion();
+			UnlockFileEx(m_File, 0, 1, 0, &ov);
+		}
+
+		CloseHandle(m_File);
+	}
+
+	bool ResultStore::LogLock::Size(std::uint64_t& size) const noexcept
+	{
+		LARGE_INTEGER li{};
+		if (!m_Held || !GetFileSizeEx(m_File, &li))
+		{
+			return false;
+		}
+
+		size = static_cast<std::uint64_t>(li.QuadPart);
+		return true;
+	}
+
+	bool ResultStore::LogLock::Write(std::uint64_t offset, const char* data, std::size_t size) noexcept
+	{
+		while (m_Held && size > 0)
+		{
+			OVERLAPPED ov{};
+			ov.Offset = static_cast<DWORD>(offset);
+			ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			DWORD written = 0;
+			const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(size, MAXDWORD));
+			if (!WriteFile(m_File, data, chunk, &written, &ov) || written == 0)
+			{
+				return false;
+			}
+
+			offset += written;
+			data += written;
+			size -= written;
+		}
+
+		return m_Held;
+	}
+
+	bool ResultStore::LogLock::Truncate(std::uint64_t size) noexcept
+	{
+		LARGE_INTEGER li{};
+		li.QuadPart = static_cast<LONGLONG>(size);
+		return m_Held && SetFilePointerEx(m_File, li, nullptr, FILE_BEGIN) && SetEndOfFile(m_File);
+	}
+#else
+	ResultStore::LogLock::LogLock(const std::string& path) noexcept
+	{
+		m_Fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (m_Fd < 0)
+		{
+			return;
+		}
+
+		int rc = 0;
+		do
+		{
+			rc = flock(m_Fd, LOCK_EX);
+		} while (rc != 0 && errno == EINTR);
+
+		m_Held = rc == 0;
+	}
+
+	ResultStore::LogLock::~LogLock()
+	{
+		if (m_Fd < 0)
+		{
+			return;
+		}
+
+		if (m_Held)
+		{
+			flock(m_Fd, LOCK_UN);
+		}
+
+		close(m_Fd);
+	}
+
+	bool ResultStore::LogLock::Size(std::uint64_t& size) const noexcept
+	{
+		struct stat st{};
+		if (!m_Held || fstat(m_Fd, &st) != 0)
+		{
+			return false;
+		}
+
+		size = static_cast<std::uint64_t>(st.st_size);
+		return true;
+	}
+
+	bool ResultStore::LogLock::Write(std::uint64_t offset, const char* data, std::size_t size) noexcept
+	{
+		while (m_Held && size > 0)
+		{
+			const ssize_t written = pwrite(m_Fd, data, size, static_cast<off_t>(offset));
+			if (written < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if (written <= 0)
+			{
+				return false;
+			}
+
+			offset += static_cast<std::uint64_t>(written);
+			data += written;
+			size -= static_cast<std::size_t>(written);
+		}
+
+		return m_Held;
+	}
+
+	bool ResultStore::LogLock::Truncate(std::uint64_t size) noexcept
+	{
+		return m_Held && ftruncate(m_Fd, static_cast<off_t>(size)) == 0;
+	}
+#endif
+
+	ResultStore::~ResultStore()
+	{
+		Close();
+	}
+
+	bool ResultStore::Open(const std::string& directory, bool writable, std::string* error)
+	{
+		Close();
+
+		namespace fs = std::filesystem;
+		std::error_code ec;
+
+		if (writable)
+		{
+			fs::create_directories(directory, ec);
+		}
+
+		m_LogPath = (fs::path{ directory } / "results.log").string();
+		m_IndexPath = (fs::path{ directory } / "results.idx").string();
+		m_Writable = writable;
+
+		if (!writable && !fs::exists(m_LogPath, ec))
+		{
+			SetError(error, "result store does not exist");
+			return false;
+		}
+
+		std::optional<LogLock> fileLock;
+		if (writable)
+		{
+			fileLock.emplace(m_LogPath);
+
+			std::uint64_t size = 0;
+			if (!fileLock->IsHeld() || !fileLock->Size(size))
+			{
+				SetError(error, "cannot lock result log");
+				Close();
+				return false;
+			}
+
+			if (size == 0)
+			{
+				LogHeader header{};
+				std::memcpy(header.Magic, LOG_MAGIC, sizeof(header.Magic));
+				header.Version = VERSION;
+
+				if (!fileLock->Write(0, reinterpret_cast<const char*>(&header), sizeof(header)))
+				{
+					SetError(error, "cannot create result log");
+					Close();
+					return false;
+				}
+			}
+		}
+
+		LogHeader header{};
+		if (!m_Log.Open(m_LogPath) || m_Log.Size() < sizeof(LogHeader))
+		{
+			SetError(error, "cannot open result log");
+			Close();
+			return false;
+		}
+
+		std::memcpy(&header, m_Log.Data(), sizeof(header));
+		if (std::memcmp(header.Magic, LOG_MAGIC, sizeof(header.Magic)) != 0 || header.Version != VERSION)
+		{
+			SetError(error, "unsupported result log version");
+			Close();
+			return false;
+		}
+
+		m_IndexedBytes = sizeof(LogHeader);
+
+		if (m_Index.Open(m_IndexPath))
+		{
+			IndexHeader ih{};
+			bool ok = m_Index.Size() >= sizeof(IndexHeader);
+
+			if (ok)
+			{
+				std::memcpy(&ih, m_Index.Data(), sizeof(ih));
+				ok = std::memcmp(ih.Magic, INDEX_MAGIC, sizeof(ih.Magic)) == 0 && ih.Version == VERSION
+					&& m_Index.Size() == sizeof(IndexHeader) + ih.Count * sizeof(IndexEntry)
+					&& ih.LogBytes >= sizeof(LogHeader) && ih.LogBytes <= m_Log.Size();
+			}
+
+			if (ok)
+			{
+				m_IndexedBytes = ih.LogBytes;
+			}
+			else
+			{
+				m_Index.Close();
+			}
+		}
+
+		std::uint64_t validEnd = m_IndexedBytes;
+		ScanLog(m_IndexedBytes, validEnd);
+		m_LogBytes = validEnd;
+
+		if (fileLock && validEnd < m_Log.Size())
+		{
+			m_Log.Close();
+			const bool truncated = fileLock->Truncate(validEnd);
+
+			if (!truncated || !m_Log.Open(m_LogPath))
+			{
+				SetError(error, "cannot repair result log");
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void ResultStore::Close() noexcept
+	{
+		if (m_Writable && m_Log.IsOpen() && !m_Tail.empty())
+		{
+			WriteIndex();
+		}
+
+		std::lock_guard lock{ m_Mutex };
+		m_Log.Close();
+		m_Index.Close();
+		m_Tail.clear();
+		m_IndexedBytes = 0;
+		m_LogBytes = 0;
+		m_Writable = false;
+	}
+
+	std::size_t ResultStore::Size() const
+	{
+		std::lock_guard lock{ m_Mutex };
+		return IndexEntries().size() + m_Tail.size();
+	}
+
+	std::size_t ResultStore::TailRecords() const
+	{
+		std::lock_guard lock{ m_Mutex };
+		return m_Tail.size();
+	}
+
+	std::span<const ResultStore::IndexEntry> ResultStore::IndexEntries() const noexcept
+	{
+		if (!m_Index.IsOpen() || m_Index.Size() < sizeof(IndexHeader))
+		{
+			return {};
+		}
+
+		const std::size_t count = (m_Index.Size() - sizeof(IndexHeader)) / sizeof(IndexEntry);
+		return std::span<const IndexEntry>{ reinterpret_cast<const IndexEntry*>(m_Index.Data() + sizeof(IndexHeader)), count };
+	}
+
+	bool ResultStore::RemapLog() const
+	{
+		return m_Log.Open(m_LogPath);
+	}
+
+	bool ResultStore::ScanLog(std::uint64_t from, std::uint64_t& validEnd)
+	{
+		std::uint64_t offset = from;
+		const std::uint64_t size = m_Log.Size();
+
+		while (offset + sizeof(RecordHeader) <= size)
+		{
+			RecordHeader rh{};
+			std::memcpy(&rh, m_Log.Data() + offset, sizeof(rh));
+
+			const std::uint64_t bytes = RecordBytes(rh.SampleCount);
+			if (rh.Magic != RECORD_MAGIC || offset + bytes > size)
+			{
+				break;
+			}
+
+			std::uint64_t stored = 0;
+			std::memcpy(&stored, m_Log.Data() + offset + bytes - sizeof(stored), sizeof(stored));
+
+			ParamsKey key{};
+			std::copy(std::begin(rh.Key), std::end(rh.Key), key.begin());
+
+			if (stored != Checksum(m_Log.Data() + offset, bytes - sizeof(stored)) || rh.Hash != HashParamsKey(key))
+			{
+				break;
+			}
+
+			m_Tail.emplace(rh.Hash, offset);
+			offset += bytes;
+		}
+
+		validEnd = offset;
+		return offset == size;
+	}
+
+	bool ResultStore::CatchUp(LogLock& fileLock, std::string* error)
+	{
+		std::uint64_t size = 0;
+		if (!fileLock.IsHeld() || !fileLock.Size(size))
+		{
+			SetError(error, "cannot lock result log");
+			return false;
+		}
+
+		if (size == m_LogBytes)
+		{
+			return true;
+		}
+
+		if (size < m_LogBytes || !RemapLog())
+		{
+			SetError(error, "result log was truncated by another writer");
+			return false;
+		}
+
+		std::uint64_t validEnd = m_LogBytes;
+		ScanLog(m_LogBytes, validEnd);
+
+		if (validEnd < size)
+		{
+			m_Log.Close();
+			const bool truncated = fileLock.Truncate(validEnd);
+
+			if (!RemapLog() || !truncated)
+			{
+				SetError(error, "cannot repair result log");
+				return false;
+			}
+		}
+
+		m_LogBytes = validEnd;
+		return true;
+	}
+
+	bool ResultStore::MatchRecord(std::uint64_t offset, const ParamsKey& key) const
+	{
+		if (offset + sizeof(RecordHeader) > m_Log.Size() && !RemapLog())
+		{
+			return false;
+		}
+
+		if (offset + sizeof(RecordHeader) > m_Log.Size())
+		{
+			return false;
+		}
+
+		RecordHeader rh{};
+		std::memcpy(&rh, m_Log.Data() + offset, sizeof(rh));
+		return rh.Magic == RECORD_MAGIC && offset + RecordBytes(rh.SampleCount) <= m_Log.Size() && std::equal(key.begin(), key.end(), std::begin(rh.Key));
+	}
+
+	bool ResultStore::Locate(const ParamsKey& key, std::uint64_t& offset) const
+	{
+		const std::uint64_t hash = HashParamsKey(key);
+		const std::span<const IndexEntry> index = IndexEntries();
+
+		const auto lo = std::partition_point(index.begin(), index.end(), [&](const IndexEntry& e) noexcept { return e.Hash < hash; });
+		for (auto it = lo; it != index.end() && it->Hash == hash; ++it)
+		{
+			if (MatchRecord(it->Offset, key))
+			{
+				offset = it->Offset;
+				return true;
+			}
+		}
+
+		const auto [first, last] = m_Tail.equal_range(hash);
+		for (auto it = first; it != last; ++it)
+		{
+			if (MatchRecord(it->second, key))
+			{
+				offset = it->second;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ResultStore::Contains(const SimParams& params) const
+	{
+		std::lock_guard lock{ m_Mutex };
+		std::uint64_t offset = 0;
+		return IsOpen() && Locate(MakeParamsKey(params), offset);
+	}
+
+	bool ResultStore::Find(const SimParams& params, PlateResult& out, StoredTrajectory* trajectory) const
+	{
+		std::lock_guard lock{ m_Mutex };
+
+		std::uint64_t offset = 0;
+		if (!IsOpen() || !Locate(MakeParamsKey(params), offset))
+		{
+			return false;
+		}
+
+		RecordHeader rh{};
+		std::memcpy(&rh, m_Log.Data() + offset, sizeof(rh));
+
+		if (trajectory && !(rh.Flags & HAS_TRAJECTORY))
+		{
+			return false;
+		}
+
+		out.Crossed = rh.Crossed != 0;
+		out.Termination = static_cast<SimTermination>(rh.Termination);
+		out.Steps = rh.Steps;
+		out.Y_m = rh.Y_m;
+		out.Z_m = rh.Z_m;
+		out.Time_s = rh.Time_s;
+
+		if (trajectory)
+		{
+			trajectory->Box = rh.Box;
+			trajectory->Samples.resize(rh.SampleCount);
+			std::memcpy(trajectory->Samples.data(), m_Log.Data() + offset + sizeof(RecordHeader), trajectory->Samples.size() * sizeof(QuantizedSample));
+		}
+
+		return true;
+	}
+
+	bool ResultStore::Put(const SimParams& params, const PlateResult& result, const QuantizedTrajectory* trajectory, std::string* error)
+	{
+		std::lock_guard lock{ m_Mutex };
+
+		if (!IsOpen() || !m_Writable)
+		{
+			SetError(error, "result store is not open for writing");
+			return false;
+		}
+
+		const ParamsKey key = MakeParamsKey(params);
+		std::uint64_t existing = 0;
+		if (Locate(key, existing))
+		{
+			return true;
+		}
+
+		RecordHeader rh{};
+		rh.Magic = RECORD_MAGIC;
+		rh.Flags = trajectory ? HAS_TRAJECTORY : 0u;
+		rh.Hash = HashParamsKey(key);
+		std::copy(key.begin(), key.end(), std::begin(rh.Key));
+		rh.Crossed = result.Crossed ? 1u : 0u;
+		rh.Termination = static_cast<std::uint32_t>(result.Termination);
+		rh.Steps = result.Steps;
+		rh.Y_m = result.Y_m;
+		rh.Z_m = result.Z_m;
+		rh.Time_s = result.Time_s;
+
+		if (trajectory)
+		{
+			rh.Box = trajectory->Box;
+			rh.SampleCount = static_cast<std::uint32_t>(trajectory->Samples.size());
+		}
+
+		const std::uint64_t bytes = RecordBytes(rh.SampleCount);
+		std::string record(static_cast<std::size_t>(bytes), '\0');
+		std::memcpy(record.data(), &rh, sizeof(rh));
+
+		if (trajectory && rh.SampleCount > 0)
+		{
+			std::memcpy(record.data() + sizeof(rh), trajectory->Samples.data(), std::size_t{ rh.SampleCount } * sizeof(QuantizedSample));
+		}
+
+		const std::uint64_t sum = Checksum(record.data(), record.size() - sizeof(sum));
+		std::memcpy(record.data() + record.size() - sizeof(sum), &sum, sizeof(sum));
+
+		LogLock fileLock{ m_LogPath };
+		if (!CatchUp(fileLock, error))
+		{
+			return false;
+		}
+
+		if (Locate(key, existing))
+		{
+			return true;
+		}
+
+		if (!fileLock.Write(m_LogBytes, record.data(), record.size()))
+		{
+			SetError(error, "failed to append to result log");
+			return false;
+		}
+
+		m_Tail.emplace(rh.Hash, m_LogBytes);
+		m_LogBytes += bytes;
+		return true;
+	}
+
+	bool ResultStore::WriteIndex(std::string* error)
+	{
+		std::lock_guard lock{ m_Mutex };
+
+		if (!IsOpen() || !m_Writable)
+		{
+			SetError(error, "result store is not open for writing");
+			return false;
+		}
+
+		LogLock fileLock{ m_LogPath };
+		if (!CatchUp(fileLock, error))
+		{
+			return false;
+		}
+
+		const std::span<const IndexEntry> index = IndexEntries();
+		std::vector<IndexEntry> entries(index.begin(), index.end());
+		entries.reserve(entries.size() + m_Tail.size());
+
+		for (const auto& [hash, offset] : m_Tail)
+		{
+			entries.push_back(IndexEntry{ hash, offset });
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const IndexEntry& a, const IndexEntry& b) noexcept
+		{
+			return a.Hash != b.Hash ? a.Hash < b.Hash : a.Offset < b.Offset;
+		});
+
+		IndexHeader ih{};
+		std::memcpy(ih.Magic, INDEX_MAGIC, sizeof(ih.Magic));
+		ih.Version = VERSION;
+		ih.Count = entries.size();
+		ih.LogBytes = m_LogBytes;
+
+		const std::string temp = m_IndexPath + ".tmp";
+		{
+			std::ofstream ofs{ temp, std::ios::binary | std::ios::trunc };
+			ofs.write(reinterpret_cast<const char*>(&ih), sizeof(ih));
+			ofs.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+
+			if (!ofs)
+			{
+				SetError(error, "failed to write result index");
+				return false;
+			}
+		}
+
+		m_Index.Close();
+
+		std::error_code ec;
+		std::filesystem::rename(temp, m_IndexPath, ec);
+
+		if (ec)
+		{
+			std::filesystem::remove(temp, ec);
+			SetError(error, "cannot replace result index");
+			m_Index.Open(m_IndexPath);
+			return false;
+		}
+
+		m_Index.Open(m_IndexPath);
+		m_IndexedBytes = m_LogBytes;
+		m_Tail.clear();
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "ParamsKey.hpp"
+#include "Physics.hpp"
+#include "SimStats.hpp"
+#include "TrajectoryCodec.hpp"
+
+namespace PitchSim
+{
+	struct StoredTrajectory
+	{
+		QuantizationBox Box;
+		std::vector<QuantizedSample> Samples;
+	};
+
+	class ResultStore
+	{
+	public:
+		static constexpr char LOG_MAGIC[8] = { 'P', 'S', 'S', 'T', 'O', 'R', 'E', '\0' };
+		static constexpr char INDEX_MAGIC[8] = { 'P', 'S', 'S', 'I', 'D', 'X', '\0', '\0' };
+		static constexpr std::uint32_t VERSION = 1;
+
+		ResultStore() = default;
+		ResultStore(const ResultStore&) = delete;
+		ResultStore& operator=(const ResultStore&) = delete;
+		~ResultStore();
+
+		bool Open(const std::string& directory, bool writable, std::string* error = nullptr);
+		void Close() noexcept;
+
+		bool IsOpen() const noexcept { return m_Log.IsOpen(); }
+		bool IsWritable() const noexcept { return m_Writable; }
+		std::size_t Size() const;
+		std::size_t TailRecords() const;
+
+		bool Contains(const SimParams& params) const;
+		bool Find(const SimParams& params, PlateResult& out, StoredTrajectory* trajectory = nullptr) const;
+		bool Put(const SimParams& params, const PlateResult& result, const QuantizedTrajectory* trajectory = nullptr, std::string* error = nullptr);
+
+		bool WriteIndex(std::string* error = nullptr);
+
+	private:
+		class LogLock;
+
+		struct IndexEntry
+		{
+			std::uint64_t Hash;
+			std::uint64_t Offset;
+		};
+
+		std::span<const IndexEntry> IndexEntries() const noexcept;
+		bool Locate(const ParamsKey& key, std::uint64_t& offset) const;
+		bool MatchRecord(std::uint64_t offset, const ParamsKey& key) const;
+		bool ScanLog(std::uint64_t from, std::uint64_t& validEnd);
+		bool CatchUp(LogLock& fileLock, std::string* error);
+		bool RemapLog() const;
+
+		std::string m_LogPath;
+		std::string m_IndexPath;
+		bool m_Writable{ false };
+
+		mutable std::mutex m_Mutex;
+		mutable MappedFile m_Log;
+		MappedFile m_Index;
+		std::uint64_t m_IndexedBytes{ 0 };
+		std::uint64_t m_LogBytes{ 0 };
+		std::unordered_multimap<std::uint64_t, std::uint64_t> m_Tail;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "SceneCulling.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace PitchSim
+{
+	void VisibilitySet::Resize(std::size_t count, bool value)
+	{
+		m_Size = count;
+		m_Words.assign((count + 63) / 64, value ? ~std::uint64_t{ 0 } : 0);
+		ClearTail();
+	}
+
+	bool VisibilitySet::Test(std::size_t i) const noexcept
+	{
+		return i < m_Size && (m_Words[i / 64] >> (i % 64)) & 1u;
+	}
+
+	void VisibilitySet::Set(std::size_t i, bool value) noexcept
+	{
+		if (i >= m_Size)
+		{
+			return;
+		}
+
+		const std::uint64_t bit = std::uint64_t{ 1 } << (i % 64);
+		m_Words[i / 64] = value ? (m_Words[i / 64] | bit) : (m_Words[i / 64] & ~bit);
+	}
+
+	void VisibilitySet::Toggle(std::size_t i) noexcept
+	{
+		if (i < m_Size)
+		{
+			m_Words[i / 64] ^= std::uint64_t{ 1 } << (i % 64);
+		}
+	}
+
+	void VisibilitySet::SetAll() noexcept
+	{
+		std::fill(m_Words.begin(), m_Words.end(), ~std::uint64_t{ 0 });
+		ClearTail();
+	}
+
+	void VisibilitySet::ClearAll() noexcept
+	{
+		std::fill(m_Words.begin(), m_Words.end(), std::uint64_t{ 0 });
+	}
+
+	std::size_t VisibilitySet::Count() const noexcept
+	{
+		std::size_t n = 0;
+
+		for (std::uint64_t w : m_Words)
+		{
+			n += static_cast<std::size_t>(std::popcount(w));
+		}
+
+		return n;
+	}
+
+	bool VisibilitySet::Any() const noexcept
+	{
+		return std::any_of(m_Words.begin(), m_Words.end(), [](std::uint64_t w) { return w != 0; });
+	}
+
+	int VisibilitySet::CountTrailingZeros(std::uint64_t v) noexcept
+	{
+		return std::countr_zero(v);
+	}
+
+	void VisibilitySet::ClearTail() noexcept
+	{
+		if (!m_Words.empty() && (m_Size % 64) != 0)
+		{
+			m_Words.back() &= (std::uint64_t{ 1 } << (m_Size % 64)) - 1;
+		}
+	}
+
+	Frustum Frustum::FromViewProj(const float* m) noexcept
+	{
+		auto col = [m](int j, float* out)
+		{
+			out[0] = m[j];
+			out[1] = m[4 + j];
+			out[2] = m[8 + j];
+			out[3] = m[12 + j];
+		};
+
+		float c0[4], c1[4], c2[4], c3[4];
+		col(0, c0);
+		col(1, c1);
+		col(2, c2);
+		col(3, c3);
+
+		Frustum f{};
+
+		for (int k = 0; k < 4; ++k)
+		{
+			f.Planes[0][k] = c3[k] + c0[k];
+			f.Planes[1][k] = c3[k] - c0[k];
+			f.Planes[2][k] = c3[k] + c1[k];
+			f.Planes[3][k] = c3[k] - c1[k];
+			f.Planes[4][k] = c2[k];
+			f.Planes[5][k] = c3[k] - c2[k];
+		}
+
+		return f;
+	}
+
+	bool Frustum::Intersects(const Aabb& box) const noexcept
+	{
+		for (const auto& p : Planes)
+		{
+			const float x = p[0] >= 0.0f ? box.Max.X : box.Min.X;
+			const float y = p[1] >= 0.0f ? box.Max.Y : box.Min.Y;
+			const float z = p[2] >= 0.0f ? box.Max.Z : box.Min.Z;
+
+			if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	namespace SceneCulling
+	{
+		Aabb BoundsOf(const QuantizationBox& box) noexcept
+		{
+			return Aabb{ box.Min, Float3{ box.Min.X + box.Extent.X, box.Min.Y + box.Extent.Y, box.Min.Z + box.Extent.Z } };
+		}
+
+		Aabb BoundsOf(const PolylineLod& lod) noexcept
+		{
+			return Aabb{ lod.BoundsMin, lod.BoundsMax };
+		}
+
+		void Cull(const std::vector<Aabb>& bounds, const VisibilitySet* filter, const Frustum& frustum, std::vector<std::uint32_t>& outIndices)
+		{
+			outIndices.clear();
+
+			if (filter)
+			{
+				filter->ForEach([&](std::size_t i)
+				{
+					if (i < bounds.size() && frustum.Intersects(bounds[i]))
+					{
+						outIndices.emplace_back(static_cast<std::uint32_t>(i));
+					}
+				});
+
+				return;
+			}
+
+			for (std::size_t i = 0; i < bounds.size(); ++i)
+			{
+				if (frustum.Intersects(bounds[i]))
+				{
+					outIndices.emplace_back(static_cast<std::uint32_t>(i));
+				}
+			}
+		}
+
+		void BuildDrawList(const std::vector<std::uint32_t>& indices, const std::vector<QuantizedTrajectory>& trajectories, const std::vector<PolylineLod>& lods, const std::vector<std::size_t>& visibleCounts, const LodView& view, std::vector<TrajectoryDraw>& out)
+		{
+			out.clear();
+			out.reserve(indices.size());
+
+			for (std::uint32_t i : indices)
+			{
+				if (i >= trajectories.size())
+				{
+					continue;
+				}
+
+				const std::size_t count = trajectories[i].Samples.size();
+				const std::size_t visible = (i < visibleCounts.size()) ? std::min(visibleCounts[i], count) : count;
+
+				if (visible == 0)
+				{
+					continue;
+				}
+
+				TrajectoryDraw d{};
+				d.Index = i;
+				d.Range.TailCount = static_cast<std::uint32_t>(visible);
+
+				if (i < lods.size() && lods[i].SampleCount == count)
+				{
+					d.Range = PolylineSimplifier::SelectRange(lods[i], view, visible);
+				}
+
+				out.emplace_back(d);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Physics.hpp"
+#include "PolylineLod.hpp"
+#include "TrajectoryCodec.hpp"
+
+namespace PitchSim
+{
+	class VisibilitySet
+	{
+	public:
+		void Resize(std::size_t count, bool value = false);
+		std::size_t Size() const noexcept { return m_Size; }
+
+		bool Test(std::size_t i) const noexcept;
+		void Set(std::size_t i, bool value) noexcept;
+		void Toggle(std::size_t i) noexcept;
+		void SetAll() noexcept;
+		void ClearAll() noexcept;
+
+		std::size_t Count() const noexcept;
+		bool Any() const noexcept;
+
+		template <typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			for (std::size_t w = 0; w < m_Words.size(); ++w)
+			{
+				std::uint64_t bits = m_Words[w];
+
+				while (bits != 0)
+				{
+					const std::size_t i = w * 64 + static_cast<std::size_t>(CountTrailingZeros(bits));
+					bits &= bits - 1;
+					fn(i);
+				}
+			}
+		}
+
+		const std::vector<std::uint64_t>& Words() const noexcept { return m_Words; }
+
+	private:
+		static int CountTrailingZeros(std::uint64_t v) noexcept;
+		void ClearTail() noexcept;
+
+		std::vector<std::uint64_t> m_Words;
+		std::size_t m_Size{ 0 };
+	};
+
+	struct Aabb
+	{
+		Float3 Min{ 0.0f, 0.0f, 0.0f };
+		Float3 Max{ 0.0f, 0.0f, 0.0f };
+	};
+
+	struct Frustum
+	{
+		float Planes[6][4]{};
+
+		static Frustum FromViewProj(const float* rowMajor) noexcept;
+
+		bool Intersects(const Aabb& box) const noexcept;
+	};
+
+	struct TrajectoryDraw
+	{
+		std::uint32_t Index{ 0 };
+		LodRange Range;
+	};
+
+	namespace SceneCulling
+	{
+		Aabb BoundsOf(const QuantizationBox& box) noexcept;
+		Aabb BoundsOf(const PolylineLod& lod) noexcept;
+
+		void Cull(const std::vector<Aabb>& bounds, const VisibilitySet* filter, const Frustum& frustum, std::vector<std::uint32_t>& outIndices);
+
+		void BuildDrawList(const std::vector<std::uint32_t>& indices, const std::vector<QuantizedTrajectory>& trajectories, const std::vector<PolylineLod>& lods, const std::vector<std::size_t>& visibleCounts, const LodView& view, std::vector<TrajectoryDraw>& out);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace PitchSim
+{
+	enum class SimTermination : std::uint8_t
+	{
+		None,
+		Plate,
+		Ground,
+		StepCap,
+		Cancelled,
+		Count
+	};
+
+	inline const char* ToString(SimTermination t) noexcept
+	{
+		switch (t)
+		{
+			case SimTermination::Plate: return "plate";
+			case SimTermination::Ground: return "ground";
+			case SimTermination::StepCap: return "step cap";
+			case SimTermination::Cancelled: return "cancelled";
+			default: return "none";
+		}
+	}
+
+	struct SimStats
+	{
+		std::uint64_t Steps{ 0 };
+		std::uint64_t ForceEvals{ 0 };
+		std::uint64_t RejectedSteps{ 0 };
+		std::uint64_t PeakOutput{ 0 };
+		std::uint64_t WallNs{ 0 };
+		double EndTime_s{ 0.0 };
+		SimTermination Termination{ SimTermination::None };
+	};
+
+	struct PlateResult
+	{
+		bool Crossed{ false };
+		double Y_m{ 0.0 };
+		double Z_m{ 0.0 };
+		double Time_s{ 0.0 };
+		SimTermination Termination{ SimTermination::None };
+		std::uint64_t Steps{ 0 };
+	};
+
+	struct SimStatsTotals
+	{
+		static constexpr std::size_t TERMINATION_COUNT = static_cast<std::size_t>(SimTermination::Count);
+
+		void Add(const SimStats& s) noexcept
+		{
+			++Runs;
+			Steps += s.Steps;
+			ForceEvals += s.ForceEvals;
+			RejectedSteps += s.RejectedSteps;
+			WallNs += s.WallNs;
+			MaxSteps = std::max(MaxSteps, s.Steps);
+			MaxWallNs = std::max(MaxWallNs, s.WallNs);
+			PeakOutput = std::max(PeakOutput, s.PeakOutput);
+			++ByTermination[static_cast<std::size_t>(s.Termination)];
+		}
+
+		void Merge(const SimStatsTotals& o) noexcept
+		{
+			Runs += o.Runs;
+			Steps += o.Steps;
+			ForceEvals += o.ForceEvals;
+			RejectedSteps += o.RejectedSteps;
+			WallNs += o.WallNs;
+			MaxSteps = std::max(MaxSteps, o.MaxSteps);
+			MaxWallNs = std::max(MaxWallNs, o.MaxWallNs);
+			PeakOutput = std::max(PeakOutput, o.PeakOutput);
+
+			for (std::size_t k = 0; k < TERMINATION_COUNT; ++k)
+			{
+				ByTermination[k] += o.ByTermination[k];
+			}
+		}
+
+		std::uint64_t Count(SimTermination t) const noexcept
+		{
+			return ByTermination[static_cast<std::size_t>(t)];
+		}
+
+		double MeanWallMs() const noexcept
+		{
+			return (Runs > 0) ? (static_cast<double>(WallNs) * 1e-6 / static_cast<double>(Runs)) : 0.0;
+		}
+
+		std::uint64_t Runs{ 0 };
+		std::uint64_t Steps{ 0 };
+		std::uint64_t ForceEvals{ 0 };
+		std::uint64_t RejectedSteps{ 0 };
+		std::uint64_t WallNs{ 0 };
+		std::uint64_t MaxSteps{ 0 };
+		std::uint64_t MaxWallNs{ 0 };
+		std::uint64_t PeakOutput{ 0 };
+		std::uint64_t ByTermination[TERMINATION_COUNT]{};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "SplineTessellator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PitchSim::SplineTessellator
+{
+	namespace
+	{
+		inline const Float3& ClampIdx(const std::pmr::vector<Float3>& v, std::ptrdiff_t i) noexcept
+		{
+			if (i < 0)
+			{
+				return v.front();
+			}
+
+			if (i >= static_cast<std::ptrdiff_t>(v.size()))
+			{
+				return v.back();
+			}
+
+			return v[static_cast<std::size_t>(i)];
+		}
+
+		inline Float3 Sub(const Float3& a, const Float3& b) noexcept
+		{
+			return Float3{ a.X - b.X, a.Y - b.Y, a.Z - b.Z };
+		}
+
+		inline float Dot(const Float3& a, const Float3& b) noexcept
+		{
+			return a.X * b.X + a.Y * b.Y + a.Z * b.Z;
+		}
+
+		inline float Length(const Float3& a) noexcept
+		{
+			return std::sqrt(Dot(a, a));
+		}
+
+		inline float DistanceToChord(const Float3& p, const Float3& a, const Float3& b) noexcept
+		{
+			const Float3 ab = Sub(b, a);
+			const Float3 ap = Sub(p, a);
+			const float len2 = Dot(ab, ab);
+			const float t = (len2 > 0.0f) ? std::clamp(Dot(ap, ab) / len2, 0.0f, 1.0f) : 0.0f;
+
+			return Length(Float3{ ap.X - ab.X * t, ap.Y - ab.Y * t, ap.Z - ab.Z * t });
+		}
+
+		inline float TurnAngle(const Float3& a, const Float3& b, const Float3& c) noexcept
+		{
+			const Float3 u = Sub(b, a);
+			const Float3 v = Sub(c, b);
+			const float lu = Length(u);
+			const float lv = Length(v);
+
+			if (lu <= 0.0f || lv <= 0.0f)
+			{
+				return 0.0f;
+			}
+
+			return std::acos(std::clamp(Dot(u, v) / (lu * lv), -1.0f, 1.0f));
+		}
+
+		struct Segment
+		{
+			const Float3& P0;
+			const Float3& P1;
+			const Float3& P2;
+			const Float3& P3;
+		};
+
+		void Subdivide(const Segment& s, float t0, const Float3& a, float t1, const Float3& b, int depth, float tolerance, const TessellationParams& params, std::pmr::vector<Float3>& out)
+		{
+			const float tm = 0.5f * (t0 + t1);
+			const Float3 m = CatmullRom(s.P0, s.P1, s.P2, s.P3, tm);
+
+			if (depth > 0)
+			{
+				const bool deviates = DistanceToChord(m, a, b) > tolerance;
+				const bool turns = TurnAngle(a, m, b) > params.MaxTurn_rad;
+
+				if (deviates || turns)
+				{
+					Subdivide(s, t0, a, tm, m, depth - 1, tolerance, params, out);
+					out.emplace_back(m);
+					Subdivide(s, tm, m, t1, b, depth - 1, tolerance, params, out);
+				}
+			}
+		}
+
+		inline int DepthFor(int maxSubdivide) noexcept
+		{
+			int depth = 0;
+			while ((1 << (depth + 1)) <= maxSubdivide)
+			{
+				++depth;
+			}
+
+			return depth;
+		}
+	}
+
+	Float3 CatmullRom(const Float3& p0, const Float3& p1, const Float3& p2, const Float3& p3, float t) noexcept
+	{
+		const float t2 = t * t;
+		const float t3 = t2 * t;
+
+		float cx = 0.5f * (2.0f * p1.X + (-p0.X + p2.X) * t + (2.0f * p0.X - 5.0f * p1.X + 4.0f * p2.X - p3.X) * t2 + (-p0.X + 3.0f * p1.X - 3.0f * p2.X + p3.X) * t3);
+		float cy = 0.5f * (2.0f * p1.Y + (-p0.Y + p2.Y) * t + (2.0f * p0.Y - 5.0f * p1.Y + 4.0f * p2.Y - p3.Y) * t2 + (-p0.Y + 3.0f * p1.Y - 3.0f * p2.Y + p3.Y) * t3);
+		float cz = 0.5f * (2.0f * p1.Z + (-p0.Z + p2.Z) * t + (2.0f * p0.Z - 5.0f * p1.Z + 4.0f * p2.Z - p3.Z) * t2 + (-p0.Z + 3.0f * p1.Z - 3.0f * p2.Z + p3.Z) * t3);
+
+		return Float3{ cx, cy, cz };
+	}
+
+	void TessellateRange(const std::pmr::vector<Float3>& points, std::size_t firstSegment, std::size_t lastSegment, const TessellationParams& params, std::pmr::vector<Float3>& out)
+	{
+		const int depth = DepthFor(params.MaxSubdivide);
+
+		for (std::size_t seg = firstSegment; seg < lastSegment; ++seg)
+		{
+			const std::ptrdiff_t i = static_cast<std::ptrdiff_t>(seg);
+			const Segment s{ ClampIdx(points, i - 1), ClampIdx(points, i), ClampIdx(points, i + 1), ClampIdx(points, i + 2) };
+
+			float tolerance = params.Tolerance_m;
+			if (params.PixelScale > 0.0f)
+			{
+				tolerance = std::max(tolerance, ToleranceForPixels(params.MaxPixelError, Length(Sub(s.P1, params.Eye)), params.PixelScale));
+			}
+
+			out.emplace_back(s.P1);
+			Subdivide(s, 0.0f, s.P1, 1.0f, s.P2, depth, tolerance, params, out);
+		}
+	}
+
+	void Tessellate(const std::pmr::vector<Float3>& points, const TessellationParams& params, std::pmr::vector<Float3>& out)
+	{
+		out.clear();
+
+		if (points.size() < 2)
+		{
+			out = points;
+			return;
+		}
+
+		TessellateRange(points, 0, points.size() - 1, params, out);
+		out.emplace_back(points.back());
+	}
+
+	float ToleranceForPixels(float pixels, float distance_m, float pixelScale) noexcept
+	{
+		return pixels * std::max(distance_m, 1e-3f) / std::max(pixelScale, 1e-3f);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "Physics.hpp"
+
+namespace PitchSim
+{
+	struct TessellationParams
+	{
+		float Tolerance_m{ 0.0005f };
+		float MaxTurn_rad{ 0.02f };
+		int MaxSubdivide{ 8 };
+
+		Float3 Eye{};
+		float PixelScale{ 0.0f };
+		float MaxPixelError{ 0.25f };
+	};
+
+	namespace SplineTessellator
+	{
+		Float3 CatmullRom(const Float3& p0, const Float3& p1, const Float3& p2, const Float3& p3, float t) noexcept;
+
+		void TessellateRange(const std::pmr::vector<Float3>& points, std::size_t firstSegment, std::size_t lastSegment, const TessellationParams& params, std::pmr::vector<Float3>& out);
+		void Tessellate(const std::pmr::vector<Float3>& points, const TessellationParams& params, std::pmr::vector<Float3>& out);
+
+		float ToleranceForPixels(float pixels, float distance_m, float pixelScale) noexcept;
+	}
+}
\ No newline at end of file
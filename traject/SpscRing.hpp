@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+
+namespace PitchSim
+{
+	template <typename T>
+	class SpscRing
+	{
+	public:
+		explicit SpscRing(std::size_t capacity)
+			: m_Capacity{ RoundUpPow2(capacity) }, m_Mask{ m_Capacity - 1 }, m_Buffer{ std::make_unique<T[]>(m_Capacity) }
+		{}
+
+		SpscRing(const SpscRing&) = delete;
+		~SpscRing() = default;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		std::size_t TryPush(const T* items, std::size_t count) noexcept
+		{
+			const std::size_t head = m_Head.load(std::memory_order_relaxed);
+
+			if (m_Capacity - (head - m_CachedTail) < count)
+			{
+				m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			}
+
+			const std::size_t n = std::min(count, m_Capacity - (head - m_CachedTail));
+			if (n == 0)
+			{
+				return 0;
+			}
+
+			const std::size_t pos = head & m_Mask;
+			const std::size_t first = std::min(n, m_Capacity - pos);
+			std::copy(items, items + first, m_Buffer.get() + pos);
+			std::copy(items + first, items + n, m_Buffer.get());
+
+			m_Head.store(head + n, std::memory_order_release);
+			return n;
+		}
+
+		std::size_t TryPop(T* out, std::size_t maxCount) noexcept
+		{
+			const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+			if (m_CachedHead - tail < maxCount)
+			{
+				m_CachedHead = m_Head.load(std::memory_order_acquire);
+			}
+
+			const std::size_t n = std::min(maxCount, m_CachedHead - tail);
+			if (n == 0)
+			{
+				return 0;
+			}
+
+			const std::size_t pos = tail & m_Mask;
+			const std::size_t first = std::min(n, m_Capacity - pos);
+			std::copy(m_Buffer.get() + pos, m_Buffer.get() + pos + first, out);
+			std::copy(m_Buffer.get(), m_Buffer.get() + (n - first), out + first);
+
+			m_Tail.store(tail + n, std::memory_order_release);
+			return n;
+		}
+
+		void Reset() noexcept
+		{
+			m_Head.store(0, std::memory_order_relaxed);
+			m_Tail.store(0, std::memory_order_relaxed);
+			m_CachedTail = 0;
+			m_CachedHead = 0;
+		}
+
+		std::size_t SizeApprox() const noexcept
+		{
+			return m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_acquire);
+		}
+
+		std::size_t Capacity() const noexcept
+		{
+			return m_Capacity;
+		}
+
+	private:
+		static std::size_t RoundUpPow2(std::size_t v) noexcept
+		{
+			std::size_t p = 1;
+			while (p < v)
+			{
+				p <<= 1;
+			}
+
+			return p;
+		}
+
+		alignas(64) std::atomic<std::size_t> m_Head{ 0 };
+		std::size_t m_CachedTail{ 0 };
+
+		alignas(64) std::atomic<std::size_t> m_Tail{ 0 };
+		std::size_t m_CachedHead{ 0 };
+
+		alignas(64) const std::size_t m_Capacity;
+		const std::size_t m_Mask;
+		std::unique_ptr<T[]> m_Buffer;
+	};
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
\ No newline at end of file
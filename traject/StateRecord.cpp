@@ -0,0 +1,117 @@
+#include "StateRecord.hpp"
+
+#include <cmath>
+
+namespace PitchSim
+{
+	namespace
+	{
+		constexpr double RAD_TO_DEG = 180.0 / 3.14159265358979323846;
+	}
+
+	void StateRecord::Clear() noexcept
+	{
+		for (auto* column : { &T, &PX, &PY, &PZ, &VX, &VY, &VZ, &AX, &AY, &AZ })
+		{
+			column->clear();
+		}
+	}
+
+	void StateRecord::Reserve(std::size_t count)
+	{
+		for (auto* column : { &T, &PX, &PY, &PZ, &VX, &VY, &VZ, &AX, &AY, &AZ })
+		{
+			column->reserve(count);
+		}
+	}
+
+	void StateRecord::Append(double t_s, const DVec3& p, const DVec3& v, const DVec3& a)
+	{
+		T.push_back(t_s);
+		PX.push_back(p.X);
+		PY.push_back(p.Y);
+		PZ.push_back(p.Z);
+		VX.push_back(v.X);
+		VY.push_back(v.Y);
+		VZ.push_back(v.Z);
+		AX.push_back(a.X);
+		AY.push_back(a.Y);
+		AZ.push_back(a.Z);
+	}
+
+	namespace StateAnalysis
+	{
+		void Speed(const StateRecord& r, double* out_mps) noexcept
+		{
+			const std::size_t n = r.Size();
+			const double* vx = r.VX.data();
+			const double* vy = r.VY.data();
+			const double* vz = r.VZ.data();
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				out_mps[i] = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+			}
+		}
+
+		void SpeedRatio(const StateRecord& r, double* out) noexcept
+		{
+			const std::size_t n = r.Size();
+			if (n == 0)
+			{
+				return;
+			}
+
+			Speed(r, out);
+
+			const double v0 = out[0];
+			const double inv = (v0 > 1e-12) ? 1.0 / v0 : 0.0;
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				out[i] *= inv;
+			}
+		}
+
+		void ApproachAngles(const StateRecord& r, double* vertical_deg, double* horizontal_deg) noexcept
+		{
+			const std::size_t n = r.Size();
+			const double* vx = r.VX.data();
+			const double* vy = r.VY.data();
+			const double* vz = r.VZ.data();
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				vertical_deg[i] = std::atan2(vy[i], vx[i]) * RAD_TO_DEG;
+				horizontal_deg[i] = std::atan2(vz[i], vx[i]) * RAD_TO_DEG;
+			}
+		}
+
+		void BreakProfile(const StateRecord& r, double* breakY_m, double* breakZ_m) noexcept
+		{
+			const std::size_t n = r.Size();
+			if (n == 0)
+			{
+				return;
+			}
+
+			const double* t = r.T.data();
+			const double* py = r.PY.data();
+			const double* pz = r.PZ.data();
+
+			const double t0 = t[0];
+			const double y0 = py[0];
+			const double z0 = pz[0];
+			const double vy0 = r.VY[0];
+			const double vz0 = r.VZ[0];
+			const double halfG = 0.5 * r.G;
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				const double dt = t[i] - t0;
+				breakY_m[i] = py[i] - (y0 + vy0 * dt - halfG * dt * dt);
+				breakZ_m[i] = pz[i] - (z0 + vz0 * dt);
+			}
+		}
+	}
+}
\ No newline at end of file
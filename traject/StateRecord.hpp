@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "MemoryTracker.hpp"
+#include "Physics.hpp"
+
+namespace PitchSim
+{
+	struct StateRecord
+	{
+		std::uint32_t Stride{ 1 };
+
+		double SpinRPM{ 0.0 };
+		DVec3 Omega{ 0.0, 0.0, 0.0 };
+		double G{ G_STANDARD };
+
+		std::pmr::vector<double> T{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> PX{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> PY{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> PZ{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> VX{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> VY{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> VZ{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> AX{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> AY{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+		std::pmr::vector<double> AZ{ MemoryTracker::Resource(MemoryTag::StateRecord) };
+
+		std::size_t Size() const noexcept { return T.size(); }
+
+		void Clear() noexcept;
+		void Reserve(std::size_t count);
+		void Append(double t_s, const DVec3& p, const DVec3& v, const DVec3& a);
+	};
+
+	namespace StateAnalysis
+	{
+		void Speed(const StateRecord& r, double* out_mps) noexcept;
+		void SpeedRatio(const StateRecord& r, double* out) noexcept;
+		void ApproachAngles(const StateRecord& r, double* vertical_deg, double* horizontal_deg) noexcept;
+		void BreakProfile(const StateRecord& r, double* breakY_m, double* breakZ_m) noexcept;
+	}
+}
\ No newline at end of file
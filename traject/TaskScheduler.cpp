@@ -0,0 +1,524 @@
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+#include "Profiler.hpp"
+
+namespace PitchSim
+{
+	namespace
+	{
+		thread_local TaskScheduler* t_Scheduler = nullptr;
+		thread_local unsigned t_WorkerIndex = 0;
+		thread_local std::uint32_t t_StealSeed = 0x9E3779B9u;
+
+		inline std::int64_t NowNs() noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		inline std::uint32_t NextSeed() noexcept
+		{
+			std::uint32_t x = t_StealSeed;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			t_StealSeed = x;
+			return x;
+		}
+	}
+
+	TaskGroup::~TaskGroup()
+	{
+		try
+		{
+			Wait();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void TaskGroup::Run(std::function<void()> fn)
+	{
+		m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+		m_Scheduler.Submit([this, fn = std::move(fn)]()
+		{
+			struct DoneGuard
+			{
+				TaskGroup& Group;
+				std::exception_ptr Error;
+				~DoneGuard() { Group.OnTaskDone(Error); }
+			} guard{ *this, nullptr };
+
+			try
+			{
+				fn();
+			}
+			catch (...)
+			{
+				guard.Error = std::current_exception();
+			}
+		});
+	}
+
+	void TaskGroup::Then(std::function<void()> continuation)
+	{
+		{
+			std::lock_guard<std::mutex> lk{ m_Mutex };
+			if (m_Pending.load(std::memory_order_acquire) != 0)
+			{
+				m_Continuation = std::move(continuation);
+				return;
+			}
+		}
+
+		m_Scheduler.Submit(std::move(continuation));
+	}
+
+	void TaskGroup::Wait()
+	{
+		if (m_Scheduler.IsWorkerThread())
+		{
+			while (m_Pending.load(std::memory_order_acquire) != 0)
+			{
+				if (!m_Scheduler.RunOne())
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> lk{ m_Mutex };
+			m_Cv.wait(lk, [this]() { return m_Pending.load(std::memory_order_acquire) == 0; });
+			error = std::exchange(m_Error, nullptr);
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	bool TaskGroup::IsDone() const noexcept
+	{
+		return m_Pending.load(std::memory_order_acquire) == 0;
+	}
+
+	void TaskGroup::OnTaskDone(std::exception_ptr error)
+	{
+		TaskScheduler& scheduler = m_Scheduler;
+		std::function<void()> continuation;
+
+		{
+			std::lock_guard<std::mutex> lk{ m_Mutex };
+			if (error && !m_Error)
+			{
+				m_Error = std::move(error);
+			}
+
+			if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				continuation = std::move(m_Continuation);
+				m_Continuation = nullptr;
+				m_Cv.notify_all();
+			}
+		}
+
+		if (continuation)
+		{
+			scheduler.Submit(std::move(continuation));
+		}
+	}
+
+	void TaskScheduler::TaskQueue::PushBack(std::function<void()>&& fn)
+	{
+		if (m_Count == m_Slots.size())
+		{
+			Grow();
+		}
+
+		m_Slots[(m_Head + m_Count) & (m_Slots.size() - 1)] = std::move(fn);
+		++m_Count;
+	}
+
+	std::function<void()> TaskScheduler::TaskQueue::PopBack() noexcept
+	{
+		--m_Count;
+		return std::move(m_Slots[(m_Head + m_Count) & (m_Slots.size() - 1)]);
+	}
+
+	std::function<void()> TaskScheduler::TaskQueue::PopFront() noexcept
+	{
+		std::function<void()> fn = std::move(m_Slots[m_Head]);
+		m_Head = (m_Head + 1) & (m_Slots.size() - 1);
+		--m_Count;
+		return fn;
+	}
+
+	void TaskScheduler::TaskQueue::Grow()
+	{
+		std::vector<std::function<void()>> slots(std::max<std::size_t>(64, m_Slots.size() * 2));
+
+		for (std::size_t k = 0; k < m_Count; ++k)
+		{
+			slots[k] = std::move(m_Slots[(m_Head + k) & (m_Slots.size() - 1)]);
+		}
+
+		m_Slots.swap(slots);
+		m_Head = 0;
+	}
+
+	TaskScheduler::TaskScheduler(unsigned workerCount)
+	{
+		if (workerCount == 0)
+		{
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		m_Workers.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i)
+		{
+			m_Workers.emplace_back(std::make_unique<Worker>());
+		}
+
+		m_StatsEpochNs.store(NowNs(), std::memory_order_relaxed);
+
+		m_Threads.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i)
+		{
+			m_Threads.emplace_back([this, i]() { WorkerLoop(i); });
+		}
+	}
+
+	TaskScheduler::~TaskScheduler()
+	{
+		m_Stop.store(true, std::memory_order_release);
+
+		{
+			std::lock_guard<std::mutex> lk{ m_SleepMutex };
+		}
+		m_SleepCv.notify_all();
+
+		for (auto& t : m_Threads)
+		{
+			if (t.joinable())
+			{
+				t.join();
+			}
+		}
+	}
+
+	void TaskScheduler::Submit(std::function<void()> fn)
+	{
+		if (t_Scheduler == this)
+		{
+			Worker& w = *m_Workers[t_WorkerIndex];
+			std::lock_guard<std::mutex> lk{ w.Mutex };
+			w.Deque.PushBack(std::move(fn));
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lk{ m_GlobalMutex };
+			m_Global.PushBack(std::move(fn));
+		}
+
+		m_Queued.fetch_add(1, std::memory_order_release);
+		Notify();
+	}
+
+	void TaskScheduler::ParallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)>& body, std::size_t minGrain)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		struct ForState
+		{
+			std::atomic<std::size_t> Next;
+			std::atomic<std::size_t> Done{ 0 };
+			std::size_t End;
+			std::size_t Count;
+			std::size_t MinGrain;
+			std::size_t Parts;
+			const std::function<void(std::size_t, std::size_t)>* Body;
+
+			std::mutex Mutex;
+			std::condition_variable Cv;
+			std::exception_ptr Error;
+
+			void Complete(std::size_t count)
+			{
+				if (count != 0 && Done.fetch_add(count, std::memory_order_acq_rel) + count == Count)
+				{
+					std::lock_guard<std::mutex> lk{ Mutex };
+					Cv.notify_all();
+				}
+			}
+
+			void Fail(std::exception_ptr error)
+			{
+				{
+					std::lock_guard<std::mutex> lk{ Mutex };
+					if (!Error)
+					{
+						Error = std::move(error);
+					}
+				}
+
+				Complete(End - Next.exchange(End, std::memory_order_acq_rel));
+			}
+		};
+
+		const std::size_t n = end - begin;
+		const std::size_t grain = std::max<std::size_t>(1, minGrain);
+
+		auto state = std::make_shared<ForState>();
+		state->Next.store(begin, std::memory_order_relaxed);
+		state->End = end;
+		state->Count = n;
+		state->MinGrain = grain;
+		state->Parts = static_cast<std::size_t>(WorkerCount()) + 1;
+		state->Body = &body;
+
+		auto drain = [](ForState& s)
+		{
+			std::size_t cur = s.Next.load(std::memory_order_relaxed);
+
+			while (cur < s.End)
+			{
+				const std::size_t remaining = s.End - cur;
+				const std::size_t chunk = std::min(remaining, std::max(s.MinGrain, remaining / (2 * s.Parts)));
+
+				if (!s.Next.compare_exchange_weak(cur, cur + chunk, std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					continue;
+				}
+
+				struct ChunkGuard
+				{
+					ForState& State;
+					std::size_t Count;
+					~ChunkGuard() { State.Complete(Count); }
+				} guard{ s, chunk };
+
+				try
+				{
+					(*s.Body)(cur, cur + chunk);
+				}
+				catch (...)
+				{
+					s.Fail(std::current_exception());
+				}
+
+				cur = s.Next.load(std::memory_order_relaxed);
+			}
+		};
+
+		const std::size_t helpers = std::min<std::size_t>(WorkerCount(), (n + grain - 1) / grain - 1);
+		for (std::size_t h = 0; h < helpers; ++h)
+		{
+			Submit([state, drain]() { drain(*state); });
+		}
+
+		drain(*state);
+
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> lk{ state->Mutex };
+			state->Cv.wait(lk, [&]() { return state->Done.load(std::memory_order_acquire) == n; });
+			error = std::exchange(state->Error, nullptr);
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	unsigned TaskScheduler::WorkerCount() const noexcept
+	{
+		return static_cast<unsigned>(m_Workers.size());
+	}
+
+	bool TaskScheduler::IsWorkerThread() const noexcept
+	{
+		return t_Scheduler == this;
+	}
+
+	bool TaskScheduler::RunOne()
+	{
+		std::function<void()> fn;
+
+		if (IsWorkerThread())
+		{
+			if (TryPopLocal(t_WorkerIndex, fn) || TryPopGlobal(fn) || TrySteal(t_WorkerIndex, fn))
+			{
+				Execute(m_Workers[t_WorkerIndex].get(), fn);
+				return true;
+			}
+
+			return false;
+		}
+
+		if (TryPopGlobal(fn) || TrySteal(WorkerCount(), fn))
+		{
+			Execute(nullptr, fn);
+			return true;
+		}
+
+		return false;
+	}
+
+	std::vector<TaskScheduler::WorkerStats> TaskScheduler::GetWorkerStats() const
+	{
+		const double wallNs = static_cast<double>(std::max<std::int64_t>(1, NowNs() - m_StatsEpochNs.load(std::memory_order_relaxed)));
+
+		std::vector<WorkerStats> out;
+		out.reserve(m_Workers.size());
+
+		for (const auto& w : m_Workers)
+		{
+			WorkerStats s{};
+			s.TasksExecuted = w->TasksExecuted.load(std::memory_order_relaxed);
+			s.Steals = w->Steals.load(std::memory_order_relaxed);
+			s.BusyNs = w->BusyNs.load(std::memory_order_relaxed);
+			s.Utilization = std::clamp(static_cast<double>(s.BusyNs) / wallNs, 0.0, 1.0);
+			out.emplace_back(s);
+		}
+
+		return out;
+	}
+
+	void TaskScheduler::ResetStats() noexcept
+	{
+		for (auto& w : m_Workers)
+		{
+			w->TasksExecuted.store(0, std::memory_order_relaxed);
+			w->Steals.store(0, std::memory_order_relaxed);
+			w->BusyNs.store(0, std::memory_order_relaxed);
+		}
+
+		m_StatsEpochNs.store(NowNs(), std::memory_order_relaxed);
+	}
+
+	void TaskScheduler::WorkerLoop(unsigned index)
+	{
+		t_Scheduler = this;
+		t_WorkerIndex = index;
+		t_StealSeed ^= (index + 1) * 0x85EBCA6Bu;
+
+		char name[32];
+		std::snprintf(name, sizeof(name), "worker %u", index);
+		Profiler::SetThreadName(name);
+
+		std::function<void()> fn;
+
+		while (!m_Stop.load(std::memory_order_acquire))
+		{
+			if (TryPopLocal(index, fn) || TryPopGlobal(fn) || TrySteal(index, fn))
+			{
+				Execute(m_Workers[index].get(), fn);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lk{ m_SleepMutex };
+			m_SleepCv.wait(lk, [this]() { return m_Stop.load(std::memory_order_acquire) || m_Queued.load(std::memory_order_acquire) > 0; });
+		}
+	}
+
+	bool TaskScheduler::TryPopLocal(unsigned index, std::function<void()>& out)
+	{
+		Worker& w = *m_Workers[index];
+		std::lock_guard<std::mutex> lk{ w.Mutex };
+
+		if (w.Deque.Empty())
+		{
+			return false;
+		}
+
+		out = w.Deque.PopBack();
+		m_Queued.fetch_sub(1, std::memory_order_acq_rel);
+		return true;
+	}
+
+	bool TaskScheduler::TryPopGlobal(std::function<void()>& out)
+	{
+		std::lock_guard<std::mutex> lk{ m_GlobalMutex };
+
+		if (m_Global.Empty())
+		{
+			return false;
+		}
+
+		out = m_Global.PopFront();
+		m_Queued.fetch_sub(1, std::memory_order_acq_rel);
+		return true;
+	}
+
+	bool TaskScheduler::TrySteal(unsigned thief, std::function<void()>& out)
+	{
+		const std::size_t count = m_Workers.size();
+		const std::size_t start = NextSeed() % count;
+
+		for (std::size_t k = 0; k < count; ++k)
+		{
+			const std::size_t victim = (start + k) % count;
+			if (victim == thief)
+			{
+				continue;
+			}
+
+			Worker& w = *m_Workers[victim];
+			std::lock_guard<std::mutex> lk{ w.Mutex };
+
+			if (w.Deque.Empty())
+			{
+				continue;
+			}
+
+			out = w.Deque.PopFront();
+			m_Queued.fetch_sub(1, std::memory_order_acq_rel);
+
+			if (thief < count)
+			{
+				m_Workers[thief]->Steals.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void TaskScheduler::Execute(Worker* worker, std::function<void()>& fn) noexcept
+	{
+		const std::int64_t t0 = NowNs();
+
+		fn();
+		fn = nullptr;
+
+		if (worker)
+		{
+			worker->BusyNs.fetch_add(static_cast<std::uint64_t>(NowNs() - t0), std::memory_order_relaxed);
+			worker->TasksExecuted.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void TaskScheduler::Notify()
+	{
+		{
+			std::lock_guard<std::mutex> lk{ m_SleepMutex };
+		}
+		m_SleepCv.notify_one();
+	}
+}
\ No newline at end of file
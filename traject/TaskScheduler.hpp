@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PitchSim
+{
+	class TaskScheduler;
+
+	class TaskGroup
+	{
+	public:
+		explicit TaskGroup(TaskScheduler& scheduler) noexcept : m_Scheduler{ scheduler } {}
+		TaskGroup(const TaskGroup&) = delete;
+		~TaskGroup();
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		void Run(std::function<void()> fn);
+		void Then(std::function<void()> continuation);
+		void Wait();
+		bool IsDone() const noexcept;
+
+	private:
+		void OnTaskDone(std::exception_ptr error);
+
+		TaskScheduler& m_Scheduler;
+		std::atomic<std::size_t> m_Pending{ 0 };
+		std::mutex m_Mutex;
+		std::condition_variable m_Cv;
+		std::function<void()> m_Continuation;
+		std::exception_ptr m_Error;
+	};
+
+	class TaskScheduler
+	{
+	public:
+		struct WorkerStats
+		{
+			std::uint64_t TasksExecuted{ 0 };
+			std::uint64_t Steals{ 0 };
+			std::uint64_t BusyNs{ 0 };
+			double Utilization{ 0.0 };
+		};
+
+		explicit TaskScheduler(unsigned workerCount = 0);
+		TaskScheduler(const TaskScheduler&) = delete;
+		~TaskScheduler();
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+		void Submit(std::function<void()> fn);
+		void ParallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)>& body, std::size_t minGrain = 1);
+
+		unsigned WorkerCount() const noexcept;
+		bool IsWorkerThread() const noexcept;
+		bool RunOne();
+
+		std::vector<WorkerStats> GetWorkerStats() const;
+		void ResetStats() noexcept;
+
+	private:
+		class TaskQueue
+		{
+		public:
+			bool Empty() const noexcept { return m_Count == 0; }
+			void PushBack(std::function<void()>&& fn);
+			std::function<void()> PopBack() noexcept;
+			std::function<void()> PopFront() noexcept;
+
+		private:
+			void Grow();
+
+			std::vector<std::function<void()>> m_Slots;
+			std::size_t m_Head{ 0 };
+			std::size_t m_Count{ 0 };
+		};
+
+		struct alignas(64) Worker
+		{
+			std::mutex Mutex;
+			TaskQueue Deque;
+			std::atomic<std::uint64_t> TasksExecuted{ 0 };
+			std::atomic<std::uint64_t> Steals{ 0 };
+			std::atomic<std::uint64_t> BusyNs{ 0 };
+		};
+
+		void WorkerLoop(unsigned index);
+		bool TryPopLocal(unsigned index, std::function<void()>& out);
+		bool TryPopGlobal(std::function<void()>& out);
+		bool TrySteal(unsigned thief, std::function<void()>& out);
+		void Execute(Worker* worker, std::function<void()>& fn) noexcept;
+		void Notify();
+
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+		std::vector<std::thread> m_Threads;
+
+		std::mutex m_GlobalMutex;
+		TaskQueue m_Global;
+
+		std::mutex m_SleepMutex;
+		std::condition_variable m_SleepCv;
+		std::atomic<std::size_t> m_Queued{ 0 };
+		std::atomic<bool> m_Stop{ false };
+
+		std::atomic<std::int64_t> m_StatsEpochNs{ 0 };
+	};
+}
\ No newline at end of file
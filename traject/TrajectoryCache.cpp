@@ -0,0 +1,133 @@
+#include "TrajectoryCache.hpp"
+
+#include <iterator>
+
+#include "ParamsKey.hpp"
+
+namespace PitchSim
+{
+	namespace
+	{
+		std::uint64_t EntryBytes(const TrajectoryCache::Entry& e) noexcept
+		{
+			return sizeof(TrajectoryCache::Entry)
+				+ e.Samples.capacity() * sizeof(QuantizedSample)
+				+ e.Lod.LevelError.capacity() * sizeof(float)
+				+ e.Lod.LevelOffsets.capacity() * sizeof(std::uint32_t)
+				+ e.Lod.Indices.capacity() * sizeof(std::uint32_t);
+		}
+	}
+
+	std::uint64_t TrajectoryCache::HashKey(const SimParams& params, double plateDistance_m) noexcept
+	{
+		std::uint64_t h = HashParamsKey(MakeParamsKey(params));
+		MixKeyWord(h, KeyWord(plateDistance_m));
+		return h;
+	}
+
+	TrajectoryCache::TrajectoryCache(std::uint64_t budgetBytes, KeyHasher hasher) noexcept : m_Hasher{ hasher }
+	{
+		m_Stats.BudgetBytes = budgetBytes;
+	}
+
+	void TrajectoryCache::SetBudget(std::uint64_t budgetBytes) noexcept
+	{
+		m_Stats.BudgetBytes = budgetBytes;
+		EvictToBudget();
+	}
+
+	const TrajectoryCache::Entry* TrajectoryCache::Find(const SimParams& params, double plateDistance_m) noexcept
+	{
+		if (!IsEnabled())
+		{
+			return nullptr;
+		}
+
+		const auto found = m_Index.find(m_Hasher(params, plateDistance_m));
+
+		if (found == m_Index.end() || !(found->second->Params == params) || found->second->PlateDistance_m != plateDistance_m)
+		{
+			++m_Stats.Misses;
+			return nullptr;
+		}
+
+		++m_Stats.Hits;
+		m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+		return &m_Entries.front();
+	}
+
+	void TrajectoryCache::Insert(const SimParams& params, double plateDistance_m, const QuantizedTrajectory& trajectory, const PolylineLod& lod, const SimStats& stats, const PlateResult& hit)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Entry e;
+		e.Params = params;
+		e.PlateDistance_m = plateDistance_m;
+		e.Box = trajectory.Box;
+		e.Samples.assign(trajectory.Samples.begin(), trajectory.Samples.end());
+		e.Lod = lod;
+		e.Stats = stats;
+		e.Hit = hit;
+
+		Push(std::move(e));
+	}
+
+	void TrajectoryCache::Insert(const SimParams& params, double plateDistance_m, QuantizedTrajectory&& trajectory, PolylineLod&& lod, const SimStats& stats, const PlateResult& hit)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Push(Entry{ 0, params, plateDistance_m, trajectory.Box, std::move(trajectory.Samples), std::move(lod), stats, hit, 0 });
+	}
+
+	void TrajectoryCache::Push(Entry&& entry)
+	{
+		const std::uint64_t hash = m_Hasher(entry.Params, entry.PlateDistance_m);
+
+		if (const auto found = m_Index.find(hash); found != m_Index.end())
+		{
+			Erase(found->second);
+		}
+
+		Entry& e = m_Entries.emplace_front(std::move(entry));
+		e.Hash = hash;
+		e.Bytes = EntryBytes(e);
+
+		m_Index[hash] = m_Entries.begin();
+		m_Stats.Bytes += e.Bytes;
+		++m_Stats.Entries;
+		++m_Stats.Inserts;
+
+		EvictToBudget();
+	}
+
+	void TrajectoryCache::Clear() noexcept
+	{
+		m_Entries.clear();
+		m_Index.clear();
+		m_Stats.Entries = 0;
+		m_Stats.Bytes = 0;
+	}
+
+	void TrajectoryCache::Erase(EntryList::iterator it) noexcept
+	{
+		m_Stats.Bytes -= it->Bytes;
+		--m_Stats.Entries;
+		m_Index.erase(it->Hash);
+		m_Entries.erase(it);
+	}
+
+	void TrajectoryCache::EvictToBudget() noexcept
+	{
+		while (!m_Entries.empty() && m_Stats.Bytes > m_Stats.BudgetBytes)
+		{
+			Erase(std::prev(m_Entries.end()));
+			++m_Stats.Evictions;
+		}
+	}
+}
\ No newline at end of file
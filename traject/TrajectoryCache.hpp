@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryTracker.hpp"
+#include "Physics.hpp"
+#include "PolylineLod.hpp"
+#include "SimStats.hpp"
+#include "TrajectoryCodec.hpp"
+
+namespace PitchSim
+{
+	struct TrajectoryCacheStats
+	{
+		std::uint64_t Hits{ 0 };
+		std::uint64_t Misses{ 0 };
+		std::uint64_t Inserts{ 0 };
+		std::uint64_t Evictions{ 0 };
+		std::size_t Entries{ 0 };
+		std::uint64_t Bytes{ 0 };
+		std::uint64_t BudgetBytes{ 0 };
+
+		double HitRate() const noexcept { return (Hits + Misses) > 0 ? static_cast<double>(Hits) / static_cast<double>(Hits + Misses) : 0.0; }
+	};
+
+	class TrajectoryCache
+	{
+	public:
+		struct Entry
+		{
+			std::uint64_t Hash{ 0 };
+			SimParams Params;
+			double PlateDistance_m{ 0.0 };
+			QuantizationBox Box;
+			std::pmr::vector<QuantizedSample> Samples{ MemoryTracker::Resource(MemoryTag::TrajectoryCache) };
+			PolylineLod Lod
+			{
+				0, Float3{}, Float3{},
+				std::pmr::vector<float>{ MemoryTracker::Resource(MemoryTag::TrajectoryCache) },
+				std::pmr::vector<std::uint32_t>{ MemoryTracker::Resource(MemoryTag::TrajectoryCache) },
+				std::pmr::vector<std::uint32_t>{ MemoryTracker::Resource(MemoryTag::TrajectoryCache) }
+			};
+			SimStats Stats;
+			PlateResult Hit;
+			std::uint64_t Bytes{ 0 };
+		};
+
+		using KeyHasher = std::uint64_t (*)(const SimParams& params, double plateDistance_m) noexcept;
+
+		static std::uint64_t HashKey(const SimParams& params, double plateDistance_m) noexcept;
+
+		TrajectoryCache() = default;
+		explicit TrajectoryCache(std::uint64_t budgetBytes, KeyHasher hasher = &HashKey) noexcept;
+		TrajectoryCache(const TrajectoryCache&) = delete;
+		TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
+		void SetBudget(std::uint64_t budgetBytes) noexcept;
+		bool IsEnabled() const noexcept { return m_Stats.BudgetBytes > 0; }
+
+		const Entry* Find(const SimParams& params, double plateDistance_m) noexcept;
+		void Insert(const SimParams& params, double plateDistance_m, const QuantizedTrajectory& trajectory, const PolylineLod& lod, const SimStats& stats, const PlateResult& hit);
+		void Insert(const SimParams& params, double plateDistance_m, QuantizedTrajectory&& trajectory, PolylineLod&& lod, const SimStats& stats, const PlateResult& hit);
+		void Clear() noexcept;
+
+		const TrajectoryCacheStats& Stats() const noexcept { return m_Stats; }
+
+	private:
+		using EntryList = std::list<Entry>;
+
+		void Push(Entry&& entry);
+		void Erase(EntryList::iterator it) noexcept;
+		void EvictToBudget() noexcept;
+
+		EntryList m_Entries;
+		std::unordered_map<std::uint64_t, EntryList::iterator> m_Index;
+		TrajectoryCacheStats m_Stats;
+		KeyHasher m_Hasher{ &HashKey };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "TrajectoryCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PitchSim::TrajectoryCodec
+{
+	namespace
+	{
+		inline std::uint16_t QuantizeAxis(float v, float min, float extent) noexcept
+		{
+			if (!(extent > 0.0f))
+			{
+				return 0;
+			}
+
+			const float n = std::clamp((v - min) / extent, 0.0f, 1.0f);
+			return static_cast<std::uint16_t>(std::lround(n * static_cast<float>(QUANT_MAX)));
+		}
+
+		inline float DequantizeAxis(std::uint16_t q, float min, float extent) noexcept
+		{
+			return min + static_cast<float>(q) * (extent / static_cast<float>(QUANT_MAX));
+		}
+
+		struct MinMax
+		{
+			Float3 Lo{ 0.0f, 0.0f, 0.0f };
+			Float3 Hi{ 0.0f, 0.0f, 0.0f };
+
+			void Add(const Float3& p, bool first) noexcept
+			{
+				if (first)
+				{
+					Lo = p;
+					Hi = p;
+					return;
+				}
+
+				Lo = Float3{ std::min(Lo.X, p.X), std::min(Lo.Y, p.Y), std::min(Lo.Z, p.Z) };
+				Hi = Float3{ std::max(Hi.X, p.X), std::max(Hi.Y, p.Y), std::max(Hi.Z, p.Z) };
+			}
+
+			QuantizationBox ToBox() const noexcept
+			{
+				return QuantizationBox{ Lo, Float3{ Hi.X - Lo.X, Hi.Y - Lo.Y, Hi.Z - Lo.Z } };
+			}
+		};
+	}
+
+	QuantizationBox ComputeBox(const Float3* points, std::size_t count) noexcept
+	{
+		MinMax mm;
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			mm.Add(points[i], i == 0);
+		}
+
+		return mm.ToBox();
+	}
+
+	QuantizationBox ComputeBox(const QuantizedTrajectory& traj) noexcept
+	{
+		MinMax mm;
+
+		const std::size_t n = traj.Samples.size();
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			mm.Add(Decode(traj.Samples[i], traj.Box), i == 0);
+		}
+
+		return mm.ToBox();
+	}
+
+	QuantizedSample Encode(const Float3& p, const QuantizationBox& box) noexcept
+	{
+		return QuantizedSample
+		{
+			QuantizeAxis(p.X, box.Min.X, box.Extent.X),
+			QuantizeAxis(p.Y, box.Min.Y, box.Extent.Y),
+			QuantizeAxis(p.Z, box.Min.Z, box.Extent.Z)
+		};
+	}
+
+	void Encode(const Float3* points, std::size_t count, const QuantizationBox& box, QuantizedSample* out) noexcept
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			out[i] = Encode(points[i], box);
+		}
+	}
+
+	Float3 Decode(const QuantizedSample& q, const QuantizationBox& box) noexcept
+	{
+		return Float3
+		{
+			DequantizeAxis(q.X, box.Min.X, box.Extent.X),
+			DequantizeAxis(q.Y, box.Min.Y, box.Extent.Y),
+			DequantizeAxis(q.Z, box.Min.Z, box.Extent.Z)
+		};
+	}
+
+	void Decode(const QuantizedSample* samples, std::size_t count, const QuantizationBox& box, Float3* out) noexcept
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			out[i] = Decode(samples[i], box);
+		}
+	}
+
+	void Requantize(QuantizedTrajectory& traj) noexcept
+	{
+		const QuantizationBox tight = ComputeBox(traj);
+
+		for (auto& q : traj.Samples)
+		{
+			q = Encode(Decode(q, traj.Box), tight);
+		}
+
+		traj.Box = tight;
+	}
+
+	float MaxError(const QuantizationBox& box) noexcept
+	{
+		const float hx = 0.5f * box.Extent.X / static_cast<float>(QUANT_MAX);
+		const float hy = 0.5f * box.Extent.Y / static_cast<float>(QUANT_MAX);
+		const float hz = 0.5f * box.Extent.Z / static_cast<float>(QUANT_MAX);
+
+		return std::sqrt(hx * hx + hy * hy + hz * hz);
+	}
+
+	float SampleParam(std::size_t index, std::size_t count) noexcept
+	{
+		return (count > 1) ? static_cast<float>(index) / static_cast<float>(count - 1) : 0.0f;
+	}
+}
\ No newline at end of file
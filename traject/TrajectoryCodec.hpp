@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "MemoryTracker.hpp"
+#include "Physics.hpp"
+
+namespace PitchSim
+{
+	struct QuantizedSample
+	{
+		std::uint16_t X;
+		std::uint16_t Y;
+		std::uint16_t Z;
+	};
+
+	static_assert(sizeof(QuantizedSample) == 6);
+
+	struct QuantizationBox
+	{
+		Float3 Min{ 0.0f, 0.0f, 0.0f };
+		Float3 Extent{ 0.0f, 0.0f, 0.0f };
+	};
+
+	struct QuantizedTrajectory
+	{
+		QuantizationBox Box;
+		std::uint32_t PaletteIndex{ 0 };
+		std::pmr::vector<QuantizedSample> Samples{ MemoryTracker::Resource(MemoryTag::Samples) };
+	};
+
+	namespace TrajectoryCodec
+	{
+		constexpr std::uint32_t QUANT_MAX = 0xFFFF;
+
+		QuantizationBox ComputeBox(const Float3* points, std::size_t count) noexcept;
+		QuantizationBox ComputeBox(const QuantizedTrajectory& traj) noexcept;
+
+		QuantizedSample Encode(const Float3& p, const QuantizationBox& box) noexcept;
+		void Encode(const Float3* points, std::size_t count, const QuantizationBox& box, QuantizedSample* out) noexcept;
+
+		Float3 Decode(const QuantizedSample& q, const QuantizationBox& box) noexcept;
+		void Decode(const QuantizedSample* samples, std::size_t count, const QuantizationBox& box, Float3* out) noexcept;
+
+		void Requantize(QuantizedTrajectory& traj) noexcept;
+
+		float MaxError(const QuantizationBox& box) noexcept;
+		float SampleParam(std::size_t index, std::size_t count) noexcept;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "TrajectoryPipeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Profiler.hpp"
+
+namespace PitchSim
+{
+	namespace
+	{
+		class FusedSink final : public PointSink
+		{
+		public:
+			FusedSink(std::pmr::vector<Float3>* record, double plateX_m, double outputDt_s, PointSink* downstream) noexcept
+				: m_Record{ record }, m_PlateX{ plateX_m }, m_OutputDt{ outputDt_s }, m_Downstream{ downstream }
+			{
+			}
+
+			bool Consume(const Float3* points, std::size_t count) override
+			{
+				Float3* dst = nullptr;
+
+				if (m_Record)
+				{
+					const std::size_t at = m_Record->size();
+					m_Record->resize(at + count);
+					dst = m_Record->data() + at;
+				}
+
+				for (std::size_t k = 0; k < count; ++k)
+				{
+					const Float3 p = points[k];
+
+					if (dst)
+					{
+						dst[k] = p;
+					}
+
+					if (m_Index == 0)
+					{
+						m_Lo = p;
+						m_Hi = p;
+					}
+					else
+					{
+						m_Lo = Float3{ std::min(m_Lo.X, p.X), std::min(m_Lo.Y, p.Y), std::min(m_Lo.Z, p.Z) };
+						m_Hi = Float3{ std::max(m_Hi.X, p.X), std::max(m_Hi.Y, p.Y), std::max(m_Hi.Z, p.Z) };
+
+						if (!m_Hit.Crossed && m_Prev.X <= m_PlateX && p.X >= m_PlateX)
+						{
+							const double dx = static_cast<double>(p.X) - static_cast<double>(m_Prev.X);
+							const double t = (std::abs(dx) > 1e-12) ? std::clamp((m_PlateX - m_Prev.X) / dx, 0.0, 1.0) : 0.0;
+							m_Hit.Crossed = true;
+							m_Hit.Y_m = m_Prev.Y + (p.Y - m_Prev.Y) * t;
+							m_Hit.Z_m = m_Prev.Z + (p.Z - m_Prev.Z) * t;
+							m_HitIndex = m_Index;
+							m_HitFraction = t;
+						}
+					}
+
+					m_Prev = p;
+					++m_Index;
+				}
+
+				return !m_Downstream || m_Downstream->Consume(points, count);
+			}
+
+			QuantizationBox Box() const noexcept
+			{
+				return QuantizationBox{ m_Lo, Float3{ m_Hi.X - m_Lo.X, m_Hi.Y - m_Lo.Y, m_Hi.Z - m_Lo.Z } };
+			}
+
+			PlateResult Hit(double endTime_s) const noexcept
+			{
+				PlateResult hit = m_Hit;
+
+				if (hit.Crossed)
+				{
+					const double t0 = static_cast<double>(m_HitIndex - 1) * m_OutputDt;
+					const double t1 = (m_HitIndex + 1 == m_Index) ? endTime_s : static_cast<double>(m_HitIndex) * m_OutputDt;
+					hit.Time_s = t0 + (t1 - t0) * m_HitFraction;
+				}
+
+				return hit;
+			}
+
+		private:
+			std::pmr::vector<Float3>* m_Record;
+			double m_PlateX;
+			double m_OutputDt;
+			PointSink* m_Downstream;
+
+			Float3 m_Lo{ 0.0f, 0.0f, 0.0f };
+			Float3 m_Hi{ 0.0f, 0.0f, 0.0f };
+			Float3 m_Prev{ 0.0f, 0.0f, 0.0f };
+			std::size_t m_Index{ 0 };
+			std::size_t m_HitIndex{ 0 };
+			double m_HitFraction{ 0.0 };
+			PlateResult m_Hit;
+		};
+	}
+
+	SimParams ResolvePitchParams(const Config::PitchEntry& entry, const SimParams& base) noexcept
+	{
+		SimParams p = base;
+		p.InitialSpeed_mps = entry.Speed_kmh / 3.6;
+		p.SpinAxis = entry.Axis;
+		p.SpinRPM = entry.Rpm;
+		p.ReleaseHeight_cm = entry.Release_cm.value_or(p.ReleaseHeight_cm);
+		p.Elevation_deg = entry.Elevation_deg.value_or(p.Elevation_deg);
+		p.Azimuth_deg = entry.Azimuth_deg.value_or(p.Azimuth_deg);
+		return p;
+	}
+
+	SimParams TrajectoryPipeline::Resolve(Config::PitchEntry& entry, const PitchSampler& sampler, SamplerRng& rng, const SimParams& base) noexcept
+	{
+		PITCHSIM_PROFILE_SCOPE("SamplePitch");
+
+		sampler.SampleOne(entry, rng);
+		return ResolvePitchParams(entry, base);
+	}
+
+	bool TrajectoryPipeline::Build(const SimParams& params, QuantizedTrajectory* packed, PolylineLod* lod, PlateResult& hit, SimStats* stats, PointSink* downstream, StateRecord* record)
+	{
+		const bool keepPoints = packed || lod;
+		const double outputDt = params.Dt_s * static_cast<double>(std::max<std::uint32_t>(1, params.OutputStride));
+
+		m_Points.clear();
+		if (keepPoints)
+		{
+			m_Points.reserve(TrajectorySimulator::EstimateSampleCount(params));
+		}
+
+		FusedSink sink{ keepPoints ? &m_Points : nullptr, params.PlateDistance_m, outputDt, downstream };
+		SimStats local{};
+		SimStats& st = stats ? *stats : local;
+
+		{
+			PITCHSIM_PROFILE_SCOPE("Simulate");
+			m_Simulator.Simulate(params, sink, &st, record);
+		}
+
+		hit = sink.Hit(st.EndTime_s);
+		hit.Termination = st.Termination;
+		hit.Steps = st.Steps;
+
+		if (st.Termination == SimTermination::Cancelled)
+		{
+			return false;
+		}
+
+		const std::size_t n = m_Points.size();
+
+		if (packed)
+		{
+			PITCHSIM_PROFILE_SCOPE("Encode");
+
+			packed->Box = sink.Box();
+			packed->Samples.resize(n);
+			TrajectoryCodec::Encode(m_Points.data(), n, packed->Box, packed->Samples.data());
+		}
+
+		if (lod)
+		{
+			PITCHSIM_PROFILE_SCOPE("BuildLod");
+			PolylineSimplifier::Build(m_Points.data(), n, *lod);
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "MemoryTracker.hpp"
+#include "Physics.hpp"
+#include "PitchConfig.hpp"
+#include "PitchSampler.hpp"
+#include "PolylineLod.hpp"
+#include "SimStats.hpp"
+#include "StateRecord.hpp"
+#include "TrajectoryCodec.hpp"
+#include "TrajectorySimulator.hpp"
+
+namespace PitchSim
+{
+	SimParams ResolvePitchParams(const Config::PitchEntry& entry, const SimParams& base) noexcept;
+
+	class TrajectoryPipeline
+	{
+	public:
+		static SimParams Resolve(Config::PitchEntry& entry, const PitchSampler& sampler, SamplerRng& rng, const SimParams& base) noexcept;
+
+		bool Build(const SimParams& params, QuantizedTrajectory* packed, PolylineLod* lod, PlateResult& hit, SimStats* stats = nullptr, PointSink* downstream = nullptr, StateRecord* record = nullptr);
+
+		const std::pmr::vector<Float3>& Points() const noexcept { return m_Points; }
+
+	private:
+		TrajectorySimulator m_Simulator;
+		std::pmr::vector<Float3> m_Points{ MemoryTracker::Resource(MemoryTag::SimPoints) };
+	};
+}
\ No newline at end of file
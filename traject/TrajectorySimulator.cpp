@@ -1,12 +1,13 @@
 #include "TrajectorySimulator.hpp"
+#include "CostEstimator.hpp"
+#include "StateRecord.hpp"
 
 #include <algorithm>
-#include <memory>
+#include <array>
+#include <chrono>
 #include <limits>
 #include <cmath>
 
-#include "App.hpp"
-
 namespace PitchSim
 {
 	constexpr double PI = 3.14159265358979323846;
@@ -40,6 +41,156 @@ namespace PitchSim
 			dir = Normalize(dir);
 			return dir;
 		}
+
+		template <typename Vector>
+		class VectorSink : public PointSink
+		{
+		public:
+			explicit VectorSink(Vector& out) noexcept : m_Out{ out } {}
+
+			bool Consume(const Float3* points, std::size_t count) override
+			{
+				m_Out.insert(m_Out.end(), points, points + count);
+				return true;
+			}
+
+		private:
+			Vector& m_Out;
+		};
+
+		constexpr double ADAPTIVE_INITIAL_STEP_S = 1e-3;
+		constexpr double ADAPTIVE_MIN_STEP_S = 1e-9;
+		constexpr double ADAPTIVE_MAX_STEP_S = 0.1;
+		constexpr double VELOCITY_ERROR_TIME_S = 0.01;
+
+		inline DVec3 Lin(const DVec3& base, double) noexcept
+		{
+			return base;
+		}
+
+		template <typename... Rest>
+		inline DVec3 Lin(const DVec3& base, double h, double c, const DVec3& v, const Rest&... rest) noexcept
+		{
+			return Lin(Add(base, Mul(v, h * c)), h, rest...);
+		}
+
+		inline double MaxAbs(const DVec3& v) noexcept
+		{
+			return std::max({ std::abs(v.X), std::abs(v.Y), std::abs(v.Z) });
+		}
+
+		inline DVec3 HermitePosition(const DVec3& p0, const DVec3& v0, const DVec3& p1, const DVec3& v1, double h, double s) noexcept
+		{
+			const double s2 = s * s;
+			const double s3 = s2 * s;
+			const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+			const double h10 = s3 - 2.0 * s2 + s;
+			const double h01 = -2.0 * s3 + 3.0 * s2;
+			const double h11 = s3 - s2;
+			return Add(Add(Mul(p0, h00), Mul(v0, h10 * h)), Add(Mul(p1, h01), Mul(v1, h11 * h)));
+		}
+
+		inline DVec3 HermiteVelocity(const DVec3& p0, const DVec3& v0, const DVec3& p1, const DVec3& v1, double h, double s) noexcept
+		{
+			const double s2 = s * s;
+			const double d00 = 6.0 * s2 - 6.0 * s;
+			const double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+			const double d01 = -6.0 * s2 + 6.0 * s;
+			const double d11 = 3.0 * s2 - 2.0 * s;
+			return Add(Add(Mul(p0, d00 / h), Mul(v0, d10)), Add(Mul(p1, d01 / h), Mul(v1, d11)));
+		}
+
+		template <typename Emit>
+		void IntegrateAdaptive(TrajectorySimulator::RK4State& state, const TrajectorySimulator::ForceParams& f, const SimParams& params, std::uint64_t& steps, std::uint64_t& rejected, std::uint64_t& forceEvals, bool withVelocity, Emit& emit)
+		{
+			auto accel = [&](const DVec3& p, const DVec3& v)
+			{
+				++forceEvals;
+				return TrajectorySimulator::ComputeAcceleration(p, v, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+			};
+
+			const double tol = std::max(1e-12, params.Tolerance_m);
+			const double outDt = std::max(1e-9, params.Dt_s) * static_cast<double>(std::max<std::uint32_t>(1, params.OutputStride));
+
+			double t = 0.0;
+			double h = std::min(ADAPTIVE_INITIAL_STEP_S, ADAPTIVE_MAX_STEP_S);
+			std::uint64_t outIndex = 1;
+			double nextOut = outDt;
+
+			DVec3 P = state.P;
+			DVec3 V = state.V;
+			DVec3 a1 = accel(P, V);
+
+			while (steps + rejected < TrajectorySimulator::MAX_STEPS)
+			{
+				const DVec3& k1p = V;
+				const DVec3& k1v = a1;
+
+				const DVec3 k2p = Lin(V, h, 1.0 / 5.0, k1v);
+				const DVec3 k2v = accel(Lin(P, h, 1.0 / 5.0, k1p), k2p);
+
+				const DVec3 k3p = Lin(V, h, 3.0 / 40.0, k1v, 9.0 / 40.0, k2v);
+				const DVec3 k3v = accel(Lin(P, h, 3.0 / 40.0, k1p, 9.0 / 40.0, k2p), k3p);
+
+				const DVec3 k4p = Lin(V, h, 44.0 / 45.0, k1v, -56.0 / 15.0, k2v, 32.0 / 9.0, k3v);
+				const DVec3 k4v = accel(Lin(P, h, 44.0 / 45.0, k1p, -56.0 / 15.0, k2p, 32.0 / 9.0, k3p), k4p);
+
+				const DVec3 k5p = Lin(V, h, 19372.0 / 6561.0, k1v, -25360.0 / 2187.0, k2v, 64448.0 / 6561.0, k3v, -212.0 / 729.0, k4v);
+				const DVec3 k5v = accel(Lin(P, h, 19372.0 / 6561.0, k1p, -25360.0 / 2187.0, k2p, 64448.0 / 6561.0, k3p, -212.0 / 729.0, k4p), k5p);
+
+				const DVec3 k6p = Lin(V, h, 9017.0 / 3168.0, k1v, -355.0 / 33.0, k2v, 46732.0 / 5247.0, k3v, 49.0 / 176.0, k4v, -5103.0 / 18656.0, k5v);
+				const DVec3 k6v = accel(Lin(P, h, 9017.0 / 3168.0, k1p, -355.0 / 33.0, k2p, 46732.0 / 5247.0, k3p, 49.0 / 176.0, k4p, -5103.0 / 18656.0, k5p), k6p);
+
+				const DVec3 Pn = Lin(P, h, 35.0 / 384.0, k1p, 500.0 / 1113.0, k3p, 125.0 / 192.0, k4p, -2187.0 / 6784.0, k5p, 11.0 / 84.0, k6p);
+				const DVec3 Vn = Lin(V, h, 35.0 / 384.0, k1v, 500.0 / 1113.0, k3v, 125.0 / 192.0, k4v, -2187.0 / 6784.0, k5v, 11.0 / 84.0, k6v);
+				const DVec3 a7 = accel(Pn, Vn);
+
+				constexpr double E1 = 71.0 / 57600.0;
+				constexpr double E3 = -71.0 / 16695.0;
+				constexpr double E4 = 71.0 / 1920.0;
+				constexpr double E5 = -17253.0 / 339200.0;
+				constexpr double E6 = 22.0 / 525.0;
+				constexpr double E7 = -1.0 / 40.0;
+
+				const DVec3 zero{ 0.0, 0.0, 0.0 };
+				const DVec3 errP = Lin(zero, h, E1, k1p, E3, k3p, E4, k4p, E5, k5p, E6, k6p, E7, Vn);
+				const DVec3 errV = Lin(zero, h, E1, k1v, E3, k3v, E4, k4v, E5, k5v, E6, k6v, E7, a7);
+				const double err = std::max(MaxAbs(errP), MaxAbs(errV) * VELOCITY_ERROR_TIME_S) / tol;
+
+				if (err <= 1.0)
+				{
+					while (nextOut <= t + h)
+					{
+						const double s = (nextOut - t) / h;
+
+						if (!emit(HermitePosition(P, V, Pn, Vn, h, s), withVelocity ? HermiteVelocity(P, V, Pn, Vn, h, s) : Vn, nextOut))
+						{
+							state = TrajectorySimulator::RK4State{ Pn, Vn };
+							++steps;
+							return;
+						}
+
+						++outIndex;
+						nextOut = static_cast<double>(outIndex) * outDt;
+					}
+
+					t += h;
+					P = Pn;
+					V = Vn;
+					a1 = a7;
+					++steps;
+				}
+				else
+				{
+					++rejected;
+				}
+
+				const double factor = (err > 0.0) ? (0.9 * std::pow(err, -0.2)) : 5.0;
+				h = std::clamp(h * std::clamp(factor, 0.2, 5.0), ADAPTIVE_MIN_STEP_S, ADAPTIVE_MAX_STEP_S);
+			}
+
+			state = TrajectorySimulator::RK4State{ P, V };
+		}
 	}
 
 	DVec3 TrajectorySimulator::ComputeAcceleration(const DVec3& position, const DVec3& velocity, double radius_m, double mass_kg, double rho, double spin_rpm, const DVec3& omega, double g) noexcept
@@ -85,75 +236,223 @@ namespace PitchSim
 		return sum;
 	}
 
-	void TrajectorySimulator::Simulate(const SimParams& params, std::vector<Float3>& outPoints)
+	TrajectorySimulator::ForceParams TrajectorySimulator::MakeForceParams(const SimParams& params) noexcept
+	{
+		ForceParams f{};
+		f.G = G_STANDARD;
+		f.Radius_m = params.Radius_mm * 1e-3;
+		f.Mass_kg = std::max(1e-9, params.Mass_kg);
+
+		double p_hPa = params.UseAltitudePressure ? PressureFromAltitude_hPa(params.Altitude_m) : params.Pressure_hPa;
+		f.Rho = ComputeAirDensity_kg_per_m3(params.AirTemp_C, params.RelHumidity_pct, p_hPa);
+
+		f.SpinRPM = params.SpinRPM;
+		double omegaMag = params.SpinRPM * 2.0 * PI / 60.0;
+		f.Omega = Mul(Normalize(params.SpinAxis), omegaMag);
+		return f;
+	}
+
+	void TrajectorySimulator::StepRK4(RK4State& state, const ForceParams& f, double dt_s) noexcept
+	{
+		const DVec3& Pp = state.P;
+		const DVec3& Pv = state.V;
+
+		DVec3 k1v = ComputeAcceleration(Pp, Pv, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		DVec3 k1p = Pv;
+
+		DVec3 v2 = Add(Pv, Mul(k1v, 0.5 * dt_s));
+		DVec3 k2v = ComputeAcceleration(Add(Pp, Mul(k1p, 0.5 * dt_s)), v2, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		DVec3 k2p = v2;
+
+		DVec3 v3 = Add(Pv, Mul(k2v, 0.5 * dt_s));
+		DVec3 k3v = ComputeAcceleration(Add(Pp, Mul(k2p, 0.5 * dt_s)), v3, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		DVec3 k3p = v3;
+
+		DVec3 v4 = Add(Pv, Mul(k3v, dt_s));
+		DVec3 k4v = ComputeAcceleration(Add(Pp, Mul(k3p, dt_s)), v4, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		DVec3 k4p = v4;
+
+		state.P = Add(Pp, Mul(Add(Add(k1p, Mul(k2p, 2.0)), Add(Mul(k3p, 2.0), k4p)), dt_s / 6.0));
+		state.V = Add(Pv, Mul(Add(Add(k1v, Mul(k2v, 2.0)), Add(Mul(k3v, 2.0), k4v)), dt_s / 6.0));
+	}
+
+	void TrajectorySimulator::Simulate(const SimParams& params, std::vector<Float3>& outPoints, SimStats* stats)
+	{
+		outPoints.clear();
+		outPoints.reserve(EstimateSampleCount(params));
+
+		VectorSink<std::vector<Float3>> sink{ outPoints };
+		Simulate(params, sink, stats);
+	}
+
+	void TrajectorySimulator::Simulate(const SimParams& params, std::pmr::vector<Float3>& outPoints, SimStats* stats)
 	{
 		outPoints.clear();
+		outPoints.reserve(EstimateSampleCount(params));
 
-		double g = G_STANDARD;
-		double r_m = params.Radius_mm * 1e-3;
-		double m_kg = std::max(1e-9, params.Mass_kg);
+		VectorSink<std::pmr::vector<Float3>> sink{ outPoints };
+		Simulate(params, sink, stats);
+	}
 
-		double p_hPa = params.UseAltitudePressure ? PressureFromAltitude_hPa(params.Altitude_m) : params.Pressure_hPa;
-		double rho = ComputeAirDensity_kg_per_m3(params.AirTemp_C, params.RelHumidity_pct, p_hPa);
+	std::size_t TrajectorySimulator::EstimateSampleCount(const SimParams& params) noexcept
+	{
+		return static_cast<std::size_t>(CostEstimator::Estimate(params).Samples);
+	}
 
-		DVec3 dir = DirectionFromAngles(params.Elevation_deg, params.Azimuth_deg);
+	void TrajectorySimulator::StepEuler(RK4State& state, const ForceParams& f, double dt_s) noexcept
+	{
+		const DVec3 a = ComputeAcceleration(state.P, state.V, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		state.V = Add(state.V, Mul(a, dt_s));
+		state.P = Add(state.P, Mul(state.V, dt_s));
+	}
 
-		DVec3 omegaAxis = Normalize(params.SpinAxis);
-		double omegaMag = params.SpinRPM * 2.0 * PI / 60.0;
-		DVec3 omega = Mul(omegaAxis, omegaMag);
+	void TrajectorySimulator::StepHeun(RK4State& state, const ForceParams& f, double dt_s) noexcept
+	{
+		const DVec3 a1 = ComputeAcceleration(state.P, state.V, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+		const DVec3 p1 = Add(state.P, Mul(state.V, dt_s));
+		const DVec3 v1 = Add(state.V, Mul(a1, dt_s));
+		const DVec3 a2 = ComputeAcceleration(p1, v1, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G);
+
+		state.P = Add(state.P, Mul(Add(state.V, v1), 0.5 * dt_s));
+		state.V = Add(state.V, Mul(Add(a1, a2), 0.5 * dt_s));
+	}
+
+	void TrajectorySimulator::Simulate(const SimParams& params, PointSink& sink, SimStats* stats, StateRecord* record)
+	{
+		const auto startTime = stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+		const ForceParams f = MakeForceParams(params);
+
+		DVec3 dir = DirectionFromAngles(params.Elevation_deg, params.Azimuth_deg);
 
 		double releaseY_m = (params.ReleaseHeight_cm + 25.4) * 0.01;
-		DVec3 p{ 0.0, releaseY_m, 0.0 };
-		DVec3 v = Mul(dir, params.InitialSpeed_mps);
+		RK4State state{ DVec3{ 0.0, releaseY_m, 0.0 }, Mul(dir, params.InitialSpeed_mps) };
 
-		outPoints.reserve(200000);
-		outPoints.emplace_back(Float3{ static_cast<float>(p.X), static_cast<float>(p.Y), static_cast<float>(p.Z) });
-		
-		int maxSteps = 5000000;
-		int steps = 0;
-		double traveled_m = 0.0;
+		std::array<Float3, CHUNK_SIZE> chunk;
+		std::size_t chunkCount = 0;
+
+		std::uint64_t steps = 0;
+		std::uint64_t forceEvals = 0;
+		std::uint64_t rejected = 0;
+		std::uint64_t emitted = 0;
+		double endTime_s = 0.0;
+		SimTermination termination = SimTermination::StepCap;
 		double dt_s = params.Dt_s;
 
-		auto StepRK4 = [&](DVec3& Pp, DVec3& Pv)
+		const std::uint32_t recordStride = record ? std::max<std::uint32_t>(1, record->Stride) : 1;
+		if (record)
 		{
-			DVec3 k1v = ComputeAcceleration(Pp, Pv, r_m, m_kg, rho, params.SpinRPM, omega, g);
-			DVec3 k1p = Pv;
+			record->Clear();
+			record->Reserve(EstimateSampleCount(params) / recordStride + 2);
+			record->SpinRPM = f.SpinRPM;
+			record->Omega = f.Omega;
+			record->G = f.G;
+		}
 
-			DVec3 v2 = Add(Pv, Mul(k1v, 0.5 * dt_s));
-			DVec3 k2v = ComputeAcceleration(Add(Pp, Mul(k1p, 0.5 * dt_s)), v2, r_m, m_kg, rho, params.SpinRPM, omega, g);
-			DVec3 k2p = v2;
+		auto reached = [&](const DVec3& q)
+		{
+			return q.X >= params.PlateDistance_m || (params.StopOnGroundHit && q.Y <= 0.0);
+		};
 
-			DVec3 v3 = Add(Pv, Mul(k2v, 0.5 * dt_s));
-			DVec3 k3v = ComputeAcceleration(Add(Pp, Mul(k2p, 0.5 * dt_s)), v3, r_m, m_kg, rho, params.SpinRPM, omega, g);
-			DVec3 k3p = v3;
+		auto emit = [&](const DVec3& q, const DVec3& v, double t_s)
+		{
+			if (record && (emitted % recordStride == 0 || reached(q)))
+			{
+				record->Append(t_s, q, v, ComputeAcceleration(q, v, f.Radius_m, f.Mass_kg, f.Rho, f.SpinRPM, f.Omega, f.G));
+			}
 
-			DVec3 v4 = Add(Pv, Mul(k3v, dt_s));
-			DVec3 k4v = ComputeAcceleration(Add(Pp, Mul(k3p, dt_s)), v4, r_m, m_kg, rho, params.SpinRPM, omega, g);
-			DVec3 k4p = v4;
+			chunk[chunkCount++] = Float3{ static_cast<float>(q.X), static_cast<float>(q.Y), static_cast<float>(q.Z) };
+			++emitted;
+			endTime_s = t_s;
+
+			if (chunkCount == chunk.size())
+			{
+				if (!sink.Consume(chunk.data(), chunkCount))
+				{
+					termination = SimTermination::Cancelled;
+					return false;
+				}
 
-			Pp = Add(Pp, Mul(Add(Add(k1p, Mul(k2p, 2.0)), Add(Mul(k3p, 2.0), k4p)), dt_s / 6.0));
-			Pv = Add(Pv, Mul(Add(Add(k1v, Mul(k2v, 2.0)), Add(Mul(k3v, 2.0), k4v)), dt_s / 6.0));
+				chunkCount = 0;
+			}
+
+			if (q.X >= params.PlateDistance_m)
+			{
+				termination = SimTermination::Plate;
+				return false;
+			}
+
+			if (params.StopOnGroundHit && q.Y <= 0.0)
+			{
+				termination = SimTermination::Ground;
+				return false;
+			}
+
+			return true;
 		};
 
-		while (steps < maxSteps)
+		auto runFixed = [&](auto step, std::uint64_t evalsPerStep)
 		{
-			extern std::unique_ptr<App> gApp;
+			const std::uint32_t stride = std::max<std::uint32_t>(1, params.OutputStride);
+			std::uint32_t pending = 0;
 
-			traveled_m = p.X;
-			if (traveled_m >= gApp->GetPlateDistance())
+			while (steps < MAX_STEPS)
 			{
-				break;
+				step(state, f, dt_s);
+				++steps;
+
+				if (++pending < stride && !reached(state.P))
+				{
+					continue;
+				}
+
+				pending = 0;
+
+				if (!emit(state.P, state.V, static_cast<double>(steps) * dt_s))
+				{
+					break;
+				}
 			}
 
-			if (params.StopOnGroundHit && p.Y <= 0.0)
+			forceEvals = steps * evalsPerStep;
+		};
+
+		if (emit(state.P, state.V, 0.0))
+		{
+			switch (params.Method)
 			{
-				break;
+				case Integrator::Euler:
+					runFixed(StepEuler, 1);
+					break;
+
+				case Integrator::Heun:
+					runFixed(StepHeun, 2);
+					break;
+
+				case Integrator::RK45:
+					IntegrateAdaptive(state, f, params, steps, rejected, forceEvals, record != nullptr, emit);
+					break;
+
+				default:
+					runFixed(StepRK4, 4);
+					break;
 			}
+		}
 
-			StepRK4(p, v);
+		if (termination != SimTermination::Cancelled && chunkCount > 0 && !sink.Consume(chunk.data(), chunkCount))
+		{
+			termination = SimTermination::Cancelled;
+		}
 
-			outPoints.emplace_back(Float3{ static_cast<float>(p.X), static_cast<float>(p.Y), static_cast<float>(p.Z) });
-			++steps;
+		if (stats)
+		{
+			stats->Steps = steps;
+			stats->ForceEvals = forceEvals;
+			stats->RejectedSteps = rejected;
+			stats->PeakOutput = emitted;
+			stats->WallNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+			stats->EndTime_s = endTime_s;
+			stats->Termination = termination;
 		}
 	}
 }
\ No newline at end of file
@@ -1,15 +1,32 @@
 #pragma once
 
 #include <vector>
+#include <memory_resource>
 #include <cstddef>
+#include <cstdint>
 
 #include "Physics.hpp"
+#include "SimStats.hpp"
 
 namespace PitchSim
 {
+	struct StateRecord;
+
+	class PointSink
+	{
+	public:
+		virtual ~PointSink() = default;
+
+		virtual bool Consume(const Float3* points, std::size_t count) = 0;
+	};
+
 	class TrajectorySimulator
 	{
 	public:
+		static constexpr std::size_t CHUNK_SIZE = 256;
+		static constexpr std::uint64_t MAX_STEPS = 5000000;
+		static constexpr std::uint32_t VERSION = 1;
+
 		TrajectorySimulator() = default;
 		TrajectorySimulator(const TrajectorySimulator&) = default;
 		TrajectorySimulator(TrajectorySimulator&&) noexcept = default;
@@ -17,15 +34,32 @@ namespace PitchSim
 		TrajectorySimulator& operator=(const TrajectorySimulator&) = default;
 		TrajectorySimulator& operator=(TrajectorySimulator&&) noexcept = default;
 
-		void Simulate(const SimParams& params, std::vector<Float3>& outPoints);
+		void Simulate(const SimParams& params, std::vector<Float3>& outPoints, SimStats* stats = nullptr);
+		void Simulate(const SimParams& params, std::pmr::vector<Float3>& outPoints, SimStats* stats = nullptr);
+		void Simulate(const SimParams& params, PointSink& sink, SimStats* stats = nullptr, StateRecord* record = nullptr);
+
+		static std::size_t EstimateSampleCount(const SimParams& params) noexcept;
 
-	private:
 		struct RK4State
 		{
 			DVec3 P;
 			DVec3 V;
 		};
 
+		struct ForceParams
+		{
+			double Radius_m;
+			double Mass_kg;
+			double Rho;
+			double SpinRPM;
+			DVec3 Omega;
+			double G;
+		};
+
+		static ForceParams MakeForceParams(const SimParams& params) noexcept;
 		static DVec3 ComputeAcceleration(const DVec3& position, const DVec3& velocity, double radius_m, double mass_kg, double rho, double spin_rpm, const DVec3& omega, double g) noexcept;
+		static void StepEuler(RK4State& state, const ForceParams& f, double dt_s) noexcept;
+		static void StepHeun(RK4State& state, const ForceParams& f, double dt_s) noexcept;
+		static void StepRK4(RK4State& state, const ForceParams& f, double dt_s) noexcept;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "Physics.hpp"
+#include "PolylineLod.hpp"
+#include "SimStats.hpp"
+#include "SpscRing.hpp"
+#include "TrajectoryCodec.hpp"
+#include "TrajectorySimulator.hpp"
+
+namespace PitchSim
+{
+	struct TrajectoryStream
+	{
+		static constexpr std::size_t DEFAULT_RING_CAPACITY = 1u << 14;
+
+		explicit TrajectoryStream(std::size_t ringCapacity = DEFAULT_RING_CAPACITY) : Ring{ ringCapacity } {}
+
+		void Reset(const SimParams& params, bool buffered = false) noexcept
+		{
+			Params = params;
+			Buffered = buffered;
+			Ring.Reset();
+			Stats = SimStats{};
+			Hit = PlateResult{};
+			Finished.store(false, std::memory_order_relaxed);
+			Cancel.store(false, std::memory_order_relaxed);
+		}
+
+		void SignalDrained() noexcept
+		{
+			Drained.fetch_add(1, std::memory_order_release);
+			Drained.notify_one();
+		}
+
+		SimParams Params;
+		SpscRing<Float3> Ring;
+		PolylineLod Lod;
+		QuantizedTrajectory Packed;
+		SimStats Stats;
+		PlateResult Hit;
+		bool Buffered{ false };
+		std::atomic<bool> Finished{ false };
+		std::atomic<bool> Cancel{ false };
+		std::atomic<std::uint32_t> Drained{ 0 };
+	};
+
+	class StreamSink : public PointSink
+	{
+	public:
+		explicit StreamSink(TrajectoryStream& stream) noexcept : m_Stream{ stream } {}
+
+		bool Consume(const Float3* points, std::size_t count) override
+		{
+			while (count > 0)
+			{
+				if (m_Stream.Cancel.load(std::memory_order_relaxed))
+				{
+					return false;
+				}
+
+				const std::uint32_t drained = m_Stream.Drained.load(std::memory_order_acquire);
+				const std::size_t n = m_Stream.Ring.TryPush(points, count);
+				points += n;
+				count -= n;
+
+				if (n == 0)
+				{
+					m_Stream.Drained.wait(drained, std::memory_order_acquire);
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		TrajectoryStream& m_Stream;
+	};
+}
\ No newline at end of file
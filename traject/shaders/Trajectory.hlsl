@@ -0,0 +1,56 @@
+cbuffer CBScene : register(b0)
+{
+    float4x4 Mvp;
+};
+
+cbuffer CBTrajectory : register(b1)
+{
+    float3 BoxMin;
+    uint FirstSample;
+    float3 BoxStep;
+    uint ColorCount;
+    uint PaletteIndex;
+    uint3 Pad;
+};
+
+cbuffer CBPalette : register(b2)
+{
+    float4 Palette[256];
+};
+
+ByteAddressBuffer Samples : register(t0);
+
+struct VSOut
+{
+    float4 pos : SV_Position;
+    float4 col : COLOR;
+};
+
+uint3 LoadSample(uint index)
+{
+    uint addr = index * 6;
+    uint2 w = Samples.Load2(addr & ~3u);
+
+    if ((addr & 2) == 0)
+    {
+        return uint3(w.x & 0xFFFF, w.x >> 16, w.y & 0xFFFF);
+    }
+
+    return uint3(w.x >> 16, w.y & 0xFFFF, w.y >> 16);
+}
+
+VSOut VSMain(uint vid : SV_VertexID)
+{
+    float3 pos = BoxMin + float3(LoadSample(vid)) * BoxStep;
+    float t = ColorCount > 1 ? saturate(float(vid - FirstSample) / float(ColorCount - 1)) : 0.0f;
+
+    VSOut o;
+    o.pos = mul(float4(pos, 1.0f), Mvp);
+    o.col = lerp(Palette[PaletteIndex % 256], float4(1.0f, 1.0f, 1.0f, 1.0f), t);
+    return o;
+}
+
+float4 PSMain(VSOut i) : SV_Target
+{
+    return i.col;
+}
\ No newline at end of file